@@ -5,18 +5,29 @@ horizon_command_handler::horizon_command_handler(
     const std::string& goals_str,
     size_t max_resolutions,
     double exploration_constant,
-    uint64_t seed
+    uint64_t seed,
+    const std::string& lemma_file
 ) :
     solver_cli_interface(file, goals_str),
     rng(seed),
-    solver(solver_args{db, gl, t, seq, bm, max_resolutions},
+    solver(solver_args{.db = db, .gl = gl, .t = t, .vars = seq, .bm = bm,
+                       .max_resolutions = max_resolutions, .base = &base,
+                       .lemma_file = lemma_file},
            mcts_solver_args{exploration_constant, rng})
 {}
 
 bool horizon_command_handler::advance() {
     std::optional<resolutions> soln;
     while (solver(soln)) {
-        if (soln.has_value()) return true;
+        if (soln.has_value()) {
+            solver.save_lemmas();
+            return true;
+        }
     }
+    solver.save_lemmas();
     return false;
 }
+
+void horizon_command_handler::print_stats() {
+    print_solver_stats(solver);
+}
@@ -7,14 +7,18 @@ solver_cli_interface::solver_cli_interface(
     const std::string& file,
     const std::string& goals_str
 ) :
-    pool(t), seq(t), bm(t), norm(pool, bm),
-    db(import_database_from_file(file, pool, seq)),
+    base(t), pool(t, &base), seq(t), bm(t), norm(pool, bm),
+    db(import_database_from_file(file, base, seq)),
     printer(std::cout, var_idx_to_name)
 {
-    auto [g, name_to_idx] = import_goals_from_string(goals_str, pool, seq);
+    auto [g, name_to_idx] = import_goals_from_string(goals_str, base, seq);
     gl = std::move(g);
     var_name_to_idx = std::move(name_to_idx);
     var_idx_to_name = invert(var_name_to_idx);
+
+    // the database and goals are shared read-only from here on;
+    // solvers and the printer build their own terms in overlays
+    base.freeze();
 }
 
 void solver_cli_interface::operator()() {
@@ -25,6 +29,7 @@ void solver_cli_interface::operator()() {
         std::cin.get();
     }
     std::cout << "REFUTED\n";
+    print_stats();
 }
 
 void solver_cli_interface::print_bindings() {
@@ -35,6 +40,15 @@ void solver_cli_interface::print_bindings() {
     }
 }
 
+void solver_cli_interface::print_solver_stats(const solver& s) {
+    const cdcl& c = s.get_cdcl();
+    std::cout << "STATS\n";
+    std::cout << "  lemmas kept = " << c.get_kept() << "\n";
+    std::cout << "  lemmas deleted = " << c.get_deleted() << "\n";
+    std::cout << "  lemmas subsumed = " << c.get_subsumed() << "\n";
+    std::cout << "  candidates prefiltered = " << s.get_prefiltered() << "\n";
+}
+
 std::map<uint32_t, std::string> solver_cli_interface::invert(const std::map<std::string, uint32_t>& m) {
     std::map<uint32_t, std::string> inv;
     for (const auto& [name, idx] : m)
@@ -19,6 +19,7 @@ int main(int argc, char** argv) {
         size_t max_resolutions      = 1000;
         double exploration_constant = 1.41;
         uint64_t seed               = 0;
+        std::string lemma_file;
     } ridge_opts;
 
     auto* ridge_sub = app.add_subcommand("ridge", "Run the Ridge solver");
@@ -27,11 +28,13 @@ int main(int argc, char** argv) {
     ridge_sub->add_option("--max-resolutions", ridge_opts.max_resolutions, "Max resolutions");
     ridge_sub->add_option("--exploration-constant", ridge_opts.exploration_constant, "MCTS exploration constant");
     ridge_sub->add_option("--seed", ridge_opts.seed, "RNG seed");
+    ridge_sub->add_option("--lemmas", ridge_opts.lemma_file, "File lemmas are loaded from and saved to");
     ridge_sub->callback([&]() {
         ridge_command_handler h(ridge_opts.file, ridge_opts.goals_str,
                                 ridge_opts.max_resolutions,
                                 ridge_opts.exploration_constant,
-                                ridge_opts.seed);
+                                ridge_opts.seed,
+                                ridge_opts.lemma_file);
         h();
     });
 
@@ -42,6 +45,7 @@ int main(int argc, char** argv) {
         size_t max_resolutions      = 1000;
         double exploration_constant = 1.41;
         uint64_t seed               = 0;
+        std::string lemma_file;
     } horizon_opts;
 
     auto* horizon_sub = app.add_subcommand("horizon", "Run the Horizon solver");
@@ -50,11 +54,13 @@ int main(int argc, char** argv) {
     horizon_sub->add_option("--max-resolutions", horizon_opts.max_resolutions, "Max resolutions");
     horizon_sub->add_option("--exploration-constant", horizon_opts.exploration_constant, "MCTS exploration constant");
     horizon_sub->add_option("--seed", horizon_opts.seed, "RNG seed");
+    horizon_sub->add_option("--lemmas", horizon_opts.lemma_file, "File lemmas are loaded from and saved to");
     horizon_sub->callback([&]() {
         horizon_command_handler h(horizon_opts.file, horizon_opts.goals_str,
                                   horizon_opts.max_resolutions,
                                   horizon_opts.exploration_constant,
-                                  horizon_opts.seed);
+                                  horizon_opts.seed,
+                                  horizon_opts.lemma_file);
         h();
     });
 
@@ -13,10 +13,12 @@ struct horizon_command_handler : solver_cli_interface {
         const std::string& goals_str,
         size_t max_resolutions,
         double exploration_constant,
-        uint64_t seed
+        uint64_t seed,
+        const std::string& lemma_file = ""
     );
 protected:
     bool advance() override;
+    void print_stats() override;
 private:
     std::mt19937 rng;
     horizon solver;
@@ -10,6 +10,7 @@
 #include "../../core/hpp/normalizer.hpp"
 #include "../../core/hpp/expr_printer.hpp"
 #include "../../core/hpp/defs.hpp"
+#include "../../core/hpp/solver.hpp"
 
 struct solver_cli_interface {
     solver_cli_interface(const std::string& file, const std::string& goals_str);
@@ -17,9 +18,12 @@ struct solver_cli_interface {
     void operator()();
 protected:
     virtual bool advance() = 0;
+    virtual void print_stats() {}
     void print_bindings();
+    static void print_solver_stats(const solver&);
 
     trail t;
+    expr_pool base;
     expr_pool pool;
     sequencer seq;
     bind_map bm;
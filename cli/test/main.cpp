@@ -17,6 +17,7 @@ struct test_solver : solver_cli_interface {
 
     // expose protected members for white-box assertions
     using solver_cli_interface::t;
+    using solver_cli_interface::base;
     using solver_cli_interface::pool;
     using solver_cli_interface::seq;
     using solver_cli_interface::bm;
@@ -109,6 +110,26 @@ void test_solver_cli_interface_constructor_db_contents() {
     assert(s.db[6].body.size() == 2);
 }
 
+void test_solver_cli_interface_constructor_frozen_base() {
+    // The database and goals live in the frozen base; pool only overlays it.
+    test_solver s("cli/examples/ancestor/db.chc", "ancestor(tom, X)");
+
+    assert(s.base.frozen());
+    assert(!s.pool.frozen());
+    assert(s.pool.size() == 0);
+
+    // Looking up a database term through the overlay returns the base node itself
+    assert(s.pool.import(s.db[0].head) == s.db[0].head);
+    assert(s.pool.import(s.gl[0]) == s.gl[0]);
+    assert(s.pool.size() == 0);
+
+    // New terms go to the overlay and leave the base untouched
+    size_t base_size = s.base.size();
+    s.pool.functor("fresh", {s.gl[0]});
+    assert(s.pool.size() == 1);
+    assert(s.base.size() == base_size);
+}
+
 void test_solver_cli_interface_constructor_goals_no_vars() {
     // Goal with no variables: var_idx_to_name must be empty.
     test_solver s("cli/examples/eq/db.chc", "eq(a, a)");
@@ -325,6 +346,7 @@ void unit_test_main() {
     // solver_cli_interface
     TEST(test_solver_cli_interface_constructor_basic);
     TEST(test_solver_cli_interface_constructor_db_contents);
+    TEST(test_solver_cli_interface_constructor_frozen_base);
     TEST(test_solver_cli_interface_constructor_goals_no_vars);
     TEST(test_solver_cli_interface_constructor_goals_with_vars);
     TEST(test_solver_cli_interface_invert);
@@ -0,0 +1,87 @@
+#include "../hpp/applicability_cache.hpp"
+
+applicability_cache::applicability_cache(size_t capacity)
+    : capacity(capacity), hand(0) {
+
+}
+
+void applicability_cache::normalize(const expr* e, bind_map& bm, key& result) {
+    result.clear();
+    renaming.clear();
+    pending.clear();
+    pending.push_back(e);
+
+    // Walk the goal through its bindings in preorder; a functor id fixes its
+    // arity, so the words need no brackets
+    while (!pending.empty()) {
+        const expr* current = bm.deref(pending.back());
+        pending.pop_back();
+
+        // Vars are numbered by first occurrence, so variants share a key
+        if (const expr::var* v = std::get_if<expr::var>(&current->content)) {
+            auto [it, inserted] = renaming.insert({v->index, renaming.size()});
+            result.push_back(var_tag | it->second);
+            continue;
+        }
+
+        if (const expr::integer* i = std::get_if<expr::integer>(&current->content)) {
+            result.push_back(integer_tag);
+            result.push_back(static_cast<uint64_t>(i->value));
+            continue;
+        }
+
+        const expr::functor& f = std::get<expr::functor>(current->content);
+        result.push_back(functor_tag | f.id);
+        for (size_t i = f.args.size(); i-- > 0;)
+            pending.push_back(f.args[i]);
+    }
+}
+
+const bool* applicability_cache::find(const key& k, bool* prefiltered) {
+    auto it = index.find(k);
+    if (it == index.end())
+        return nullptr;
+
+    // a hit earns the entry a second chance when the hand comes round
+    slot& s = slots[it->second];
+    s.referenced = true;
+    if (prefiltered)
+        *prefiltered = s.prefiltered;
+    return &s.applicable;
+}
+
+void applicability_cache::insert(const key& k, bool applicable, bool prefiltered) {
+    if (capacity == 0 || index.contains(k))
+        return;
+
+    // Grow the clock until it is full
+    if (slots.size() < capacity) {
+        auto it = index.insert({k, slots.size()}).first;
+        slots.push_back({&it->first, applicable, prefiltered, false});
+        return;
+    }
+
+    // Advance the hand past referenced entries, clearing their bit
+    while (slots[hand].referenced) {
+        slots[hand].referenced = false;
+        hand = (hand + 1) % capacity;
+    }
+
+    // Replace the victim under the hand
+    index.erase(*slots[hand].goal);
+    auto it = index.insert({k, hand}).first;
+    slots[hand] = {&it->first, applicable, prefiltered, false};
+    hand = (hand + 1) % capacity;
+}
+
+size_t applicability_cache::size() const {
+    return index.size();
+}
+
+size_t applicability_cache::key_hash::operator()(const key& k) const {
+    // FNV-style mixing over the words
+    size_t h = 14695981039346656037ull;
+    for (uint64_t w : k)
+        h = (h ^ w) * 1099511628211ull;
+    return h;
+}
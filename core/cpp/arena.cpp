@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <stdexcept>
+#include "../hpp/arena.hpp"
+
+arena::arena(size_t block_size) :
+    block_size(block_size),
+    blocks(),
+    current(0),
+    offset(0) {
+
+}
+
+void* arena::allocate(size_t bytes, size_t alignment) {
+    while (true) {
+        // try to fit the allocation into the current block
+        if (current < blocks.size()) {
+            block& b = blocks[current];
+            size_t aligned = (offset + alignment - 1) & ~(alignment - 1);
+            if (aligned + bytes <= b.size) {
+                offset = aligned + bytes;
+                return b.data.get() + aligned;
+            }
+            // a retained block that is too small is skipped, never split
+            if (current + 1 < blocks.size()) {
+                ++current;
+                offset = 0;
+                continue;
+            }
+        }
+
+        // out of retained blocks: grow, oversizing for allocations larger than a block
+        size_t size = std::max(block_size, bytes + alignment);
+        blocks.push_back(block{std::make_unique<std::byte[]>(size), size});
+        current = blocks.size() - 1;
+        offset = 0;
+    }
+}
+
+void arena::rewind(const void* p) {
+    // walk back from the current block to the one holding p
+    for (size_t i = current + 1; i-- > 0;) {
+        if (contains(blocks[i], p)) {
+            current = i;
+            offset = static_cast<const std::byte*>(p) - blocks[i].data.get();
+            return;
+        }
+    }
+    throw std::invalid_argument("Pointer was not allocated from this arena");
+}
+
+size_t arena::used() const {
+    // bytes handed out up to the bump pointer, counting skipped block tails
+    size_t result = 0;
+    for (size_t i = 0; i < current && i < blocks.size(); ++i)
+        result += blocks[i].size;
+    return result + offset;
+}
+
+bool arena::contains(const block& b, const void* p) const {
+    const std::byte* bp = static_cast<const std::byte*>(p);
+    return bp >= b.data.get() && bp < b.data.get() + b.size;
+}
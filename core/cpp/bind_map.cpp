@@ -1,6 +1,48 @@
+#include <algorithm>
+#include <stdexcept>
 #include "../hpp/bind_map.hpp"
+#include "../hpp/copier.hpp"
 
-bind_map::bind_map(trail& trail_ref) : trail_ref(trail_ref) {
+const expr*& bind_map::binding_array::operator[](uint32_t index) {
+    if (index >= slots.size())
+        slots.resize(size_t(index) + 1, nullptr);
+    return slots[index];
+}
+
+const expr* bind_map::binding_array::at(uint32_t index) const {
+    const expr* value = get(index);
+    if (!value)
+        throw std::out_of_range("Variable is unbound");
+    return value;
+}
+
+const expr* bind_map::binding_array::get(uint32_t index) const {
+    return index < slots.size() ? slots[index] : nullptr;
+}
+
+size_t bind_map::binding_array::count(uint32_t index) const {
+    return get(index) ? 1 : 0;
+}
+
+size_t bind_map::binding_array::size() const {
+    // number of bound vars; walks the slots, so keep it off hot paths
+    return slots.size() - std::count(slots.begin(), slots.end(), nullptr);
+}
+
+bool bind_map::binding_array::empty() const {
+    return size() == 0;
+}
+
+bool bind_map::binding_array::operator==(const binding_array& other) const {
+    // trailing unbound slots carry no bindings, so they take no part in equality
+    size_t n = std::max(slots.size(), other.slots.size());
+    for (size_t i = 0; i < n; ++i)
+        if (get(i) != other.get(i))
+            return false;
+    return true;
+}
+
+bind_map::bind_map(trail& trail_ref) : trail_ref(trail_ref), recorder(nullptr) {
 
 }
 
@@ -9,116 +51,341 @@ const expr* bind_map::whnf(const expr* key) {
     if (!std::holds_alternative<expr::var>(key->content))
         return key;
 
-    // Get the variable out of the key
-    const expr::var& var = std::get<expr::var>(key->content);
-
-    // Check if the variable is bound
-    auto it = bindings.find(var.index);
-    
     // If the variable is not bound, return the key
-    if (it == bindings.end())
+    const expr* bound_value = bindings.get(std::get<expr::var>(key->content).index);
+    if (!bound_value)
         return key;
 
-    // Get the bound value
-    const expr* bound_value = it->second;
-        
-    // WHNF the bound value
-    const expr* whnf_bound_value = whnf(bound_value);
+    // A binding straight to a non-variable is already collapsed
+    if (!std::holds_alternative<expr::var>(bound_value->content))
+        return bound_value;
+
+    // Follow the chain of bound variables to its end
+    whnf_path.clear();
+    const expr* current = key;
+    while (const expr::var* v = std::get_if<expr::var>(&current->content)) {
+        const expr* next = bindings.get(v->index);
+        if (!next)
+            break;
+        whnf_path.push_back(current);
+        current = next;
+    }
 
-    // Collapse the binding
-    bind(var.index, whnf_bound_value);
+    // Collapse every binding on the chain, innermost first
+    for (size_t i = whnf_path.size(); i-- > 0;)
+        bind(std::get<expr::var>(whnf_path[i]->content).index, current);
 
-    return whnf_bound_value;
+    return current;
 }
 
 bool bind_map::unify(const expr* lhs, const expr* rhs) {
-    // WHNF the lhs and rhs
-    lhs = whnf(lhs);
-    rhs = whnf(rhs);
-
-    // get the lhs and rhs var handles if they are variables
-    const expr::var* lv = std::get_if<expr::var>(&lhs->content);
-    const expr::var* rv = std::get_if<expr::var>(&rhs->content);
-
-    // if they are the same variable, unification succeeds trivially
-    if (lv && rv && lv->index == rv->index)
-        return true;
-    
-    // If the lhs is a variable, add a binding to the whnf of the rhs
-    if (lv) {
-        if (occurs_check(lv->index, rhs))
+    unify_stack.clear();
+    unify_stack.emplace_back(lhs, rhs);
+
+    while (!unify_stack.empty()) {
+        auto [l, r] = unify_stack.back();
+        unify_stack.pop_back();
+
+        // WHNF the lhs and rhs
+        l = whnf(l);
+        r = whnf(r);
+
+        // identical nodes unify trivially (this covers the same variable)
+        if (l == r)
+            continue;
+
+        // get the lhs and rhs var handles if they are variables
+        const expr::var* lv = std::get_if<expr::var>(&l->content);
+        const expr::var* rv = std::get_if<expr::var>(&r->content);
+
+        // if they are the same variable, unification succeeds trivially
+        if (lv && rv && lv->index == rv->index)
+            continue;
+
+        // If the lhs is a variable, add a binding to the whnf of the rhs
+        if (lv) {
+            if (occurs_check(lv->index, r))
+                return false;
+            bind(lv->index, r);
+            continue;
+        }
+
+        // If the rhs is a variable, add a binding to the whnf of the lhs
+        if (rv) {
+            if (occurs_check(rv->index, l))
+                return false;
+            bind(rv->index, l);
+            continue;
+        }
+
+        // If they are not the same type, unification fails
+        if (l->content.index() != r->content.index())
             return false;
-        bind(lv->index, rhs);
-        return true;
+
+        // If they are both functors, match symbol and arity, then queue the args
+        if (std::holds_alternative<expr::functor>(l->content)) {
+            const expr::functor& lf = std::get<expr::functor>(l->content);
+            const expr::functor& rf = std::get<expr::functor>(r->content);
+            if (lf.id != rf.id || lf.args.size() != rf.args.size())
+                return false;
+            // pushed in reverse so args are unified left to right
+            for (size_t i = lf.args.size(); i-- > 0;)
+                unify_stack.emplace_back(lf.args[i], rf.args[i]);
+            continue;
+        }
+
+        // If they are both integers, they unify exactly when their values match
+        if (const expr::integer* li = std::get_if<expr::integer>(&l->content)) {
+            if (li->value != std::get<expr::integer>(r->content).value)
+                return false;
+            continue;
+        }
+
+        return false;
     }
 
-    // If the rhs is a variable, add a binding to the whnf of the lhs
-    if (rv) {
-        if (occurs_check(rv->index, lhs))
+    return true;
+}
+
+bool bind_map::unify(std::span<const rule::cell> cells, uint32_t base, const expr* rhs, std::span<const uint32_t> linear, copier& cp) {
+    // the lhs is a template instance read in place: a var cell stands for the
+    // fresh var base + slot, and linear names slots rather than indices. Only
+    // a subterm bound to an rhs var is ever built, so a clash allocates nothing
+    auto is_linear = [linear](uint32_t slot) {
+        return std::binary_search(linear.begin(), linear.end(), slot);
+    };
+
+    template_stack.clear();
+    template_stack.push_back(rhs);
+
+    for (size_t i = 0; i < cells.size();) {
+        const rule::cell& c = cells[i];
+        const expr* r = template_stack.back();
+        template_stack.pop_back();
+
+        // Ground subterms are shared by every instance, so unify them as they are
+        if (c.e->meta.ground) {
+            if (!unify(c.e, r))
+                return false;
+            ++i;
+            continue;
+        }
+
+        // A var cell is bound like the lhs var of an ordinary unification
+        if (std::holds_alternative<expr::var>(c.e->content)) {
+            uint32_t index = base + c.slot;
+            ++i;
+
+            // once bound, the fresh var unifies through its binding
+            if (const expr* bound = bindings.get(index)) {
+                if (!unify(bound, r))
+                    return false;
+                continue;
+            }
+
+            r = whnf(r);
+            if (const expr::var* rv = std::get_if<expr::var>(&r->content); rv && rv->index == index)
+                continue;
+            if (!is_linear(c.slot) && occurs_check(index, r))
+                return false;
+            bind(index, r);
+            continue;
+        }
+
+        const expr::functor& f = std::get<expr::functor>(c.e->content);
+        r = whnf(r);
+
+        // An rhs var takes the instance of this subterm, which must now be built
+        if (const expr::var* rv = std::get_if<expr::var>(&r->content)) {
+            // the subterm spans this cell and the cells of its args
+            size_t end = rule::subterm_end(cells, i);
+            const expr* instance = cp(cells.subspan(i, end - i), base);
+            if (occurs_check(rv->index, instance))
+                return false;
+            bind(rv->index, instance);
+            i = end;
+            continue;
+        }
+
+        // Otherwise match symbol and arity, then queue the args
+        const expr::functor* rf = std::get_if<expr::functor>(&r->content);
+        if (!rf || rf->id != f.id || rf->args.size() != f.args.size())
             return false;
-        bind(rv->index, lhs);
-        return true;
+        // pushed in reverse so args are matched left to right, as the cells are
+        for (size_t k = rf->args.size(); k-- > 0;)
+            template_stack.push_back(rf->args[k]);
+        ++i;
     }
 
-    // If they are not the same type, unification fails
-    if (lhs->content.index() != rhs->content.index())
-        return false;
+    return true;
+}
+
+const expr* bind_map::deref(const expr* key) const {
+    // follow the chain without collapsing it, so nothing is bound or logged
+    while (const expr::var* v = std::get_if<expr::var>(&key->content)) {
+        const expr* next = bindings.get(v->index);
+        if (!next)
+            break;
+        key = next;
+    }
+    return key;
+}
+
+const expr* bind_map::binding(uint32_t index) const {
+    // one step only: the value the var is bound to directly, or null
+    return bindings.get(index);
+}
+
+bool bind_map::matches(const expr* lhs, const expr* rhs) {
+    // a read-only necessary condition for unify: symbols, arities and
+    // integers agree wherever both sides are bound. Vars match anything,
+    // so repeated vars and occurs checks are left to unification
+    match_stack.clear();
+    match_stack.emplace_back(lhs, rhs);
+
+    while (!match_stack.empty()) {
+        auto [l, r] = match_stack.back();
+        match_stack.pop_back();
 
-    // If they are both functors, unify name, arity, and all args
-    if (std::holds_alternative<expr::functor>(lhs->content)) {
-        const expr::functor& lf = std::get<expr::functor>(lhs->content);
-        const expr::functor& rf = std::get<expr::functor>(rhs->content);
-        if (lf.name != rf.name || lf.args.size() != rf.args.size())
+        l = deref(l);
+        r = deref(r);
+
+        if (l == r)
+            continue;
+
+        if (std::holds_alternative<expr::var>(l->content) || std::holds_alternative<expr::var>(r->content))
+            continue;
+
+        if (l->content.index() != r->content.index())
             return false;
-        for (size_t i = 0; i < lf.args.size(); ++i)
-            if (!unify(lf.args[i], rf.args[i]))
+
+        if (const expr::functor* lf = std::get_if<expr::functor>(&l->content)) {
+            const expr::functor& rf = std::get<expr::functor>(r->content);
+            if (lf->id != rf.id || lf->args.size() != rf.args.size())
                 return false;
-        return true;
+            for (size_t i = lf->args.size(); i-- > 0;)
+                match_stack.emplace_back(lf->args[i], rf.args[i]);
+            continue;
+        }
+
+        if (std::get<expr::integer>(l->content).value != std::get<expr::integer>(r->content).value)
+            return false;
     }
 
-    return false;
+    return true;
+}
+
+bool bind_map::matches(std::span<const rule::cell> cells, const expr* rhs) {
+    // the template read as in unify, but without binding anything: var
+    // cells match anything, and so does an rhs var against a whole subterm
+    template_stack.clear();
+    template_stack.push_back(rhs);
+
+    for (size_t i = 0; i < cells.size();) {
+        const rule::cell& c = cells[i];
+        const expr* r = deref(template_stack.back());
+        template_stack.pop_back();
+
+        bool rhs_var = std::holds_alternative<expr::var>(r->content);
 
+        // Ground subterms are compared as they are
+        if (c.e->meta.ground) {
+            if (!rhs_var && !matches(c.e, r))
+                return false;
+            ++i;
+            continue;
+        }
+
+        if (std::holds_alternative<expr::var>(c.e->content)) {
+            ++i;
+            continue;
+        }
+
+        if (rhs_var) {
+            i = rule::subterm_end(cells, i);
+            continue;
+        }
+
+        // Otherwise match symbol and arity, then queue the args
+        const expr::functor& f = std::get<expr::functor>(c.e->content);
+        const expr::functor* rf = std::get_if<expr::functor>(&r->content);
+        if (!rf || rf->id != f.id || rf->args.size() != f.args.size())
+            return false;
+        for (size_t k = rf->args.size(); k-- > 0;)
+            template_stack.push_back(rf->args[k]);
+        ++i;
+    }
+
+    return true;
+}
+
+void bind_map::record(std::vector<uint32_t>* sink) {
+    recorder = sink;
 }
 
 bool bind_map::occurs_check(uint32_t index, const expr* key) {
-    key = whnf(key);
+    occurs_stack.clear();
+    occurs_stack.push_back(key);
+
+    while (!occurs_stack.empty()) {
+        const expr* e = occurs_stack.back();
+        occurs_stack.pop_back();
+
+        // Ground terms contain no variables, bound or otherwise
+        if (e->meta.ground)
+            continue;
 
-    if (const expr::var* var = std::get_if<expr::var>(&key->content))
-        return var->index == index;
+        e = whnf(e);
 
-    if (const expr::functor* f = std::get_if<expr::functor>(&key->content)) {
-        for (const expr* arg : f->args)
-            if (occurs_check(index, arg))
+        if (const expr::var* var = std::get_if<expr::var>(&e->content)) {
+            if (var->index == index)
                 return true;
-        return false;
+            continue;
+        }
+
+        if (const expr::functor* f = std::get_if<expr::functor>(&e->content))
+            for (size_t i = f->args.size(); i-- > 0;)
+                occurs_stack.push_back(f->args[i]);
     }
 
     return false;
 }
 
 void bind_map::bind(uint32_t index, const expr* value) {
-    // look up the entry for the index
-    auto it = bindings.find(index);
+    // Get the old value (null when unbound), growing the array to cover the index
+    const expr*& slot = bindings[index];
+    const expr* old_value = slot;
 
-    if (it == bindings.end()) {
-        // if the value is not found, insert it
-        trail_ref.log([this, index]{bindings.erase(index);});
-        it = bindings.insert({index, value}).first;
-    }
-    else {
-        // Get the old value
-        const expr* old_value = it->second;
-        
-        // If the new value is the same as the old value, do nothing
-        if (old_value == value)
-            return;
-
-        // If the new value is different from the old value, insert it
-        trail_ref.log([it, old_value]{it->second = old_value;});
-
-        // Update the value
-        it->second = value;
+    // If the new value is the same as the old value, do nothing
+    if (old_value == value)
+        return;
+
+    // restore the old value (or unbind) when the frame pops
+    if (old_value)
+        trail_ref.log_rebind(*this, index, old_value);
+    else
+        trail_ref.log_unbind(*this, index);
+
+    // only a var bound from unbound changes what the terms containing it mean
+    if (!old_value && recorder)
+        recorder->push_back(index);
+
+    // Update the value
+    slot = value;
+}
+
+void bind_map::unbind(uint32_t index) {
+    std::vector<const expr*>& slots = bindings.slots;
+    slots[index] = nullptr;
+
+    // unbinding the last slot also truncates the array, so rolled-back
+    // var indices leave no tail behind
+    if (index + 1 == slots.size()) {
+        while (!slots.empty() && !slots.back())
+            slots.pop_back();
     }
-    
-    return;
+}
+
+void bind_map::rebind(uint32_t index, const expr* old_value) {
+    bindings.slots[index] = old_value;
 }
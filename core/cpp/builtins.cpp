@@ -0,0 +1,136 @@
+#include <stdexcept>
+#include "../hpp/builtins.hpp"
+
+bool builtins::contains(const expr* e) {
+    return lookup(e).has_value();
+}
+
+const rule& builtins::rule_at(const database& db, size_t idx) {
+    // builtin goals resolve against a bodiless stand-in, so they spawn no children
+    static const rule stand_in{nullptr, {}};
+    if (idx == candidate)
+        return stand_in;
+    return db.at(idx);
+}
+
+builtins::builtins(bind_map& bm, expr_pool& ep) :
+    bm(bm),
+    ep(ep) {
+
+}
+
+bool builtins::ready(const expr* e) {
+    const expr::functor& f = std::get<expr::functor>(e->content);
+    op o = lookup(e).value();
+
+    // a non-integer argument decides the goal (it fails) regardless of the rest
+    for (const expr* arg : f.args)
+        if (bound_non_integer(arg))
+            return true;
+
+    std::optional<int64_t> x = value(f.args[0]);
+    std::optional<int64_t> y = value(f.args[1]);
+
+    switch (o) {
+        case op::add:
+        case op::sub: {
+            std::optional<int64_t> z = value(f.args[2]);
+            return (x && y) || (x && z) || (y && z);
+        }
+        case op::mul: {
+            std::optional<int64_t> z = value(f.args[2]);
+            // a zero factor fixes the product even when the other factor is free
+            return (x && y) || (x && *x == 0) || (y && *y == 0) || (x && z) || (y && z);
+        }
+        default:
+            return x && y;
+    }
+}
+
+bool builtins::evaluate(const expr* e) {
+    const expr::functor& f = std::get<expr::functor>(e->content);
+    op o = lookup(e).value();
+
+    for (const expr* arg : f.args)
+        if (bound_non_integer(arg))
+            return false;
+
+    std::optional<int64_t> x = value(f.args[0]);
+    std::optional<int64_t> y = value(f.args[1]);
+    int64_t r;
+
+    switch (o) {
+        case op::add: {
+            std::optional<int64_t> z = value(f.args[2]);
+            if (x && y)
+                return !__builtin_add_overflow(*x, *y, &r) && bm.unify(f.args[2], ep.integer(r));
+            if (x && z)
+                return !__builtin_sub_overflow(*z, *x, &r) && bm.unify(f.args[1], ep.integer(r));
+            if (y && z)
+                return !__builtin_sub_overflow(*z, *y, &r) && bm.unify(f.args[0], ep.integer(r));
+            break;
+        }
+        case op::sub: {
+            std::optional<int64_t> z = value(f.args[2]);
+            if (x && y)
+                return !__builtin_sub_overflow(*x, *y, &r) && bm.unify(f.args[2], ep.integer(r));
+            if (x && z)
+                return !__builtin_sub_overflow(*x, *z, &r) && bm.unify(f.args[1], ep.integer(r));
+            if (y && z)
+                return !__builtin_add_overflow(*z, *y, &r) && bm.unify(f.args[0], ep.integer(r));
+            break;
+        }
+        case op::mul: {
+            std::optional<int64_t> z = value(f.args[2]);
+            if (x && y)
+                return !__builtin_mul_overflow(*x, *y, &r) && bm.unify(f.args[2], ep.integer(r));
+            if ((x && *x == 0) || (y && *y == 0))
+                return bm.unify(f.args[2], ep.integer(0));
+            // solve for the free factor; it must divide the product exactly
+            if (x && z)
+                return !(*z == INT64_MIN && *x == -1) && *z % *x == 0 && bm.unify(f.args[1], ep.integer(*z / *x));
+            if (y && z)
+                return !(*z == INT64_MIN && *y == -1) && *z % *y == 0 && bm.unify(f.args[0], ep.integer(*z / *y));
+            break;
+        }
+        case op::lt: if (x && y) return *x <  *y; break;
+        case op::le: if (x && y) return *x <= *y; break;
+        case op::gt: if (x && y) return *x >  *y; break;
+        case op::ge: if (x && y) return *x >= *y; break;
+    }
+
+    throw std::logic_error("Builtin evaluated before its inputs were bound");
+}
+
+std::optional<builtins::op> builtins::lookup(const expr* e) {
+    static const uint32_t add_id = symbols().intern("int_add", 3);
+    static const uint32_t sub_id = symbols().intern("int_sub", 3);
+    static const uint32_t mul_id = symbols().intern("int_mul", 3);
+    static const uint32_t lt_id  = symbols().intern("int_lt", 2);
+    static const uint32_t le_id  = symbols().intern("int_le", 2);
+    static const uint32_t gt_id  = symbols().intern("int_gt", 2);
+    static const uint32_t ge_id  = symbols().intern("int_ge", 2);
+
+    const expr::functor* f = std::get_if<expr::functor>(&e->content);
+    if (!f)
+        return std::nullopt;
+
+    if (f->id == add_id) return op::add;
+    if (f->id == sub_id) return op::sub;
+    if (f->id == mul_id) return op::mul;
+    if (f->id == lt_id)  return op::lt;
+    if (f->id == le_id)  return op::le;
+    if (f->id == gt_id)  return op::gt;
+    if (f->id == ge_id)  return op::ge;
+    return std::nullopt;
+}
+
+std::optional<int64_t> builtins::value(const expr* e) {
+    if (const expr::integer* i = std::get_if<expr::integer>(&bm.whnf(e)->content))
+        return i->value;
+    return std::nullopt;
+}
+
+bool builtins::bound_non_integer(const expr* e) {
+    return std::holds_alternative<expr::functor>(bm.whnf(e)->content);
+}
@@ -1,63 +1,128 @@
+#include <algorithm>
+#include <iterator>
 #include "../hpp/candidate_store.hpp"
     
 candidate_store::candidate_store(
     const database& db,
     const goals& goals,
-    lineage_pool& lp) :
+    lineage_pool& lp,
+    const rule_index* shared) :
     frontier<std::vector<size_t>>(db, lp),
     db(db),
-    lp(lp)
+    lp(lp),
+    owned_index(shared ? nullptr : std::make_unique<const rule_index>(db)),
+    ri(shared ? *shared : *owned_index)
 {
-    // make the initial candidates
-    for (int i = 0; i < db.size(); ++i)
-        initial_candidates.push_back(i);
     // make the initial members
-    for (int i = 0; i < goals.size(); ++i)
-        insert(lp.goal(nullptr, i), initial_candidates);
+    for (size_t i = 0; i < goals.size(); ++i) {
+        insert(lp.goal(nullptr, i), ri.seed(goals.at(i)));
+        track(lp.goal(nullptr, i), SIZE_MAX);
+    }
 }
 
 size_t candidate_store::eliminate(const std::function<bool(const goal_lineage*, size_t)>& pred) {
     size_t result = 0;
-    for (auto it = begin(); it != end(); ++it) {
-        const goal_lineage* gl = it->first;
-        std::vector<size_t>& candidates = it->second;
-        for (size_t i = 0; i < candidates.size();) {
-            if (pred(gl, candidates[i])) {
-                candidates[i] = candidates.back();
-                candidates.pop_back();
-                ++result;
-            }
-            else {
-                ++i;
-            }
+    for (auto it = begin(); it != end(); ++it)
+        result += eliminate(it->first, pred);
+    return result;
+}
+
+size_t candidate_store::eliminate(const goal_lineage* gl, const std::function<bool(const goal_lineage*, size_t)>& pred) {
+    size_t result = 0;
+    std::vector<size_t>& candidates = at(gl);
+    for (size_t i = 0; i < candidates.size();) {
+        if (pred(gl, candidates[i])) {
+            candidates[i] = candidates.back();
+            candidates.pop_back();
+            ++result;
+        }
+        else {
+            ++i;
         }
     }
+    if (result > 0)
+        track(gl, candidates.size() + result);
     return result;
 }
 
-bool candidate_store::unit(const goal_lineage*& gl, size_t& candidate) const {
-    for (auto it = begin(); it != end(); ++it) {
-        const goal_lineage* key = it->first;
-        const std::vector<size_t>& candidates = it->second;
-        if (candidates.size() == 1) {
-            gl = key;
-            candidate = candidates.front();
-            return true;
+bool candidate_store::unit(const goal_lineage*& gl, size_t& candidate) {
+    // drop units that were resolved or eliminated down to nothing
+    while (!units.empty() && (!contains(units.front()) || at(units.front()).size() != 1))
+        units.pop_front();
+    if (units.empty())
+        return false;
+    // the unit stays queued until it is resolved
+    gl = units.front();
+    candidate = at(gl).front();
+    return true;
+}
+
+bool candidate_store::conflicted() const {
+    return conflicts > 0;
+}
+
+void candidate_store::index(const goal_lineage* gl, const expr* goal, bind_map& bm) {
+    // only goals of an indexed predicate can be narrowed by their args
+    const expr::functor* f = std::get_if<expr::functor>(&goal->content);
+    if (!f || builtins::contains(goal) || !ri.predicate(f->id))
+        return;
+
+    // take the narrowest selection any bound arg makes
+    rule_index::selection narrowest;
+    bool found = false;
+    for (size_t i = 0; i < f->args.size(); ++i) {
+        rule_index::selection s;
+        if (ri.lookup(f->id, i, bm.whnf(f->args[i]), s) && (!found || s.size() < narrowest.size())) {
+            narrowest = s;
+            found = true;
         }
     }
-    return false;
+
+    // the goal has just been seeded with its predicate's rules, which every
+    // selection of that predicate is a subset of
+    if (!found)
+        return;
+    std::vector<size_t> selected;
+    selected.reserve(narrowest.size());
+    std::merge(narrowest.keyed->begin(), narrowest.keyed->end(),
+               narrowest.unkeyed->begin(), narrowest.unkeyed->end(),
+               std::back_inserter(selected));
+    size_t before = at(gl).size();
+    at(gl) = std::move(selected);
+    track(gl, before);
 }
 
-bool candidate_store::conflicted() const {
-    return std::any_of(
-       begin(),
-        end(),
-        [](const auto& e) { return e.second.size() == 0; });
+void candidate_store::resolve(const resolution_lineage* rl) {
+    // the parent leaves the counts; the unit queue forgets it lazily
+    if (at(rl->parent).empty())
+        --conflicts;
+    frontier<std::vector<size_t>>::resolve(rl);
+    for (size_t i = 0; i < builtins::rule_at(db, rl->idx).body.size(); ++i)
+        track(lp.goal(rl, i), SIZE_MAX);
 }
 
 std::vector<std::vector<size_t>> candidate_store::expand(const std::vector<size_t>& candidates, const rule& r) {
     std::vector<std::vector<size_t>> result;
-    for (int i = 0; i < r.body.size(); ++i)
-        result.push_back(initial_candidates);
+    for (size_t i = 0; i < r.body.size(); ++i)
+        result.push_back(ri.seed(r.body.at(i)));
     return result;
 }
+
+void candidate_store::track(const goal_lineage* gl, size_t before) {
+    // before is SIZE_MAX for a goal just added
+    const std::vector<size_t>& candidates = at(gl);
+    size_t count = candidates.size();
+    if (count == before)
+        return;
+    if (before == 0)
+        --conflicts;
+    if (count == 0)
+        ++conflicts;
+    // builtin goals are evaluated once ready rather than propagated
+    if (count == 1 && !builtin(candidates))
+        units.push_back(gl);
+}
+
+bool candidate_store::builtin(const std::vector<size_t>& candidates) const {
+    return candidates.size() == 1 && candidates.front() == builtins::candidate;
+}
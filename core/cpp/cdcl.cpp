@@ -1,87 +1,249 @@
+#include <algorithm>
 #include "../hpp/cdcl.hpp"
 
 cdcl::cdcl() :
     avoidances(),
+    occurrences(),
+    watches(),
     watched_goals(),
+    taken(),
+    reasons(),
     is_refuted(false),
     eliminated_resolutions(),
-    next_avoidance_id(0) {
+    next_avoidance_id(0),
+    hits(),
+    activity(),
+    deleted(0),
+    pinned(),
+    implied_avoidances(),
+    unimplied_goals(),
+    subsumed(0) {
 
 }
 
-void cdcl::learn(const lemma& l) {
+void cdcl::learn(const lemma& l, bool pin, bool implied) {
     // 1. copy the already-trimmed resolutions into a local avoidance
     avoidance av = l.get_resolutions();
 
-    // 2. get a new id for the avoidance
+    // 2. get a new id for the avoidance; pinned ones come from no conflict
     size_t id = next_avoidance_id++;
+    bool derived = !pin && implied;
 
-    // 3. if the avoidance is empty, we are refuted.
-    //    we should never achieve refutation in upsert() since we should never make
-    //    moves that are eliminated which would lead to refutation.
+    // 3. a stored subset already avoids everything this would, so drop it;
+    //    if this was pinned, the subset now stands in for it and is pinned
+    size_t by = id;
+    if (redundant(av, &by)) {
+        if (pin && avoidances.contains(by))
+            pinned.insert(by);
+        ++subsumed;
+        return;
+    }
+
+    // 4. stored supersets are now redundant; their activity and pins carry
+    //    over, since this fires wherever they would have
+    for (size_t old : supersets(av)) {
+        if (auto it = activity.find(old); it != activity.end())
+            activity[id] = std::max(activity[id], it->second);
+        pin = pin || pinned.contains(old);
+        erase(old);
+        ++subsumed;
+    }
+
+    // 5. if the avoidance is empty, we are refuted.
+    //    we should never achieve refutation in constrain() since we should never
+    //    make moves that are eliminated which would lead to refutation.
     if (av.empty())
         is_refuted = true;
-    
-    // 4. add the avoidance to the store
-    upsert(id, av);
 
-    // 5. get all the goals that are watching this avoidance
-    //    and link the avoidance to the goals
-    for (const resolution_lineage* rl : av)
-        watched_goals[rl->parent].insert(id);
+    // 6. a singleton eliminates its only resolution outright
+    if (av.size() == 1) {
+        eliminated_resolutions.insert(*av.begin());
+        if (!derived)
+            unimplied_goals.insert((*av.begin())->parent);
+    }
+
+    // 7. add the avoidance to the store and index its resolutions
+    const avoidance& stored = avoidances[id] = std::move(av);
+    for (const resolution_lineage* rl : stored)
+        occurrences[rl].insert(id);
+    if (pin)
+        pinned.insert(id);
+    if (derived)
+        implied_avoidances.insert(id);
 
+    // 8. watch its first two resolutions
+    watches[id] = {nullptr, nullptr};
+    size_t slot = 0;
+    for (auto it = stored.begin(); it != stored.end() && slot < 2; ++it)
+        watch(id, slot++, *it);
 }
 
 void cdcl::constrain(const resolution_lineage* rl) {
-    // 1. get the parent goal
+    // 1. get the parent goal and record how it was resolved
     const goal_lineage* gl = rl->parent;
-    
-    // 2. get the set of avoidances that concern this resolution
-    std::set<size_t> ids = watched_goals[gl];
+    taken[gl] = rl;
 
-    // 3. for each avoidance, if the avoidance contains the resolution,
-    //    reduce the avoidance. Else, remove the avoidance from the store.
-    for (size_t id : ids) {
+    // 2. take the set of avoidances watching this goal; the goal is never
+    //    resolved again, so none of them will watch it from here on
+    auto node = watched_goals.extract(gl);
+    if (node.empty())
+        return;
 
-        // 4. get the avoidance
-        avoidance av = avoidances.at(id);
+    // 3. visit each avoidance that is still live
+    for (size_t id : node.mapped()) {
+        auto av = avoidances.find(id);
+        if (av == avoidances.end())
+            continue;
 
-        // 5. reduce the avoidance
-        size_t erased = av.erase(rl);
+        // 4. find which of its watches this goal was
+        std::array<const resolution_lineage*, 2>& w = watches.at(id);
+        size_t slot = w[0]->parent == gl ? 0 : 1;
+        const resolution_lineage* other = w[1 - slot];
 
-        // 6a. if the resolution was found, then it is consistent
-        if (erased > 0)
-            upsert(id, av);
+        // 5a. the goal was resolved some other way, so the avoidance can
+        //     never be completed
+        if (w[slot] != rl) {
+            erase(id);
+            continue;
+        }
+
+        // 5b. look for another resolution not yet taken to watch instead
+        const resolution_lineage* replacement = nullptr;
+        bool satisfied = false;
+        for (const resolution_lineage* candidate : av->second) {
+            if (candidate == w[slot] || candidate == other)
+                continue;
+            auto t = taken.find(candidate->parent);
+            if (t == taken.end()) {
+                replacement = candidate;
+                break;
+            }
+            if (t->second != candidate) {
+                satisfied = true;
+                break;
+            }
+        }
 
-        // 6b. if the resolution was not found, then it is conflicting
-        else
+        if (satisfied) {
             erase(id);
-    }
+            continue;
+        }
 
-    // 7. Remove the parent goal from the watched goals
-    watched_goals.erase(gl);
-}
+        // 6a. move the watch to the replacement
+        if (replacement) {
+            watch(id, slot, replacement);
+            continue;
+        }
 
-void cdcl::upsert(size_t id, const avoidance& av) {
-    // 1. update the avoidance in the store
-    avoidances[id] = av;
+        // 6b. every other resolution has been taken, so the remaining
+        //     watch must not be, unless its goal already went another way
+        if (!other)
+            continue;
+        auto t = taken.find(other->parent);
+        if (t == taken.end()) {
+            eliminated_resolutions.insert(other);
+            if (!implied_avoidances.contains(id))
+                unimplied_goals.insert(other->parent);
+            ++hits[id];
+            std::vector<const resolution_lineage*>& because = reasons[other->parent];
+            for (const resolution_lineage* r : av->second)
+                if (r != other)
+                    because.push_back(r);
+        }
+        else if (t->second != other)
+            erase(id);
+    }
+}
 
-    // 2. if the avoidance is singleton, we have eliminated something.
-    if (av.size() == 1)
-        eliminated_resolutions.insert(*av.begin());
+void cdcl::watch(size_t id, size_t slot, const resolution_lineage* rl) {
+    // 1. point the watch at the resolution, and link the avoidance to its goal
+    watches.at(id)[slot] = rl;
+    watched_goals[rl->parent].insert(id);
 }
 
 void cdcl::erase(size_t id) {
-    // 1. get the avoidance
-    const avoidance& av = avoidances.at(id);
-
-    // 2. for each goal that is watching this avoidance,
-    //    unlink the avoidance from the goal
-    for (const resolution_lineage* rl : av)
-        watched_goals[rl->parent].erase(id);
-    
+    // 1. unlink the avoidance from the goals it watches
+    if (auto w = watches.find(id); w != watches.end()) {
+        for (const resolution_lineage* rl : w->second) {
+            if (!rl)
+                continue;
+            if (auto it = watched_goals.find(rl->parent); it != watched_goals.end())
+                it->second.erase(id);
+        }
+        watches.erase(w);
+    }
+
+    // 2. drop it from the occurrence index
+    if (auto av = avoidances.find(id); av != avoidances.end()) {
+        for (const resolution_lineage* rl : av->second) {
+            auto it = occurrences.find(rl);
+            it->second.erase(id);
+            if (it->second.empty())
+                occurrences.erase(it);
+        }
+    }
+
     // 3. remove the avoidance from the store
     avoidances.erase(id);
+    activity.erase(id);
+    pinned.erase(id);
+    implied_avoidances.erase(id);
+}
+
+bool cdcl::redundant(const avoidance& av, size_t* by) const {
+    // 1. the empty avoidance, once learned, is a subset of everything
+    if (is_refuted)
+        return true;
+
+    // 2. count how many of each stored avoidance's resolutions av shares;
+    //    only avoidances sharing one are ever visited
+    std::map<size_t, size_t> shared;
+    for (const resolution_lineage* rl : av) {
+        auto it = occurrences.find(rl);
+        if (it == occurrences.end())
+            continue;
+        for (size_t id : it->second) {
+            if (++shared[id] == avoidances.at(id).size()) {
+                if (by)
+                    *by = id;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+std::vector<size_t> cdcl::supersets(const avoidance& av) const {
+    std::vector<size_t> result;
+
+    // 1. every stored avoidance contains the empty one
+    if (av.empty()) {
+        for (const auto& [id, stored] : avoidances)
+            result.push_back(id);
+        return result;
+    }
+
+    // 2. a superset must contain av's rarest resolution, so only the
+    //    avoidances it occurs in are candidates
+    const std::set<size_t>* rarest = nullptr;
+    for (const resolution_lineage* rl : av) {
+        auto it = occurrences.find(rl);
+        if (it == occurrences.end())
+            return result;
+        if (!rarest || it->second.size() < rarest->size())
+            rarest = &it->second;
+    }
+
+    // 3. keep the candidates containing the rest of av
+    for (size_t id : *rarest) {
+        const avoidance& stored = avoidances.at(id);
+        if (stored.size() >= av.size() &&
+            std::all_of(av.begin(), av.end(), [&](const resolution_lineage* rl) { return stored.contains(rl); }))
+            result.push_back(id);
+    }
+
+    return result;
 }
 
 bool cdcl::refuted() const {
@@ -91,3 +253,81 @@ bool cdcl::refuted() const {
 bool cdcl::eliminated(const resolution_lineage* rl) const {
     return eliminated_resolutions.contains(rl);
 }
+
+bool cdcl::implied(size_t id) const {
+    return implied_avoidances.contains(id);
+}
+
+bool cdcl::explain(const goal_lineage* gl, std::vector<const resolution_lineage*>& result) const {
+    // 1. append the resolutions whose taking eliminated the goal's candidates;
+    //    eliminations learned outright have no reason to give
+    if (auto it = reasons.find(gl); it != reasons.end())
+        result.insert(result.end(), it->second.begin(), it->second.end());
+
+    // 2. say whether those eliminations all rest on implied avoidances
+    return !unimplied_goals.contains(gl);
+}
+
+void cdcl::credit(const cdcl& used) {
+    // 1. add the eliminations a sim's copy caused to the avoidances still here
+    for (const auto& [id, count] : used.hits)
+        if (avoidances.contains(id))
+            activity[id] += count;
+}
+
+size_t cdcl::reduce(size_t target) {
+    // 1. only conflict lemmas are deleted: the program and the pinned
+    //    avoidances imply them, so losing one costs pruning and iterations,
+    //    never a solution. pinned avoidances are kept, and so are those of
+    //    two resolutions or fewer, which are cheap to watch, and the newest,
+    //    which have not had a chance to fire.
+    size_t recent = next_avoidance_id - std::min(next_avoidance_id, target / 2);
+    std::vector<size_t> deletable;
+    for (const auto& [id, av] : avoidances)
+        if (av.size() > 2 && id < recent && !pinned.contains(id))
+            deletable.push_back(id);
+
+    // 2. delete the least active first; among equals, the longest, then the oldest
+    auto score = [this](size_t id) {
+        auto it = activity.find(id);
+        return it == activity.end() ? 0.0 : it->second;
+    };
+    std::sort(deletable.begin(), deletable.end(), [&](size_t a, size_t b) {
+        if (score(a) != score(b))
+            return score(a) < score(b);
+        if (avoidances.at(a).size() != avoidances.at(b).size())
+            return avoidances.at(a).size() > avoidances.at(b).size();
+        return a < b;
+    });
+
+    size_t result = 0;
+    for (size_t id : deletable) {
+        if (avoidances.size() <= target)
+            break;
+        erase(id);
+        ++result;
+    }
+    deleted += result;
+
+    // 3. decay the survivors' activity, so recent eliminations count for more
+    for (auto& [id, a] : activity)
+        a /= 2;
+
+    return result;
+}
+
+size_t cdcl::get_kept() const {
+    return avoidances.size();
+}
+
+size_t cdcl::get_deleted() const {
+    return deleted;
+}
+
+size_t cdcl::get_subsumed() const {
+    return subsumed;
+}
+
+const std::map<size_t, avoidance>& cdcl::get_avoidances() const {
+    return avoidances;
+}
@@ -1,4 +1,3 @@
-#include <stdexcept>
 #include "../hpp/copier.hpp"
 
 copier::copier(sequencer& sequencer_ref, expr_pool& expr_pool_ref)
@@ -6,28 +5,41 @@ copier::copier(sequencer& sequencer_ref, expr_pool& expr_pool_ref)
 
 }
 
-const expr* copier::operator()(const expr* e, std::map<uint32_t, uint32_t>& variable_map) {
-    // If the expression is a variable
-    if (const expr::var* v = std::get_if<expr::var>(&e->content)) {
-        // See if the variable has already been copied
-        auto it = variable_map.find(v->index);
-        
-        // If the variable does not have a mapping, create one
-        if (it == variable_map.end())
-            it = variable_map.insert({v->index, sequencer_ref()}).first;
+const expr* copier::operator()(std::span<const rule::cell> cells, uint32_t base) {
+    pending.clear();
+    built.clear();
 
-        // Return the mapped variable
-        return expr_pool_ref.var(it->second);
-    }
+    // Replay the compiled term: slots are offset into the reserved block
+    for (const rule::cell& c : cells) {
+        const expr* leaf;
+        if (c.e->meta.ground)
+            leaf = c.e;
+        else if (std::holds_alternative<expr::var>(c.e->content))
+            leaf = expr_pool_ref.var(base + c.slot);
+        else {
+            // A functor waits for its args, which are the cells that follow
+            pending.emplace_back(c.e, built.size());
+            continue;
+        }
+        built.push_back(leaf);
 
-    // If the expression is a functor, copy all args recursively
-    if (const expr::functor* f = std::get_if<expr::functor>(&e->content)) {
-        std::vector<const expr*> copied_args;
-        copied_args.reserve(f->args.size());
-        for (const expr* arg : f->args)
-            copied_args.push_back(operator()(arg, variable_map));
-        return expr_pool_ref.functor(f->name, std::move(copied_args));
+        // Rebuild every functor whose last arg this leaf completed
+        while (!pending.empty()) {
+            auto [e, first] = pending.back();
+            const expr::functor& f = std::get<expr::functor>(e->content);
+            if (built.size() - first < f.args.size())
+                break;
+            std::vector<const expr*> copied_args(built.begin() + first, built.end());
+            built.resize(first);
+            built.push_back(expr_pool_ref.functor(f.id, std::move(copied_args)));
+            pending.pop_back();
+        }
     }
 
-    throw std::runtime_error("Unsupported expression type");
-}
\ No newline at end of file
+    return built.back();
+}
+
+uint32_t copier::reserve(uint32_t count) {
+    // one block of fresh indices for a whole template's slots
+    return sequencer_ref.reserve(count);
+}
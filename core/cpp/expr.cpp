@@ -1,41 +1,208 @@
 #include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <new>
 #include "../hpp/expr.hpp"
 
-expr_pool::expr_pool(trail& t) : trail_ref(t) {
+bool expr::functor::operator==(const functor& other) const {
+    return id == other.id && std::ranges::equal(args, other.args);
+}
+
+std::strong_ordering expr::functor::operator<=>(const functor& other) const {
+    if (auto cmp = id <=> other.id; cmp != 0)
+        return cmp;
+    return std::lexicographical_compare_three_way(
+        args.begin(), args.end(),
+        other.args.begin(), other.args.end());
+}
+
+bool expr::operator==(const expr& other) const {
+    // metadata is derived from content, so it takes no part in identity
+    return content == other.content;
+}
+
+std::strong_ordering expr::operator<=>(const expr& other) const {
+    return content <=> other.content;
+}
+
+expr_pool::expr_pool(trail& t, const expr_pool* base) :
+    trail_ref(t),
+    base(base),
+    is_frozen(false),
+    nodes_arena(),
+    nodes(),
+    exprs(),
+    logged_depth(std::numeric_limits<size_t>::max()) {
 
 }
 
 const expr* expr_pool::functor(const std::string& name, std::vector<const expr*> args) {
-    return intern(expr{expr::functor{name, std::move(args)}});
+    uint32_t id = symbols().intern(name, args.size());
+    return functor(id, std::move(args));
+}
+
+const expr* expr_pool::functor(uint32_t id, std::vector<const expr*> args) {
+    // the probe borrows the caller's args; intern copies them inline on insert
+    return intern(expr{expr::functor{id, args}});
 }
 
 const expr* expr_pool::var(uint32_t i) {
     return intern(expr{expr::var{i}});
 }
 
+const expr* expr_pool::integer(int64_t value) {
+    return intern(expr{expr::integer{value}});
+}
+
 const expr* expr_pool::import(const expr* e) {
-    // if the expression is a var, just intern it
-    if (std::holds_alternative<expr::var>(e->content))
-        return intern(expr{e->content});
-
-    // if the expression is a functor, recursively import all args then rebuild
-    if (const expr::functor* f = std::get_if<expr::functor>(&e->content)) {
-        std::vector<const expr*> imported_args;
-        imported_args.reserve(f->args.size());
-        for (const expr* arg : f->args)
-            imported_args.push_back(import(arg));
-        return functor(f->name, std::move(imported_args));
+    // terms owned by the frozen base are shared as they are
+    if (base && base->find(*e) == e)
+        return e;
+
+    // if the expression is a var or an integer, just intern it
+    if (!std::holds_alternative<expr::functor>(e->content))
+        return intern(*e);
+
+    pending.clear();
+    built.clear();
+    pending.emplace_back(e, 0);
+
+    while (!pending.empty()) {
+        auto& [current, next] = pending.back();
+        const expr::functor& f = std::get<expr::functor>(current->content);
+
+        // Descend into the next arg
+        if (next < f.args.size()) {
+            const expr* arg = f.args[next++];
+            if (base && base->find(*arg) == arg)
+                built.push_back(arg);
+            else if (!std::holds_alternative<expr::functor>(arg->content))
+                built.push_back(intern(*arg));
+            else
+                pending.emplace_back(arg, 0);
+            continue;
+        }
+
+        // All args are imported: rebuild the functor over the last arity entries
+        std::vector<const expr*> imported_args(built.end() - f.args.size(), built.end());
+        built.resize(built.size() - f.args.size());
+        built.push_back(functor(f.id, std::move(imported_args)));
+        pending.pop_back();
     }
 
-    throw std::runtime_error("Unsupported expression type");
+    return built.back();
+}
+
+void expr_pool::freeze() {
+    is_frozen = true;
+}
+
+bool expr_pool::frozen() const {
+    return is_frozen;
 }
 
 size_t expr_pool::size() const {
-    return exprs.size();
+    // counts this layer only, not the base beneath it
+    return nodes.size();
+}
+
+const expr* expr_pool::find(const expr& probe) const {
+    auto it = exprs.find(&probe);
+    if (it != exprs.end())
+        return *it;
+    return base ? base->find(probe) : nullptr;
+}
+
+const expr* expr_pool::intern(const expr& probe) {
+    // hash-cons: return the existing node if an equal one was interned already
+    if (const expr* existing = find(probe))
+        return existing;
+
+    if (is_frozen)
+        throw std::logic_error("Cannot intern into a frozen expr_pool");
+
+    // log one watermark per trail frame instead of one undo per node
+    if (logged_depth != trail_ref.depth()) {
+        trail_ref.log_truncate(*this, nodes.size(), logged_depth);
+        logged_depth = trail_ref.depth();
+    }
+
+    // lay the node out as one block: the expr header followed by its args
+    const expr::functor* f = std::get_if<expr::functor>(&probe.content);
+    size_t arity = f ? f->args.size() : 0;
+    void* block = nodes_arena.allocate(sizeof(expr) + arity * sizeof(const expr*), alignof(expr));
+    expr* node = new (block) expr(probe);
+    if (f) {
+        const expr** inline_args = reinterpret_cast<const expr**>(node + 1);
+        std::copy(f->args.begin(), f->args.end(), inline_args);
+        std::get<expr::functor>(node->content).args = std::span<const expr* const>(inline_args, arity);
+    }
+    annotate(*node);
+
+    nodes.push_back(node);
+    exprs.insert(node);
+    return node;
+}
+
+void expr_pool::annotate(expr& e) {
+    // vars are the only non-ground leaves; integers and atoms are ground
+    const expr::functor* f = std::get_if<expr::functor>(&e.content);
+    if (!f) {
+        e.meta.ground = !std::holds_alternative<expr::var>(e.content);
+        return;
+    }
+
+    // a functor is ground when all its (already annotated) args are
+    e.meta.ground = std::all_of(f->args.begin(), f->args.end(),
+        [](const expr* arg) { return arg->meta.ground; });
+}
+
+void expr_pool::truncate(size_t watermark) {
+    // frozen nodes may be shared by overlays, so popping frames no longer reclaims them
+    if (is_frozen || watermark >= nodes.size())
+        return;
+
+    // unindex the discarded nodes, then hand their memory back to the arena
+    for (size_t i = watermark; i < nodes.size(); ++i)
+        exprs.erase(nodes[i]);
+    nodes_arena.rewind(nodes[watermark]);
+    nodes.resize(watermark);
 }
 
-const expr* expr_pool::intern(expr&& e) {
-    auto [it, inserted] = exprs.insert(std::move(e));
-    if (inserted) trail_ref.log([this, it]() { exprs.erase(it); });
-    return &*it;
+void expr_pool::rollback(size_t watermark, size_t previous_depth) {
+    truncate(watermark);
+    logged_depth = previous_depth;
+}
+
+size_t expr_pool::deref_hash::operator()(const expr* e) const {
+    return std::hash<expr>{}(*e);
+}
+
+bool expr_pool::deref_equal::operator()(const expr* lhs, const expr* rhs) const {
+    return *lhs == *rhs;
+}
+
+size_t std::hash<expr>::operator()(const expr& e) const {
+    // mix the variant tag in first so functors and vars never share a seed
+    size_t seed = e.content.index();
+
+    auto combine = [&seed](size_t h) {
+        seed ^= h + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    };
+
+    if (const expr::var* v = std::get_if<expr::var>(&e.content)) {
+        combine(std::hash<uint32_t>{}(v->index));
+        return seed;
+    }
+
+    if (const expr::integer* i = std::get_if<expr::integer>(&e.content)) {
+        combine(std::hash<int64_t>{}(i->value));
+        return seed;
+    }
+
+    const expr::functor& f = std::get<expr::functor>(e.content);
+    combine(std::hash<uint32_t>{}(f.id));
+    for (const expr* arg : f.args)
+        combine(std::hash<const expr*>{}(arg));
+    return seed;
 }
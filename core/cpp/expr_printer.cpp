@@ -5,6 +5,10 @@ expr_printer::expr_printer(std::ostream& os, const std::map<uint32_t, std::strin
 {}
 
 void expr_printer::operator()(const expr* e) const {
+    // list sugar is recognised by symbol id; names are only looked up for output
+    static const uint32_t nil_id = symbols().intern("nil", 0);
+    static const uint32_t cons_id = symbols().intern("cons", 2);
+
     if (const expr::var* v = std::get_if<expr::var>(&e->content)) {
         auto it = var_names.find(v->index);
         if (it != var_names.end())
@@ -17,25 +21,25 @@ void expr_printer::operator()(const expr* e) const {
     if (const expr::functor* f = std::get_if<expr::functor>(&e->content)) {
         // Nullary functor (atom-like)
         if (f->args.empty()) {
-            if (f->name == "nil")
+            if (f->id == nil_id)
                 os << "[]";
             else
-                os << f->name;
+                os << symbols().name(f->id);
             return;
         }
 
         // List spine: cons(head, tail)
-        if (f->name == "cons" && f->args.size() == 2) {
+        if (f->id == cons_id) {
             os << "[";
             operator()(f->args[0]);
             const expr* tail = f->args[1];
             while (true) {
                 const expr::functor* tf = std::get_if<expr::functor>(&tail->content);
-                if (tf && tf->name == "nil" && tf->args.empty()) {
+                if (tf && tf->id == nil_id) {
                     os << "]";
                     break;
                 }
-                if (tf && tf->name == "cons" && tf->args.size() == 2) {
+                if (tf && tf->id == cons_id) {
                     os << ", ";
                     operator()(tf->args[0]);
                     tail = tf->args[1];
@@ -50,7 +54,7 @@ void expr_printer::operator()(const expr* e) const {
         }
 
         // General functor: name(arg1, arg2, ...)
-        os << f->name << "(";
+        os << symbols().name(f->id) << "(";
         for (size_t i = 0; i < f->args.size(); ++i) {
             if (i > 0) os << ", ";
             operator()(f->args[i]);
@@ -59,5 +63,10 @@ void expr_printer::operator()(const expr* e) const {
         return;
     }
 
+    if (const expr::integer* i = std::get_if<expr::integer>(&e->content)) {
+        os << i->value;
+        return;
+    }
+
     throw std::runtime_error("Unsupported expression type");
 }
@@ -7,6 +7,7 @@ goal_store::goal_store(
     trail& t,
     copier& cp,
     bind_map& bm,
+    builtins& bi,
     lineage_pool& lp)
     :
     frontier<const expr*>(db, lp),
@@ -14,30 +15,45 @@ goal_store::goal_store(
     t(t),
     cp(cp),
     bm(bm),
-    lp(lp)
+    bi(bi),
+    lp(lp),
+    prefiltered(0)
 {
     // add the goals to the frontier
     for (int i = 0; i < goals.size(); ++i)
         insert(lp.goal(nullptr, i), goals.at(i));
 }
 
-bool goal_store::try_unify_head(const expr* const& e, const rule& r, std::map<uint32_t, uint32_t>& translation_map) {
-    // copy the head of the rule
-    const expr* copied_head = cp(r.head, translation_map);
+bool goal_store::try_unify_head(const expr* const& e, const rule& r, uint32_t& base) {
+    // rename every var of the rule with one block reservation
+    base = cp.reserve(r.vars.size());
 
-    // unify the head with the goal
-    return bm.unify(copied_head, e);
+    // unify the goal against the head template in place, without copying it;
+    // linear vars skip their occurs checks
+    return bm.unify(r.head_template, base, e, r.linear, cp);
 }
 
 bool goal_store::applicable(const expr* const& e, const rule& r) {
+    // reject obvious head mismatches before paying for a frame and a block
+    if (!builtins::contains(e) && !bm.matches(r.head_template, e)) {
+        ++prefiltered;
+        return false;
+    }
+
     // push a temporary frame since bindings must be temporary
     t.push();
 
-    // create the translation map for copying the rule
-    std::map<uint32_t, uint32_t> translation_map;
+    bool applicable;
 
-    // try to unify the head with the goal
-    bool applicable = try_unify_head(e, r, translation_map);
+    if (builtins::contains(e)) {
+        // a builtin stays applicable until its bound arguments refute it
+        applicable = !bi.ready(e) || bi.evaluate(e);
+    }
+    else {
+        // try to unify the head with the goal
+        uint32_t base;
+        applicable = try_unify_head(e, r, base);
+    }
 
     // pop the temporary frame
     t.pop();
@@ -47,17 +63,26 @@ bool goal_store::applicable(const expr* const& e, const rule& r) {
 }
 
 std::vector<const expr*> goal_store::expand(const expr* const& e, const rule& r) {
-    // create the translation map for copying the rule
-    std::map<uint32_t, uint32_t> translation_map;
+    // builtins bind their outputs in place and leave no subgoals
+    if (builtins::contains(e)) {
+        if (!bi.evaluate(e))
+            throw std::runtime_error("Failed to evaluate the builtin goal");
+        return {};
+    }
 
     // try to unify the head with the goal
-    if (!try_unify_head(e, r, translation_map))
+    uint32_t base;
+    if (!try_unify_head(e, r, base))
         throw std::runtime_error("Failed to unify the head with the goal");
 
-    // copy the body of the rule
+    // instantiate the body templates over the block the head reserved
     std::vector<const expr*> copied_body;
-    for (const expr* e : r.body)
-        copied_body.push_back(cp(e, translation_map));
+    for (const std::vector<rule::cell>& cells : r.body_template)
+        copied_body.push_back(cp(cells, base));
 
     return copied_body;
 }
+
+size_t goal_store::get_prefiltered() const {
+    return prefiltered;
+}
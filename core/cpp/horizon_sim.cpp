@@ -12,6 +12,8 @@ double horizon_sim::reward() {
 
 const resolution_lineage* horizon_sim::decide_one() {
     auto [chosen_goal, chosen_candidate] = dec();
+    if (!chosen_goal)
+        return nullptr;
     return lp.resolution(chosen_goal, chosen_candidate);
 }
 
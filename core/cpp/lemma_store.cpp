@@ -0,0 +1,214 @@
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include "../hpp/lemma_store.hpp"
+#include "../hpp/lemma.hpp"
+#include "../hpp/symbol_table.hpp"
+
+lemma_store::lemma_store(const std::string& path) :
+    path(path) {
+
+}
+
+uint64_t lemma_store::fingerprint(const database& db, const goals& gl) {
+    // FNV-1a over a canonical walk: symbols by name, since ids depend on
+    // the order they were interned in, and vars by first occurrence
+    uint64_t h = 14695981039346656037ull;
+
+    // 1. the rules in order, each with vars of its own
+    mix(h, db.size());
+    for (const rule& r : db) {
+        std::map<uint32_t, uint64_t> vars;
+        mix(h, r.body.size());
+        mix(h, r.head, vars);
+        for (const expr* e : r.body)
+            mix(h, e, vars);
+    }
+
+    // 2. the goals, which share their vars
+    std::map<uint32_t, uint64_t> vars;
+    mix(h, gl.size());
+    for (const expr* e : gl)
+        mix(h, e, vars);
+
+    return h;
+}
+
+size_t lemma_store::load(uint64_t key, cdcl& c, lineage_pool& lp) const {
+    // 1. with no file yet, there is nothing to load
+    if (path.empty())
+        return 0;
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return 0;
+
+    // 2. files from another version, for other inputs, or that are no lemma
+    //    file at all, are ignored, and replaced by the next save
+    char header[sizeof(magic)];
+    in.read(header, sizeof(magic));
+    if (!in || !std::equal(header, header + sizeof(magic), magic))
+        return 0;
+    uint64_t file_version;
+    uint64_t file_key;
+    if (!get(in, file_version) || file_version != version || !get(in, file_key) || file_key != key)
+        return 0;
+
+    // 3. read the whole file before touching the pool or the avoidances, so
+    //    one that is truncated or malformed, or refers to a lineage it never
+    //    wrote, leaves both as they were
+    std::vector<std::array<uint64_t, 3>> entries;
+    uint64_t n;
+    if (!get(in, n))
+        return 0;
+    for (; n > 0; --n) {
+        std::array<uint64_t, 3>& e = entries.emplace_back();
+        if (!get(in, e[0]) || !get(in, e[1]) || !get(in, e[2]) || e[0] >= entries.size())
+            return 0;
+    }
+    std::vector<std::vector<uint64_t>> avoidances;
+    if (!get(in, n))
+        return 0;
+    for (; n > 0; --n) {
+        std::vector<uint64_t>& ids = avoidances.emplace_back();
+        uint64_t k;
+        if (!get(in, k))
+            return 0;
+        for (; k > 0; --k) {
+            uint64_t id;
+            if (!get(in, id) || id >= entries.size())
+                return 0;
+            ids.push_back(id);
+        }
+    }
+
+    // 4. rebuild the lineages, parents first, and pin them so trims keep them
+    std::vector<const resolution_lineage*> lineages;
+    for (const auto& [parent, goal_idx, rule_idx] : entries) {
+        const goal_lineage* gl = lp.goal(parent ? lineages[parent - 1] : nullptr, goal_idx);
+        const resolution_lineage* rl = lp.resolution(gl, rule_idx);
+        lp.pin(rl);
+        lineages.push_back(rl);
+    }
+
+    // 5. learn the avoidances again, which restores their watches,
+    //    eliminations and any refutation
+    for (const std::vector<uint64_t>& ids : avoidances) {
+        resolutions rs;
+        for (uint64_t id : ids)
+            rs.insert(lineages[id]);
+        c.learn(lemma(rs));
+    }
+
+    return avoidances.size();
+}
+
+void lemma_store::save(uint64_t key, const cdcl& c) const {
+    if (path.empty())
+        return;
+
+    // 1. number the lineages the avoidances use, writing each the first time
+    //    it is met, after its ancestors. only conflict lemmas are written: the
+    //    others block solutions or budgets of this run, not of the next.
+    std::map<const resolution_lineage*, size_t> numbers;
+    std::ostringstream lineages;
+    std::ostringstream avoidances;
+    size_t count = 0;
+    for (const auto& [id, av] : c.get_avoidances()) {
+        if (!c.implied(id))
+            continue;
+        put(avoidances, av.size());
+        for (const resolution_lineage* rl : av)
+            put(avoidances, number(rl, numbers, lineages));
+        ++count;
+    }
+
+    // 2. write a temporary file and move it into place, so an interrupted
+    //    save never leaves a torn file behind
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(magic, sizeof(magic));
+        put(out, version);
+        put(out, key);
+        put(out, numbers.size());
+        out << lineages.str();
+        put(out, count);
+        out << avoidances.str();
+        if (!out)
+            throw std::runtime_error("Failed to write the lemma file");
+    }
+    std::filesystem::rename(temporary, path);
+}
+
+void lemma_store::mix(uint64_t& h, uint64_t word) {
+    for (size_t i = 0; i < sizeof(word); ++i) {
+        h ^= (word >> (8 * i)) & 0xff;
+        h *= 1099511628211ull;
+    }
+}
+
+void lemma_store::mix(uint64_t& h, const expr* e, std::map<uint32_t, uint64_t>& vars) {
+    if (const expr::var* v = std::get_if<expr::var>(&e->content)) {
+        mix(h, 0);
+        mix(h, vars.insert({v->index, vars.size()}).first->second);
+        return;
+    }
+
+    if (const expr::integer* i = std::get_if<expr::integer>(&e->content)) {
+        mix(h, 1);
+        mix(h, static_cast<uint64_t>(i->value));
+        return;
+    }
+
+    const expr::functor& f = std::get<expr::functor>(e->content);
+    const std::string& name = symbols().name(f.id);
+    mix(h, 2);
+    mix(h, name.size());
+    for (char ch : name)
+        mix(h, static_cast<unsigned char>(ch));
+    mix(h, f.args.size());
+    for (const expr* arg : f.args)
+        mix(h, arg, vars);
+}
+
+void lemma_store::put(std::ostream& out, uint64_t value) {
+    // LEB128: seven bits a byte, low first, the high bit set on all but the last
+    while (value >= 0x80) {
+        out.put(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+bool lemma_store::get(std::istream& in, uint64_t& result) {
+    // false if the stream ends mid-value, or the value runs past 64 bits
+    result = 0;
+    for (size_t shift = 0; shift < 64; shift += 7) {
+        int byte = in.get();
+        if (byte == std::char_traits<char>::eof())
+            return false;
+        result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+size_t lemma_store::number(const resolution_lineage* rl, std::map<const resolution_lineage*, size_t>& numbers, std::ostream& out) {
+    if (auto it = numbers.find(rl); it != numbers.end())
+        return it->second;
+
+    // 1. a resolution is written as its parent resolution's number plus one
+    //    (zero at the root), its goal's index, and its rule's index
+    const goal_lineage* gl = rl->parent;
+    uint64_t parent = gl->parent ? number(gl->parent, numbers, out) + 1 : 0;
+    size_t result = numbers.size();
+    numbers[rl] = result;
+    put(out, parent);
+    put(out, gl->idx);
+    put(out, rl->idx);
+    return result;
+}
@@ -9,6 +9,8 @@ mcts_decider::mcts_decider(
 
 std::pair<const goal_lineage*, size_t> mcts_decider::operator()() {
     const goal_lineage* chosen_gl = choose_goal();
+    if (!chosen_gl)
+        return std::make_pair(nullptr, 0);
     const size_t chosen_i = choose_candidate(chosen_gl);
     return std::make_pair(chosen_gl, chosen_i);
 }
@@ -18,9 +20,16 @@ const goal_lineage* mcts_decider::choose_goal() {
     std::vector<choice> goals;
     goals.reserve(cs.size());
 
-    // Convert the goals to choices
-    for (auto it = cs.begin(); it != cs.end(); ++it)
-        goals.push_back(it->first);
+    // Convert the goals to choices, leaving out builtins since they are never decided
+    for (auto it = cs.begin(); it != cs.end(); ++it) {
+        const std::vector<size_t>& candidates = it->second;
+        if (candidates.size() != 1 || candidates.front() != builtins::candidate)
+            goals.push_back(it->first);
+    }
+
+    // Every remaining goal is a builtin waiting on its inputs
+    if (goals.empty())
+        return nullptr;
 
     // Choose a goal to resolve
     const choice choice_a = sim.choose(goals);
@@ -9,20 +9,44 @@ normalizer::normalizer(expr_pool& expr_pool_ref, bind_map& bind_map_ref)
 const expr* normalizer::operator()(const expr* e) {
     // First, get the whnf
     e = bind_map_ref.whnf(e);
-    
+
     // If the expression is a variable, return it unchanged since it is already normalized
     if (std::holds_alternative<expr::var>(e->content))
         return e;
 
-    // If the expression is a functor, normalize all args recursively
-    if (const expr::functor* f = std::get_if<expr::functor>(&e->content)) {
-        std::vector<const expr*> normalized_args;
-        normalized_args.reserve(f->args.size());
-        for (const expr* arg : f->args)
-            normalized_args.push_back(operator()(arg));
-        return expr_pool_ref.functor(f->name, std::move(normalized_args));
+    // If the expression is an integer, it is already normalized
+    if (const expr::integer* i = std::get_if<expr::integer>(&e->content))
+        return expr_pool_ref.integer(i->value);
+
+    if (!std::holds_alternative<expr::functor>(e->content))
+        throw std::runtime_error("Unsupported expression type");
+
+    pending.clear();
+    built.clear();
+    pending.emplace_back(e, 0);
+
+    while (!pending.empty()) {
+        auto& [current, next] = pending.back();
+        const expr::functor& f = std::get<expr::functor>(current->content);
+
+        // Descend into the whnf of the next arg
+        if (next < f.args.size()) {
+            const expr* arg = bind_map_ref.whnf(f.args[next++]);
+            if (std::holds_alternative<expr::var>(arg->content))
+                built.push_back(arg);
+            else if (const expr::integer* i = std::get_if<expr::integer>(&arg->content))
+                built.push_back(expr_pool_ref.integer(i->value));
+            else
+                pending.emplace_back(arg, 0);
+            continue;
+        }
+
+        // All args are normalized: they are the last arity entries of the built stack
+        std::vector<const expr*> normalized_args(built.end() - f.args.size(), built.end());
+        built.resize(built.size() - f.args.size());
+        built.push_back(expr_pool_ref.functor(f.id, std::move(normalized_args)));
+        pending.pop_back();
     }
 
-    throw std::runtime_error("Unsupported expression type");
-    
+    return built.back();
 }
@@ -12,7 +12,7 @@ ridge::ridge(solver_args sa, mcts_solver_args ma) :
 std::unique_ptr<sim> ridge::construct_sim() {
     mc_sim.emplace(root, exploration_constant, rng);
     return std::make_unique<ridge_sim>(
-        sim_args{max_resolutions, db, gl, t, vars, ep, bm, lp, c},
+        sim_args{max_resolutions, db, gl, t, vars, ep, bm, lp, c, &ac, &ri},
         mcts_sim_args{*mc_sim}
     );
 }
@@ -7,6 +7,8 @@ ridge_sim::ridge_sim(sim_args sa, mcts_sim_args ma) :
 
 const resolution_lineage* ridge_sim::decide_one() {
     auto [chosen_goal, chosen_candidate] = dec();
+    if (!chosen_goal)
+        return nullptr;
     return lp.resolution(chosen_goal, chosen_candidate);
 }
 
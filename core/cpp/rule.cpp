@@ -0,0 +1,69 @@
+#include <map>
+#include "../hpp/rule.hpp"
+
+rule::rule(const expr* head, std::vector<const expr*> body) :
+    head(head),
+    body(std::move(body))
+{
+    // slot and occurrence count of each var, in the order the walk meets them
+    std::map<uint32_t, uint32_t> slots;
+    std::vector<size_t> occurrences;
+    std::vector<const expr*> pending;
+    auto compile = [&](const expr* root) {
+        std::vector<cell> cells;
+        pending.push_back(root);
+        while (!pending.empty()) {
+            const expr* e = pending.back();
+            pending.pop_back();
+
+            // Vars take the next slot on their first occurrence
+            uint32_t slot = 0;
+            if (const expr::var* v = std::get_if<expr::var>(&e->content)) {
+                auto [it, inserted] = slots.insert({v->index, vars.size()});
+                if (inserted) {
+                    vars.push_back(v->index);
+                    occurrences.push_back(0);
+                }
+                slot = it->second;
+                ++occurrences[slot];
+            }
+
+            cells.push_back({e, slot});
+
+            // Ground subterms are leaves; functors are followed by their args,
+            // pushed in reverse so they are visited left to right
+            if (e->meta.ground)
+                continue;
+            if (const expr::functor* f = std::get_if<expr::functor>(&e->content))
+                for (size_t i = f->args.size(); i-- > 0;)
+                    pending.push_back(f->args[i]);
+        }
+        return cells;
+    };
+
+    // bodiless stand-ins have no head to compile
+    if (!head)
+        return;
+
+    head_template = compile(head);
+
+    // head vars hold the first slots, so the linear ones come out sorted
+    for (uint32_t slot = 0; slot < vars.size(); ++slot)
+        if (occurrences[slot] == 1)
+            linear.push_back(slot);
+
+    for (const expr* e : this->body)
+        body_template.push_back(compile(e));
+}
+
+size_t rule::subterm_end(std::span<const cell> cells, size_t first) {
+    // each cell fills one open place and opens one per arg of a non-ground functor
+    size_t end = first;
+    for (size_t open = 1; open > 0; ++end) {
+        const expr* e = cells[end].e;
+        --open;
+        if (const expr::functor* f = std::get_if<expr::functor>(&e->content); f && !e->meta.ground)
+            open += f->args.size();
+    }
+    return end;
+}
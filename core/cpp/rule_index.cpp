@@ -0,0 +1,101 @@
+#include "../hpp/rule_index.hpp"
+#include "../hpp/builtins.hpp"
+#include "../hpp/symbol_table.hpp"
+
+size_t rule_index::selection::size() const {
+    return keyed->size() + unkeyed->size();
+}
+
+rule_index::rule_index(const database& db) :
+    db(db)
+{
+    // make the initial candidates
+    for (size_t i = 0; i < db.size(); ++i)
+        initial_candidates.push_back(i);
+    // make a list for each predicate the database defines
+    for (const rule& r : db)
+        if (const expr::functor* f = std::get_if<expr::functor>(&r.head->content))
+            predicate_candidates[f->id];
+    // index the rules by head predicate, keeping database order
+    for (size_t i = 0; i < db.size(); ++i) {
+        if (const expr::functor* f = std::get_if<expr::functor>(&db[i].head->content)) {
+            predicate_candidates[f->id].push_back(i);
+            continue;
+        }
+        unindexed_candidates.push_back(i);
+        for (auto& [id, candidates] : predicate_candidates)
+            candidates.push_back(i);
+    }
+    // index each predicate's rules by every head arg, keeping database order
+    for (const auto& [id, rules] : predicate_candidates) {
+        std::vector<argument_index>& positions = argument_indices[id];
+        positions.resize(symbols().arity(id));
+        for (size_t position = 0; position < positions.size(); ++position) {
+            argument_index& ai = positions[position];
+            for (size_t i : rules) {
+                const expr* a = head_arg(i, position);
+                if (a) {
+                    if (const expr::functor* f = std::get_if<expr::functor>(&a->content)) {
+                        ai.functors[f->id].push_back(i);
+                        continue;
+                    }
+                    if (const expr::integer* n = std::get_if<expr::integer>(&a->content)) {
+                        ai.integers[n->value].push_back(i);
+                        continue;
+                    }
+                }
+                ai.unkeyed.push_back(i);
+            }
+        }
+    }
+}
+
+const std::vector<size_t>& rule_index::seed(const expr* e) const {
+    static const std::vector<size_t> builtin_candidates{builtins::candidate};
+    // builtin goals never resolve against the database
+    if (builtins::contains(e))
+        return builtin_candidates;
+    // functor goals only resolve against rules of their own predicate
+    if (const expr::functor* f = std::get_if<expr::functor>(&e->content)) {
+        auto it = predicate_candidates.find(f->id);
+        return it != predicate_candidates.end() ? it->second : unindexed_candidates;
+    }
+    return initial_candidates;
+}
+
+const std::vector<size_t>* rule_index::predicate(uint32_t id) const {
+    auto it = predicate_candidates.find(id);
+    return it != predicate_candidates.end() ? &it->second : nullptr;
+}
+
+bool rule_index::lookup(uint32_t id, size_t position, const expr* arg, selection& result) const {
+    static const std::vector<size_t> none;
+
+    // an unbound arg selects every rule of the predicate
+    if (std::holds_alternative<expr::var>(arg->content))
+        return false;
+    auto it = argument_indices.find(id);
+    if (it == argument_indices.end())
+        return false;
+    const argument_index& ai = it->second.at(position);
+
+    // keys no head mentions are only matched by the unkeyed rules
+    result.keyed = &none;
+    result.unkeyed = &ai.unkeyed;
+    if (const expr::functor* f = std::get_if<expr::functor>(&arg->content)) {
+        if (auto bucket = ai.functors.find(f->id); bucket != ai.functors.end())
+            result.keyed = &bucket->second;
+    }
+    else {
+        const expr::integer& n = std::get<expr::integer>(arg->content);
+        if (auto bucket = ai.integers.find(n.value); bucket != ai.integers.end())
+            result.keyed = &bucket->second;
+    }
+    return true;
+}
+
+const expr* rule_index::head_arg(size_t i, size_t position) const {
+    // the head arg in this position, or null for rules with var heads
+    const expr::functor* h = std::get_if<expr::functor>(&db[i].head->content);
+    return h ? h->args[position] : nullptr;
+}
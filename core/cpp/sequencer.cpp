@@ -1,11 +1,30 @@
+#include <limits>
 #include "../hpp/sequencer.hpp"
 
 sequencer::sequencer(trail& trail_ref)
-    : trail_ref(trail_ref), index(0) {
+    : trail_ref(trail_ref), index(0), logged_depth(std::numeric_limits<size_t>::max()) {
 
 }
 
 uint32_t sequencer::operator()() {
-    trail_ref.log([this]{--index;});
+    trail_ref.log_rewind(*this, index, logged_depth);
     return index++;
 }
+
+uint32_t sequencer::reserve(uint32_t count) {
+    // log one watermark per trail frame instead of one undo per index
+    if (count > 0 && logged_depth != trail_ref.depth()) {
+        trail_ref.log_rewind(*this, index, logged_depth);
+        logged_depth = trail_ref.depth();
+    }
+
+    // hand out the block [index, index + count)
+    uint32_t base = index;
+    index += count;
+    return base;
+}
+
+void sequencer::rollback(uint32_t watermark, size_t previous_depth) {
+    index = watermark;
+    logged_depth = previous_depth;
+}
@@ -4,14 +4,24 @@ sim::sim(sim_args args) :
     db(args.db),
     t(args.t),
     lp(args.lp),
-    gs(args.db, args.gl, args.t, cp, args.bm, args.lp),
-    cs(args.db, args.gl, args.lp),
+    bm(args.bm),
+    bi(args.bm, args.ep),
+    gs(args.db, args.gl, args.t, cp, args.bm, bi, args.lp),
+    cs(args.db, args.gl, args.lp, args.index),
     cp(args.vars, args.ep),
     c(args.c),
     max_resolutions(args.max_resolutions),
     rs({}),
-    ds({})
-{}
+    ds({}),
+    cache(args.cache),
+    cached_prefiltered(0)
+{
+    // narrow the goals' candidates by their bound args; all need a first check
+    for (const auto& [gl, e] : gs) {
+        cs.index(gl, e, bm);
+        mark(gl);
+    }
+}
 
 bool sim::operator()() {
 
@@ -25,6 +35,10 @@ bool sim::operator()() {
         // decide on a goal and candidate
         const resolution_lineage* rl = decide_one();
 
+        // no decidable goal remains, only builtins waiting on unbound inputs
+        if (!rl)
+            break;
+
         // mark this resolution as a decision
         ds.insert(rl);
         resolve(rl);
@@ -42,13 +56,80 @@ const decisions& sim::get_decisions() const {
     return ds;
 }
 
+const cdcl& sim::get_cdcl() const {
+    return c;
+}
+
+size_t sim::get_prefiltered() const {
+    // rejections the prefilter made, whether now or through the cache
+    return gs.get_prefiltered() + cached_prefiltered;
+}
+
+bool sim::failed() const {
+    // stopped at a conflict, rather than solved or out of budget or decisions
+    return cs.conflicted();
+}
+
+decisions sim::analyze() {
+    // find a goal left with no candidates; without one there is no conflict
+    // to analyze, and every decision is blamed
+    const goal_lineage* conflicting = nullptr;
+    for (const auto& [gl, candidates] : cs) {
+        if (candidates.empty()) {
+            conflicting = gl;
+            break;
+        }
+    }
+    is_implied = conflicting != nullptr;
+    if (!conflicting)
+        return ds;
+
+    // walk back from the conflicting goal through the resolutions it rests on,
+    // keeping the decisions reached
+    decisions result;
+    std::unordered_set<const resolution_lineage*> visited;
+    std::vector<const resolution_lineage*> pending;
+    explained_vars.clear();
+    explain(conflicting, true, pending);
+    while (!pending.empty()) {
+        const resolution_lineage* rl = pending.back();
+        pending.pop_back();
+        if (!rl || !visited.insert(rl).second)
+            continue;
+        // a decision was free to be taken, so only the goal instance it
+        // acted on is blamed; a forced resolution also blames what forced it
+        bool decided = ds.contains(rl);
+        if (decided)
+            result.insert(rl);
+        explain(rl->parent, !decided, pending);
+    }
+
+    return result;
+}
+
+bool sim::implied() const {
+    return is_implied;
+}
+
 bool sim::solved() {
     return gs.empty();
 }
 
 bool sim::conflicted() {
-    // head elimination
-    cs.eliminate([this](const goal_lineage* gl, size_t i) { return !gs.applicable(gs.at(gl), db.at(i)); });
+    // head elimination, for dirty goals only: the heads a goal can match
+    // change only when one of its vars is bound
+    for (const goal_lineage* gl : dirty) {
+        // goals resolved since they were marked have left the stores
+        if (!cs.contains(gl))
+            continue;
+        // builtins are checked by evaluation, which is cheaper than a lookup
+        if (cache && !builtins::contains(gs.at(gl)))
+            eliminate_cached(gl);
+        else
+            cs.eliminate(gl, [this](const goal_lineage* gl, size_t i) { return !gs.applicable(gs.at(gl), builtins::rule_at(db, i)); });
+        watch(gl);
+    }
+    dirty.clear();
 
     // cdcl elimination
     cs.eliminate([this](const goal_lineage* gl, size_t i) { return c.eliminated(lp.resolution(gl, i)); });
@@ -58,6 +139,14 @@ bool sim::conflicted() {
 }
 
 const resolution_lineage* sim::derive_one() {
+    // builtin evaluation, once enough arguments are bound
+    while (!ready.empty()) {
+        const goal_lineage* gl = ready.front();
+        ready.pop_front();
+        if (gs.contains(gl))
+            return lp.resolution(gl, builtins::candidate);
+    }
+
     // unit propagation
     const goal_lineage* propagated_gl;
     size_t propagated_rule_id;
@@ -72,8 +161,116 @@ const resolution_lineage* sim::derive_one() {
 
 void sim::resolve(const resolution_lineage* rl) {
     rs.insert(rl);
+
+    // note the vars this resolution binds, to find the goals it changes
+    newly_bound.clear();
+    resolved_terms[rl->parent] = gs.at(rl->parent);
+    bm.record(&newly_bound);
     gs.resolve(rl);
+    bm.record(nullptr);
+    for (uint32_t index : newly_bound)
+        binders[index] = {rl, bm.binding(index)};
+
     cs.resolve(rl);
+    // the new subgoals' args are bound now, so they can narrow their candidates
+    for (size_t i = 0; i < builtins::rule_at(db, rl->idx).body.size(); ++i) {
+        const goal_lineage* child = lp.goal(rl, i);
+        cs.index(child, gs.at(child), bm);
+        mark(child);
+    }
+
+    // goals containing a newly bound var must be checked again
+    for (uint32_t index : newly_bound) {
+        auto it = watchers.find(index);
+        if (it == watchers.end())
+            continue;
+        for (const goal_lineage* gl : it->second)
+            mark(gl);
+        watchers.erase(it);
+    }
     c.constrain(rl);
     on_resolve(rl);
 }
+
+void sim::watch(const goal_lineage* gl) {
+    // register the goal under each var it still leaves unbound
+    watch_stack.clear();
+    watch_stack.push_back(gs.at(gl));
+    while (!watch_stack.empty()) {
+        const expr* e = bm.deref(watch_stack.back());
+        watch_stack.pop_back();
+        if (e->meta.ground)
+            continue;
+        if (const expr::var* v = std::get_if<expr::var>(&e->content))
+            watchers[v->index].insert(gl);
+        else if (const expr::functor* f = std::get_if<expr::functor>(&e->content))
+            for (const expr* arg : f->args)
+                watch_stack.push_back(arg);
+    }
+}
+
+void sim::mark(const goal_lineage* gl) {
+    // the goal's heads must be checked again
+    dirty.insert(gl);
+
+    // a builtin whose inputs are now bound is ready to evaluate; goals
+    // resolved since they were watched are left to conflicted() to skip
+    if (!gs.contains(gl))
+        return;
+    const expr* e = gs.at(gl);
+    if (builtins::contains(e) && bi.ready(e))
+        ready.push_back(gl);
+}
+
+void sim::eliminate_cached(const goal_lineage* gl) {
+    // key the goal once; the last word names the candidate being checked
+    const expr* e = gs.at(gl);
+    cache->normalize(e, bm, goal_key);
+    goal_key.push_back(0);
+
+    cs.eliminate(gl, [this, e](const goal_lineage*, size_t i) {
+        goal_key.back() = i;
+        bool prefiltered;
+        if (const bool* applicable = cache->find(goal_key, &prefiltered)) {
+            cached_prefiltered += prefiltered;
+            return !*applicable;
+        }
+        size_t before = gs.get_prefiltered();
+        bool applicable = gs.applicable(e, builtins::rule_at(db, i));
+        cache->insert(goal_key, applicable, gs.get_prefiltered() != before);
+        return !applicable;
+    });
+}
+
+void sim::explain(const goal_lineage* gl, bool forced, std::vector<const resolution_lineage*>& pending) {
+    // the goal exists because its parent resolution was taken
+    pending.push_back(gl->parent);
+
+    // its instance rests on whichever resolutions bound its vars, followed
+    // through the values they bound them to
+    auto it = resolved_terms.find(gl);
+    explain_stack.clear();
+    explain_stack.push_back(it != resolved_terms.end() ? it->second : gs.at(gl));
+    while (!explain_stack.empty()) {
+        const expr* e = explain_stack.back();
+        explain_stack.pop_back();
+        if (e->meta.ground)
+            continue;
+        if (const expr::var* v = std::get_if<expr::var>(&e->content)) {
+            auto binder = binders.find(v->index);
+            if (binder == binders.end() || !explained_vars.insert(v->index).second)
+                continue;
+            pending.push_back(binder->second.first);
+            explain_stack.push_back(binder->second.second);
+        }
+        else if (const expr::functor* f = std::get_if<expr::functor>(&e->content)) {
+            for (const expr* arg : f->args)
+                explain_stack.push_back(arg);
+        }
+    }
+
+    // a goal whose candidates were whittled down also rests on the
+    // resolutions whose avoidances eliminated some of them
+    if (forced && !c.explain(gl, pending))
+        is_implied = false;
+}
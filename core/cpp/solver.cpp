@@ -2,16 +2,23 @@
 
 solver::solver(solver_args args) :
     db(args.db),
+    ri(args.db),
     gl(args.gl),
     t(args.t),
     vars(args.vars),
     bm(args.bm),
-    ep(args.t),
+    ep(args.t, args.base),
     lp(),
     max_resolutions(args.max_resolutions),
+    max_lemmas(args.max_lemmas),
     c(),
+    ac(args.cache_capacity),
+    ls(args.lemma_file),
+    lemma_key(lemma_store::fingerprint(args.db, args.gl)),
+    prefiltered(0),
     managed_sim(nullptr)
 {
+    ls.load(lemma_key, c, lp);
     t.push();
 }
 
@@ -37,11 +44,21 @@ bool solver::operator()(std::optional<resolutions>& soln) {
 
     // derived-class post-processing (e.g. MCTS backpropagation)
     terminate(*managed_sim);
+    prefiltered += managed_sim->get_prefiltered();
 
-    // learn to avoid the exact derivation path taken this iteration;
-    // this guarantees we never revisit the same decisions regardless of outcome
+    // learn to avoid the decisions that caused this iteration's conflict, or
+    // the whole derivation path when there was none; either way the same
+    // decisions are never revisited. only the conflict's lemma follows from
+    // the program, so the others are pinned against reduction. it carries
+    // over to other runs only if its analysis rested on no pinned lemma.
     const decisions& ds = managed_sim->get_decisions();
-    c.learn(lemma(ds));
+    c.credit(managed_sim->get_cdcl());
+    decisions blamed = managed_sim->analyze();
+    c.learn(lemma(blamed), !managed_sim->failed(), managed_sim->implied());
+
+    // past the budget, cut the avoidances back to half of it
+    if (c.get_kept() > max_lemmas)
+        c.reduce(max_lemmas / 2);
 
     // pin decision lineages so they survive the next lp.trim()
     for (const resolution_lineage* rl : ds)
@@ -55,3 +72,15 @@ bool solver::operator()(std::optional<resolutions>& soln) {
     // consume it before the next call detects (or triggers) refutation.
     return solved || !c.refuted();
 }
+
+void solver::save_lemmas() const {
+    ls.save(lemma_key, c);
+}
+
+const cdcl& solver::get_cdcl() const {
+    return c;
+}
+
+size_t solver::get_prefiltered() const {
+    return prefiltered;
+}
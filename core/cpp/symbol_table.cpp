@@ -0,0 +1,40 @@
+#include <mutex>
+#include "../hpp/symbol_table.hpp"
+
+uint32_t symbol_table::intern(const std::string& name, size_t arity) {
+    // fast path: the symbol already exists, so a shared lock suffices
+    {
+        std::shared_lock lock(mtx);
+        auto it = ids.find({name, arity});
+        if (it != ids.end())
+            return it->second;
+    }
+
+    // slow path: another thread may have interned it since we checked
+    std::unique_lock lock(mtx);
+    auto [it, inserted] = ids.emplace(std::make_pair(name, arity), (uint32_t)entries.size());
+    if (inserted)
+        entries.push_back(entry{name, arity});
+    return it->second;
+}
+
+const std::string& symbol_table::name(uint32_t id) const {
+    // deque references stay valid across push_back, but the lookup itself must not race one
+    std::shared_lock lock(mtx);
+    return entries.at(id).name;
+}
+
+size_t symbol_table::arity(uint32_t id) const {
+    std::shared_lock lock(mtx);
+    return entries.at(id).arity;
+}
+
+size_t symbol_table::size() const {
+    std::shared_lock lock(mtx);
+    return entries.size();
+}
+
+symbol_table& symbols() {
+    static symbol_table table;
+    return table;
+}
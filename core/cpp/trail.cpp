@@ -1,4 +1,7 @@
 #include "../hpp/trail.hpp"
+#include "../hpp/expr.hpp"
+#include "../hpp/bind_map.hpp"
+#include "../hpp/sequencer.hpp"
 
 void trail::push() {
     frame_boundary_stack.push(undo_stack.size());
@@ -11,15 +14,50 @@ void trail::pop() {
     frame_boundary_stack.pop();
     // pop the undo stack up to the last frame boundary
     while (undo_stack.size() > checkpoint) {
-        // execute the undo function
-        undo_stack.top()();
-        // pop the undo function
-        undo_stack.pop();
+        // execute the undo operation
+        const entry e = undo_stack.back();
+        undo_stack.pop_back();
+        switch (e.kind) {
+            case op::unbind:
+                static_cast<bind_map*>(e.target)->unbind(e.first);
+                break;
+            case op::rebind:
+                static_cast<bind_map*>(e.target)->rebind(e.first, reinterpret_cast<const expr*>(e.second));
+                break;
+            case op::truncate:
+                static_cast<expr_pool*>(e.target)->rollback(e.first, e.second);
+                break;
+            case op::rewind:
+                static_cast<sequencer*>(e.target)->rollback(e.first, e.second);
+                break;
+            case op::call:
+                // entries are popped in order, so the matching closure is always the last one
+                closures.back()();
+                closures.pop_back();
+                break;
+        }
     }
 }
 
 void trail::log(const std::function<void()>& a_function) {
-    undo_stack.push(a_function);
+    closures.push_back(a_function);
+    undo_stack.push_back({op::call, nullptr, 0, 0});
+}
+
+void trail::log_unbind(bind_map& bm, uint32_t index) {
+    undo_stack.push_back({op::unbind, &bm, index, 0});
+}
+
+void trail::log_rebind(bind_map& bm, uint32_t index, const expr* old_value) {
+    undo_stack.push_back({op::rebind, &bm, index, reinterpret_cast<size_t>(old_value)});
+}
+
+void trail::log_truncate(expr_pool& pool, size_t watermark, size_t previous_depth) {
+    undo_stack.push_back({op::truncate, &pool, watermark, previous_depth});
+}
+
+void trail::log_rewind(sequencer& seq, uint32_t watermark, size_t previous_depth) {
+    undo_stack.push_back({op::rewind, &seq, watermark, previous_depth});
 }
 
 size_t trail::depth() const {
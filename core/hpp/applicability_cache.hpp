@@ -0,0 +1,49 @@
+#ifndef APPLICABILITY_CACHE_HPP
+#define APPLICABILITY_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "expr.hpp"
+#include "bind_map.hpp"
+
+// Whether a rule's head unifies with a goal depends only on the goal up to
+// a renaming of its vars. Goals are keyed in that variant-normal form, so
+// answers carry over between sims, whose terms are rebuilt every iteration.
+// The cache is bounded and evicts with the clock (second chance) policy.
+struct applicability_cache {
+    using key = std::vector<uint64_t>;
+    applicability_cache(size_t);
+    void normalize(const expr*, bind_map&, key&);
+    const bool* find(const key&, bool* = nullptr);
+    void insert(const key&, bool, bool = false);
+    size_t size() const;
+#ifndef DEBUG
+private:
+#endif
+    // each node is one tagged word; an integer's value follows in a word of its own
+    static constexpr uint64_t functor_tag = 0ull << 62;
+    static constexpr uint64_t var_tag     = 1ull << 62;
+    static constexpr uint64_t integer_tag = 2ull << 62;
+    struct key_hash {
+        size_t operator()(const key&) const;
+    };
+    struct slot {
+        const key* goal;
+        bool applicable;
+        // rejected by the prefilter, before any unification
+        bool prefiltered;
+        bool referenced;
+    };
+    size_t capacity;
+    std::unordered_map<key, size_t, key_hash> index;
+    // the clock: filled in order, then reused from the hand onwards
+    std::vector<slot> slots;
+    size_t hand;
+    // reusable normalization state: pending terms, and canonical var numbers
+    std::vector<const expr*> pending;
+    std::unordered_map<uint32_t, uint64_t> renaming;
+};
+
+#endif
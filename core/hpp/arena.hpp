@@ -0,0 +1,30 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+// Bump allocator backing expr_pool. Allocations are released in LIFO order by
+// rewinding to the address of an earlier allocation; blocks are kept for reuse.
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+struct arena {
+    arena(size_t block_size = 1 << 16);
+    void* allocate(size_t bytes, size_t alignment);
+    void rewind(const void*);
+    size_t used() const;
+#ifndef DEBUG
+private:
+#endif
+    struct block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+    bool contains(const block&, const void*) const;
+    size_t block_size;
+    std::vector<block> blocks;
+    size_t current;
+    size_t offset;
+};
+
+#endif
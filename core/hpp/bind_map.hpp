@@ -1,20 +1,56 @@
 #ifndef BIND_MAP_HPP
 #define BIND_MAP_HPP
 
-#include <map>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
 #include "expr.hpp"
+#include "rule.hpp"
+
+struct copier;
 
 struct bind_map {
+    // Bindings indexed directly by var index. sequencer hands out dense
+    // indices, so a growable array replaces a tree lookup; a null slot is
+    // an unbound var.
+    struct binding_array {
+        const expr*& operator[](uint32_t);
+        const expr* at(uint32_t) const;
+        const expr* get(uint32_t) const;
+        size_t count(uint32_t) const;
+        size_t size() const;
+        bool empty() const;
+        bool operator==(const binding_array&) const;
+        std::vector<const expr*> slots;
+    };
     bind_map(trail&);
     const expr* whnf(const expr*);
     bool unify(const expr*, const expr*);
+    bool unify(std::span<const rule::cell>, uint32_t, const expr*, std::span<const uint32_t>, copier&);
+    const expr* deref(const expr*) const;
+    const expr* binding(uint32_t) const;
+    bool matches(const expr*, const expr*);
+    bool matches(std::span<const rule::cell>, const expr*);
+    void record(std::vector<uint32_t>*);
 #ifndef DEBUG
 private:
 #endif
+    friend struct trail;
     bool occurs_check(uint32_t, const expr*);
     void bind(uint32_t, const expr*);
-    std::map<uint32_t, const expr*> bindings;
+    void unbind(uint32_t);
+    void rebind(uint32_t, const expr*);
+    binding_array bindings;
     trail& trail_ref;
+    // while set, receives the index of each var bound from unbound
+    std::vector<uint32_t>* recorder;
+    // reusable work stacks, so deep terms are walked without recursion
+    std::vector<const expr*> whnf_path;
+    std::vector<std::pair<const expr*, const expr*>> unify_stack;
+    std::vector<const expr*> occurs_stack;
+    std::vector<const expr*> template_stack;
+    std::vector<std::pair<const expr*, const expr*>> match_stack;
 };
 
 #endif
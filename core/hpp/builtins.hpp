@@ -0,0 +1,40 @@
+#ifndef BUILTINS_HPP
+#define BUILTINS_HPP
+
+// Arithmetic predicates over native integers. Goals on these symbols are never
+// resolved against the database: they are evaluated directly once enough of
+// their arguments are bound, as a derivation that involves no choice.
+//
+//   int_add(X, Y, Z)   X + Y = Z   (any two of X, Y, Z determine the third)
+//   int_sub(X, Y, Z)   X - Y = Z   (any two of X, Y, Z determine the third)
+//   int_mul(X, Y, Z)   X * Y = Z   (X, Y determine Z; a nonzero factor and Z determine the other)
+//   int_lt / int_le / int_gt / int_ge (X, Y)   comparison of two bound integers
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include "expr.hpp"
+#include "rule.hpp"
+#include "bind_map.hpp"
+#include "defs.hpp"
+
+struct builtins {
+    // candidate index standing in for a database rule on builtin goals
+    static constexpr size_t candidate = SIZE_MAX;
+    static bool contains(const expr*);
+    static const rule& rule_at(const database&, size_t);
+    builtins(bind_map&, expr_pool&);
+    bool ready(const expr*);
+    bool evaluate(const expr*);
+#ifndef DEBUG
+private:
+#endif
+    enum class op { add, sub, mul, lt, le, gt, ge };
+    static std::optional<op> lookup(const expr*);
+    std::optional<int64_t> value(const expr*);
+    bool bound_non_integer(const expr*);
+    bind_map& bm;
+    expr_pool& ep;
+};
+
+#endif
@@ -1,28 +1,47 @@
 #ifndef CANDIDATE_STORE_HPP
 #define CANDIDATE_STORE_HPP
 
+#include <deque>
+#include <memory>
 #include "lineage.hpp"
 #include "frontier.hpp"
 #include "defs.hpp"
+#include "bind_map.hpp"
+#include "rule_index.hpp"
 
 struct candidate_store : frontier<std::vector<size_t>> {
     candidate_store(
         const database&,
         const goals&,
-        lineage_pool&
+        lineage_pool&,
+        const rule_index* = nullptr
     );
     size_t eliminate(const std::function<bool(const goal_lineage*, size_t)>&);
-    bool unit(const goal_lineage*&, size_t&) const;
+    size_t eliminate(const goal_lineage*, const std::function<bool(const goal_lineage*, size_t)>&);
+    bool unit(const goal_lineage*&, size_t&);
     bool conflicted() const;
+    void index(const goal_lineage*, const expr*, bind_map&);
+    void resolve(const resolution_lineage*);
 #ifndef DEBUG
 private:
 #endif
     std::vector<std::vector<size_t>> expand(const std::vector<size_t>&, const rule&) override;
+    void track(const goal_lineage*, size_t);
+    bool builtin(const std::vector<size_t>&) const;
 
     const database& db;
     lineage_pool& lp;
 
-    std::vector<size_t> initial_candidates;
+    // the shared index, or one of its own when none was given
+    std::unique_ptr<const rule_index> owned_index;
+    const rule_index& ri;
+
+    // Goals left with one candidate, queued as their counts drop. The queue
+    // is lazy: entries for goals since resolved or narrowed to nothing are
+    // dropped when they reach the front.
+    std::deque<const goal_lineage*> units;
+    // goals with no candidates left, kept exact
+    size_t conflicts = 0;
 };
 
 #endif
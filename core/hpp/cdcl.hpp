@@ -1,6 +1,7 @@
 #ifndef AVOIDANCE_HPP
 #define AVOIDANCE_HPP
 
+#include <array>
 #include "lineage.hpp"
 #include "defs.hpp"
 #include "lemma.hpp"
@@ -9,21 +10,60 @@ using avoidance = std::unordered_set<const resolution_lineage*>;
 
 struct cdcl {
     cdcl();
-    void learn(const lemma&);
+    void learn(const lemma&, bool = false, bool = true);
     void constrain(const resolution_lineage*);
     bool refuted() const;
     bool eliminated(const resolution_lineage*) const;
+    bool implied(size_t) const;
+    bool explain(const goal_lineage*, std::vector<const resolution_lineage*>&) const;
+    void credit(const cdcl&);
+    size_t reduce(size_t);
+    size_t get_kept() const;
+    size_t get_deleted() const;
+    size_t get_subsumed() const;
+    const std::map<size_t, avoidance>& get_avoidances() const;
     #ifndef DEBUG
     private:
     #endif
-    void upsert(size_t, const avoidance&);
+    void watch(size_t, size_t, const resolution_lineage*);
     void erase(size_t);
+    bool redundant(const avoidance&, size_t* = nullptr) const;
+    std::vector<size_t> supersets(const avoidance&) const;
 
+    // avoidances as learned; constrain() never rewrites them
     std::map<size_t, avoidance> avoidances;
+    // by resolution, the avoidances it occurs in
+    std::map<const resolution_lineage*, std::set<size_t>> occurrences;
+    // Each avoidance watches two of its resolutions whose goals are not yet
+    // resolved (one, if it is a singleton), and is visited only when one of
+    // those goals is. When every other resolution has been taken, the last
+    // is eliminated.
+    std::map<size_t, std::array<const resolution_lineage*, 2>> watches;
     std::map<const goal_lineage*, std::set<size_t>> watched_goals;
+    // the resolution each resolved goal took
+    std::map<const goal_lineage*, const resolution_lineage*> taken;
+    // by goal, the taken resolutions that eliminated any of its candidates
+    std::map<const goal_lineage*, std::vector<const resolution_lineage*>> reasons;
     bool is_refuted;
     std::set<const resolution_lineage*> eliminated_resolutions;
     size_t next_avoidance_id;
+
+    // eliminations each avoidance has caused in this copy, and their decayed
+    // totals as credited back from the sims
+    std::map<size_t, size_t> hits;
+    std::map<size_t, double> activity;
+    size_t deleted;
+    // avoidances reduce() never deletes: those blocking a solution already
+    // found, or a derivation already run out of budget. No conflict implies
+    // them, so once gone nothing would learn them again.
+    std::set<size_t> pinned;
+    // avoidances learned from a conflict whose analysis rested on the program
+    // and other such avoidances alone; only these hold in another run
+    std::set<size_t> implied_avoidances;
+    // goals that had a candidate eliminated by an avoidance not implied
+    std::set<const goal_lineage*> unimplied_goals;
+    // lemmas dropped for containing another, whether on arrival or later
+    size_t subsumed;
 };
 
 #endif
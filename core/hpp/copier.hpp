@@ -1,18 +1,25 @@
 #ifndef COPIER_HPP
 #define COPIER_HPP
 
-#include <map>
+#include <span>
+#include <utility>
+#include <vector>
 #include "sequencer.hpp"
 #include "expr.hpp"
+#include "rule.hpp"
 
 struct copier {
     copier(sequencer&, expr_pool&);
-    const expr* operator()(const expr*, std::map<uint32_t, uint32_t>&);
+    const expr* operator()(std::span<const rule::cell>, uint32_t);
+    uint32_t reserve(uint32_t);
 #ifndef DEBUG
 private:
 #endif
     sequencer& sequencer_ref;
     expr_pool& expr_pool_ref;
+    // reusable work stacks: functors pending their args, and finished copies
+    std::vector<std::pair<const expr*, size_t>> pending;
+    std::vector<const expr*> built;
 };
 
 #endif
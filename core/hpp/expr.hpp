@@ -5,35 +5,83 @@
 // functions that operate on them such as unifications.
 
 #include <cstdint>
+#include <compare>
 #include <string>
 #include <vector>
+#include <span>
 #include <variant>
-#include <set>
+#include <unordered_set>
+#include <utility>
 #include "trail.hpp"
+#include "symbol_table.hpp"
+#include "arena.hpp"
 
 struct expr {
     struct functor {
-        std::string name;
-        std::vector<const expr*> args;
-        auto operator<=>(const functor&) const = default;
+        uint32_t id;
+        // pool-owned exprs keep their args inline, directly after the node
+        std::span<const expr* const> args;
+        bool operator==(const functor&) const;
+        std::strong_ordering operator<=>(const functor&) const;
     };
     struct var  { uint32_t index; auto operator<=>(const var&) const = default; };
-    std::variant<functor, var> content;
-    auto operator<=>(const expr&) const = default;
+    struct integer { int64_t value; auto operator<=>(const integer&) const = default; };
+    // filled in by expr_pool::intern; exprs built elsewhere keep the
+    // conservative defaults and are always walked in full
+    struct metadata {
+        bool ground = false;
+    };
+    std::variant<functor, var, integer> content;
+    metadata meta{};
+    bool operator==(const expr&) const;
+    std::strong_ordering operator<=>(const expr&) const;
+};
+
+// Shallow hash: args are already interned, so children hash by address.
+template<>
+struct std::hash<expr> {
+    size_t operator()(const expr&) const;
 };
 
+// A pool may overlay a frozen base pool. Lookups fall through to the base, so
+// terms already in the base are never duplicated and keep their identity; new
+// terms land in the overlay. A frozen pool accepts no new terms and is safe to
+// read from many overlays on different threads at once.
 struct expr_pool {
-    expr_pool(trail&);
+    expr_pool(trail&, const expr_pool* base = nullptr);
     const expr* functor(const std::string& name, std::vector<const expr*> args = {});
+    const expr* functor(uint32_t id, std::vector<const expr*> args = {});
     const expr* var(uint32_t);
+    const expr* integer(int64_t);
     const expr* import(const expr*);
+    void freeze();
+    bool frozen() const;
     size_t size() const;
 #ifndef DEBUG
 private:
 #endif
-    const expr* intern(expr&&);
+    struct deref_hash {
+        size_t operator()(const expr*) const;
+    };
+    struct deref_equal {
+        bool operator()(const expr*, const expr*) const;
+    };
+    friend struct trail;
+    const expr* find(const expr&) const;
+    const expr* intern(const expr&);
+    void annotate(expr&);
+    void truncate(size_t);
+    void rollback(size_t, size_t);
     trail& trail_ref;
-    std::set<expr> exprs;
+    const expr_pool* base;
+    bool is_frozen;
+    arena nodes_arena;
+    std::vector<const expr*> nodes;
+    std::unordered_set<const expr*, deref_hash, deref_equal> exprs;
+    size_t logged_depth;
+    // reusable import stacks: functors pending their args, and finished imports
+    std::vector<std::pair<const expr*, size_t>> pending;
+    std::vector<const expr*> built;
 };
 
 #endif
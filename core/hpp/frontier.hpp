@@ -3,6 +3,7 @@
 
 #include <unordered_map>
 #include "defs.hpp"
+#include "builtins.hpp"
 
 template<typename T>
 struct frontier {
@@ -23,6 +24,7 @@ struct frontier {
     const T& at(const goal_lineage*) const;
     size_t size() const;
     bool empty() const;
+    bool contains(const goal_lineage*) const;
 #ifndef DEBUG
 private:
 #endif
@@ -51,7 +53,7 @@ void frontier<T>::resolve(const resolution_lineage* r) {
     const T& parent_value = members.at(parent);
     
     // expand the parent's value with the rule at the resolution index
-    auto child_values = expand(parent_value, db.at(r->idx));
+    auto child_values = expand(parent_value, builtins::rule_at(db, r->idx));
 
     // erase the parent from the frontier
     members.erase(parent);
@@ -101,4 +103,9 @@ bool frontier<T>::empty() const {
     return members.empty();
 }
 
+template<typename T>
+bool frontier<T>::contains(const goal_lineage* gl) const {
+    return members.contains(gl);
+}
+
 #endif
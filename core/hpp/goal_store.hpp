@@ -6,6 +6,7 @@
 #include "bind_map.hpp"
 #include "lineage.hpp"
 #include "frontier.hpp"
+#include "builtins.hpp"
 
 struct goal_store : frontier<const expr*> {
     goal_store(
@@ -14,11 +15,13 @@ struct goal_store : frontier<const expr*> {
         trail&,
         copier&,
         bind_map&,
+        builtins&,
         lineage_pool&
     );
-    bool try_unify_head(const expr* const&, const rule&, std::map<uint32_t, uint32_t>&);
+    bool try_unify_head(const expr* const&, const rule&, uint32_t&);
     bool applicable(const expr* const&, const rule&);
     std::vector<const expr*> expand(const expr* const&, const rule&) override;
+    size_t get_prefiltered() const;
 #ifndef DEBUG
 private:
 #endif
@@ -26,7 +29,10 @@ private:
     trail& t;
     copier& cp;
     bind_map& bm;
+    builtins& bi;
     lineage_pool& lp;
+    // head tests the read-only prefilter rejected before unification
+    size_t prefiltered;
 };
 
 #endif
@@ -0,0 +1,40 @@
+#ifndef LEMMA_STORE_HPP
+#define LEMMA_STORE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <map>
+#include <istream>
+#include <ostream>
+#include "defs.hpp"
+#include "lineage.hpp"
+#include "cdcl.hpp"
+
+// Keeps a solver's avoidances on disk between runs. Lineages name goals and
+// resolutions by position (goal index, body index, rule index), so for the
+// same database and goals they mean the same thing in every run, and a file
+// written by one run prunes the next from its first iteration. Only conflict
+// lemmas are kept, since the program implies them whatever the search does
+// and whatever the resolution budget. A file whose key does not match, or that cannot
+// be read, is ignored, and overwritten on the next save.
+struct lemma_store {
+    lemma_store(const std::string&);
+    static uint64_t fingerprint(const database&, const goals&);
+    size_t load(uint64_t, cdcl&, lineage_pool&) const;
+    void save(uint64_t, const cdcl&) const;
+#ifndef DEBUG
+private:
+#endif
+    static constexpr char magic[4] = {'A', 'T', 'L', 'L'};
+    static constexpr uint64_t version = 1;
+    static void mix(uint64_t&, uint64_t);
+    static void mix(uint64_t&, const expr*, std::map<uint32_t, uint64_t>&);
+    static void put(std::ostream&, uint64_t);
+    static bool get(std::istream&, uint64_t&);
+    static size_t number(const resolution_lineage*, std::map<const resolution_lineage*, size_t>&, std::ostream&);
+    // empty for none: nothing is loaded or saved
+    std::string path;
+};
+
+#endif
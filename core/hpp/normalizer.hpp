@@ -1,6 +1,8 @@
 #ifndef NORMALIZER_HPP
 #define NORMALIZER_HPP
 
+#include <utility>
+#include <vector>
 #include "expr.hpp"
 #include "bind_map.hpp"
 
@@ -12,6 +14,9 @@ private:
 #endif
     expr_pool& expr_pool_ref;
     bind_map& bind_map_ref;
+    // reusable work stacks: functors pending their args, and finished results
+    std::vector<std::pair<const expr*, size_t>> pending;
+    std::vector<const expr*> built;
 };
 
 #endif
@@ -1,12 +1,36 @@
 #ifndef RULE_HPP
 #define RULE_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 #include "expr.hpp"
 
 struct rule {
+    // one step of a compiled term, in preorder: a ground subterm is shared
+    // as-is, a var is renamed to base + slot, and a functor is rebuilt over
+    // the subterms compiled by the steps that follow it
+    struct cell {
+        const expr* e;
+        uint32_t slot;
+        auto operator<=>(const cell&) const = default;
+    };
+    // one past the last cell of the subterm that starts at the given cell
+    static size_t subterm_end(std::span<const cell>, size_t);
+    rule(const expr* head, std::vector<const expr*> body);
     const expr* head;
     std::vector<const expr*> body;
+    // distinct vars in the order a copy of the head, then the body, first
+    // meets them; a var's position here is its slot in the templates
+    std::vector<uint32_t> vars;
+    // slots of head vars that occur exactly once in the head, in ascending
+    // order; binding one of these during head unification needs no occurs check
+    std::vector<uint32_t> linear;
+    // head and body compiled at load time, so renaming a clause is one block
+    // of vars.size() fresh indices rather than a lookup per var occurrence
+    std::vector<cell> head_template;
+    std::vector<std::vector<cell>> body_template;
     auto operator<=>(const rule&) const = default;
 };
 
@@ -0,0 +1,50 @@
+#ifndef RULE_INDEX_HPP
+#define RULE_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "defs.hpp"
+#include "expr.hpp"
+
+// The rules of a database by the predicate of their heads, and within a
+// predicate by the principal symbol of each head arg. Built once per
+// database; a solver's sims share it read-only rather than each rebuilding
+// it over every rule.
+struct rule_index {
+    // the rules a bound arg selects: those filed under its key, and those
+    // with a var in its position, each in database order
+    struct selection {
+        const std::vector<size_t>* keyed;
+        const std::vector<size_t>* unkeyed;
+        size_t size() const;
+    };
+    rule_index(const database&);
+    const std::vector<size_t>& seed(const expr*) const;
+    const std::vector<size_t>* predicate(uint32_t) const;
+    bool lookup(uint32_t, size_t, const expr*, selection&) const;
+#ifndef DEBUG
+private:
+#endif
+    // rules of one predicate keyed by the principal symbol of one head arg;
+    // rules that match any key are kept once, apart from the keys
+    struct argument_index {
+        std::unordered_map<uint32_t, std::vector<size_t>> functors;
+        std::unordered_map<int64_t, std::vector<size_t>> integers;
+        std::vector<size_t> unkeyed;
+    };
+    const expr* head_arg(size_t, size_t) const;
+    const database& db;
+    // every rule, for goals whose predicate is not known until they are bound
+    std::vector<size_t> initial_candidates;
+    // rules by the functor id (name and arity) of their heads, in database
+    // order; rules whose heads are not functors may match any goal, so they
+    // are unindexed and appear in every list
+    std::unordered_map<uint32_t, std::vector<size_t>> predicate_candidates;
+    std::vector<size_t> unindexed_candidates;
+    // by predicate, one per argument position
+    std::unordered_map<uint32_t, std::vector<argument_index>> argument_indices;
+};
+
+#endif
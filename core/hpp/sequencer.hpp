@@ -1,17 +1,22 @@
 #ifndef SEQUENCER_HPP
 #define SEQUENCER_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include "trail.hpp"
 
 struct sequencer {
     sequencer(trail&);
     uint32_t operator()();
+    uint32_t reserve(uint32_t);
 #ifndef DEBUG
 private:
 #endif
+    friend struct trail;
+    void rollback(uint32_t, size_t);
     trail& trail_ref;
     uint32_t index;
+    size_t logged_depth;
 };
 
 #endif
@@ -1,6 +1,10 @@
 #ifndef SIM_HPP
 #define SIM_HPP
 
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "sim_args.hpp"
 #include "goal_store.hpp"
 #include "candidate_store.hpp"
@@ -10,6 +14,11 @@ struct sim {
     bool operator()();
     const resolutions& get_resolutions() const;
     const decisions& get_decisions() const;
+    const cdcl& get_cdcl() const;
+    size_t get_prefiltered() const;
+    bool failed() const;
+    decisions analyze();
+    bool implied() const;
 #ifndef DEBUG
 protected:
 #endif
@@ -19,11 +28,17 @@ protected:
     void resolve(const resolution_lineage*);
     virtual const resolution_lineage* decide_one() = 0;
     virtual void on_resolve(const resolution_lineage*) = 0;
+    void watch(const goal_lineage*);
+    void mark(const goal_lineage*);
+    void eliminate_cached(const goal_lineage*);
+    void explain(const goal_lineage*, bool, std::vector<const resolution_lineage*>&);
 
     const database& db;
     trail& t;
     lineage_pool& lp;
+    bind_map& bm;
 
+    builtins bi;
     goal_store gs;
     candidate_store cs;
 
@@ -34,6 +49,36 @@ protected:
     resolutions rs;
     decisions ds;
     size_t max_resolutions;
+
+    // goals whose candidates need their heads checked again: new goals, and
+    // goals containing a var that a resolution has since bound
+    std::unordered_set<const goal_lineage*> dirty;
+    // builtin goals found ready as they were marked, so derivation pops one
+    // rather than scanning every goal; entries since resolved are skipped
+    std::deque<const goal_lineage*> ready;
+    // goals by the unbound vars they contained when they were last checked
+    std::unordered_map<uint32_t, std::unordered_set<const goal_lineage*>> watchers;
+    // vars bound by the resolution in progress, and a reusable walk stack
+    std::vector<uint32_t> newly_bound;
+    std::vector<const expr*> watch_stack;
+
+    // head checks shared with the other sims of a solver, if any, and the
+    // key of the goal being checked
+    applicability_cache* cache;
+    applicability_cache::key goal_key;
+    // candidates the cache rejected on the prefilter's earlier say-so
+    size_t cached_prefiltered;
+
+    // for conflict analysis: the resolution that bound each var with the
+    // value it bound it to (slots may later be collapsed past intermediate
+    // vars), and the term each goal had when it was resolved
+    std::unordered_map<uint32_t, std::pair<const resolution_lineage*, const expr*>> binders;
+    std::unordered_map<const goal_lineage*, const expr*> resolved_terms;
+    std::unordered_set<uint32_t> explained_vars;
+    std::vector<const expr*> explain_stack;
+    // whether the last analysis found a conflict resting on the program and
+    // implied avoidances alone
+    bool is_implied = false;
 };
 
 #endif
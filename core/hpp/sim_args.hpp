@@ -9,6 +9,8 @@
 #include "bind_map.hpp"
 #include "lineage.hpp"
 #include "cdcl.hpp"
+#include "applicability_cache.hpp"
+#include "rule_index.hpp"
 
 struct sim_args {
     size_t           max_resolutions;
@@ -20,6 +22,9 @@ struct sim_args {
     bind_map&        bm;
     lineage_pool&    lp;
     cdcl             c;
+    applicability_cache* cache = nullptr;
+    // the database's rules by predicate, shared by the solver's sims
+    const rule_index* index = nullptr;
 };
 
 #endif
@@ -10,6 +10,9 @@
 #include "lineage.hpp"
 #include "sequencer.hpp"
 #include "cdcl.hpp"
+#include "applicability_cache.hpp"
+#include "lemma_store.hpp"
+#include "rule_index.hpp"
 #include "sim.hpp"
 #include "solver_args.hpp"
 
@@ -17,6 +20,9 @@ struct solver {
     solver(solver_args);
     virtual ~solver();
     bool operator()(std::optional<resolutions>&);
+    void save_lemmas() const;
+    const cdcl& get_cdcl() const;
+    size_t get_prefiltered() const;
 #ifndef DEBUG
 protected:
 #endif
@@ -24,6 +30,8 @@ protected:
     virtual void terminate(sim&) = 0;
 
     const database& db;
+    // built once here, rather than by every sim
+    rule_index ri;
     const goals& gl;
     trail& t;
     sequencer& vars;
@@ -33,7 +41,16 @@ protected:
     lineage_pool lp;
 
     size_t max_resolutions;
+    size_t max_lemmas;
     cdcl c;
+    // outlives the sims, so head checks carry over between iterations
+    applicability_cache ac;
+    // avoidances proved in earlier runs on the same inputs
+    lemma_store ls;
+    uint64_t lemma_key;
+
+    // candidates the prefilter removed, over every sim so far
+    size_t prefiltered;
 
     std::unique_ptr<sim> managed_sim;
 };
@@ -2,18 +2,29 @@
 #define SOLVER_ARGS_HPP
 
 #include <cstddef>
+#include <limits>
+#include <string>
 #include "defs.hpp"
 #include "trail.hpp"
 #include "sequencer.hpp"
+#include "expr.hpp"
 #include "bind_map.hpp"
 
 struct solver_args {
-    const database& db;
-    const goals&    gl;
-    trail&          t;
-    sequencer&      vars;
-    bind_map&       bm;
-    size_t          max_resolutions;
+    const database&  db;
+    const goals&     gl;
+    trail&           t;
+    sequencer&       vars;
+    bind_map&        bm;
+    size_t           max_resolutions;
+    const expr_pool* base = nullptr;
+    // entries kept by the applicability cache shared by this solver's sims
+    size_t           cache_capacity = 1 << 16;
+    // avoidances kept before the least active conflict lemmas are deleted;
+    // unlimited unless set
+    size_t           max_lemmas = std::numeric_limits<size_t>::max();
+    // file the avoidances are loaded from and saved to; empty for none
+    std::string      lemma_file = "";
 };
 
 #endif
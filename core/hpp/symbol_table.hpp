@@ -0,0 +1,34 @@
+#ifndef SYMBOL_TABLE_HPP
+#define SYMBOL_TABLE_HPP
+
+// Interns functor name/arity pairs to dense 32-bit ids so that the rest of the
+// solver compares and hashes integers. Names are only resolved for output.
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <deque>
+#include <map>
+#include <shared_mutex>
+
+struct symbol_table {
+    uint32_t intern(const std::string&, size_t);
+    const std::string& name(uint32_t) const;
+    size_t arity(uint32_t) const;
+    size_t size() const;
+#ifndef DEBUG
+private:
+#endif
+    struct entry {
+        std::string name;
+        size_t arity;
+    };
+    mutable std::shared_mutex mtx;
+    std::map<std::pair<std::string, size_t>, uint32_t> ids;
+    std::deque<entry> entries;
+};
+
+// the process-wide table shared by every expr_pool
+symbol_table& symbols();
+
+#endif
@@ -1,19 +1,42 @@
 #ifndef TRAIL_HPP
 #define TRAIL_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <stack>
+#include <vector>
 #include <functional>
 
+struct expr;
+struct expr_pool;
+struct bind_map;
+struct sequencer;
+
 struct trail {
     void push();
     void pop();
     void log(const std::function<void()>&);
+    void log_unbind(bind_map&, uint32_t);
+    void log_rebind(bind_map&, uint32_t, const expr*);
+    void log_truncate(expr_pool&, size_t, size_t);
+    void log_rewind(sequencer&, uint32_t, size_t);
     size_t depth() const;
 #ifndef DEBUG
 private:
 #endif
-    std::stack<std::function<void()>> undo_stack;
-    std::stack<size_t>                frame_boundary_stack;
+    // The hot undo operations are plain tagged records, so logging and
+    // popping them never touches the heap. Arbitrary closures are still
+    // accepted; they are kept aside and run through the call entry.
+    enum class op : uint8_t { unbind, rebind, truncate, rewind, call };
+    struct entry {
+        op kind;
+        void* target;
+        size_t first;
+        size_t second;
+    };
+    std::vector<entry>                 undo_stack;
+    std::vector<std::function<void()>> closures;
+    std::stack<size_t>                 frame_boundary_stack;
 };
 
 #endif
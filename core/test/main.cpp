@@ -1,3 +1,5 @@
+#include "../hpp/symbol_table.hpp"
+#include "../hpp/arena.hpp"
 #include "../hpp/expr.hpp"
 #include "../hpp/bind_map.hpp"
 #include "../hpp/lineage.hpp"
@@ -6,6 +8,7 @@
 #include "../hpp/normalizer.hpp"
 #include "../hpp/rule.hpp"
 #include "../hpp/defs.hpp"
+#include "../hpp/builtins.hpp"
 #include "../hpp/sim.hpp"
 #include "../hpp/mcts_decider.hpp"
 #include "../hpp/ridge_sim.hpp"
@@ -16,9 +19,17 @@
 #include "../hpp/cdcl.hpp"
 #include "../hpp/lemma.hpp"
 #include "../hpp/weight_store.hpp"
+#include "../hpp/candidate_store.hpp"
+#include "../hpp/rule_index.hpp"
+#include "../hpp/applicability_cache.hpp"
+#include "../hpp/lemma_store.hpp"
 #include <algorithm>
 #include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
 #include <sstream>
+#include <thread>
 #include <vector>
 #include "../../test_utils.hpp"
 
@@ -997,71 +1008,423 @@ void test_trail_log() {
         assert(t.depth() == 0);
         assert(val == 100);
     }
+
+    // Closures interleave with typed entries and still run in reverse order
+    {
+        trail t;
+        sequencer seq(t);
+        std::vector<int> order;
+        t.push();
+        t.log([&]() { order.push_back(1); });
+        seq();
+        t.log([&]() { order.push_back(2); });
+        assert(t.undo_stack.size() == 3);
+        assert(t.closures.size() == 2);
+        t.pop();
+        assert(order == std::vector<int>({2, 1}));
+        assert(seq.index == 0);
+        assert(t.closures.empty());
+    }
+}
+
+void test_trail_log_unbind() {
+    trail t;
+    bind_map bm(t);
+    expr a{expr::functor{symbols().intern("a", 0), {}}};
+
+    t.push();
+    bm.bindings[4] = &a;
+    t.log_unbind(bm, 4);
+    assert(t.undo_stack.size() == 1);
+    assert(t.undo_stack.back().kind == trail::op::unbind);
+    assert(t.closures.empty());
+
+    // popping clears the slot and drops the now-unbound tail
+    t.pop();
+    assert(bm.bindings.get(4) == nullptr);
+    assert(bm.bindings.slots.empty());
+    assert(t.undo_stack.empty());
+}
+
+void test_trail_log_rebind() {
+    trail t;
+    bind_map bm(t);
+    expr a{expr::functor{symbols().intern("a", 0), {}}};
+    expr b{expr::functor{symbols().intern("b", 0), {}}};
+
+    bm.bindings[2] = &a;
+    t.push();
+    bm.bindings[2] = &b;
+    t.log_rebind(bm, 2, &a);
+    assert(t.undo_stack.back().kind == trail::op::rebind);
+    assert(t.closures.empty());
+
+    t.pop();
+    assert(bm.bindings.get(2) == &a);
+    assert(bm.bindings.slots.size() == 3);
+}
+
+void test_trail_log_truncate() {
+    trail t;
+    expr_pool pool(t);
+    pool.functor("a");
+
+    t.push();
+    pool.functor("b");
+    pool.functor("c");
+    // the pool logged its own watermark; one more entry for the same frame is harmless
+    assert(t.undo_stack.size() == 2);
+    assert(t.undo_stack.back().kind == trail::op::truncate);
+    t.log_truncate(pool, 2, pool.logged_depth);
+    assert(t.undo_stack.size() == 3);
+    assert(t.closures.empty());
+
+    t.pop();
+    assert(pool.size() == 1);
+    assert(pool.logged_depth == 0);
+}
+
+void test_trail_log_rewind() {
+    trail t;
+    sequencer seq(t);
+
+    t.push();
+    seq();
+    seq();
+    assert(t.undo_stack.size() == 2);
+    assert(t.undo_stack.back().kind == trail::op::rewind);
+    t.log_rewind(seq, 0, seq.logged_depth);
+    seq.index = 40;
+    assert(t.closures.empty());
+
+    t.pop();
+    assert(seq.index == 0);
+}
+
+void test_symbol_table_intern() {
+    // Fresh table starts empty and hands out dense ids in order
+    {
+        symbol_table st;
+        assert(st.entries.size() == 0);
+        assert(st.ids.size() == 0);
+
+        uint32_t a = st.intern("a", 0);
+        uint32_t b = st.intern("b", 0);
+        uint32_t c = st.intern("c", 3);
+        assert(a == 0);
+        assert(b == 1);
+        assert(c == 2);
+        assert(st.entries.size() == 3);
+        assert(st.ids.size() == 3);
+        assert(st.entries[2].name == "c");
+        assert(st.entries[2].arity == 3);
+    }
+
+    // Re-interning returns the same id without growing the table
+    {
+        symbol_table st;
+        uint32_t a1 = st.intern("duplicate", 2);
+        uint32_t a2 = st.intern("duplicate", 2);
+        assert(a1 == a2);
+        assert(st.entries.size() == 1);
+    }
+
+    // Same name with different arity is a different symbol
+    {
+        symbol_table st;
+        uint32_t f0 = st.intern("f", 0);
+        uint32_t f1 = st.intern("f", 1);
+        uint32_t f2 = st.intern("f", 2);
+        assert(f0 != f1);
+        assert(f1 != f2);
+        assert(f0 != f2);
+        assert(st.entries.size() == 3);
+        assert(st.intern("f", 1) == f1);
+    }
+
+    // Unusual names are interned verbatim
+    {
+        symbol_table st;
+        std::string long_str(1000, 'a');
+        std::vector<std::string> names = {
+            "", " ", "\t", "\n", "0", "12345", "-42", "test_123", "hello world",
+            "!@#$%^&*()", "αβγδ", "日本語", "line1\nline2", long_str
+        };
+        std::vector<uint32_t> ids;
+        for (const std::string& n : names)
+            ids.push_back(st.intern(n, 0));
+        for (size_t i = 0; i < names.size(); ++i) {
+            assert(ids[i] == i);
+            assert(st.entries[i].name == names[i]);
+            assert(st.intern(names[i], 0) == ids[i]);
+        }
+        assert(st.entries.size() == names.size());
+    }
+
+    // Separate tables are independent
+    {
+        symbol_table st1;
+        symbol_table st2;
+        st1.intern("x", 0);
+        uint32_t y1 = st1.intern("y", 0);
+        uint32_t y2 = st2.intern("y", 0);
+        assert(y1 == 1);
+        assert(y2 == 0);
+        assert(st1.entries.size() == 2);
+        assert(st2.entries.size() == 1);
+    }
+}
+
+void test_symbol_table_name() {
+    symbol_table st;
+    uint32_t a = st.intern("hello", 0);
+    uint32_t b = st.intern("", 0);
+    uint32_t c = st.intern("hello", 2);
+    assert(st.name(a) == "hello");
+    assert(st.name(b) == "");
+    assert(st.name(c) == "hello");
+
+    // references stay valid while the table grows
+    const std::string& ref = st.name(a);
+    for (int i = 0; i < 1000; ++i)
+        st.intern("s" + std::to_string(i), 0);
+    assert(ref == "hello");
+    assert(&ref == &st.name(a));
+
+    // unknown ids throw
+    assert_throws(st.name(5000), std::out_of_range);
+}
+
+void test_symbol_table_arity() {
+    symbol_table st;
+    uint32_t a = st.intern("f", 0);
+    uint32_t b = st.intern("f", 1);
+    uint32_t c = st.intern("g", 7);
+    assert(st.arity(a) == 0);
+    assert(st.arity(b) == 1);
+    assert(st.arity(c) == 7);
+    assert_throws(st.arity(3), std::out_of_range);
+}
+
+void test_symbol_table_size() {
+    symbol_table st;
+    assert(st.size() == 0);
+    st.intern("a", 0);
+    assert(st.size() == 1);
+    st.intern("a", 0);
+    assert(st.size() == 1);
+    st.intern("a", 1);
+    assert(st.size() == 2);
+    st.intern("b", 0);
+    assert(st.size() == 3);
+}
+
+void test_symbols() {
+    // The process-wide table is a single instance
+    assert(&symbols() == &symbols());
+
+    // It behaves like any other table
+    size_t before = symbols().size();
+    uint32_t id = symbols().intern("test_symbols_unique_name", 4);
+    assert(symbols().size() == before + 1);
+    assert(symbols().intern("test_symbols_unique_name", 4) == id);
+    assert(symbols().size() == before + 1);
+    assert(symbols().name(id) == "test_symbols_unique_name");
+    assert(symbols().arity(id) == 4);
+}
+
+void test_arena_constructor() {
+    // Default construction allocates nothing up front
+    {
+        arena a;
+        assert(a.block_size == (1 << 16));
+        assert(a.blocks.empty());
+        assert(a.current == 0);
+        assert(a.offset == 0);
+        assert(a.used() == 0);
+    }
+
+    // Custom block size
+    {
+        arena a(128);
+        assert(a.block_size == 128);
+        assert(a.blocks.empty());
+    }
+}
+
+void test_arena_allocate() {
+    // First allocation creates a block
+    {
+        arena a(64);
+        void* p = a.allocate(16, 8);
+        assert(p != nullptr);
+        assert(a.blocks.size() == 1);
+        assert(a.blocks[0].size == 64);
+        assert(a.offset == 16);
+        assert(p == a.blocks[0].data.get());
+    }
+
+    // Consecutive allocations are contiguous
+    {
+        arena a(64);
+        std::byte* p1 = static_cast<std::byte*>(a.allocate(16, 8));
+        std::byte* p2 = static_cast<std::byte*>(a.allocate(8, 8));
+        std::byte* p3 = static_cast<std::byte*>(a.allocate(24, 8));
+        assert(p2 == p1 + 16);
+        assert(p3 == p2 + 8);
+        assert(a.blocks.size() == 1);
+        assert(a.offset == 48);
+    }
+
+    // Alignment padding is inserted when needed
+    {
+        arena a(64);
+        std::byte* p1 = static_cast<std::byte*>(a.allocate(3, 1));
+        std::byte* p2 = static_cast<std::byte*>(a.allocate(8, 8));
+        assert(p2 == p1 + 8);
+        assert(reinterpret_cast<uintptr_t>(p2) % 8 == 0);
+        assert(a.offset == 16);
+    }
+
+    // Allocation that does not fit starts a new block
+    {
+        arena a(64);
+        a.allocate(40, 8);
+        void* p = a.allocate(40, 8);
+        assert(a.blocks.size() == 2);
+        assert(a.current == 1);
+        assert(a.offset == 40);
+        assert(p == a.blocks[1].data.get());
+    }
+
+    // Oversized allocation gets a dedicated, larger block
+    {
+        arena a(64);
+        void* p = a.allocate(1000, 8);
+        assert(a.blocks.size() == 1);
+        assert(a.blocks[0].size >= 1000);
+        assert(p == a.blocks[0].data.get());
+    }
+
+    // Memory is writable over its whole extent
+    {
+        arena a(64);
+        std::vector<uint64_t*> ptrs;
+        for (uint64_t i = 0; i < 100; ++i) {
+            uint64_t* p = static_cast<uint64_t*>(a.allocate(sizeof(uint64_t), alignof(uint64_t)));
+            *p = i;
+            ptrs.push_back(p);
+        }
+        for (uint64_t i = 0; i < 100; ++i)
+            assert(*ptrs[i] == i);
+        assert(a.blocks.size() == 13);
+    }
+}
+
+void test_arena_rewind() {
+    // Rewinding to an allocation makes its address the next one handed out
+    {
+        arena a(64);
+        a.allocate(8, 8);
+        void* p2 = a.allocate(8, 8);
+        a.allocate(8, 8);
+        assert(a.offset == 24);
+        a.rewind(p2);
+        assert(a.offset == 8);
+        void* p4 = a.allocate(8, 8);
+        assert(p4 == p2);
+    }
+
+    // Rewinding across blocks keeps the later blocks for reuse
+    {
+        arena a(64);
+        void* p1 = a.allocate(40, 8);
+        void* p2 = a.allocate(40, 8);
+        assert(a.blocks.size() == 2);
+        a.rewind(p1);
+        assert(a.current == 0);
+        assert(a.offset == 0);
+        assert(a.blocks.size() == 2);
+        assert(a.allocate(40, 8) == p1);
+        assert(a.allocate(40, 8) == p2);
+        assert(a.blocks.size() == 2);
+    }
+
+    // A retained block too small for the request is skipped
+    {
+        arena a(64);
+        void* p1 = a.allocate(40, 8);
+        a.allocate(40, 8);
+        a.rewind(p1);
+        void* big = a.allocate(100, 8);
+        assert(a.blocks.size() == 3);
+        assert(a.current == 2);
+        assert(big == a.blocks[2].data.get());
+    }
+
+    // Foreign pointers are rejected
+    {
+        arena a(64);
+        a.allocate(8, 8);
+        int x;
+        assert_throws(a.rewind(&x), std::invalid_argument);
+    }
+}
+
+void test_arena_used() {
+    arena a(64);
+    assert(a.used() == 0);
+    void* p1 = a.allocate(16, 8);
+    assert(a.used() == 16);
+    a.allocate(8, 8);
+    assert(a.used() == 24);
+    // skipped tail of the first block counts as used
+    a.allocate(48, 8);
+    assert(a.used() == 64 + 48);
+    a.rewind(p1);
+    assert(a.used() == 0);
 }
 
 void test_functor_constructor() {
-    // Basic string
-    expr::functor a1{"hello"};
-    assert(a1.name == "hello");
-    
-    // Empty string
-    expr::functor a2{""};
-    assert(a2.name == "");
-    
-    // Single character
-    expr::functor a3{"x"};
-    assert(a3.name == "x");
-    
-    // Numeric strings
-    expr::functor a4{"0"};
-    assert(a4.name == "0");
-    expr::functor a5{"12345"};
-    assert(a5.name == "12345");
-    expr::functor a6{"-42"};
-    assert(a6.name == "-42");
-    
-    // Special characters
-    expr::functor a7{"test_123"};
-    assert(a7.name == "test_123");
-    expr::functor a8{"hello world"};
-    assert(a8.name == "hello world");
-    expr::functor a9{"!@#$%^&*()"};
-    assert(a9.name == "!@#$%^&*()");
-    
-    // Whitespace variations
-    expr::functor a10{" "};
-    assert(a10.name == " ");
-    expr::functor a11{"\t"};
-    assert(a11.name == "\t");
-    expr::functor a12{"\n"};
-    assert(a12.name == "\n");
-    
-    // Long string
-    std::string long_str(1000, 'a');
-    expr::functor a13{long_str};
-    assert(a13.name == long_str);
-    
-    // Unicode/special characters
-    expr::functor a14{"αβγδ"};
-    assert(a14.name == "αβγδ");
-    expr::functor a15{"日本語"};
-    assert(a15.name == "日本語");
-    
-    // Escape sequences
-    expr::functor a16{"line1\nline2"};
-    assert(a16.name == "line1\nline2");
-    
-    // Multiple atoms with same value
-    expr::functor a17{"duplicate"};
-    expr::functor a18{"duplicate"};
-    assert(a17.name == a18.name);
+    // Nullary functor
+    uint32_t hello = symbols().intern("hello", 0);
+    expr::functor a1{hello};
+    assert(a1.id == hello);
+    assert(a1.args.empty());
+    assert(symbols().name(a1.id) == "hello");
+
+    // Functor carrying args
+    expr e1{expr::var{0}};
+    expr e2{expr::var{1}};
+    uint32_t f = symbols().intern("f", 2);
+    const expr* a2_args[] = {&e1, &e2};
+    expr::functor a2{f, a2_args};
+    assert(a2.id == f);
+    assert(a2.args.size() == 2);
+    assert(a2.args[0] == &e1);
+    assert(a2.args[1] == &e2);
+
+    // Multiple functors with same symbol
+    uint32_t dup = symbols().intern("duplicate", 0);
+    expr::functor a17{dup};
+    expr::functor a18{dup};
+    assert(a17.id == a18.id);
     assert((a17 <=> a18) == 0);
-    
-    // Test spaceship operator with different values
-    expr::functor a19{"aaa"};
-    expr::functor a20{"bbb"};
-    assert((a19 <=> a20) < 0);
-    assert((a20 <=> a19) > 0);
+
+    // Different symbols compare by id
+    expr::functor a19{symbols().intern("aaa", 0)};
+    expr::functor a20{symbols().intern("bbb", 0)};
+    assert((a19 <=> a20) != 0);
+    assert((a19 <=> a20) == (a19.id <=> a20.id));
+    assert((a20 <=> a19) == (a20.id <=> a19.id));
+
+    // Same symbol, different args
+    const expr* a21_args[] = {&e1, &e2};
+    expr::functor a21{f, a21_args};
+    const expr* a22_args[] = {&e2, &e1};
+    expr::functor a22{f, a22_args};
+    assert((a21 <=> a22) != 0);
+    assert((a2 <=> a21) == 0);
 }
 
 void test_var_constructor() {
@@ -1110,65 +1473,102 @@ void test_var_constructor() {
     }
 }
 
+void test_integer_constructor() {
+    // Zero, positive and negative values
+    expr::integer i1{0};
+    assert(i1.value == 0);
+    expr::integer i2{42};
+    assert(i2.value == 42);
+    expr::integer i3{-7};
+    assert(i3.value == -7);
+
+    // Extremes
+    expr::integer i4{INT64_MAX};
+    assert(i4.value == INT64_MAX);
+    expr::integer i5{INT64_MIN};
+    assert(i5.value == INT64_MIN);
+
+    // Ordering follows the numeric value
+    assert((i3 <=> i1) < 0);
+    assert((i2 <=> i1) > 0);
+    assert((expr::integer{42} <=> i2) == 0);
+
+    // Integers are a kind of their own, distinct from atoms and vars
+    expr e1{expr::integer{3}};
+    expr e2{expr::var{3}};
+    expr e3{expr::functor{symbols().intern("3", 0), {}}};
+    assert(std::holds_alternative<expr::integer>(e1.content));
+    assert(e1 != e2);
+    assert(e1 != e3);
+    assert(e1 == expr{expr::integer{3}});
+}
+
 void test_functor_cons_constructor() {
     // Basic cons with raw pointers (testing the struct itself)
-    expr e1{expr::functor{"left", {}}};
-    expr e2{expr::functor{"right", {}}};
-    expr::functor c1{"cons", {&e1, &e2}};
+    expr e1{expr::functor{symbols().intern("left", 0), {}}};
+    expr e2{expr::functor{symbols().intern("right", 0), {}}};
+    const expr* c1_args[] = {&e1, &e2};
+    expr::functor c1{symbols().intern("cons", 2), c1_args};
     
     assert(c1.args[0] == &e1);
     assert(c1.args[1] == &e2);
-    assert(std::get<expr::functor>(c1.args[0]->content).name == "left");
-    assert(std::get<expr::functor>(c1.args[1]->content).name == "right");
+    assert(symbols().name(std::get<expr::functor>(c1.args[0]->content).id) == "left");
+    assert(symbols().name(std::get<expr::functor>(c1.args[1]->content).id) == "right");
     
     // Cons with variables
     expr e3{expr::var{0}};
     expr e4{expr::var{1}};
-    expr::functor c2{"cons", {&e3, &e4}};
+    const expr* c2_args[] = {&e3, &e4};
+    expr::functor c2{symbols().intern("cons", 2), c2_args};
     
     assert(std::get<expr::var>(c2.args[0]->content).index == 0);
     assert(std::get<expr::var>(c2.args[1]->content).index == 1);
     
     // Cons with mixed types
-    expr e5{expr::functor{"atom", {}}};
+    expr e5{expr::functor{symbols().intern("atom", 0), {}}};
     expr e6{expr::var{42}};
-    expr::functor c3{"cons", {&e5, &e6}};
+    const expr* c3_args[] = {&e5, &e6};
+    expr::functor c3{symbols().intern("cons", 2), c3_args};
     
-    assert(std::get<expr::functor>(c3.args[0]->content).name == "atom");
+    assert(symbols().name(std::get<expr::functor>(c3.args[0]->content).id) == "atom");
     assert(std::get<expr::var>(c3.args[1]->content).index == 42);
     
     // Cons with same expr on both sides
-    expr e7{expr::functor{"same", {}}};
-    expr::functor c4{"cons", {&e7, &e7}};
+    expr e7{expr::functor{symbols().intern("same", 0), {}}};
+    const expr* c4_args[] = {&e7, &e7};
+    expr::functor c4{symbols().intern("cons", 2), c4_args};
     
     assert(c4.args[0] == c4.args[1]);
     assert(c4.args[0] == &e7);
     
     // Test spaceship operator
-    expr e8{expr::functor{"a", {}}};
-    expr e9{expr::functor{"b", {}}};
-    expr::functor c5{"cons", {&e8, &e9}};
-    expr::functor c6{"cons", {&e8, &e9}};
+    expr e8{expr::functor{symbols().intern("a", 0), {}}};
+    expr e9{expr::functor{symbols().intern("b", 0), {}}};
+    const expr* c5_args[] = {&e8, &e9};
+    expr::functor c5{symbols().intern("cons", 2), c5_args};
+    const expr* c6_args[] = {&e8, &e9};
+    expr::functor c6{symbols().intern("cons", 2), c6_args};
     
     assert((c5 <=> c6) == 0);
     
     // Different cons
-    expr e10{expr::functor{"c", {}}};
-    expr::functor c7{"cons", {&e8, &e10}};
+    expr e10{expr::functor{symbols().intern("c", 0), {}}};
+    const expr* c7_args[] = {&e8, &e10};
+    expr::functor c7{symbols().intern("cons", 2), c7_args};
     
     assert((c5 <=> c7) != 0);
 }
 
 void test_expr_constructor() {
     // Expr with atom
-    expr e1{expr::functor{"test", {}}};
+    expr e1{expr::functor{symbols().intern("test", 0), {}}};
     assert(std::holds_alternative<expr::functor>(e1.content));
-    assert(std::get<expr::functor>(e1.content).name == "test");
+    assert(symbols().name(std::get<expr::functor>(e1.content).id) == "test");
     
     // Expr with empty atom
-    expr e2{expr::functor{"", {}}};
+    expr e2{expr::functor{symbols().intern("", 0), {}}};
     assert(std::holds_alternative<expr::functor>(e2.content));
-    assert(std::get<expr::functor>(e2.content).name == "");
+    assert(symbols().name(std::get<expr::functor>(e2.content).id) == "");
     
     // Expr with var
     expr e3{expr::var{42}};
@@ -1183,21 +1583,22 @@ void test_expr_constructor() {
     assert(std::get<expr::var>(e5.content).index == UINT32_MAX);
     
     // Expr with cons
-    expr left{expr::functor{"left", {}}};
-    expr right{expr::functor{"right", {}}};
-    expr e6{expr::functor{"cons", {&left, &right}}};
+    expr left{expr::functor{symbols().intern("left", 0), {}}};
+    expr right{expr::functor{symbols().intern("right", 0), {}}};
+    const expr* e6_args[] = {&left, &right};
+    expr e6{expr::functor{symbols().intern("cons", 2), e6_args}};
     
     assert(std::holds_alternative<expr::functor>(e6.content));
     const expr::functor& c1 = std::get<expr::functor>(e6.content);
-    assert(std::get<expr::functor>(c1.args[0]->content).name == "left");
-    assert(std::get<expr::functor>(c1.args[1]->content).name == "right");
+    assert(symbols().name(std::get<expr::functor>(c1.args[0]->content).id) == "left");
+    assert(symbols().name(std::get<expr::functor>(c1.args[1]->content).id) == "right");
     
     // Test spaceship operator
-    expr e7{expr::functor{"aaa", {}}};
-    expr e8{expr::functor{"aaa", {}}};
+    expr e7{expr::functor{symbols().intern("aaa", 0), {}}};
+    expr e8{expr::functor{symbols().intern("aaa", 0), {}}};
     assert((e7 <=> e8) == 0);
     
-    expr e9{expr::functor{"bbb", {}}};
+    expr e9{expr::functor{symbols().intern("bbb", 0), {}}};
     assert((e7 <=> e9) < 0);
     assert((e9 <=> e7) > 0);
     
@@ -1207,6 +1608,66 @@ void test_expr_constructor() {
     assert((e7 <=> e10) != 0);
 }
 
+void test_expr_hash() {
+    std::hash<expr> h;
+
+    // Equal atoms hash equally
+    expr a1{expr::functor{symbols().intern("a", 0), {}}};
+    expr a2{expr::functor{symbols().intern("a", 0), {}}};
+    assert(a1 == a2);
+    assert(h(a1) == h(a2));
+
+    // Equal vars hash equally
+    expr v1{expr::var{7}};
+    expr v2{expr::var{7}};
+    assert(h(v1) == h(v2));
+
+    // Different names, indices and kinds hash differently
+    expr b{expr::functor{symbols().intern("b", 0), {}}};
+    expr v3{expr::var{8}};
+    expr v0{expr::var{0}};
+    expr empty{expr::functor{symbols().intern("", 0), {}}};
+    assert(h(a1) != h(b));
+    assert(h(v1) != h(v3));
+    assert(h(v0) != h(empty));
+
+    // Compound exprs hash by child address, not child content
+    const expr* c1_args[] = {&a1, &b};
+    expr c1{expr::functor{symbols().intern("f", 2), c1_args}};
+    const expr* c2_args[] = {&a1, &b};
+    expr c2{expr::functor{symbols().intern("f", 2), c2_args}};
+    const expr* c3_args[] = {&a2, &b};
+    expr c3{expr::functor{symbols().intern("f", 2), c3_args}};
+    assert(c1 == c2);
+    assert(h(c1) == h(c2));
+    assert(c1 != c3);
+    assert(h(c1) != h(c3));
+
+    // Argument order matters
+    const expr* c4_args[] = {&b, &a1};
+    expr c4{expr::functor{symbols().intern("f", 2), c4_args}};
+    assert(h(c1) != h(c4));
+
+    // Arity matters
+    const expr* c5_args[] = {&a1};
+    expr c5{expr::functor{symbols().intern("f", 1), c5_args}};
+    const expr* c6_args[] = {&a1, &a1};
+    expr c6{expr::functor{symbols().intern("f", 2), c6_args}};
+    assert(h(c5) != h(c6));
+
+    // Integers hash by value and apart from vars of the same number
+    expr i1{expr::integer{7}};
+    expr i2{expr::integer{7}};
+    expr i3{expr::integer{-7}};
+    assert(h(i1) == h(i2));
+    assert(h(i1) != h(i3));
+    assert(h(i1) != h(v1));
+
+    // Hashing is deterministic
+    for (int i = 0; i < 10; ++i)
+        assert(h(c1) == h(c2));
+}
+
 void test_expr_pool_functor_constructor() {
     trail t;
     
@@ -1235,7 +1696,7 @@ void test_expr_pool_functor_constructor() {
     assert(e1 != nullptr);
     assert(pool1.size() == 1);
     assert(pool1.exprs.size() == 1);
-    assert(pool1.exprs.count(*e1) == 1);
+    assert(pool1.exprs.count(e1) == 1);
     
     // Other pools are independent
     assert(pool2.size() == 0);
@@ -1247,7 +1708,7 @@ void test_expr_pool_functor_constructor() {
     const expr* e2 = pool2.functor("test2", {});
     assert(pool2.size() == 1);
     assert(pool2.exprs.size() == 1);
-    assert(pool2.exprs.count(*e2) == 1);
+    assert(pool2.exprs.count(e2) == 1);
     assert(pool1.size() == 1);  // pool1 unchanged
     assert(pool1.exprs.size() == 1);
     
@@ -1261,6 +1722,26 @@ void test_expr_pool_functor_constructor() {
     // pool3 with different trail is unaffected
     assert(pool3.size() == 0);
     assert(pool3.exprs.size() == 0);
+
+    // Overlay construction: reads fall through to the base, writes stay local
+    {
+        trail tb;
+        expr_pool base(tb);
+        const expr* a = base.functor("a");
+        base.freeze();
+
+        trail to;
+        expr_pool overlay(to, &base);
+        assert(overlay.base == &base);
+        assert(!overlay.frozen());
+        assert(overlay.size() == 0);
+        assert(overlay.functor("a") == a);
+        assert(overlay.size() == 0);
+        const expr* fa = overlay.functor("f", {a});
+        assert(overlay.size() == 1);
+        assert(base.size() == 1);
+        assert(base.exprs.count(fa) == 0);
+    }
 }
 
 void test_expr_pool_functor() {
@@ -1274,17 +1755,17 @@ void test_expr_pool_functor() {
     const expr* e1 = pool.functor("test", {});
     assert(e1 != nullptr);
     assert(std::holds_alternative<expr::functor>(e1->content));
-    assert(std::get<expr::functor>(e1->content).name == "test");
+    assert(symbols().name(std::get<expr::functor>(e1->content).id) == "test");
     assert(pool.size() == 1);
     assert(pool.exprs.size() == 1);
-    assert(pool.exprs.count(*e1) == 1);
+    assert(pool.exprs.count(e1) == 1);
     
     // Empty string
     const expr* e2 = pool.functor("", {});
-    assert(std::get<expr::functor>(e2->content).name == "");
+    assert(symbols().name(std::get<expr::functor>(e2->content).id) == "");
     assert(pool.size() == 2);
     assert(pool.exprs.size() == 2);
-    assert(pool.exprs.count(*e2) == 1);
+    assert(pool.exprs.count(e2) == 1);
     assert(e1 != e2);
     
     // Interning - same string should return same pointer
@@ -1298,7 +1779,7 @@ void test_expr_pool_functor() {
     assert(e1 != e4);
     assert(pool.size() == 3);
     assert(pool.exprs.size() == 3);
-    assert(pool.exprs.count(*e4) == 1);
+    assert(pool.exprs.count(e4) == 1);
     
     // Multiple calls with same string
     const expr* e5 = pool.functor("shared", {});
@@ -1309,7 +1790,7 @@ void test_expr_pool_functor() {
     assert(e6 == e7);
     assert(pool.size() == 4);  // Only one "shared" added
     assert(pool.exprs.size() == 4);
-    assert(pool.exprs.count(*e5) == 1);
+    assert(pool.exprs.count(e5) == 1);
     
     // Special characters
     const expr* e8 = pool.functor("!@#$", {});
@@ -1318,7 +1799,7 @@ void test_expr_pool_functor() {
     assert(e8 == e9);
     assert(pool.size() == 5);
     assert(pool.exprs.size() == 5);
-    assert(pool.exprs.count(*e8) == 1);
+    assert(pool.exprs.count(e8) == 1);
     
     // Long strings
     std::string long_str(1000, 'x');
@@ -1328,7 +1809,7 @@ void test_expr_pool_functor() {
     assert(e10 == e11);
     assert(pool.size() == 6);
     assert(pool.exprs.size() == 6);
-    assert(pool.exprs.count(*e10) == 1);
+    assert(pool.exprs.count(e10) == 1);
     
     // Test backtracking: push frame, add content, pop frame
     size_t size_before = pool.size();
@@ -1338,8 +1819,8 @@ void test_expr_pool_functor() {
     const expr* temp2 = pool.functor("temporary2", {});
     assert(pool.size() == size_before + 2);
     assert(pool.exprs.size() == size_before + 2);
-    assert(pool.exprs.count(*temp1) == 1);
-    assert(pool.exprs.count(*temp2) == 1);
+    assert(pool.exprs.count(temp1) == 1);
+    assert(pool.exprs.count(temp2) == 1);
     t.pop();
     assert(pool.size() == size_before);  // Should be back to original size
     assert(pool.exprs.size() == size_before);
@@ -1350,7 +1831,7 @@ void test_expr_pool_functor() {
     size_t checkpoint1 = pool.size();
     assert(content_c != nullptr);
     assert(pool.exprs.size() == checkpoint1);
-    assert(pool.exprs.count(*content_c) == 1);
+    assert(pool.exprs.count(content_c) == 1);
     
     t.push();  // Frame 2
     const expr* content_c_again = pool.functor("content_c", {});  // Should return same pointer, no log
@@ -1367,7 +1848,7 @@ void test_expr_pool_functor() {
     assert(content_c == content_c_verify);
     assert(pool.size() == checkpoint1);
     assert(pool.exprs.size() == checkpoint1);
-    assert(pool.exprs.count(*content_c) == 1);
+    assert(pool.exprs.count(content_c) == 1);
     
     t.pop();  // Pop frame 1
     // Now content_c should be removed
@@ -1421,11 +1902,11 @@ void test_expr_pool_functor() {
     
     const expr* early_content_1 = pool.functor("early_1", {});
     assert(pool.exprs.size() == checkpoint_start + 1);
-    assert(pool.exprs.count(*early_content_1) == 1);
+    assert(pool.exprs.count(early_content_1) == 1);
     
     const expr* early_content_2 = pool.functor("early_2", {});
     assert(pool.exprs.size() == checkpoint_start + 2);
-    assert(pool.exprs.count(*early_content_2) == 1);
+    assert(pool.exprs.count(early_content_2) == 1);
     
     size_t checkpoint_a = pool.size();
     assert(checkpoint_a == checkpoint_start + 2);
@@ -1436,7 +1917,7 @@ void test_expr_pool_functor() {
     
     const expr* mid_content = pool.functor("mid_content", {});
     assert(pool.exprs.size() == checkpoint_a + 1);
-    assert(pool.exprs.count(*mid_content) == 1);
+    assert(pool.exprs.count(mid_content) == 1);
     
     size_t checkpoint_b = pool.size();
     assert(checkpoint_b == checkpoint_a + 1);
@@ -1447,16 +1928,16 @@ void test_expr_pool_functor() {
     assert(early_content_1 == early_content_1_again);
     assert(pool.size() == checkpoint_b);  // Size unchanged
     assert(pool.exprs.size() == checkpoint_b);  // Set size also unchanged
-    assert(pool.exprs.count(*early_content_1) == 1);  // Still in set
+    assert(pool.exprs.count(early_content_1) == 1);  // Still in set
     
     // Add more new content in Frame B
     const expr* late_content_1 = pool.functor("late_1", {});
     assert(pool.exprs.size() == checkpoint_b + 1);
-    assert(pool.exprs.count(*late_content_1) == 1);
+    assert(pool.exprs.count(late_content_1) == 1);
     
     const expr* late_content_2 = pool.functor("late_2", {});
     assert(pool.exprs.size() == checkpoint_b + 2);
-    assert(pool.exprs.count(*late_content_2) == 1);
+    assert(pool.exprs.count(late_content_2) == 1);
     
     size_t checkpoint_b_final = pool.size();
     assert(checkpoint_b_final == checkpoint_b + 2);
@@ -1469,30 +1950,30 @@ void test_expr_pool_functor() {
     const expr* early_content_2_again = pool.functor("early_2", {});
     assert(early_content_2 == early_content_2_again);
     assert(pool.exprs.size() == checkpoint_b_final);  // No change
-    assert(pool.exprs.count(*early_content_2) == 1);
+    assert(pool.exprs.count(early_content_2) == 1);
     
     const expr* mid_content_again = pool.functor("mid_content", {});
     assert(mid_content == mid_content_again);
     assert(pool.size() == checkpoint_b_final);  // Size unchanged
     assert(pool.exprs.size() == checkpoint_b_final);  // Set size unchanged
-    assert(pool.exprs.count(*mid_content) == 1);
+    assert(pool.exprs.count(mid_content) == 1);
     
     // Add new content in Frame C
     const expr* frame_c_content = pool.functor("frame_c", {});
     assert(pool.exprs.size() == checkpoint_b_final + 1);
-    assert(pool.exprs.count(*frame_c_content) == 1);
+    assert(pool.exprs.count(frame_c_content) == 1);
     
     size_t checkpoint_c = pool.size();
     assert(checkpoint_c == checkpoint_b_final + 1);
     assert(pool.exprs.size() == checkpoint_c);
     
     // Verify all content from all frames is present
-    assert(pool.exprs.count(*early_content_1) == 1);
-    assert(pool.exprs.count(*early_content_2) == 1);
-    assert(pool.exprs.count(*mid_content) == 1);
-    assert(pool.exprs.count(*late_content_1) == 1);
-    assert(pool.exprs.count(*late_content_2) == 1);
-    assert(pool.exprs.count(*frame_c_content) == 1);
+    assert(pool.exprs.count(early_content_1) == 1);
+    assert(pool.exprs.count(early_content_2) == 1);
+    assert(pool.exprs.count(mid_content) == 1);
+    assert(pool.exprs.count(late_content_1) == 1);
+    assert(pool.exprs.count(late_content_2) == 1);
+    assert(pool.exprs.count(frame_c_content) == 1);
     
     // Pop Frame C - only frame_c_content should be removed
     t.pop();
@@ -1506,25 +1987,25 @@ void test_expr_pool_functor() {
     // Verify early and mid content still exist
     const expr* verify_early_1 = pool.functor("early_1", {});
     assert(verify_early_1 == early_content_1);
-    assert(pool.exprs.count(*verify_early_1) == 1);
+    assert(pool.exprs.count(verify_early_1) == 1);
     
     const expr* verify_mid = pool.functor("mid_content", {});
     assert(verify_mid == mid_content);
-    assert(pool.exprs.count(*verify_mid) == 1);
+    assert(pool.exprs.count(verify_mid) == 1);
     
     const expr* verify_late_1 = pool.functor("late_1", {});
     assert(verify_late_1 == late_content_1);
-    assert(pool.exprs.count(*verify_late_1) == 1);
+    assert(pool.exprs.count(verify_late_1) == 1);
     
     assert(pool.size() == checkpoint_b_final);  // Still unchanged
     assert(pool.exprs.size() == checkpoint_b_final);
     
     // Verify all Frame A and Frame B content is still present
-    assert(pool.exprs.count(*early_content_1) == 1);
-    assert(pool.exprs.count(*early_content_2) == 1);
-    assert(pool.exprs.count(*mid_content) == 1);
-    assert(pool.exprs.count(*late_content_1) == 1);
-    assert(pool.exprs.count(*late_content_2) == 1);
+    assert(pool.exprs.count(early_content_1) == 1);
+    assert(pool.exprs.count(early_content_2) == 1);
+    assert(pool.exprs.count(mid_content) == 1);
+    assert(pool.exprs.count(late_content_1) == 1);
+    assert(pool.exprs.count(late_content_2) == 1);
     
     // Pop Frame B - should remove mid_content, late_1, late_2 but NOT early_1, early_2
     t.pop();
@@ -1534,18 +2015,18 @@ void test_expr_pool_functor() {
     // Verify early content still exists
     const expr* verify_early_1_after_b = pool.functor("early_1", {});
     assert(verify_early_1_after_b == early_content_1);
-    assert(pool.exprs.count(*verify_early_1_after_b) == 1);
+    assert(pool.exprs.count(verify_early_1_after_b) == 1);
     
     const expr* verify_early_2_after_b = pool.functor("early_2", {});
     assert(verify_early_2_after_b == early_content_2);
-    assert(pool.exprs.count(*verify_early_2_after_b) == 1);
+    assert(pool.exprs.count(verify_early_2_after_b) == 1);
     
     assert(pool.size() == checkpoint_a);  // Still unchanged
     assert(pool.exprs.size() == checkpoint_a);
     
     // Verify only Frame A content remains
-    assert(pool.exprs.count(*early_content_1) == 1);
-    assert(pool.exprs.count(*early_content_2) == 1);
+    assert(pool.exprs.count(early_content_1) == 1);
+    assert(pool.exprs.count(early_content_2) == 1);
     
     // Pop Frame A - should remove early_1 and early_2
     t.pop();
@@ -1573,7 +2054,7 @@ void test_expr_pool_var() {
     assert(std::get<expr::var>(e1->content).index == 0);
     assert(pool.size() == 1);
     assert(pool.exprs.size() == 1);
-    assert(pool.exprs.count(*e1) == 1);
+    assert(pool.exprs.count(e1) == 1);
     
     // Interning - same index should return same pointer
     const expr* e2 = pool.var(0);
@@ -1586,7 +2067,7 @@ void test_expr_pool_var() {
     assert(e1 != e3);
     assert(pool.size() == 2);
     assert(pool.exprs.size() == 2);
-    assert(pool.exprs.count(*e3) == 1);
+    assert(pool.exprs.count(e3) == 1);
     
     // Multiple calls with same index
     const expr* e4 = pool.var(42);
@@ -1597,7 +2078,7 @@ void test_expr_pool_var() {
     assert(e5 == e6);
     assert(pool.size() == 3);  // Only one var(42) added
     assert(pool.exprs.size() == 3);
-    assert(pool.exprs.count(*e4) == 1);
+    assert(pool.exprs.count(e4) == 1);
     
     // Edge cases
     const expr* e7 = pool.var(UINT32_MAX);
@@ -1606,7 +2087,7 @@ void test_expr_pool_var() {
     assert(e7 == e8);
     assert(pool.size() == 4);
     assert(pool.exprs.size() == 4);
-    assert(pool.exprs.count(*e7) == 1);
+    assert(pool.exprs.count(e7) == 1);
     
     // Sequential indices
     for (uint32_t i = 0; i < 100; i++) {
@@ -1625,8 +2106,8 @@ void test_expr_pool_var() {
     const expr* temp2 = pool.var(8888);
     assert(pool.size() == size_before + 2);
     assert(pool.exprs.size() == size_before + 2);
-    assert(pool.exprs.count(*temp1) == 1);
-    assert(pool.exprs.count(*temp2) == 1);
+    assert(pool.exprs.count(temp1) == 1);
+    assert(pool.exprs.count(temp2) == 1);
     t.pop();
     assert(pool.size() == size_before);  // Should be back to original size
     assert(pool.exprs.size() == size_before);
@@ -1637,7 +2118,7 @@ void test_expr_pool_var() {
     size_t checkpoint1 = pool.size();
     assert(var_100 != nullptr);
     assert(pool.exprs.size() == checkpoint1);
-    assert(pool.exprs.count(*var_100) == 1);
+    assert(pool.exprs.count(var_100) == 1);
     
     t.push();  // Frame 2
     const expr* var_100_again = pool.var(100);  // Should return same pointer, no log
@@ -1654,7 +2135,7 @@ void test_expr_pool_var() {
     assert(var_100 == var_100_verify);
     assert(pool.size() == checkpoint1);
     assert(pool.exprs.size() == checkpoint1);
-    assert(pool.exprs.count(*var_100) == 1);
+    assert(pool.exprs.count(var_100) == 1);
     
     t.pop();  // Pop frame 1
     // Now var_100 should be removed
@@ -1698,11 +2179,11 @@ void test_expr_pool_var() {
     
     const expr* early_var_1 = pool.var(500);
     assert(pool.exprs.size() == checkpoint_start + 1);
-    assert(pool.exprs.count(*early_var_1) == 1);
+    assert(pool.exprs.count(early_var_1) == 1);
     
     const expr* early_var_2 = pool.var(501);
     assert(pool.exprs.size() == checkpoint_start + 2);
-    assert(pool.exprs.count(*early_var_2) == 1);
+    assert(pool.exprs.count(early_var_2) == 1);
     
     size_t checkpoint_a = pool.size();
     assert(checkpoint_a == checkpoint_start + 2);
@@ -1713,7 +2194,7 @@ void test_expr_pool_var() {
     
     const expr* mid_var = pool.var(600);
     assert(pool.exprs.size() == checkpoint_a + 1);
-    assert(pool.exprs.count(*mid_var) == 1);
+    assert(pool.exprs.count(mid_var) == 1);
     
     size_t checkpoint_b = pool.size();
     assert(checkpoint_b == checkpoint_a + 1);
@@ -1724,16 +2205,16 @@ void test_expr_pool_var() {
     assert(early_var_1 == early_var_1_again);
     assert(pool.size() == checkpoint_b);  // Size unchanged
     assert(pool.exprs.size() == checkpoint_b);  // Set size also unchanged
-    assert(pool.exprs.count(*early_var_1) == 1);  // Still in set
+    assert(pool.exprs.count(early_var_1) == 1);  // Still in set
     
     // Add more new content in Frame B
     const expr* late_var_1 = pool.var(700);
     assert(pool.exprs.size() == checkpoint_b + 1);
-    assert(pool.exprs.count(*late_var_1) == 1);
+    assert(pool.exprs.count(late_var_1) == 1);
     
     const expr* late_var_2 = pool.var(701);
     assert(pool.exprs.size() == checkpoint_b + 2);
-    assert(pool.exprs.count(*late_var_2) == 1);
+    assert(pool.exprs.count(late_var_2) == 1);
     
     size_t checkpoint_b_final = pool.size();
     assert(checkpoint_b_final == checkpoint_b + 2);
@@ -1746,30 +2227,30 @@ void test_expr_pool_var() {
     const expr* early_var_2_again = pool.var(501);
     assert(early_var_2 == early_var_2_again);
     assert(pool.exprs.size() == checkpoint_b_final);  // No change
-    assert(pool.exprs.count(*early_var_2) == 1);
+    assert(pool.exprs.count(early_var_2) == 1);
     
     const expr* mid_var_again = pool.var(600);
     assert(mid_var == mid_var_again);
     assert(pool.size() == checkpoint_b_final);  // Size unchanged
     assert(pool.exprs.size() == checkpoint_b_final);  // Set size unchanged
-    assert(pool.exprs.count(*mid_var) == 1);
+    assert(pool.exprs.count(mid_var) == 1);
     
     // Add new content in Frame C
     const expr* frame_c_var = pool.var(800);
     assert(pool.exprs.size() == checkpoint_b_final + 1);
-    assert(pool.exprs.count(*frame_c_var) == 1);
+    assert(pool.exprs.count(frame_c_var) == 1);
     
     size_t checkpoint_c = pool.size();
     assert(checkpoint_c == checkpoint_b_final + 1);
     assert(pool.exprs.size() == checkpoint_c);
     
     // Verify all content from all frames is present
-    assert(pool.exprs.count(*early_var_1) == 1);
-    assert(pool.exprs.count(*early_var_2) == 1);
-    assert(pool.exprs.count(*mid_var) == 1);
-    assert(pool.exprs.count(*late_var_1) == 1);
-    assert(pool.exprs.count(*late_var_2) == 1);
-    assert(pool.exprs.count(*frame_c_var) == 1);
+    assert(pool.exprs.count(early_var_1) == 1);
+    assert(pool.exprs.count(early_var_2) == 1);
+    assert(pool.exprs.count(mid_var) == 1);
+    assert(pool.exprs.count(late_var_1) == 1);
+    assert(pool.exprs.count(late_var_2) == 1);
+    assert(pool.exprs.count(frame_c_var) == 1);
     
     // Pop Frame C - only frame_c_var should be removed
     t.pop();
@@ -1779,25 +2260,25 @@ void test_expr_pool_var() {
     // Verify early and mid content still exist
     const expr* verify_early_1 = pool.var(500);
     assert(verify_early_1 == early_var_1);
-    assert(pool.exprs.count(*verify_early_1) == 1);
+    assert(pool.exprs.count(verify_early_1) == 1);
     
     const expr* verify_mid = pool.var(600);
     assert(verify_mid == mid_var);
-    assert(pool.exprs.count(*verify_mid) == 1);
+    assert(pool.exprs.count(verify_mid) == 1);
     
     const expr* verify_late_1 = pool.var(700);
     assert(verify_late_1 == late_var_1);
-    assert(pool.exprs.count(*verify_late_1) == 1);
+    assert(pool.exprs.count(verify_late_1) == 1);
     
     assert(pool.size() == checkpoint_b_final);  // Still unchanged
     assert(pool.exprs.size() == checkpoint_b_final);
     
     // Verify all Frame A and Frame B content is still present
-    assert(pool.exprs.count(*early_var_1) == 1);
-    assert(pool.exprs.count(*early_var_2) == 1);
-    assert(pool.exprs.count(*mid_var) == 1);
-    assert(pool.exprs.count(*late_var_1) == 1);
-    assert(pool.exprs.count(*late_var_2) == 1);
+    assert(pool.exprs.count(early_var_1) == 1);
+    assert(pool.exprs.count(early_var_2) == 1);
+    assert(pool.exprs.count(mid_var) == 1);
+    assert(pool.exprs.count(late_var_1) == 1);
+    assert(pool.exprs.count(late_var_2) == 1);
     
     // Pop Frame B - should remove mid_var, late_var_1, late_var_2 but NOT early vars
     t.pop();
@@ -1807,18 +2288,18 @@ void test_expr_pool_var() {
     // Verify early content still exists
     const expr* verify_early_1_after_b = pool.var(500);
     assert(verify_early_1_after_b == early_var_1);
-    assert(pool.exprs.count(*verify_early_1_after_b) == 1);
+    assert(pool.exprs.count(verify_early_1_after_b) == 1);
     
     const expr* verify_early_2_after_b = pool.var(501);
     assert(verify_early_2_after_b == early_var_2);
-    assert(pool.exprs.count(*verify_early_2_after_b) == 1);
+    assert(pool.exprs.count(verify_early_2_after_b) == 1);
     
     assert(pool.size() == checkpoint_a);  // Still unchanged
     assert(pool.exprs.size() == checkpoint_a);
     
     // Verify only Frame A content remains
-    assert(pool.exprs.count(*early_var_1) == 1);
-    assert(pool.exprs.count(*early_var_2) == 1);
+    assert(pool.exprs.count(early_var_1) == 1);
+    assert(pool.exprs.count(early_var_2) == 1);
     
     // Pop Frame A - should remove early vars
     t.pop();
@@ -1832,6 +2313,47 @@ void test_expr_pool_var() {
     assert(pool.exprs.empty());
 }
 
+void test_expr_pool_integer() {
+    trail t;
+    expr_pool pool(t);
+
+    t.push();
+
+    // Basic integer creation
+    const expr* e1 = pool.integer(5);
+    assert(e1 != nullptr);
+    assert(std::holds_alternative<expr::integer>(e1->content));
+    assert(std::get<expr::integer>(e1->content).value == 5);
+    assert(pool.size() == 1);
+
+    // Interning - same value should return same pointer
+    assert(pool.integer(5) == e1);
+    assert(pool.size() == 1);
+
+    // Different values, including negatives and extremes
+    const expr* e2 = pool.integer(-5);
+    const expr* e3 = pool.integer(INT64_MAX);
+    const expr* e4 = pool.integer(INT64_MIN);
+    assert(e2 != e1);
+    assert(e3 != e4);
+    assert(pool.size() == 4);
+
+    // Integers never collide with vars or numeric atoms
+    assert(pool.var(5) != e1);
+    assert(pool.functor("5") != e1);
+    assert(pool.size() == 6);
+
+    // Integers are usable as functor arguments
+    const expr* f = pool.functor("f", {e1, e2});
+    assert(std::get<expr::functor>(f->content).args[0] == e1);
+    assert(std::get<expr::functor>(f->content).args[1] == e2);
+
+    // Popping the frame discards them like any other node
+    t.pop();
+    assert(pool.size() == 0);
+    assert(pool.exprs.empty());
+}
+
 void test_expr_pool_functor_cons() {
     trail t;
     expr_pool pool(t);
@@ -1852,7 +2374,7 @@ void test_expr_pool_functor_cons() {
     assert(cons1.args[1] == right);
     assert(pool.size() == 3);  // left, right, cons
     assert(pool.exprs.size() == 3);
-    assert(pool.exprs.count(*c1) == 1);
+    assert(pool.exprs.count(c1) == 1);
     
     // Interning - same cons should return same pointer
     const expr* c2 = pool.functor("cons", {left, right});
@@ -1865,7 +2387,7 @@ void test_expr_pool_functor_cons() {
     assert(c1 != c3);
     assert(pool.size() == 4);
     assert(pool.exprs.size() == 4);
-    assert(pool.exprs.count(*c3) == 1);
+    assert(pool.exprs.count(c3) == 1);
     
     // Cons with variables
     const expr* v1 = pool.var(10);
@@ -1877,13 +2399,13 @@ void test_expr_pool_functor_cons() {
     assert(c4 == c5);
     assert(pool.size() == 7);  // v1, v2, cons(v1,v2)
     assert(pool.exprs.size() == 7);
-    assert(pool.exprs.count(*c4) == 1);
+    assert(pool.exprs.count(c4) == 1);
     
     // Nested cons
     const expr* inner = pool.functor("cons", {pool.functor("a", {}), pool.functor("b", {})});
-    assert(pool.exprs.count(*inner) == 1);
+    assert(pool.exprs.count(inner) == 1);
     const expr* outer = pool.functor("cons", {inner, pool.functor("c", {})});
-    assert(pool.exprs.count(*outer) == 1);
+    assert(pool.exprs.count(outer) == 1);
     const expr* outer2 = pool.functor("cons", {inner, pool.functor("c", {})});
     assert(outer == outer2);
     size_t size_after_nested = pool.size();
@@ -1892,7 +2414,7 @@ void test_expr_pool_functor_cons() {
     // Same expr on both sides
     const expr* same = pool.functor("same", {});
     const expr* c6 = pool.functor("cons", {same, same});
-    assert(pool.exprs.count(*c6) == 1);
+    assert(pool.exprs.count(c6) == 1);
     const expr* c7 = pool.functor("cons", {same, same});
     assert(c6 == c7);
     assert(pool.size() == size_after_nested + 2);  // same, cons(same,same)
@@ -1900,11 +2422,11 @@ void test_expr_pool_functor_cons() {
     
     // Deep nesting with interning
     const expr* d1 = pool.functor("cons", {pool.functor("x", {}), pool.functor("y", {})});
-    assert(pool.exprs.count(*d1) == 1);
+    assert(pool.exprs.count(d1) == 1);
     const expr* d2 = pool.functor("cons", {d1, d1});
-    assert(pool.exprs.count(*d2) == 1);
+    assert(pool.exprs.count(d2) == 1);
     const expr* d3 = pool.functor("cons", {d2, d2});
-    assert(pool.exprs.count(*d3) == 1);
+    assert(pool.exprs.count(d3) == 1);
     
     const expr* d1_dup = pool.functor("cons", {pool.functor("x", {}), pool.functor("y", {})});
     const expr* d2_dup = pool.functor("cons", {d1_dup, d1_dup});
@@ -1991,15 +2513,15 @@ void test_expr_pool_functor_cons() {
     
     const expr* early_atom_1 = pool.functor("early_atom_1", {});
     assert(pool.exprs.size() == checkpoint_start + 1);
-    assert(pool.exprs.count(*early_atom_1) == 1);
+    assert(pool.exprs.count(early_atom_1) == 1);
     
     const expr* early_atom_2 = pool.functor("early_atom_2", {});
     assert(pool.exprs.size() == checkpoint_start + 2);
-    assert(pool.exprs.count(*early_atom_2) == 1);
+    assert(pool.exprs.count(early_atom_2) == 1);
     
     const expr* early_cons = pool.functor("cons", {early_atom_1, early_atom_2});
     assert(pool.exprs.size() == checkpoint_start + 3);
-    assert(pool.exprs.count(*early_cons) == 1);
+    assert(pool.exprs.count(early_cons) == 1);
     
     size_t checkpoint_a = pool.size();
     assert(checkpoint_a == checkpoint_start + 3);
@@ -2010,11 +2532,11 @@ void test_expr_pool_functor_cons() {
     
     const expr* mid_atom = pool.functor("mid_atom", {});
     assert(pool.exprs.size() == checkpoint_a + 1);
-    assert(pool.exprs.count(*mid_atom) == 1);
+    assert(pool.exprs.count(mid_atom) == 1);
     
     const expr* mid_cons = pool.functor("cons", {early_atom_1, mid_atom});  // Uses early_atom_1
     assert(pool.exprs.size() == checkpoint_a + 2);
-    assert(pool.exprs.count(*mid_cons) == 1);
+    assert(pool.exprs.count(mid_cons) == 1);
     
     size_t checkpoint_b = pool.size();
     assert(checkpoint_b == checkpoint_a + 2);  // mid_atom, mid_cons
@@ -2025,16 +2547,16 @@ void test_expr_pool_functor_cons() {
     assert(early_cons == early_cons_again);
     assert(pool.size() == checkpoint_b);  // Size unchanged
     assert(pool.exprs.size() == checkpoint_b);  // Set size also unchanged
-    assert(pool.exprs.count(*early_cons) == 1);  // Still in set
+    assert(pool.exprs.count(early_cons) == 1);  // Still in set
     
     // Add more new content in Frame B
     const expr* late_atom = pool.functor("late_atom", {});
     assert(pool.exprs.size() == checkpoint_b + 1);
-    assert(pool.exprs.count(*late_atom) == 1);
+    assert(pool.exprs.count(late_atom) == 1);
     
     const expr* late_cons = pool.functor("cons", {late_atom, mid_atom});
     assert(pool.exprs.size() == checkpoint_b + 2);
-    assert(pool.exprs.count(*late_cons) == 1);
+    assert(pool.exprs.count(late_cons) == 1);
     
     size_t checkpoint_b_final = pool.size();
     assert(checkpoint_b_final == checkpoint_b + 2);
@@ -2047,37 +2569,37 @@ void test_expr_pool_functor_cons() {
     const expr* early_cons_again2 = pool.functor("cons", {early_atom_1, early_atom_2});
     assert(early_cons == early_cons_again2);
     assert(pool.exprs.size() == checkpoint_b_final);  // No change
-    assert(pool.exprs.count(*early_cons) == 1);
+    assert(pool.exprs.count(early_cons) == 1);
     
     const expr* mid_cons_again = pool.functor("cons", {early_atom_1, mid_atom});
     assert(mid_cons == mid_cons_again);
     assert(pool.size() == checkpoint_b_final);  // Size unchanged
     assert(pool.exprs.size() == checkpoint_b_final);  // Set size unchanged
-    assert(pool.exprs.count(*mid_cons) == 1);
+    assert(pool.exprs.count(mid_cons) == 1);
     
     // Add new content in Frame C
     const expr* frame_c_atom = pool.functor("frame_c_atom", {});
     assert(pool.exprs.size() == checkpoint_b_final + 1);
-    assert(pool.exprs.count(*frame_c_atom) == 1);
+    assert(pool.exprs.count(frame_c_atom) == 1);
     
     const expr* frame_c_cons = pool.functor("cons", {frame_c_atom, early_atom_1});
     assert(pool.exprs.size() == checkpoint_b_final + 2);
-    assert(pool.exprs.count(*frame_c_cons) == 1);
+    assert(pool.exprs.count(frame_c_cons) == 1);
     
     size_t checkpoint_c = pool.size();
     assert(checkpoint_c == checkpoint_b_final + 2);
     assert(pool.exprs.size() == checkpoint_c);
     
     // Verify all content from all frames is present
-    assert(pool.exprs.count(*early_atom_1) == 1);
-    assert(pool.exprs.count(*early_atom_2) == 1);
-    assert(pool.exprs.count(*early_cons) == 1);
-    assert(pool.exprs.count(*mid_atom) == 1);
-    assert(pool.exprs.count(*mid_cons) == 1);
-    assert(pool.exprs.count(*late_atom) == 1);
-    assert(pool.exprs.count(*late_cons) == 1);
-    assert(pool.exprs.count(*frame_c_atom) == 1);
-    assert(pool.exprs.count(*frame_c_cons) == 1);
+    assert(pool.exprs.count(early_atom_1) == 1);
+    assert(pool.exprs.count(early_atom_2) == 1);
+    assert(pool.exprs.count(early_cons) == 1);
+    assert(pool.exprs.count(mid_atom) == 1);
+    assert(pool.exprs.count(mid_cons) == 1);
+    assert(pool.exprs.count(late_atom) == 1);
+    assert(pool.exprs.count(late_cons) == 1);
+    assert(pool.exprs.count(frame_c_atom) == 1);
+    assert(pool.exprs.count(frame_c_cons) == 1);
     
     // Pop Frame C - only frame_c_atom and frame_c_cons should be removed
     t.pop();
@@ -2087,23 +2609,23 @@ void test_expr_pool_functor_cons() {
     // Verify early and mid content still exist
     const expr* verify_early_cons = pool.functor("cons", {early_atom_1, early_atom_2});
     assert(verify_early_cons == early_cons);
-    assert(pool.exprs.count(*verify_early_cons) == 1);
+    assert(pool.exprs.count(verify_early_cons) == 1);
     
     const expr* verify_mid_cons = pool.functor("cons", {early_atom_1, mid_atom});
     assert(verify_mid_cons == mid_cons);
-    assert(pool.exprs.count(*verify_mid_cons) == 1);
+    assert(pool.exprs.count(verify_mid_cons) == 1);
     
     assert(pool.size() == checkpoint_b_final);  // Still unchanged
     assert(pool.exprs.size() == checkpoint_b_final);
     
     // Verify all Frame A and Frame B content is still present
-    assert(pool.exprs.count(*early_atom_1) == 1);
-    assert(pool.exprs.count(*early_atom_2) == 1);
-    assert(pool.exprs.count(*early_cons) == 1);
-    assert(pool.exprs.count(*mid_atom) == 1);
-    assert(pool.exprs.count(*mid_cons) == 1);
-    assert(pool.exprs.count(*late_atom) == 1);
-    assert(pool.exprs.count(*late_cons) == 1);
+    assert(pool.exprs.count(early_atom_1) == 1);
+    assert(pool.exprs.count(early_atom_2) == 1);
+    assert(pool.exprs.count(early_cons) == 1);
+    assert(pool.exprs.count(mid_atom) == 1);
+    assert(pool.exprs.count(mid_cons) == 1);
+    assert(pool.exprs.count(late_atom) == 1);
+    assert(pool.exprs.count(late_cons) == 1);
     
     // Pop Frame B - should remove mid_atom, mid_cons, late_atom, late_cons but NOT early content
     t.pop();
@@ -2113,15 +2635,15 @@ void test_expr_pool_functor_cons() {
     // Verify early content still exists
     const expr* verify_early_cons_after_b = pool.functor("cons", {early_atom_1, early_atom_2});
     assert(verify_early_cons_after_b == early_cons);
-    assert(pool.exprs.count(*verify_early_cons_after_b) == 1);
+    assert(pool.exprs.count(verify_early_cons_after_b) == 1);
     
     assert(pool.size() == checkpoint_a);  // Still unchanged
     assert(pool.exprs.size() == checkpoint_a);
     
     // Verify only Frame A content remains
-    assert(pool.exprs.count(*early_atom_1) == 1);
-    assert(pool.exprs.count(*early_atom_2) == 1);
-    assert(pool.exprs.count(*early_cons) == 1);
+    assert(pool.exprs.count(early_atom_1) == 1);
+    assert(pool.exprs.count(early_atom_2) == 1);
+    assert(pool.exprs.count(early_cons) == 1);
     
     // Pop Frame A - should remove early atoms and cons
     t.pop();
@@ -2142,13 +2664,13 @@ void test_expr_pool_import() {
         trail t;
         expr_pool pool(t);
         t.push();
-        expr stack_atom{expr::functor{"hello", {}}};
+        expr stack_atom{expr::functor{symbols().intern("hello", 0), {}}};
         const expr* imported = pool.import(&stack_atom);
         assert(imported != nullptr);
         assert(imported != &stack_atom);
         assert(std::holds_alternative<expr::functor>(imported->content));
-        assert(std::get<expr::functor>(imported->content).name == "hello");
-        assert(pool.exprs.count(*imported) == 1);
+        assert(symbols().name(std::get<expr::functor>(imported->content).id) == "hello");
+        assert(pool.exprs.count(imported) == 1);
         assert(pool.size() == 1);
         t.pop();
     }
@@ -2164,7 +2686,7 @@ void test_expr_pool_import() {
         assert(imported != &stack_var);
         assert(std::holds_alternative<expr::var>(imported->content));
         assert(std::get<expr::var>(imported->content).index == 42);
-        assert(pool.exprs.count(*imported) == 1);
+        assert(pool.exprs.count(imported) == 1);
         assert(pool.size() == 1);
         t.pop();
     }
@@ -2178,14 +2700,14 @@ void test_expr_pool_import() {
         const expr* imported0 = pool.import(&stack_var0);
         assert(imported0 != &stack_var0);
         assert(std::get<expr::var>(imported0->content).index == 0);
-        assert(pool.exprs.count(*imported0) == 1);
+        assert(pool.exprs.count(imported0) == 1);
         assert(pool.size() == 1);
 
         expr stack_var_max{expr::var{UINT32_MAX}};
         const expr* imported_max = pool.import(&stack_var_max);
         assert(imported_max != &stack_var_max);
         assert(std::get<expr::var>(imported_max->content).index == UINT32_MAX);
-        assert(pool.exprs.count(*imported_max) == 1);
+        assert(pool.exprs.count(imported_max) == 1);
         assert(pool.size() == 2);
         t.pop();
     }
@@ -2195,9 +2717,10 @@ void test_expr_pool_import() {
         trail t;
         expr_pool pool(t);
         t.push();
-        expr l{expr::functor{"left", {}}};
-        expr r{expr::functor{"right", {}}};
-        expr c{expr::functor{"cons", {&l, &r}}};
+        expr l{expr::functor{symbols().intern("left", 0), {}}};
+        expr r{expr::functor{symbols().intern("right", 0), {}}};
+        const expr* c_args[] = {&l, &r};
+        expr c{expr::functor{symbols().intern("cons", 2), c_args}};
         const expr* imported = pool.import(&c);
         assert(imported != nullptr);
         assert(imported != &c);
@@ -2205,11 +2728,11 @@ void test_expr_pool_import() {
         const expr::functor& ic = std::get<expr::functor>(imported->content);
         assert(ic.args[0] != &l);   // pool copy, not the stack object
         assert(ic.args[1] != &r);
-        assert(pool.exprs.count(*ic.args[0]) == 1);
-        assert(pool.exprs.count(*ic.args[1]) == 1);
-        assert(pool.exprs.count(*imported) == 1);
-        assert(std::get<expr::functor>(ic.args[0]->content).name == "left");
-        assert(std::get<expr::functor>(ic.args[1]->content).name == "right");
+        assert(pool.exprs.count(ic.args[0]) == 1);
+        assert(pool.exprs.count(ic.args[1]) == 1);
+        assert(pool.exprs.count(imported) == 1);
+        assert(symbols().name(std::get<expr::functor>(ic.args[0]->content).id) == "left");
+        assert(symbols().name(std::get<expr::functor>(ic.args[1]->content).id) == "right");
         assert(pool.size() == 3);  // l, r, cons
         t.pop();
     }
@@ -2219,22 +2742,24 @@ void test_expr_pool_import() {
         trail t;
         expr_pool pool(t);
         t.push();
-        expr a{expr::functor{"a", {}}};
+        expr a{expr::functor{symbols().intern("a", 0), {}}};
         expr v{expr::var{1}};
-        expr inner{expr::functor{"cons", {&a, &v}}};
-        expr b{expr::functor{"b", {}}};
-        expr root{expr::functor{"cons", {&inner, &b}}};
+        const expr* inner_args[] = {&a, &v};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        expr b{expr::functor{symbols().intern("b", 0), {}}};
+        const expr* root_args[] = {&inner, &b};
+        expr root{expr::functor{symbols().intern("cons", 2), root_args}};
         const expr* imported = pool.import(&root);
         assert(imported != nullptr);
         assert(pool.size() == 5);  // a, v, inner, b, root
         const expr::functor& rc = std::get<expr::functor>(imported->content);
         const expr::functor& ic = std::get<expr::functor>(rc.args[0]->content);
-        assert(std::get<expr::functor>(ic.args[0]->content).name == "a");
+        assert(symbols().name(std::get<expr::functor>(ic.args[0]->content).id) == "a");
         assert(std::get<expr::var>(ic.args[1]->content).index == 1);
-        assert(std::get<expr::functor>(rc.args[1]->content).name == "b");
-        assert(pool.exprs.count(*rc.args[0]) == 1);
-        assert(pool.exprs.count(*rc.args[1]) == 1);
-        assert(pool.exprs.count(*imported) == 1);
+        assert(symbols().name(std::get<expr::functor>(rc.args[1]->content).id) == "b");
+        assert(pool.exprs.count(rc.args[0]) == 1);
+        assert(pool.exprs.count(rc.args[1]) == 1);
+        assert(pool.exprs.count(imported) == 1);
         t.pop();
     }
 
@@ -2244,15 +2769,16 @@ void test_expr_pool_import() {
         expr_pool pool(t);
         t.push();
         const expr* pool_x = pool.functor("x", {});
-        expr stack_r{expr::functor{"r", {}}};
-        expr stack_c{expr::functor{"cons", {pool_x, &stack_r}}};
+        expr stack_r{expr::functor{symbols().intern("r", 0), {}}};
+        const expr* stack_c_args[] = {pool_x, &stack_r};
+        expr stack_c{expr::functor{symbols().intern("cons", 2), stack_c_args}};
         const expr* imported = pool.import(&stack_c);
         assert(imported != nullptr);
         const expr::functor& ic = std::get<expr::functor>(imported->content);
         assert(ic.args[0] == pool_x);       // pool LHS pointer is preserved exactly
         assert(ic.args[1] != &stack_r);     // stack RHS got a fresh pool pointer
-        assert(pool.exprs.count(*ic.args[1]) == 1);
-        assert(std::get<expr::functor>(ic.args[1]->content).name == "r");
+        assert(pool.exprs.count(ic.args[1]) == 1);
+        assert(symbols().name(std::get<expr::functor>(ic.args[1]->content).id) == "r");
         assert(pool.size() == 3);  // pool_x + stack_r atom + cons
         t.pop();
     }
@@ -2263,14 +2789,15 @@ void test_expr_pool_import() {
         expr_pool pool(t);
         t.push();
         const expr* pool_y = pool.functor("y", {});
-        expr stack_l{expr::functor{"l", {}}};
-        expr stack_c{expr::functor{"cons", {&stack_l, pool_y}}};
+        expr stack_l{expr::functor{symbols().intern("l", 0), {}}};
+        const expr* stack_c_args[] = {&stack_l, pool_y};
+        expr stack_c{expr::functor{symbols().intern("cons", 2), stack_c_args}};
         const expr* imported = pool.import(&stack_c);
         assert(imported != nullptr);
         const expr::functor& ic = std::get<expr::functor>(imported->content);
         assert(ic.args[0] != &stack_l);     // stack LHS got a fresh pool pointer
         assert(ic.args[1] == pool_y);       // pool RHS pointer is preserved exactly
-        assert(pool.exprs.count(*ic.args[0]) == 1);
+        assert(pool.exprs.count(ic.args[0]) == 1);
         assert(pool.size() == 3);  // pool_y + stack_l atom + cons
         t.pop();
     }
@@ -2283,14 +2810,15 @@ void test_expr_pool_import() {
         const expr* pool_p = pool.functor("p", {});
         const expr* pool_q = pool.functor("q", {});
         const expr* pool_inner = pool.functor("cons", {pool_p, pool_q});
-        expr stack_r{expr::functor{"r", {}}};
-        expr stack_outer{expr::functor{"cons", {pool_inner, &stack_r}}};
+        expr stack_r{expr::functor{symbols().intern("r", 0), {}}};
+        const expr* stack_outer_args[] = {pool_inner, &stack_r};
+        expr stack_outer{expr::functor{symbols().intern("cons", 2), stack_outer_args}};
         const expr* imported = pool.import(&stack_outer);
         assert(imported != nullptr);
         const expr::functor& oc = std::get<expr::functor>(imported->content);
         assert(oc.args[0] == pool_inner);   // inner cons pointer is preserved exactly
         assert(oc.args[1] != &stack_r);
-        assert(pool.exprs.count(*oc.args[1]) == 1);
+        assert(pool.exprs.count(oc.args[1]) == 1);
         assert(pool.size() == 5);  // p, q, inner, stack_r atom, outer cons
         t.pop();
     }
@@ -2340,7 +2868,7 @@ void test_expr_pool_import() {
         expr_pool pool(t);
         t.push();
         const expr* pool_dup = pool.functor("dup", {});
-        expr stack_dup{expr::functor{"dup", {}}};
+        expr stack_dup{expr::functor{symbols().intern("dup", 0), {}}};
         const expr* imported = pool.import(&stack_dup);
         assert(imported == pool_dup);   // must return pool pointer, not &stack_dup
         assert(pool.size() == 1);       // pool must not grow
@@ -2355,9 +2883,10 @@ void test_expr_pool_import() {
         const expr* pa = pool.functor("a", {});
         const expr* pb = pool.functor("b", {});
         const expr* pc = pool.functor("cons", {pa, pb});
-        expr stack_a{expr::functor{"a", {}}};
-        expr stack_b{expr::functor{"b", {}}};
-        expr stack_c{expr::functor{"cons", {&stack_a, &stack_b}}};
+        expr stack_a{expr::functor{symbols().intern("a", 0), {}}};
+        expr stack_b{expr::functor{symbols().intern("b", 0), {}}};
+        const expr* stack_c_args[] = {&stack_a, &stack_b};
+        expr stack_c{expr::functor{symbols().intern("cons", 2), stack_c_args}};
         const expr* imported = pool.import(&stack_c);
         assert(imported == pc);         // must deduplicate to the existing pool pointer
         assert(pool.size() == 3);
@@ -2370,32 +2899,36 @@ void test_expr_pool_import() {
         trail t;
         expr_pool pool(t);
         t.push();
-        expr d0{expr::functor{"d0", {}}};
+        expr d0{expr::functor{symbols().intern("d0", 0), {}}};
         expr x0{expr::var{0}};
-        expr ll{expr::functor{"cons", {&d0, &x0}}};
+        const expr* ll_args[] = {&d0, &x0};
+        expr ll{expr::functor{symbols().intern("cons", 2), ll_args}};
         expr x1{expr::var{1}};
-        expr d1{expr::functor{"d1", {}}};
-        expr lr{expr::functor{"cons", {&x1, &d1}}};
-        expr l{expr::functor{"cons", {&ll, &lr}}};
-        expr d2{expr::functor{"d2", {}}};
-        expr root{expr::functor{"cons", {&l, &d2}}};
+        expr d1{expr::functor{symbols().intern("d1", 0), {}}};
+        const expr* lr_args[] = {&x1, &d1};
+        expr lr{expr::functor{symbols().intern("cons", 2), lr_args}};
+        const expr* l_args[] = {&ll, &lr};
+        expr l{expr::functor{symbols().intern("cons", 2), l_args}};
+        expr d2{expr::functor{symbols().intern("d2", 0), {}}};
+        const expr* root_args[] = {&l, &d2};
+        expr root{expr::functor{symbols().intern("cons", 2), root_args}};
         const expr* imported = pool.import(&root);
         assert(imported != nullptr);
         assert(pool.size() == 9);
         const expr::functor& rc = std::get<expr::functor>(imported->content);
-        assert(std::get<expr::functor>(rc.args[1]->content).name == "d2");
-        assert(pool.exprs.count(*rc.args[1]) == 1);
+        assert(symbols().name(std::get<expr::functor>(rc.args[1]->content).id) == "d2");
+        assert(pool.exprs.count(rc.args[1]) == 1);
         const expr::functor& lc = std::get<expr::functor>(rc.args[0]->content);
-        assert(pool.exprs.count(*rc.args[0]) == 1);
+        assert(pool.exprs.count(rc.args[0]) == 1);
         const expr::functor& llc = std::get<expr::functor>(lc.args[0]->content);
-        assert(pool.exprs.count(*lc.args[0]) == 1);
-        assert(std::get<expr::functor>(llc.args[0]->content).name == "d0");
+        assert(pool.exprs.count(lc.args[0]) == 1);
+        assert(symbols().name(std::get<expr::functor>(llc.args[0]->content).id) == "d0");
         assert(std::get<expr::var>(llc.args[1]->content).index == 0);
         const expr::functor& lrc = std::get<expr::functor>(lc.args[1]->content);
-        assert(pool.exprs.count(*lc.args[1]) == 1);
+        assert(pool.exprs.count(lc.args[1]) == 1);
         assert(std::get<expr::var>(lrc.args[0]->content).index == 1);
-        assert(std::get<expr::functor>(lrc.args[1]->content).name == "d1");
-        assert(pool.exprs.count(*imported) == 1);
+        assert(symbols().name(std::get<expr::functor>(lrc.args[1]->content).id) == "d1");
+        assert(pool.exprs.count(imported) == 1);
         t.pop();
     }
 
@@ -2405,7 +2938,8 @@ void test_expr_pool_import() {
         expr_pool pool(t);
         t.push();
         const expr* pool_s = pool.functor("s", {});
-        expr stack_c{expr::functor{"cons", {pool_s, pool_s}}};
+        const expr* stack_c_args[] = {pool_s, pool_s};
+        expr stack_c{expr::functor{symbols().intern("cons", 2), stack_c_args}};
         const expr* imported = pool.import(&stack_c);
         assert(imported != nullptr);
         const expr::functor& ic = std::get<expr::functor>(imported->content);
@@ -2421,7 +2955,7 @@ void test_expr_pool_import() {
         expr_pool pool(t);
         t.push();
         t.push();
-        expr stack_atom{expr::functor{"trail_atom", {}}};
+        expr stack_atom{expr::functor{symbols().intern("trail_atom", 0), {}}};
         const expr* imported = pool.import(&stack_atom);
         assert(imported != nullptr);
         assert(pool.size() == 1);
@@ -2438,8 +2972,9 @@ void test_expr_pool_import() {
         const expr* outer_atom = pool.functor("outer", {});
         assert(pool.size() == 1);
         t.push();
-        expr stack_inner{expr::functor{"inner", {}}};
-        expr stack_c{expr::functor{"cons", {outer_atom, &stack_inner}}};
+        expr stack_inner{expr::functor{symbols().intern("inner", 0), {}}};
+        const expr* stack_c_args[] = {outer_atom, &stack_inner};
+        expr stack_c{expr::functor{symbols().intern("cons", 2), stack_c_args}};
         const expr* imported = pool.import(&stack_c);
         assert(imported != nullptr);
         const expr::functor& ic = std::get<expr::functor>(imported->content);
@@ -2448,7 +2983,7 @@ void test_expr_pool_import() {
         t.pop();
         // inner atom and cons were rolled back; outer_atom must survive
         assert(pool.size() == 1);
-        assert(pool.exprs.count(*outer_atom) == 1);
+        assert(pool.exprs.count(outer_atom) == 1);
         t.pop();
     }
 
@@ -2478,14 +3013,14 @@ void test_expr_pool_import() {
         trail t;
         expr_pool pool(t);
         t.push();
-        expr stack_e1{expr::functor{"e1", {}}};
-        expr stack_e2{expr::functor{"e2", {}}};
+        expr stack_e1{expr::functor{symbols().intern("e1", 0), {}}};
+        expr stack_e2{expr::functor{symbols().intern("e2", 0), {}}};
 
         // Deliberately construct a cons in the pool whose children are stack pointers
         const expr* pool_cons_bad = pool.functor("cons", {&stack_e1, &stack_e2});
-        assert(pool.exprs.count(*pool_cons_bad) == 1);  // cons is in pool
-        assert(pool.exprs.count(stack_e1) == 0);        // but children are NOT
-        assert(pool.exprs.count(stack_e2) == 0);
+        assert(pool.exprs.count(pool_cons_bad) == 1);  // cons is in pool
+        assert(pool.exprs.count(&stack_e1) == 0);        // but children are NOT
+        assert(pool.exprs.count(&stack_e2) == 0);
         assert(pool.size() == 1);
 
         const expr* imported = pool.import(pool_cons_bad);
@@ -2494,12 +3029,12 @@ void test_expr_pool_import() {
         // was already in the set; result must be a fully-interned cons
         assert(imported != nullptr);
         const expr::functor& ic = std::get<expr::functor>(imported->content);
-        assert(pool.exprs.count(*ic.args[0]) == 1);  // e1 now in pool
-        assert(pool.exprs.count(*ic.args[1]) == 1);  // e2 now in pool
+        assert(pool.exprs.count(ic.args[0]) == 1);  // e1 now in pool
+        assert(pool.exprs.count(ic.args[1]) == 1);  // e2 now in pool
         assert(ic.args[0] != &stack_e1);              // pool pointer, not stack
         assert(ic.args[1] != &stack_e2);
-        assert(std::get<expr::functor>(ic.args[0]->content).name == "e1");
-        assert(std::get<expr::functor>(ic.args[1]->content).name == "e2");
+        assert(symbols().name(std::get<expr::functor>(ic.args[0]->content).id) == "e1");
+        assert(symbols().name(std::get<expr::functor>(ic.args[1]->content).id) == "e2");
         // pool has: pool_cons_bad (with stack children) + e1 + e2 + proper cons
         assert(pool.size() == 4);
         t.pop();
@@ -2511,10 +3046,12 @@ void test_expr_pool_import() {
         trail t;
         expr_pool pool(t);
         t.push();
-        expr a{expr::functor{"a", {}}};
+        expr a{expr::functor{symbols().intern("a", 0), {}}};
         // &a appears as both children of inner, and again as the rhs of root
-        expr inner{expr::functor{"cons", {&a, &a}}};
-        expr root{expr::functor{"cons", {&inner, &a}}};
+        const expr* inner_args[] = {&a, &a};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* root_args[] = {&inner, &a};
+        expr root{expr::functor{symbols().intern("cons", 2), root_args}};
         const expr* imported = pool.import(&root);
         assert(imported != nullptr);
         // Only 3 pool entries: atom "a", cons(a,a), root cons
@@ -2524,7 +3061,7 @@ void test_expr_pool_import() {
         // All four leaf references resolve to the exact same pool pointer
         assert(ic.args[0] == ic.args[1]);
         assert(ic.args[0] == rc.args[1]);
-        assert(pool.exprs.count(*ic.args[0]) == 1);
+        assert(pool.exprs.count(ic.args[0]) == 1);
         t.pop();
     }
 
@@ -2534,14 +3071,15 @@ void test_expr_pool_import() {
         trail t;
         expr_pool pool(t);
         t.push();
-        expr a{expr::functor{"a", {}}};
-        expr c{expr::functor{"cons", {&a, &a}}}; 
+        expr a{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* c_args[] = {&a, &a};
+        expr c{expr::functor{symbols().intern("cons", 2), c_args}}; 
         const expr* imported = pool.import(&c);
         assert(imported != nullptr);
         assert(pool.size() == 2);  // atom "a" + cons, not 3
         const expr::functor& ic = std::get<expr::functor>(imported->content);
         assert(ic.args[0] == ic.args[1]);  // both sides are the same pool pointer
-        assert(pool.exprs.count(*ic.args[0]) == 1);
+        assert(pool.exprs.count(ic.args[0]) == 1);
         t.pop();
     }
 
@@ -2565,118 +3103,585 @@ void test_expr_pool_import() {
         const expr::functor& c = std::get<expr::functor>(p2_cons->content);
         assert(c.args[0] != p1_atom);           // pool2 pointer, not pool1's
         assert(c.args[1] != p1_var);
-        assert(pool2.exprs.count(*c.args[0]) == 1);
-        assert(pool2.exprs.count(*c.args[1]) == 1);
-        assert(pool2.exprs.count(*p2_cons) == 1);
-        assert(std::get<expr::functor>(c.args[0]->content).name == "x");
+        assert(pool2.exprs.count(c.args[0]) == 1);
+        assert(pool2.exprs.count(c.args[1]) == 1);
+        assert(pool2.exprs.count(p2_cons) == 1);
+        assert(symbols().name(std::get<expr::functor>(c.args[0]->content).id) == "x");
         assert(std::get<expr::var>(c.args[1]->content).index == 5);
         // pool1 is unaffected
         assert(pool1.size() == 3);
         t1.pop();
         t2.pop();
     }
+
+    // Terms owned by the base are returned as-is, without walking them
+    {
+        trail t;
+        expr_pool base(t);
+        const expr* g = base.functor("g", {base.functor("a"), base.integer(3)});
+        base.freeze();
+        expr_pool overlay(t, &base);
+        assert(overlay.import(g) == g);
+        assert(overlay.size() == 0);
+        const expr* h = overlay.functor("h", {g, overlay.var(0)});
+        assert(overlay.import(h) == h);
+        assert(overlay.size() == 2);
+
+        // a structurally equal term from an unrelated pool maps onto the base node
+        expr_pool other(t);
+        assert(overlay.import(other.functor("g", {other.functor("a"), other.integer(3)})) == g);
+        assert(overlay.size() == 2);
+    }
+
+    // Deep terms are imported without recursion
+    {
+        trail t;
+        expr_pool src(t);
+        expr_pool dst(t);
+        const expr* deep = src.var(3);
+        for (int i = 0; i < 200000; ++i)
+            deep = src.functor("s", {deep, src.integer(i)});
+        const expr* imported = dst.import(deep);
+        assert(imported != deep);
+        assert(!imported->meta.ground);
+        assert(dst.import(imported) == imported);
+        assert(dst.size() == src.size());
+    }
 }
 
-void test_bind_map_bind() {
-    // bind() is the fundamental function for managing bindings with trail support
-    // It tracks all changes to the bindings map and logs rollback operations
-    // Tests verify: new bindings, updates, no-op optimization, trail integration
-    
-    // ========== BASIC BIND OPERATIONS ==========
-    
-    // Test 1: Bind new entry - should insert and log erase
+void test_expr_pool_intern() {
+    // Functor args are stored inline, directly after the node
     {
         trail t;
-        bind_map bm(t);
+        expr_pool pool(t);
         t.push();
-        
-        expr a1{expr::functor{"test", {}}};
-        bm.bind(0, &a1);
-        
-        assert(bm.bindings.size() == 1);
-        assert(bm.bindings.count(0) == 1);
-        assert(bm.bindings.at(0) == &a1);
-        
-        // Pop should erase the entry
+        const expr* a = pool.functor("a");
+        const expr* b = pool.functor("b");
+        const expr* c = pool.functor("f", {a, b});
+        const expr::functor& cf = std::get<expr::functor>(c->content);
+        assert(cf.args.size() == 2);
+        assert(cf.args[0] == a);
+        assert(cf.args[1] == b);
+        assert(static_cast<const void*>(cf.args.data()) == static_cast<const void*>(c + 1));
         t.pop();
-        assert(bm.bindings.size() == 0);
-        assert(bm.bindings.count(0) == 0);
     }
-    
-    // Test 2: Bind multiple new entries
+
+    // Args are copied, so the caller's vector may go away
     {
         trail t;
-        bind_map bm(t);
+        expr_pool pool(t);
         t.push();
-        
-        expr a1{expr::functor{"first", {}}};
-        expr a2{expr::functor{"second", {}}};
-        expr a3{expr::functor{"third", {}}};
-        
-        bm.bind(0, &a1);
-        bm.bind(1, &a2);
-        bm.bind(2, &a3);
-        
-        assert(bm.bindings.size() == 3);
-        assert(bm.bindings.at(0) == &a1);
-        assert(bm.bindings.at(1) == &a2);
-        assert(bm.bindings.at(2) == &a3);
-        
-        // Pop should erase all entries
+        const expr* a = pool.functor("a");
+        const expr* c;
+        {
+            std::vector<const expr*> args = {a, a, a};
+            c = pool.functor("g", args);
+            args[0] = nullptr;
+        }
+        const expr::functor& cf = std::get<expr::functor>(c->content);
+        assert(cf.args.size() == 3);
+        assert(cf.args[0] == a);
+        assert(pool.functor("g", {a, a, a}) == c);
         t.pop();
-        assert(bm.bindings.size() == 0);
     }
-    
-    // Test 3: Update existing entry - should log old value
+
+    // Only one undo entry is logged per trail frame, however many nodes are interned
     {
         trail t;
-        bind_map bm(t);
-        
-        // Frame 1: Create initial binding
+        expr_pool pool(t);
         t.push();
-        expr a1{expr::functor{"old", {}}};
-        bm.bind(5, &a1);
-        assert(bm.bindings.at(5) == &a1);
-        assert(bm.bindings.size() == 1);
-        
-        // Frame 2: Update to new value
+        assert(t.undo_stack.size() == 0);
+        pool.functor("a");
+        assert(t.undo_stack.size() == 1);
+        pool.functor("b");
+        pool.var(0);
+        pool.functor("f", {pool.var(1)});
+        assert(t.undo_stack.size() == 1);
+        assert(pool.size() == 5);
+        assert(pool.logged_depth == 1);
+
+        // a nested frame gets its own watermark
         t.push();
-        expr a2{expr::functor{"new", {}}};
-        bm.bind(5, &a2);
-        assert(bm.bindings.size() == 1);
-        assert(bm.bindings.at(5) == &a2);
-        
-        // Pop Frame 2: should restore old value
+        pool.functor("c");
+        assert(t.undo_stack.size() == 2);
+        pool.functor("d");
+        assert(t.undo_stack.size() == 2);
+        assert(pool.logged_depth == 2);
+        assert(pool.size() == 7);
+
+        // an intern that hits an existing node logs nothing
+        t.push();
+        pool.functor("a");
+        assert(t.undo_stack.size() == 2);
+        assert(pool.logged_depth == 2);
         t.pop();
-        assert(bm.bindings.size() == 1);
-        assert(bm.bindings.at(5) == &a1);  // Restored to old value
-        
-        // Pop Frame 1: should remove entry
+
         t.pop();
-        assert(bm.bindings.size() == 0);
+        assert(pool.size() == 5);
+        assert(pool.logged_depth == 1);
+
+        // re-entering the same depth logs a fresh watermark
+        t.push();
+        pool.functor("e");
+        assert(t.undo_stack.size() == 2);
+        t.pop();
+        assert(pool.size() == 5);
+
+        t.pop();
+        assert(pool.size() == 0);
+        assert(pool.exprs.empty());
+        assert(pool.logged_depth == std::numeric_limits<size_t>::max());
     }
-    
-    // Test 4: No-op optimization - binding same value twice
+
+    // Interning with no frame open logs a single entry that is never undone
     {
         trail t;
-        bind_map bm(t);
+        expr_pool pool(t);
+        pool.functor("a");
+        pool.functor("b");
+        assert(t.undo_stack.size() == 1);
+        assert(pool.logged_depth == 0);
         t.push();
-        
-        expr a1{expr::functor{"same", {}}};
-        
-        bm.bind(10, &a1);
-        assert(bm.bindings.at(10) == &a1);
-        assert(bm.bindings.size() == 1);
-        
-        // Check undo stack size after first bind
-        size_t undo_stack_size = t.undo_stack.size();
-        assert(undo_stack_size == 1);  // One undo for the insert
-        
-        // Bind same value again - should be no-op
-        bm.bind(10, &a1);
-        assert(bm.bindings.size() == 1);
-        assert(bm.bindings.at(10) == &a1);
-        
+        pool.functor("c");
+        assert(t.undo_stack.size() == 2);
+        t.pop();
+        assert(pool.size() == 2);
+        assert(t.undo_stack.size() == 1);
+    }
+
+    // Arena memory released by a pop is reused by the next frame
+    {
+        trail t;
+        expr_pool pool(t);
+        t.push();
+        pool.functor("a");
+        t.push();
+        const expr* x1 = pool.functor("x");
+        size_t used = pool.nodes_arena.used();
+        t.pop();
+        assert(pool.nodes_arena.used() < used);
+        t.push();
+        const expr* y1 = pool.functor("y");
+        assert(x1 == y1);
+        assert(pool.nodes_arena.used() == used);
+        t.pop();
+        t.pop();
+    }
+}
+
+void test_expr_pool_annotate() {
+    // Vars are non-ground
+    {
+        trail t;
+        expr_pool pool(t);
+        const expr* v = pool.var(9);
+        assert(!v->meta.ground);
+    }
+
+    // Atoms are ground
+    {
+        trail t;
+        expr_pool pool(t);
+        const expr* a = pool.functor("a");
+        assert(a->meta.ground);
+    }
+
+    // Integers are ground
+    {
+        trail t;
+        expr_pool pool(t);
+        const expr* i = pool.integer(-12);
+        assert(i->meta.ground);
+        assert(pool.functor("f", {i, i})->meta.ground);
+    }
+
+    // A compound is ground exactly when all its args are
+    {
+        trail t;
+        expr_pool pool(t);
+        const expr* a = pool.functor("a");
+        const expr* g = pool.functor("g", {a, a});
+        assert(g->meta.ground);
+
+        const expr* f = pool.functor("f", {pool.var(4), g, pool.functor("h", {pool.var(2)})});
+        assert(!f->meta.ground);
+    }
+
+    // Exprs built outside a pool keep the conservative defaults
+    {
+        expr e{expr::var{5}};
+        assert(!e.meta.ground);
+    }
+
+    // Metadata never affects identity
+    {
+        trail t;
+        expr_pool pool(t);
+        const expr* a = pool.functor("a");
+        expr stack_a{expr::functor{symbols().intern("a", 0), {}}};
+        assert(*a == stack_a);
+        assert((*a <=> stack_a) == 0);
+        assert(pool.exprs.count(&stack_a) == 1);
+    }
+}
+
+void test_expr_pool_truncate() {
+    // Truncating drops the newest nodes from the index and the arena
+    {
+        trail t;
+        expr_pool pool(t);
+        const expr* a = pool.functor("a");
+        const expr* b = pool.functor("b");
+        size_t used = pool.nodes_arena.used();
+        pool.functor("f", {a, b});
+        pool.var(3);
+        assert(pool.size() == 4);
+        pool.truncate(2);
+        assert(pool.size() == 2);
+        assert(pool.exprs.size() == 2);
+        assert(pool.exprs.count(a) == 1);
+        assert(pool.exprs.count(b) == 1);
+        assert(pool.nodes_arena.used() == used);
+        assert(pool.nodes[0] == a);
+        assert(pool.nodes[1] == b);
+    }
+
+    // Truncating to the current size or beyond is a no-op
+    {
+        trail t;
+        expr_pool pool(t);
+        pool.functor("a");
+        pool.truncate(1);
+        assert(pool.size() == 1);
+        pool.truncate(10);
+        assert(pool.size() == 1);
+    }
+
+    // Truncating to zero empties the pool and re-interning starts over
+    {
+        trail t;
+        expr_pool pool(t);
+        const expr* a1 = pool.functor("a");
+        pool.functor("g", {a1});
+        pool.truncate(0);
+        assert(pool.size() == 0);
+        assert(pool.exprs.empty());
+        assert(pool.nodes_arena.used() == 0);
+        const expr* a2 = pool.functor("a");
+        assert(a2 == a1);
+        assert(pool.size() == 1);
+    }
+}
+
+void test_expr_pool_rollback() {
+    // Rolling back truncates and restores the depth of the previous watermark
+    trail t;
+    expr_pool pool(t);
+    const expr* a = pool.functor("a");
+    pool.functor("f", {a});
+    pool.logged_depth = 4;
+    pool.rollback(1, 1);
+    assert(pool.size() == 1);
+    assert(pool.nodes[0] == a);
+    assert(pool.logged_depth == 1);
+
+    // a frozen pool keeps its nodes but still restores the depth
+    pool.freeze();
+    pool.logged_depth = 3;
+    pool.rollback(0, 2);
+    assert(pool.size() == 1);
+    assert(pool.logged_depth == 2);
+}
+
+void test_expr_pool_freeze() {
+    // A frozen pool still finds what it holds but refuses new terms
+    {
+        trail t;
+        expr_pool pool(t);
+        const expr* a = pool.functor("a");
+        const expr* one = pool.integer(1);
+        pool.freeze();
+        assert(pool.functor("a") == a);
+        assert(pool.integer(1) == one);
+        assert(pool.import(a) == a);
+
+        bool threw = false;
+        try { pool.functor("b"); } catch (const std::logic_error&) { threw = true; }
+        assert(threw);
+        threw = false;
+        try { pool.var(0); } catch (const std::logic_error&) { threw = true; }
+        assert(threw);
+        assert(pool.size() == 2);
+    }
+
+    // Popping the frame that built a frozen pool keeps its nodes alive
+    {
+        trail t;
+        expr_pool pool(t);
+        t.push();
+        const expr* g = pool.functor("g", {pool.functor("a")});
+        pool.freeze();
+        t.pop();
+        assert(pool.size() == 2);
+        assert(pool.exprs.count(g) == 1);
+    }
+
+    // Overlays on separate threads share the base without copying it
+    {
+        trail tb;
+        expr_pool base(tb);
+        std::vector<const expr*> facts;
+        for (int i = 0; i < 64; ++i)
+            facts.push_back(base.functor("edge", {base.integer(i), base.integer(i + 1)}));
+        base.freeze();
+        size_t base_size = base.size();
+
+        std::vector<std::thread> workers;
+        std::vector<char> ok(4, false);
+        for (int w = 0; w < 4; ++w) {
+            workers.emplace_back([&, w]() {
+                trail t;
+                expr_pool overlay(t, &base);
+                t.push();
+                bool good = true;
+                for (int i = 0; i < 64; ++i) {
+                    good &= overlay.functor("edge", {overlay.integer(i), overlay.integer(i + 1)}) == facts[i];
+                    good &= !overlay.functor("path", {facts[i], overlay.var(w)})->meta.ground;
+                }
+                good &= overlay.size() == 65;
+                t.pop();
+                good &= overlay.size() == 0;
+                ok[w] = good;
+            });
+        }
+        for (std::thread& th : workers)
+            th.join();
+        for (char b : ok)
+            assert(b);
+        assert(base.size() == base_size);
+    }
+}
+
+void test_expr_pool_frozen() {
+    trail t;
+    expr_pool pool(t);
+    assert(!pool.frozen());
+    pool.freeze();
+    assert(pool.frozen());
+    pool.freeze();
+    assert(pool.frozen());
+
+    // overlays start unfrozen and can be frozen in turn
+    expr_pool overlay(t, &pool);
+    assert(!overlay.frozen());
+    overlay.freeze();
+    assert(overlay.frozen());
+    assert(pool.frozen());
+}
+
+void test_expr_pool_size() {
+    // Counts distinct interned nodes, args included
+    trail t;
+    expr_pool pool(t);
+    assert(pool.size() == 0);
+    const expr* a = pool.functor("a");
+    pool.functor("f", {a, a});
+    pool.functor("f", {a, a});
+    pool.integer(1);
+    assert(pool.size() == 3);
+
+    // an overlay counts its own layer, not the base beneath it
+    pool.freeze();
+    expr_pool overlay(t, &pool);
+    assert(overlay.size() == 0);
+    assert(overlay.functor("a") == a);
+    assert(overlay.size() == 0);
+    overlay.functor("g", {a});
+    assert(overlay.size() == 1);
+    assert(pool.size() == 3);
+}
+
+void test_expr_pool_find() {
+    trail t;
+    expr_pool base(t);
+    const expr* a = base.functor("a");
+    base.freeze();
+    expr_pool mid(t, &base);
+    const expr* b = mid.functor("b");
+    mid.freeze();
+    expr_pool top(t, &mid);
+    const expr* c = top.functor("c");
+
+    // each layer sees itself and everything beneath it, never above
+    expr pa{expr::functor{symbols().intern("a", 0), {}}};
+    expr pb{expr::functor{symbols().intern("b", 0), {}}};
+    expr pc{expr::functor{symbols().intern("c", 0), {}}};
+    expr pd{expr::functor{symbols().intern("d", 0), {}}};
+    assert(top.find(pa) == a);
+    assert(top.find(pb) == b);
+    assert(top.find(pc) == c);
+    assert(mid.find(pa) == a);
+    assert(mid.find(pc) == nullptr);
+    assert(base.find(pb) == nullptr);
+    assert(top.find(pd) == nullptr);
+
+    // a compound over base children is found only where it was interned
+    const expr* fa = top.functor("f", {a});
+    const expr* fa_args[] = {a};
+    expr pfa{expr::functor{symbols().intern("f", 1), fa_args}};
+    assert(top.find(pfa) == fa);
+    assert(mid.find(pfa) == nullptr);
+}
+
+void test_bind_map_binding_array() {
+    expr a{expr::functor{symbols().intern("a", 0), {}}};
+    expr b{expr::functor{symbols().intern("b", 0), {}}};
+
+    // Starts empty; lookups past the end read as unbound
+    bind_map::binding_array ba;
+    assert(ba.empty());
+    assert(ba.size() == 0);
+    assert(ba.get(5) == nullptr);
+    assert(ba.count(5) == 0);
+
+    // Subscript grows the array up to the index, leaving the gap unbound
+    ba[3] = &a;
+    assert(ba.slots.size() == 4);
+    assert(ba.size() == 1);
+    assert(!ba.empty());
+    assert(ba.get(3) == &a);
+    assert(ba.at(3) == &a);
+    assert(ba.count(3) == 1);
+    assert(ba.get(1) == nullptr);
+    assert(ba.count(1) == 0);
+
+    // at() throws for unbound slots, in range or not
+    bool threw = false;
+    try { ba.at(1); } catch (const std::out_of_range&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { ba.at(100); } catch (const std::out_of_range&) { threw = true; }
+    assert(threw);
+
+    // Subscript within range does not grow
+    ba[0] = &b;
+    assert(ba.slots.size() == 4);
+    assert(ba.size() == 2);
+
+    // Equality ignores trailing unbound slots
+    bind_map::binding_array other;
+    other[0] = &b;
+    other[3] = &a;
+    other[9] = nullptr;
+    assert(other.slots.size() == 10);
+    assert(ba == other);
+    other[9] = &a;
+    assert(!(ba == other));
+    other[9] = nullptr;
+    other[3] = &b;
+    assert(!(ba == other));
+}
+
+void test_bind_map_bind() {
+    // bind() is the fundamental function for managing bindings with trail support
+    // It tracks all changes to the bindings map and logs rollback operations
+    // Tests verify: new bindings, updates, no-op optimization, trail integration
+    
+    // ========== BASIC BIND OPERATIONS ==========
+    
+    // Test 1: Bind new entry - should insert and log erase
+    {
+        trail t;
+        bind_map bm(t);
+        t.push();
+        
+        expr a1{expr::functor{symbols().intern("test", 0), {}}};
+        bm.bind(0, &a1);
+        
+        assert(bm.bindings.size() == 1);
+        assert(bm.bindings.count(0) == 1);
+        assert(bm.bindings.at(0) == &a1);
+        
+        // Pop should erase the entry
+        t.pop();
+        assert(bm.bindings.size() == 0);
+        assert(bm.bindings.count(0) == 0);
+    }
+    
+    // Test 2: Bind multiple new entries
+    {
+        trail t;
+        bind_map bm(t);
+        t.push();
+        
+        expr a1{expr::functor{symbols().intern("first", 0), {}}};
+        expr a2{expr::functor{symbols().intern("second", 0), {}}};
+        expr a3{expr::functor{symbols().intern("third", 0), {}}};
+        
+        bm.bind(0, &a1);
+        bm.bind(1, &a2);
+        bm.bind(2, &a3);
+        
+        assert(bm.bindings.size() == 3);
+        assert(bm.bindings.at(0) == &a1);
+        assert(bm.bindings.at(1) == &a2);
+        assert(bm.bindings.at(2) == &a3);
+        
+        // Pop should erase all entries
+        t.pop();
+        assert(bm.bindings.size() == 0);
+    }
+    
+    // Test 3: Update existing entry - should log old value
+    {
+        trail t;
+        bind_map bm(t);
+        
+        // Frame 1: Create initial binding
+        t.push();
+        expr a1{expr::functor{symbols().intern("old", 0), {}}};
+        bm.bind(5, &a1);
+        assert(bm.bindings.at(5) == &a1);
+        assert(bm.bindings.size() == 1);
+        
+        // Frame 2: Update to new value
+        t.push();
+        expr a2{expr::functor{symbols().intern("new", 0), {}}};
+        bm.bind(5, &a2);
+        assert(bm.bindings.size() == 1);
+        assert(bm.bindings.at(5) == &a2);
+        
+        // Pop Frame 2: should restore old value
+        t.pop();
+        assert(bm.bindings.size() == 1);
+        assert(bm.bindings.at(5) == &a1);  // Restored to old value
+        
+        // Pop Frame 1: should remove entry
+        t.pop();
+        assert(bm.bindings.size() == 0);
+    }
+    
+    // Test 4: No-op optimization - binding same value twice
+    {
+        trail t;
+        bind_map bm(t);
+        t.push();
+        
+        expr a1{expr::functor{symbols().intern("same", 0), {}}};
+        
+        bm.bind(10, &a1);
+        assert(bm.bindings.at(10) == &a1);
+        assert(bm.bindings.size() == 1);
+        
+        // Check undo stack size after first bind
+        size_t undo_stack_size = t.undo_stack.size();
+        assert(undo_stack_size == 1);  // One undo for the insert
+        
+        // Bind same value again - should be no-op
+        bm.bind(10, &a1);
+        assert(bm.bindings.size() == 1);
+        assert(bm.bindings.at(10) == &a1);
+        
         // Verify undo stack did NOT grow (no-op optimization)
         assert(t.undo_stack.size() == undo_stack_size);
         
@@ -2689,9 +3694,9 @@ void test_bind_map_bind() {
         trail t;
         bind_map bm(t);
         
-        expr a1{expr::functor{"first", {}}};
-        expr a2{expr::functor{"second", {}}};
-        expr a3{expr::functor{"third", {}}};
+        expr a1{expr::functor{symbols().intern("first", 0), {}}};
+        expr a2{expr::functor{symbols().intern("second", 0), {}}};
+        expr a3{expr::functor{symbols().intern("third", 0), {}}};
         
         // Frame 1: Initial binding
         t.push();
@@ -2735,21 +3740,21 @@ void test_bind_map_bind() {
         
         // Frame 1
         t.push();
-        expr a1{expr::functor{"frame1", {}}};
+        expr a1{expr::functor{symbols().intern("frame1", 0), {}}};
         bm.bind(20, &a1);
         assert(bm.bindings.size() == 1);
-        std::map<uint32_t, const expr*> checkpoint1 = bm.bindings;
+        bind_map::binding_array checkpoint1 = bm.bindings;
         
         // Frame 2
         t.push();
-        expr a2{expr::functor{"frame2", {}}};
+        expr a2{expr::functor{symbols().intern("frame2", 0), {}}};
         bm.bind(21, &a2);
         assert(bm.bindings.size() == 2);
-        std::map<uint32_t, const expr*> checkpoint2 = bm.bindings;
+        bind_map::binding_array checkpoint2 = bm.bindings;
         
         // Frame 3
         t.push();
-        expr a3{expr::functor{"frame3", {}}};
+        expr a3{expr::functor{symbols().intern("frame3", 0), {}}};
         bm.bind(22, &a3);
         assert(bm.bindings.size() == 3);
         
@@ -2775,21 +3780,21 @@ void test_bind_map_bind() {
         
         // Frame 1: bind index 30 to a1
         t.push();
-        expr a1{expr::functor{"v1", {}}};
+        expr a1{expr::functor{symbols().intern("v1", 0), {}}};
         bm.bind(30, &a1);
         assert(bm.bindings.at(30) == &a1);
-        std::map<uint32_t, const expr*> checkpoint1 = bm.bindings;
+        bind_map::binding_array checkpoint1 = bm.bindings;
         
         // Frame 2: update index 30 to a2
         t.push();
-        expr a2{expr::functor{"v2", {}}};
+        expr a2{expr::functor{symbols().intern("v2", 0), {}}};
         bm.bind(30, &a2);
         assert(bm.bindings.at(30) == &a2);
-        std::map<uint32_t, const expr*> checkpoint2 = bm.bindings;
+        bind_map::binding_array checkpoint2 = bm.bindings;
         
         // Frame 3: update index 30 to a3
         t.push();
-        expr a3{expr::functor{"v3", {}}};
+        expr a3{expr::functor{symbols().intern("v3", 0), {}}};
         bm.bind(30, &a3);
         assert(bm.bindings.at(30) == &a3);
         
@@ -2814,21 +3819,21 @@ void test_bind_map_bind() {
         bind_map bm(t);
         
         t.push();
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         bm.bind(40, &a1);
         bm.bind(41, &a2);
-        std::map<uint32_t, const expr*> checkpoint1 = bm.bindings;
+        bind_map::binding_array checkpoint1 = bm.bindings;
         
         t.push();
-        expr a3{expr::functor{"c", {}}};
-        expr a4{expr::functor{"d", {}}};
+        expr a3{expr::functor{symbols().intern("c", 0), {}}};
+        expr a4{expr::functor{symbols().intern("d", 0), {}}};
         bm.bind(42, &a3);
         bm.bind(43, &a4);
-        std::map<uint32_t, const expr*> checkpoint2 = bm.bindings;
+        bind_map::binding_array checkpoint2 = bm.bindings;
         
         t.push();
-        expr a5{expr::functor{"e", {}}};
+        expr a5{expr::functor{symbols().intern("e", 0), {}}};
         bm.bind(40, &a5);  // Update existing from frame 1
         assert(bm.bindings.size() == 4);
         assert(bm.bindings.at(40) == &a5);
@@ -2851,11 +3856,12 @@ void test_bind_map_bind() {
         trail t;
         bind_map bm(t);
         
-        expr a1{expr::functor{"atom", {}}};
+        expr a1{expr::functor{symbols().intern("atom", 0), {}}};
         expr v1{expr::var{50}};
-        expr a2{expr::functor{"x", {}}};
-        expr a3{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a2, &a3}}};
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
+        expr a3{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a2, &a3};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Frame 1: var -> atom
         t.push();
@@ -2894,7 +3900,7 @@ void test_bind_map_bind() {
         expr v1{expr::var{60}};
         expr v2{expr::var{61}};
         expr v3{expr::var{62}};
-        expr a1{expr::functor{"end", {}}};
+        expr a1{expr::functor{symbols().intern("end", 0), {}}};
         
         // Frame 1: Start chain 60 -> v1
         t.push();
@@ -2937,14 +3943,16 @@ void test_bind_map_bind() {
         
         expr v1{expr::var{70}};
         expr v2{expr::var{71}};
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
         // Build nested: cons(cons(v1, a1), v2)
-        expr inner{expr::functor{"cons", {&v1, &a1}}};
-        expr outer{expr::functor{"cons", {&inner, &v2}}};
+        const expr* inner_args[] = {&v1, &a1};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* outer_args[] = {&inner, &v2};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
-        expr a2{expr::functor{"bound1", {}}};
-        expr a3{expr::functor{"bound2", {}}};
+        expr a2{expr::functor{symbols().intern("bound1", 0), {}}};
+        expr a3{expr::functor{symbols().intern("bound2", 0), {}}};
         
         // Frame 1: Bind first var
         t.push();
@@ -2980,17 +3988,17 @@ void test_bind_map_bind() {
         trail t;
         bind_map bm(t);
         
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
-        expr a3{expr::functor{"c", {}}};
-        expr a4{expr::functor{"d", {}}};
-        expr a5{expr::functor{"e", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        expr a3{expr::functor{symbols().intern("c", 0), {}}};
+        expr a4{expr::functor{symbols().intern("d", 0), {}}};
+        expr a5{expr::functor{symbols().intern("e", 0), {}}};
         
         // Frame 1: Create initial bindings
         t.push();
         bm.bind(80, &a1);
         bm.bind(81, &a2);
-        std::map<uint32_t, const expr*> checkpoint1 = bm.bindings;
+        bind_map::binding_array checkpoint1 = bm.bindings;
         
         // Frame 2: Add new and update existing
         t.push();
@@ -2998,7 +4006,7 @@ void test_bind_map_bind() {
         bm.bind(80, &a4);  // Update 80
         assert(bm.bindings.size() == 3);
         assert(bm.bindings.at(80) == &a4);
-        std::map<uint32_t, const expr*> checkpoint2 = bm.bindings;
+        bind_map::binding_array checkpoint2 = bm.bindings;
         
         // Frame 3: More updates
         t.push();
@@ -3028,7 +4036,7 @@ void test_bind_map_bind() {
         trail t;
         bind_map bm(t);
         
-        expr a1{expr::functor{"same", {}}};
+        expr a1{expr::functor{symbols().intern("same", 0), {}}};
         
         // Frame 1: Initial binding
         t.push();
@@ -3068,20 +4076,20 @@ void test_bind_map_bind() {
         trail t;
         bind_map bm(t);
         
-        expr a1{expr::functor{"val1", {}}};
-        expr a2{expr::functor{"val2", {}}};
+        expr a1{expr::functor{symbols().intern("val1", 0), {}}};
+        expr a2{expr::functor{symbols().intern("val2", 0), {}}};
         
         t.push();
         bm.bind(95, &a1);
-        std::map<uint32_t, const expr*> checkpoint1 = bm.bindings;
+        bind_map::binding_array checkpoint1 = bm.bindings;
         
         t.push();
         bm.bind(95, &a2);
-        std::map<uint32_t, const expr*> checkpoint2 = bm.bindings;
+        bind_map::binding_array checkpoint2 = bm.bindings;
         
         t.push();
         bm.bind(95, &a1);  // Back to a1
-        std::map<uint32_t, const expr*> checkpoint3 = bm.bindings;
+        bind_map::binding_array checkpoint3 = bm.bindings;
         
         t.push();
         bm.bind(95, &a2);  // Back to a2
@@ -3113,22 +4121,22 @@ void test_bind_map_bind() {
         expr v1{expr::var{100}};
         expr v2{expr::var{101}};
         expr v3{expr::var{102}};
-        expr a1{expr::functor{"end", {}}};
+        expr a1{expr::functor{symbols().intern("end", 0), {}}};
         
         // Frame 1: Start of chain
         t.push();
         bm.bind(100, &v1);
-        std::map<uint32_t, const expr*> checkpoint1 = bm.bindings;
+        bind_map::binding_array checkpoint1 = bm.bindings;
         
         // Frame 2: Extend chain
         t.push();
         bm.bind(101, &v2);
-        std::map<uint32_t, const expr*> checkpoint2 = bm.bindings;
+        bind_map::binding_array checkpoint2 = bm.bindings;
         
         // Frame 3: Extend more
         t.push();
         bm.bind(102, &v3);
-        std::map<uint32_t, const expr*> checkpoint3 = bm.bindings;
+        bind_map::binding_array checkpoint3 = bm.bindings;
         
         // Frame 4: Terminate chain
         t.push();
@@ -3157,16 +4165,18 @@ void test_bind_map_bind() {
         trail t;
         bind_map bm(t);
         
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
-        expr a3{expr::functor{"z", {}}};
-        expr c2{expr::functor{"cons", {&c1, &a3}}};
+        expr a3{expr::functor{symbols().intern("z", 0), {}}};
+        const expr* c2_args[] = {&c1, &a3};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         t.push();
         bm.bind(110, &c1);
-        std::map<uint32_t, const expr*> checkpoint1 = bm.bindings;
+        bind_map::binding_array checkpoint1 = bm.bindings;
         
         t.push();
         bm.bind(111, &c2);
@@ -3185,26 +4195,26 @@ void test_bind_map_bind() {
         trail t;
         bind_map bm(t);
         
-        expr a1{expr::functor{"1", {}}};
-        expr a2{expr::functor{"2", {}}};
-        expr a3{expr::functor{"3", {}}};
-        expr a4{expr::functor{"4", {}}};
-        expr a5{expr::functor{"5", {}}};
-        expr a6{expr::functor{"6", {}}};
+        expr a1{expr::functor{symbols().intern("1", 0), {}}};
+        expr a2{expr::functor{symbols().intern("2", 0), {}}};
+        expr a3{expr::functor{symbols().intern("3", 0), {}}};
+        expr a4{expr::functor{symbols().intern("4", 0), {}}};
+        expr a5{expr::functor{symbols().intern("5", 0), {}}};
+        expr a6{expr::functor{symbols().intern("6", 0), {}}};
         
         // Frame 1
         t.push();
         bm.bind(120, &a1);
         bm.bind(121, &a2);
         bm.bind(122, &a3);
-        std::map<uint32_t, const expr*> checkpoint1 = bm.bindings;
+        bind_map::binding_array checkpoint1 = bm.bindings;
         
         // Frame 2
         t.push();
         bm.bind(120, &a4);  // Update
         bm.bind(123, &a5);  // New
         assert(bm.bindings.size() == 4);
-        std::map<uint32_t, const expr*> checkpoint2 = bm.bindings;
+        bind_map::binding_array checkpoint2 = bm.bindings;
         
         // Frame 3
         t.push();
@@ -3231,24 +4241,27 @@ void test_bind_map_bind() {
         expr v1{expr::var{130}};
         expr v2{expr::var{131}};
         expr v3{expr::var{132}};
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
         // Build: cons(cons(v1, v2), cons(v3, a1))
-        expr left{expr::functor{"cons", {&v1, &v2}}};
-        expr right{expr::functor{"cons", {&v3, &a1}}};
-        expr outer{expr::functor{"cons", {&left, &right}}};
+        const expr* left_args[] = {&v1, &v2};
+        expr left{expr::functor{symbols().intern("cons", 2), left_args}};
+        const expr* right_args[] = {&v3, &a1};
+        expr right{expr::functor{symbols().intern("cons", 2), right_args}};
+        const expr* outer_args[] = {&left, &right};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
-        expr a2{expr::functor{"x", {}}};
-        expr a3{expr::functor{"y", {}}};
-        expr a4{expr::functor{"z", {}}};
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
+        expr a3{expr::functor{symbols().intern("y", 0), {}}};
+        expr a4{expr::functor{symbols().intern("z", 0), {}}};
         
         t.push();
         bm.bind(130, &a2);
-        std::map<uint32_t, const expr*> checkpoint1 = bm.bindings;
+        bind_map::binding_array checkpoint1 = bm.bindings;
         
         t.push();
         bm.bind(131, &a3);
-        std::map<uint32_t, const expr*> checkpoint2 = bm.bindings;
+        bind_map::binding_array checkpoint2 = bm.bindings;
         
         t.push();
         bm.bind(132, &a4);
@@ -3272,9 +4285,9 @@ void test_bind_map_bind() {
         trail t;
         bind_map bm(t);
         
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
-        expr a3{expr::functor{"c", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        expr a3{expr::functor{symbols().intern("c", 0), {}}};
         
         // Frame 1: 10 bindings
         t.push();
@@ -3282,7 +4295,7 @@ void test_bind_map_bind() {
             bm.bind(i, &a1);
         }
         assert(bm.bindings.size() == 10);
-        std::map<uint32_t, const expr*> checkpoint1 = bm.bindings;
+        bind_map::binding_array checkpoint1 = bm.bindings;
         
         // Frame 2: Update half, add 5 new
         t.push();
@@ -3293,7 +4306,7 @@ void test_bind_map_bind() {
             bm.bind(i, &a3);  // New
         }
         assert(bm.bindings.size() == 15);
-        std::map<uint32_t, const expr*> checkpoint2 = bm.bindings;
+        bind_map::binding_array checkpoint2 = bm.bindings;
         
         // Frame 3: More updates
         t.push();
@@ -3317,7 +4330,7 @@ void test_bind_map_bind() {
         trail t;
         bind_map bm(t);
         
-        expr a1{expr::functor{"same", {}}};
+        expr a1{expr::functor{symbols().intern("same", 0), {}}};
         
         t.push();
         bm.bind(160, &a1);
@@ -3345,6 +4358,34 @@ void test_bind_map_bind() {
         t.pop();
         assert(bm.bindings.size() == 0);
     }
+
+    // Rolling back the newest bindings truncates the dense array again
+    {
+        trail t;
+        bind_map bm(t);
+        expr a{expr::functor{symbols().intern("a", 0), {}}};
+
+        t.push();
+        bm.bind(2, &a);
+        assert(bm.bindings.slots.size() == 3);
+
+        t.push();
+        bm.bind(7, &a);
+        bm.bind(5, &a);
+        assert(bm.bindings.slots.size() == 8);
+        t.pop();
+        assert(bm.bindings.slots.size() == 3);
+        assert(bm.bindings.size() == 1);
+
+        // a rebinding below the top does not truncate
+        t.push();
+        bm.bind(0, &a);
+        t.pop();
+        assert(bm.bindings.slots.size() == 3);
+
+        t.pop();
+        assert(bm.bindings.slots.empty());
+    }
 }
 
 void test_bind_map_whnf() {
@@ -3352,7 +4393,7 @@ void test_bind_map_whnf() {
     {
         trail t;
         bind_map bm(t);
-        expr a1{expr::functor{"test", {}}};
+        expr a1{expr::functor{symbols().intern("test", 0), {}}};
         const expr* result = bm.whnf(&a1);
         assert(result == &a1);
         assert(bm.bindings.size() == 0);  // No bindings created for non-vars
@@ -3362,9 +4403,10 @@ void test_bind_map_whnf() {
     {
         trail t;
         bind_map bm(t);
-        expr a1{expr::functor{"left", {}}};
-        expr a2{expr::functor{"right", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("left", 0), {}}};
+        expr a2{expr::functor{symbols().intern("right", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         const expr* result = bm.whnf(&c1);
         assert(result == &c1);
         assert(bm.bindings.size() == 0);
@@ -3385,7 +4427,7 @@ void test_bind_map_whnf() {
         trail t;
         bind_map bm(t);
         expr v1{expr::var{1}};
-        expr a1{expr::functor{"bound", {}}};
+        expr a1{expr::functor{symbols().intern("bound", 0), {}}};
         bm.bindings[1] = &a1;
         
         const expr* result = bm.whnf(&v1);
@@ -3402,7 +4444,7 @@ void test_bind_map_whnf() {
         expr v1{expr::var{10}};
         expr v2{expr::var{11}};
         expr v3{expr::var{12}};
-        expr a1{expr::functor{"end", {}}};
+        expr a1{expr::functor{symbols().intern("end", 0), {}}};
         
         // Create chain: v1 -> v2 -> v3 -> a1
         bm.bindings[10] = &v2;
@@ -3433,7 +4475,7 @@ void test_bind_map_whnf() {
         expr v3{expr::var{22}};
         expr v4{expr::var{23}};
         expr v5{expr::var{24}};
-        expr a1{expr::functor{"final", {}}};
+        expr a1{expr::functor{symbols().intern("final", 0), {}}};
         
         // Create chain: v1 -> v2 -> v3 -> v4 -> v5 -> a1
         bm.bindings[20] = &v2;
@@ -3461,9 +4503,10 @@ void test_bind_map_whnf() {
         trail t;
         bind_map bm(t);
         expr v1{expr::var{30}};
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         bm.bindings[30] = &c1;
         assert(bm.bindings.size() == 1);
@@ -3482,9 +4525,10 @@ void test_bind_map_whnf() {
         
         expr v1{expr::var{40}};
         expr v2{expr::var{41}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         bm.bindings[40] = &v2;
         bm.bindings[41] = &c1;
@@ -3522,7 +4566,7 @@ void test_bind_map_whnf() {
         trail t;
         bind_map bm(t);
         expr v1{expr::var{60}};
-        expr a1{expr::functor{"repeated", {}}};
+        expr a1{expr::functor{symbols().intern("repeated", 0), {}}};
         bm.bindings[60] = &a1;
         assert(bm.bindings.size() == 1);
         
@@ -3567,11 +4611,13 @@ void test_bind_map_whnf() {
         trail t;
         bind_map bm(t);
         expr v1{expr::var{80}};
-        expr a1{expr::functor{"inner", {}}};
-        expr a2{expr::functor{"outer", {}}};
-        expr inner_cons{expr::functor{"cons", {&a1, &a2}}};
-        expr a3{expr::functor{"wrap", {}}};
-        expr outer_cons{expr::functor{"cons", {&inner_cons, &a3}}};
+        expr a1{expr::functor{symbols().intern("inner", 0), {}}};
+        expr a2{expr::functor{symbols().intern("outer", 0), {}}};
+        const expr* inner_cons_args[] = {&a1, &a2};
+        expr inner_cons{expr::functor{symbols().intern("cons", 2), inner_cons_args}};
+        expr a3{expr::functor{symbols().intern("wrap", 0), {}}};
+        const expr* outer_cons_args[] = {&inner_cons, &a3};
+        expr outer_cons{expr::functor{symbols().intern("cons", 2), outer_cons_args}};
         
         bm.bindings[80] = &outer_cons;
         assert(bm.bindings.size() == 1);
@@ -3582,17 +4628,18 @@ void test_bind_map_whnf() {
         assert(bm.bindings.size() == 1);
     }
     
-    // Test 13: whnf with different var indices
+    // Test 13: whnf with different var indices (bindings are dense, so "large"
+    // means far apart rather than at the top of the index range)
     {
         trail t;
         bind_map bm(t);
         expr v_small{expr::var{0}};
-        expr v_large{expr::var{UINT32_MAX}};
-        expr a1{expr::functor{"small", {}}};
-        expr a2{expr::functor{"large", {}}};
+        expr v_large{expr::var{1u << 20}};
+        expr a1{expr::functor{symbols().intern("small", 0), {}}};
+        expr a2{expr::functor{symbols().intern("large", 0), {}}};
         
         bm.bindings[0] = &a1;
-        bm.bindings[UINT32_MAX] = &a2;
+        bm.bindings[1u << 20] = &a2;
         assert(bm.bindings.size() == 2);
         
         assert(bm.whnf(&v_small) == &a1);
@@ -3604,9 +4651,9 @@ void test_bind_map_whnf() {
     {
         trail t;
         bind_map bm(t);
-        expr a1{expr::functor{"", {}}};
-        expr a2{expr::functor{"test123", {}}};
-        expr a3{expr::functor{"!@#$%", {}}};
+        expr a1{expr::functor{symbols().intern("", 0), {}}};
+        expr a2{expr::functor{symbols().intern("test123", 0), {}}};
+        expr a3{expr::functor{symbols().intern("!@#$%", 0), {}}};
         
         assert(bm.whnf(&a1) == &a1);
         assert(bm.whnf(&a2) == &a2);
@@ -3623,9 +4670,10 @@ void test_bind_map_whnf() {
         expr v1{expr::var{90}};
         expr v2{expr::var{91}};
         expr v3{expr::var{92}};
-        expr a1{expr::functor{"left", {}}};
-        expr a2{expr::functor{"right", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("left", 0), {}}};
+        expr a2{expr::functor{symbols().intern("right", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Chain: v1 -> v2 -> v3 -> c1
         bm.bindings[90] = &v2;
@@ -3650,13 +4698,14 @@ void test_bind_map_whnf() {
         bind_map bm(t);
         expr v1{expr::var{100}};
         expr v2{expr::var{101}};
-        expr a1{expr::functor{"bound_atom", {}}};
+        expr a1{expr::functor{symbols().intern("bound_atom", 0), {}}};
         
         // Bind v2 to an atom
         bm.bindings[101] = &a1;
         
         // Create cons with v1 and v2 as children
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // whnf of the cons should return the cons itself, NOT reduce children
         const expr* result = bm.whnf(&c1);
@@ -3677,15 +4726,16 @@ void test_bind_map_whnf() {
         expr v_outer{expr::var{110}};
         expr v_left{expr::var{111}};
         expr v_right{expr::var{112}};
-        expr a1{expr::functor{"left_val", {}}};
-        expr a2{expr::functor{"right_val", {}}};
+        expr a1{expr::functor{symbols().intern("left_val", 0), {}}};
+        expr a2{expr::functor{symbols().intern("right_val", 0), {}}};
         
         // Bind the inner vars
         bm.bindings[111] = &a1;
         bm.bindings[112] = &a2;
         
         // Create cons with bound vars as children
-        expr c1{expr::functor{"cons", {&v_left, &v_right}}};
+        const expr* c1_args[] = {&v_left, &v_right};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         bm.bindings[110] = &c1;
         assert(bm.bindings.size() == 3);
         
@@ -3709,11 +4759,12 @@ void test_bind_map_whnf() {
         expr v_chain2{expr::var{121}};
         expr v_inner1{expr::var{122}};
         expr v_inner2{expr::var{123}};
-        expr a1{expr::functor{"inner_bound", {}}};
+        expr a1{expr::functor{symbols().intern("inner_bound", 0), {}}};
         
         bm.bindings[122] = &a1;
         
-        expr c1{expr::functor{"cons", {&v_inner1, &v_inner2}}};
+        const expr* c1_args[] = {&v_inner1, &v_inner2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         bm.bindings[120] = &v_chain2;
         bm.bindings[121] = &c1;
         assert(bm.bindings.size() == 3);
@@ -3744,15 +4795,18 @@ void test_bind_map_whnf() {
         expr v4{expr::var{134}};
         
         // Bind some inner vars
-        expr a1{expr::functor{"bound1", {}}};
-        expr a2{expr::functor{"bound2", {}}};
+        expr a1{expr::functor{symbols().intern("bound1", 0), {}}};
+        expr a2{expr::functor{symbols().intern("bound2", 0), {}}};
         bm.bindings[131] = &a1;
         bm.bindings[133] = &a2;
         
         // Create nested structure: cons(cons(v1, v2), cons(v3, v4))
-        expr inner_left{expr::functor{"cons", {&v1, &v2}}};
-        expr inner_right{expr::functor{"cons", {&v3, &v4}}};
-        expr outer{expr::functor{"cons", {&inner_left, &inner_right}}};
+        const expr* inner_left_args[] = {&v1, &v2};
+        expr inner_left{expr::functor{symbols().intern("cons", 2), inner_left_args}};
+        const expr* inner_right_args[] = {&v3, &v4};
+        expr inner_right{expr::functor{symbols().intern("cons", 2), inner_right_args}};
+        const expr* outer_args[] = {&inner_left, &inner_right};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         bm.bindings[130] = &outer;
         assert(bm.bindings.size() == 3);
@@ -3784,13 +4838,14 @@ void test_bind_map_whnf() {
         expr v_left{expr::var{141}};
         expr v_right{expr::var{142}};
         expr v_chain{expr::var{143}};
-        expr a1{expr::functor{"chained", {}}};
+        expr a1{expr::functor{symbols().intern("chained", 0), {}}};
         
         // v_left chains to atom
         bm.bindings[141] = &v_chain;
         bm.bindings[143] = &a1;
         
-        expr c1{expr::functor{"cons", {&v_left, &v_right}}};
+        const expr* c1_args[] = {&v_left, &v_right};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         bm.bindings[140] = &c1;
         assert(bm.bindings.size() == 3);
         
@@ -3811,7 +4866,7 @@ void test_bind_map_whnf() {
         expr v1{expr::var{150}};
         expr v2{expr::var{151}};
         expr v3{expr::var{152}};
-        expr a1{expr::functor{"shared", {}}};
+        expr a1{expr::functor{symbols().intern("shared", 0), {}}};
         
         bm.bindings[150] = &a1;
         bm.bindings[151] = &a1;
@@ -3830,9 +4885,10 @@ void test_bind_map_whnf() {
         bind_map bm(t);
         expr v1{expr::var{160}};
         expr v2{expr::var{161}};
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         bm.bindings[160] = &c1;
         bm.bindings[161] = &c1;
@@ -3849,7 +4905,8 @@ void test_bind_map_whnf() {
         bind_map bm(t);
         expr v1{expr::var{170}};
         expr v2{expr::var{171}};
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         const expr* result = bm.whnf(&c1);
         assert(result == &c1);
@@ -3865,9 +4922,10 @@ void test_bind_map_whnf() {
     {
         trail t;
         bind_map bm(t);
-        expr a1{expr::functor{"atom", {}}};
+        expr a1{expr::functor{symbols().intern("atom", 0), {}}};
         expr v1{expr::var{180}};
-        expr c1{expr::functor{"cons", {&a1, &v1}}};
+        const expr* c1_args[] = {&a1, &v1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         const expr* result = bm.whnf(&c1);
         assert(result == &c1);
@@ -3883,10 +4941,12 @@ void test_bind_map_whnf() {
         trail t;
         bind_map bm(t);
         expr v1{expr::var{190}};
-        expr a1{expr::functor{"inner", {}}};
-        expr a2{expr::functor{"inner2", {}}};
-        expr inner_cons{expr::functor{"cons", {&a1, &a2}}};
-        expr outer_cons{expr::functor{"cons", {&v1, &inner_cons}}};
+        expr a1{expr::functor{symbols().intern("inner", 0), {}}};
+        expr a2{expr::functor{symbols().intern("inner2", 0), {}}};
+        const expr* inner_cons_args[] = {&a1, &a2};
+        expr inner_cons{expr::functor{symbols().intern("cons", 2), inner_cons_args}};
+        const expr* outer_cons_args[] = {&v1, &inner_cons};
+        expr outer_cons{expr::functor{symbols().intern("cons", 2), outer_cons_args}};
         
         const expr* result = bm.whnf(&outer_cons);
         assert(result == &outer_cons);
@@ -3904,15 +4964,16 @@ void test_bind_map_whnf() {
         expr v_outer{expr::var{200}};
         expr v_inner1{expr::var{201}};
         expr v_inner2{expr::var{202}};
-        expr a1{expr::functor{"val1", {}}};
-        expr a2{expr::functor{"val2", {}}};
+        expr a1{expr::functor{symbols().intern("val1", 0), {}}};
+        expr a2{expr::functor{symbols().intern("val2", 0), {}}};
         
         // Bind inner vars
         bm.bindings[201] = &a1;
         bm.bindings[202] = &a2;
         
         // Create cons with bound vars
-        expr c1{expr::functor{"cons", {&v_inner1, &v_inner2}}};
+        const expr* c1_args[] = {&v_inner1, &v_inner2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         bm.bindings[200] = &c1;
         assert(bm.bindings.size() == 3);
         
@@ -3939,14 +5000,15 @@ void test_bind_map_whnf() {
         expr v_left{expr::var{212}};
         expr v_right{expr::var{213}};
         expr v_left_chain{expr::var{214}};
-        expr a1{expr::functor{"left_end", {}}};
+        expr a1{expr::functor{symbols().intern("left_end", 0), {}}};
         
         // v_left chains to atom
         bm.bindings[212] = &v_left_chain;
         bm.bindings[214] = &a1;
         
         // Cons contains chained var and unbound var
-        expr c1{expr::functor{"cons", {&v_left, &v_right}}};
+        const expr* c1_args[] = {&v_left, &v_right};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         bm.bindings[210] = &v_mid;
         bm.bindings[211] = &c1;
         assert(bm.bindings.size() == 4);
@@ -3974,15 +5036,18 @@ void test_bind_map_whnf() {
         expr v2{expr::var{221}};
         expr v3{expr::var{222}};
         expr v4{expr::var{223}};
-        expr a1{expr::functor{"deep", {}}};
+        expr a1{expr::functor{symbols().intern("deep", 0), {}}};
         
         // Bind v4
         bm.bindings[223] = &a1;
         
         // Create: cons(cons(v1, v2), cons(v3, v4))
-        expr inner_left{expr::functor{"cons", {&v1, &v2}}};
-        expr inner_right{expr::functor{"cons", {&v3, &v4}}};
-        expr outer{expr::functor{"cons", {&inner_left, &inner_right}}};
+        const expr* inner_left_args[] = {&v1, &v2};
+        expr inner_left{expr::functor{symbols().intern("cons", 2), inner_left_args}};
+        const expr* inner_right_args[] = {&v3, &v4};
+        expr inner_right{expr::functor{symbols().intern("cons", 2), inner_right_args}};
+        const expr* outer_args[] = {&inner_left, &inner_right};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         const expr* result = bm.whnf(&outer);
         assert(result == &outer);
@@ -4014,15 +5079,16 @@ void test_bind_map_whnf() {
         expr v_left{expr::var{232}};
         expr v_left_chain{expr::var{233}};
         expr v_right{expr::var{234}};
-        expr a_left{expr::functor{"left", {}}};
-        expr a_right{expr::functor{"right", {}}};
+        expr a_left{expr::functor{symbols().intern("left", 0), {}}};
+        expr a_right{expr::functor{symbols().intern("right", 0), {}}};
         
         // Setup chains
         bm.bindings[232] = &v_left_chain;
         bm.bindings[233] = &a_left;
         bm.bindings[234] = &a_right;
         
-        expr c1{expr::functor{"cons", {&v_left, &v_right}}};
+        const expr* c1_args[] = {&v_left, &v_right};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         bm.bindings[230] = &v_outer_chain;
         bm.bindings[231] = &c1;
         assert(bm.bindings.size() == 5);
@@ -4081,7 +5147,7 @@ void test_bind_map_whnf() {
         bind_map bm(t);
         
         expr v1{expr::var{300}};
-        expr a1{expr::functor{"frame1", {}}};
+        expr a1{expr::functor{symbols().intern("frame1", 0), {}}};
         
         t.push();
         bm.bind(300, &a1);
@@ -4107,8 +5173,8 @@ void test_bind_map_whnf() {
 
         expr v1{expr::var{310}};
         expr v2{expr::var{311}};
-        expr a1{expr::functor{"outer", {}}};
-        expr a2{expr::functor{"inner", {}}};
+        expr a1{expr::functor{symbols().intern("outer", 0), {}}};
+        expr a2{expr::functor{symbols().intern("inner", 0), {}}};
         
         // Frame 1: bind v1 to a1
         t.push();
@@ -4143,7 +5209,7 @@ void test_bind_map_whnf() {
         expr v1{expr::var{320}};
         expr v2{expr::var{321}};
         expr v3{expr::var{322}};
-        expr a1{expr::functor{"end", {}}};
+        expr a1{expr::functor{symbols().intern("end", 0), {}}};
         
         // Frame 1: v1 -> v2
         t.push();
@@ -4190,14 +5256,14 @@ void test_bind_map_whnf() {
         bind_map bm(t);
         
         expr v1{expr::var{330}};
-        expr a1{expr::functor{"first", {}}};
-        expr a2{expr::functor{"second", {}}};
+        expr a1{expr::functor{symbols().intern("first", 0), {}}};
+        expr a2{expr::functor{symbols().intern("second", 0), {}}};
         
         // Frame 1: bind v1 to a1
         t.push();
         bm.bind(330, &a1);
         assert(bm.whnf(&v1) == &a1);
-        std::map<uint32_t, const expr*> checkpoint1 = bm.bindings;
+        bind_map::binding_array checkpoint1 = bm.bindings;
         
         // Frame 2: update v1 to a2
         t.push();
@@ -4225,7 +5291,7 @@ void test_bind_map_whnf() {
         expr v2{expr::var{341}};
         expr v3{expr::var{342}};
         expr v4{expr::var{343}};
-        expr a1{expr::functor{"final", {}}};
+        expr a1{expr::functor{symbols().intern("final", 0), {}}};
         
         // Frame 1: v1 -> v2
         t.push();
@@ -4275,9 +5341,10 @@ void test_bind_map_whnf() {
         
         expr v1{expr::var{350}};
         expr v2{expr::var{351}};
-        expr a1{expr::functor{"left", {}}};
-        expr a2{expr::functor{"right", {}}};
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        expr a1{expr::functor{symbols().intern("left", 0), {}}};
+        expr a2{expr::functor{symbols().intern("right", 0), {}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Frame 1: bind v1 to a1
         t.push();
@@ -4319,8 +5386,8 @@ void test_bind_map_whnf() {
         expr v2{expr::var{361}};
         expr v3{expr::var{362}};
         expr v4{expr::var{363}};
-        expr a1{expr::functor{"chain1", {}}};
-        expr a2{expr::functor{"chain2", {}}};
+        expr a1{expr::functor{symbols().intern("chain1", 0), {}}};
+        expr a2{expr::functor{symbols().intern("chain2", 0), {}}};
         
         // Frame 1: Start two chains
         t.push();
@@ -4359,22 +5426,22 @@ void test_bind_map_whnf() {
         expr v1{expr::var{370}};
         expr v2{expr::var{371}};
         expr v3{expr::var{372}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
-        expr a3{expr::functor{"c", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        expr a3{expr::functor{symbols().intern("c", 0), {}}};
         
         // Frame 1: v1 -> a1
         t.push();
         bm.bind(370, &a1);
         assert(bm.whnf(&v1) == &a1);
-        std::map<uint32_t, const expr*> checkpoint1 = bm.bindings;
+        bind_map::binding_array checkpoint1 = bm.bindings;
         
         // Frame 2: v1 -> a2 (update v1's binding)
         t.push();
         bm.bind(370, &a2);
         assert(bm.whnf(&v1) == &a2);
         assert(bm.bindings.size() == 1);
-        std::map<uint32_t, const expr*> checkpoint2 = bm.bindings;
+        bind_map::binding_array checkpoint2 = bm.bindings;
         
         // Frame 3: v1 -> a3 (update again), v2 -> a1
         t.push();
@@ -4410,7 +5477,7 @@ void test_bind_map_whnf() {
         expr v1{expr::var{380}};
         expr v2{expr::var{381}};
         expr v3{expr::var{382}};
-        expr a1{expr::functor{"target", {}}};
+        expr a1{expr::functor{symbols().intern("target", 0), {}}};
         
         // Build chain in single frame: v1 -> v2 -> v3 -> a1
         t.push();
@@ -4442,10 +5509,12 @@ void test_bind_map_whnf() {
         expr v1{expr::var{390}};
         expr v2{expr::var{391}};
         expr v3{expr::var{392}};
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&v2, &a1}}};
-        expr c2{expr::functor{"cons", {&v3, &a2}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&v2, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
+        const expr* c2_args[] = {&v3, &a2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Frame 1: v1 -> c1
         t.push();
@@ -4501,9 +5570,9 @@ void test_bind_map_whnf() {
         expr v3{expr::var{402}};
         expr v4{expr::var{403}};
         expr v5{expr::var{404}};
-        expr a1{expr::functor{"1", {}}};
-        expr a2{expr::functor{"2", {}}};
-        expr a3{expr::functor{"3", {}}};
+        expr a1{expr::functor{symbols().intern("1", 0), {}}};
+        expr a2{expr::functor{symbols().intern("2", 0), {}}};
+        expr a3{expr::functor{symbols().intern("3", 0), {}}};
         
         // Frame 1: Build chain v1 -> v2 -> a1
         t.push();
@@ -4635,7 +5704,7 @@ void test_bind_map_whnf() {
         expr v4{expr::var{503}};
         expr v5{expr::var{504}};
         expr v6{expr::var{505}};
-        expr a1{expr::functor{"end", {}}};
+        expr a1{expr::functor{symbols().intern("end", 0), {}}};
         
         // Frame 1: Create a long chain v1 -> v2 -> v3 -> v4 -> a1
         t.push();
@@ -4700,6 +5769,21 @@ void test_bind_map_whnf() {
         assert(bm.whnf(&v2) == &v2);
         assert(bm.whnf(&v3) == &v3);
     }
+
+    // Long var chains are followed without recursion and fully collapsed
+    {
+        trail t;
+        expr_pool ep(t);
+        bind_map bm(t);
+        const uint32_t n = 200000;
+        const expr* a = ep.functor("a");
+        for (uint32_t i = 0; i + 1 < n; ++i)
+            bm.bind(i, ep.var(i + 1));
+        bm.bind(n - 1, a);
+        assert(bm.whnf(ep.var(0)) == a);
+        for (uint32_t i = 0; i < n; ++i)
+            assert(bm.bindings.get(i) == a);
+    }
 }
 
 void test_bind_map_occurs_check() {
@@ -4714,7 +5798,7 @@ void test_bind_map_occurs_check() {
         bind_map bm(t);
         t.push();
         
-        expr a1{expr::functor{"test", {}}};
+        expr a1{expr::functor{symbols().intern("test", 0), {}}};
         assert(!bm.occurs_check(0, &a1));
         assert(!bm.occurs_check(100, &a1));
         assert(bm.bindings.size() == 0);
@@ -4756,7 +5840,7 @@ void test_bind_map_occurs_check() {
         t.push();
         
         expr v1{expr::var{15}};
-        expr a1{expr::functor{"bound", {}}};
+        expr a1{expr::functor{symbols().intern("bound", 0), {}}};
         bm.bindings[15] = &a1;
         
         assert(!bm.occurs_check(15, &v1));  // v1 reduces to atom
@@ -4799,7 +5883,7 @@ void test_bind_map_occurs_check() {
         
         expr v1{expr::var{40}};
         expr v2{expr::var{41}};
-        expr a1{expr::functor{"end", {}}};
+        expr a1{expr::functor{symbols().intern("end", 0), {}}};
         
         // Chain: v1 -> v2 -> atom
         bm.bindings[40] = &v2;
@@ -4819,9 +5903,10 @@ void test_bind_map_occurs_check() {
         bind_map bm(t);
         t.push();
         
-        expr a1{expr::functor{"left", {}}};
-        expr a2{expr::functor{"right", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("left", 0), {}}};
+        expr a2{expr::functor{symbols().intern("right", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         assert(!bm.occurs_check(0, &c1));
         assert(!bm.occurs_check(50, &c1));
@@ -4837,8 +5922,9 @@ void test_bind_map_occurs_check() {
         t.push();
         
         expr v1{expr::var{55}};
-        expr a1{expr::functor{"right", {}}};
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
+        expr a1{expr::functor{symbols().intern("right", 0), {}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         assert(bm.occurs_check(55, &c1));
         assert(!bm.occurs_check(56, &c1));
@@ -4853,9 +5939,10 @@ void test_bind_map_occurs_check() {
         bind_map bm(t);
         t.push();
         
-        expr a1{expr::functor{"left", {}}};
+        expr a1{expr::functor{symbols().intern("left", 0), {}}};
         expr v1{expr::var{60}};
-        expr c1{expr::functor{"cons", {&a1, &v1}}};
+        const expr* c1_args[] = {&a1, &v1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         assert(bm.occurs_check(60, &c1));
         assert(!bm.occurs_check(61, &c1));
@@ -4872,7 +5959,8 @@ void test_bind_map_occurs_check() {
         
         expr v1{expr::var{65}};
         expr v2{expr::var{65}};  // Same index
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         assert(bm.occurs_check(65, &c1));
         assert(bm.bindings.size() == 0);
@@ -4888,7 +5976,8 @@ void test_bind_map_occurs_check() {
         
         expr v1{expr::var{70}};
         expr v2{expr::var{71}};
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         assert(bm.occurs_check(70, &c1));
         assert(bm.occurs_check(71, &c1));
@@ -4905,10 +5994,12 @@ void test_bind_map_occurs_check() {
         t.push();
         
         expr v1{expr::var{75}};
-        expr a1{expr::functor{"inner", {}}};
-        expr inner_cons{expr::functor{"cons", {&v1, &a1}}};
-        expr a2{expr::functor{"outer", {}}};
-        expr outer_cons{expr::functor{"cons", {&inner_cons, &a2}}};
+        expr a1{expr::functor{symbols().intern("inner", 0), {}}};
+        const expr* inner_cons_args[] = {&v1, &a1};
+        expr inner_cons{expr::functor{symbols().intern("cons", 2), inner_cons_args}};
+        expr a2{expr::functor{symbols().intern("outer", 0), {}}};
+        const expr* outer_cons_args[] = {&inner_cons, &a2};
+        expr outer_cons{expr::functor{symbols().intern("cons", 2), outer_cons_args}};
         
         assert(bm.occurs_check(75, &outer_cons));  // v1 is in nested cons
         assert(!bm.occurs_check(76, &outer_cons));
@@ -4924,14 +6015,17 @@ void test_bind_map_occurs_check() {
         t.push();
         
         expr v1{expr::var{80}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
-        expr a3{expr::functor{"c", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        expr a3{expr::functor{symbols().intern("c", 0), {}}};
         
         // Build: cons(cons(cons(v1, a1), a2), a3)
-        expr inner1{expr::functor{"cons", {&v1, &a1}}};
-        expr inner2{expr::functor{"cons", {&inner1, &a2}}};
-        expr outer{expr::functor{"cons", {&inner2, &a3}}};
+        const expr* inner1_args[] = {&v1, &a1};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* inner2_args[] = {&inner1, &a2};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* outer_args[] = {&inner2, &a3};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         assert(bm.occurs_check(80, &outer));
         assert(!bm.occurs_check(81, &outer));
@@ -4946,8 +6040,9 @@ void test_bind_map_occurs_check() {
     //     bind_map bm(t);
     //     expr v1{expr::var{85}};
     //     expr v2{expr::var{85}};  // Same index
-    //     expr a1{expr::functor{"test", {}}};
-    //     expr c1{expr::functor{"cons", {&v2, &a1}}};
+    //     expr a1{expr::functor{symbols().intern("test", 0), {}}};
+    //     const expr* c1_args[] = {&v2, &a1};
+    //     expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
     //     
     //     bm.bindings[85] = &c1;
     //     
@@ -4964,8 +6059,9 @@ void test_bind_map_occurs_check() {
         
         expr v1{expr::var{90}};
         expr v2{expr::var{91}};
-        expr a1{expr::functor{"test", {}}};
-        expr c1{expr::functor{"cons", {&v2, &a1}}};
+        expr a1{expr::functor{symbols().intern("test", 0), {}}};
+        const expr* c1_args[] = {&v2, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         bm.bindings[90] = &c1;
         
@@ -4985,8 +6081,9 @@ void test_bind_map_occurs_check() {
         expr v1{expr::var{95}};
         expr v2{expr::var{96}};
         expr v3{expr::var{97}};
-        expr a1{expr::functor{"test", {}}};
-        expr c1{expr::functor{"cons", {&v3, &a1}}};
+        expr a1{expr::functor{symbols().intern("test", 0), {}}};
+        const expr* c1_args[] = {&v3, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Chain: v1 -> v2 -> c1 (which contains v3, v3 unbound)
         bm.bindings[95] = &v2;
@@ -5008,12 +6105,13 @@ void test_bind_map_occurs_check() {
         
         expr v1{expr::var{100}};
         expr v2{expr::var{101}};
-        expr a1{expr::functor{"bound", {}}};
+        expr a1{expr::functor{symbols().intern("bound", 0), {}}};
         
         // Bind v2 to atom
         bm.bindings[101] = &a1;
         
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         assert(bm.occurs_check(100, &c1));  // v1 is in cons
         assert(!bm.occurs_check(101, &c1)); // v2 reduces to atom
@@ -5053,13 +6151,14 @@ void test_bind_map_occurs_check() {
         
         expr v1{expr::var{110}};
         expr v2{expr::var{111}};
-        expr a1{expr::functor{"left_bound", {}}};
-        expr a2{expr::functor{"right_bound", {}}};
+        expr a1{expr::functor{symbols().intern("left_bound", 0), {}}};
+        expr a2{expr::functor{symbols().intern("right_bound", 0), {}}};
         
         bm.bindings[110] = &a1;
         bm.bindings[111] = &a2;
         
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         assert(!bm.occurs_check(110, &c1));  // Both reduce to atoms
         assert(!bm.occurs_check(111, &c1));
@@ -5078,13 +6177,14 @@ void test_bind_map_occurs_check() {
         expr v1{expr::var{115}};
         expr v2{expr::var{116}};
         expr v3{expr::var{117}};
-        expr a1{expr::functor{"rhs", {}}};
+        expr a1{expr::functor{symbols().intern("rhs", 0), {}}};
         
         // v1 -> v2 -> v3 (v3 unbound)
         bm.bindings[115] = &v2;
         bm.bindings[116] = &v3;
         
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         assert(bm.occurs_check(117, &c1));  // v1 chains to v3
         assert(!bm.occurs_check(115, &c1)); // After compression
@@ -5102,10 +6202,12 @@ void test_bind_map_occurs_check() {
         
         expr v1{expr::var{120}};
         expr v2{expr::var{121}};
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
-        expr inner{expr::functor{"cons", {&v1, &a1}}};
-        expr outer{expr::functor{"cons", {&inner, &v2}}};
+        const expr* inner_args[] = {&v1, &a1};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* outer_args[] = {&inner, &v2};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         assert(bm.occurs_check(120, &outer));
         assert(bm.occurs_check(121, &outer));
@@ -5123,12 +6225,14 @@ void test_bind_map_occurs_check() {
         
         expr v_outer{expr::var{125}};
         expr v_inner{expr::var{126}};
-        expr a1{expr::functor{"deep", {}}};
-        expr a2{expr::functor{"deeper", {}}};
+        expr a1{expr::functor{symbols().intern("deep", 0), {}}};
+        expr a2{expr::functor{symbols().intern("deeper", 0), {}}};
         
         // Build nested: cons(cons(v_inner, a1), a2)
-        expr inner{expr::functor{"cons", {&v_inner, &a1}}};
-        expr outer{expr::functor{"cons", {&inner, &a2}}};
+        const expr* inner_args[] = {&v_inner, &a1};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* outer_args[] = {&inner, &a2};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         bm.bindings[125] = &outer;
         
@@ -5147,7 +6251,8 @@ void test_bind_map_occurs_check() {
         
         expr v1{expr::var{130}};
         expr v2{expr::var{130}};  // Same var
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         assert(bm.occurs_check(130, &c1));
         assert(bm.bindings.size() == 0);  // No explicit bindings
@@ -5178,11 +6283,13 @@ void test_bind_map_occurs_check() {
         
         expr v1{expr::var{140}};
         expr v2{expr::var{141}};
-        expr a1{expr::functor{"base", {}}};
+        expr a1{expr::functor{symbols().intern("base", 0), {}}};
         
         // Build: cons(cons(a1, v2), a1) where v2 is unbound
-        expr inner{expr::functor{"cons", {&a1, &v2}}};
-        expr outer{expr::functor{"cons", {&inner, &a1}}};
+        const expr* inner_args[] = {&a1, &v2};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* outer_args[] = {&inner, &a1};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         bm.bindings[140] = &outer;
         
@@ -5199,12 +6306,14 @@ void test_bind_map_occurs_check() {
         bind_map bm(t);
         t.push();
         
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
-        expr a3{expr::functor{"c", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        expr a3{expr::functor{symbols().intern("c", 0), {}}};
         
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
-        expr c2{expr::functor{"cons", {&c1, &a3}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
+        const expr* c2_args[] = {&c1, &a3};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(!bm.occurs_check(0, &c2));
         assert(!bm.occurs_check(999, &c2));
@@ -5222,9 +6331,10 @@ void test_bind_map_occurs_check() {
         expr v1{expr::var{145}};
         expr v2{expr::var{146}};
         expr v3{expr::var{147}};
-        expr a1{expr::functor{"test", {}}};
+        expr a1{expr::functor{symbols().intern("test", 0), {}}};
         
-        expr c1{expr::functor{"cons", {&v3, &a1}}};  // v3 unbound
+        const expr* c1_args[] = {&v3, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};  // v3 unbound
         bm.bindings[145] = &v2;
         bm.bindings[146] = &c1;
         
@@ -5286,7 +6396,7 @@ void test_bind_map_occurs_check() {
         expr v5{expr::var{215}};
         expr v6{expr::var{216}};
         expr v7{expr::var{217}};
-        expr a1{expr::functor{"end", {}}};
+        expr a1{expr::functor{symbols().intern("end", 0), {}}};
         
         bm.bindings[210] = &v1;
         bm.bindings[211] = &v2;
@@ -5312,17 +6422,22 @@ void test_bind_map_occurs_check() {
         t.push();
         
         expr v1{expr::var{220}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
-        expr a3{expr::functor{"c", {}}};
-        expr a4{expr::functor{"d", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        expr a3{expr::functor{symbols().intern("c", 0), {}}};
+        expr a4{expr::functor{symbols().intern("d", 0), {}}};
         
         // Build: cons(cons(cons(cons(cons(v1, a1), a2), a3), a4), a1)
-        expr level1{expr::functor{"cons", {&v1, &a1}}};
-        expr level2{expr::functor{"cons", {&level1, &a2}}};
-        expr level3{expr::functor{"cons", {&level2, &a3}}};
-        expr level4{expr::functor{"cons", {&level3, &a4}}};
-        expr level5{expr::functor{"cons", {&level4, &a1}}};
+        const expr* level1_args[] = {&v1, &a1};
+        expr level1{expr::functor{symbols().intern("cons", 2), level1_args}};
+        const expr* level2_args[] = {&level1, &a2};
+        expr level2{expr::functor{symbols().intern("cons", 2), level2_args}};
+        const expr* level3_args[] = {&level2, &a3};
+        expr level3{expr::functor{symbols().intern("cons", 2), level3_args}};
+        const expr* level4_args[] = {&level3, &a4};
+        expr level4{expr::functor{symbols().intern("cons", 2), level4_args}};
+        const expr* level5_args[] = {&level4, &a1};
+        expr level5{expr::functor{symbols().intern("cons", 2), level5_args}};
         
         assert(bm.occurs_check(220, &level5));
         assert(!bm.occurs_check(221, &level5));
@@ -5340,12 +6455,15 @@ void test_bind_map_occurs_check() {
         expr v1{expr::var{225}};
         expr v2{expr::var{226}};
         expr v3{expr::var{227}};
-        expr a1{expr::functor{"x", {}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
         
         // Build: cons(cons(v1, v2), cons(a1, v3))
-        expr left{expr::functor{"cons", {&v1, &v2}}};
-        expr right{expr::functor{"cons", {&a1, &v3}}};
-        expr outer{expr::functor{"cons", {&left, &right}}};
+        const expr* left_args[] = {&v1, &v2};
+        expr left{expr::functor{symbols().intern("cons", 2), left_args}};
+        const expr* right_args[] = {&a1, &v3};
+        expr right{expr::functor{symbols().intern("cons", 2), right_args}};
+        const expr* outer_args[] = {&left, &right};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         assert(bm.occurs_check(225, &outer));  // v1 in left subtree
         assert(bm.occurs_check(226, &outer));  // v2 in left subtree
@@ -5366,17 +6484,20 @@ void test_bind_map_occurs_check() {
         expr v1{expr::var{231}};
         expr v2{expr::var{232}};
         expr v3{expr::var{233}};
-        expr a1{expr::functor{"bound1", {}}};
-        expr a2{expr::functor{"bound2", {}}};
+        expr a1{expr::functor{symbols().intern("bound1", 0), {}}};
+        expr a2{expr::functor{symbols().intern("bound2", 0), {}}};
         
         // Bind some vars to atoms
         bm.bindings[231] = &a1;
         bm.bindings[232] = &a2;
         
         // Build: cons(cons(v1, v2), cons(v3, a1))
-        expr left{expr::functor{"cons", {&v1, &v2}}};
-        expr right{expr::functor{"cons", {&v3, &a1}}};
-        expr outer{expr::functor{"cons", {&left, &right}}};
+        const expr* left_args[] = {&v1, &v2};
+        expr left{expr::functor{symbols().intern("cons", 2), left_args}};
+        const expr* right_args[] = {&v3, &a1};
+        expr right{expr::functor{symbols().intern("cons", 2), right_args}};
+        const expr* outer_args[] = {&left, &right};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         bm.bindings[230] = &outer;
         
@@ -5400,13 +6521,16 @@ void test_bind_map_occurs_check() {
         expr v_chain2{expr::var{241}};
         expr v_chain3{expr::var{242}};
         expr v_target{expr::var{243}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         
         // Build nested cons: cons(cons(cons(v_target, a1), a2), a1)
-        expr inner1{expr::functor{"cons", {&v_target, &a1}}};
-        expr inner2{expr::functor{"cons", {&inner1, &a2}}};
-        expr outer{expr::functor{"cons", {&inner2, &a1}}};
+        const expr* inner1_args[] = {&v_target, &a1};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* inner2_args[] = {&inner1, &a2};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* outer_args[] = {&inner2, &a1};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         // Chain: v_chain1 -> v_chain2 -> v_chain3 -> outer
         bm.bindings[240] = &v_chain2;
@@ -5443,7 +6567,8 @@ void test_bind_map_occurs_check() {
         bm.bindings[253] = &v_right2;
         bm.bindings[254] = &v_right3;
         
-        expr c1{expr::functor{"cons", {&v_left1, &v_right1}}};
+        const expr* c1_args[] = {&v_left1, &v_right1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         assert(bm.occurs_check(252, &c1));  // v_left3 via left child
         assert(bm.occurs_check(255, &c1));  // v_right3 via right child
@@ -5465,14 +6590,19 @@ void test_bind_map_occurs_check() {
         expr v3{expr::var{262}};
         expr v4{expr::var{263}};
         expr v5{expr::var{264}};
-        expr a1{expr::functor{"atom", {}}};
+        expr a1{expr::functor{symbols().intern("atom", 0), {}}};
         
         // Build: cons(cons(v1, cons(v2, v3)), cons(cons(v4, v5), a1))
-        expr inner_left_right{expr::functor{"cons", {&v2, &v3}}};
-        expr inner_left{expr::functor{"cons", {&v1, &inner_left_right}}};
-        expr inner_right_left{expr::functor{"cons", {&v4, &v5}}};
-        expr inner_right{expr::functor{"cons", {&inner_right_left, &a1}}};
-        expr outer{expr::functor{"cons", {&inner_left, &inner_right}}};
+        const expr* inner_left_right_args[] = {&v2, &v3};
+        expr inner_left_right{expr::functor{symbols().intern("cons", 2), inner_left_right_args}};
+        const expr* inner_left_args[] = {&v1, &inner_left_right};
+        expr inner_left{expr::functor{symbols().intern("cons", 2), inner_left_args}};
+        const expr* inner_right_left_args[] = {&v4, &v5};
+        expr inner_right_left{expr::functor{symbols().intern("cons", 2), inner_right_left_args}};
+        const expr* inner_right_args[] = {&inner_right_left, &a1};
+        expr inner_right{expr::functor{symbols().intern("cons", 2), inner_right_args}};
+        const expr* outer_args[] = {&inner_left, &inner_right};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         assert(bm.occurs_check(260, &outer));  // v1 in left subtree
         assert(bm.occurs_check(261, &outer));  // v2 in left subtree, nested
@@ -5496,11 +6626,11 @@ void test_bind_map_occurs_check() {
         
         expr v_left1{expr::var{272}};
         expr v_left2{expr::var{273}};
-        expr a_left{expr::functor{"left_end", {}}};
+        expr a_left{expr::functor{symbols().intern("left_end", 0), {}}};
         
         expr v_right1{expr::var{274}};
         expr v_right2{expr::var{275}};
-        expr a_right{expr::functor{"right_end", {}}};
+        expr a_right{expr::functor{symbols().intern("right_end", 0), {}}};
         
         // Left chain: v_left1 -> v_left2 -> a_left
         bm.bindings[272] = &v_left2;
@@ -5510,7 +6640,8 @@ void test_bind_map_occurs_check() {
         bm.bindings[274] = &v_right2;
         bm.bindings[275] = &a_right;
         
-        expr c1{expr::functor{"cons", {&v_left1, &v_right1}}};
+        const expr* c1_args[] = {&v_left1, &v_right1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Outer chain: v_outer -> v_mid -> c1
         bm.bindings[270] = &v_mid;
@@ -5540,7 +6671,7 @@ void test_bind_map_occurs_check() {
         expr v3{expr::var{282}};
         expr v4{expr::var{283}};
         expr v5{expr::var{284}};
-        expr a1{expr::functor{"other", {}}};
+        expr a1{expr::functor{symbols().intern("other", 0), {}}};
         
         // Chain: v1 -> v2 -> v3 -> v4 -> v5 (unbound)
         bm.bindings[280] = &v2;
@@ -5548,7 +6679,8 @@ void test_bind_map_occurs_check() {
         bm.bindings[282] = &v4;
         bm.bindings[283] = &v5;
         
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         assert(bm.occurs_check(284, &c1));  // v5 is at end of chain in lhs
         assert(!bm.occurs_check(280, &c1)); // After path compression
@@ -5566,12 +6698,15 @@ void test_bind_map_occurs_check() {
         expr v1{expr::var{290}};
         expr v2{expr::var{290}};  // Same index as v1
         expr v3{expr::var{290}};  // Same index as v1
-        expr a1{expr::functor{"x", {}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
         
         // Build: cons(cons(v1, a1), cons(v2, v3))
-        expr left{expr::functor{"cons", {&v1, &a1}}};
-        expr right{expr::functor{"cons", {&v2, &v3}}};
-        expr outer{expr::functor{"cons", {&left, &right}}};
+        const expr* left_args[] = {&v1, &a1};
+        expr left{expr::functor{symbols().intern("cons", 2), left_args}};
+        const expr* right_args[] = {&v2, &v3};
+        expr right{expr::functor{symbols().intern("cons", 2), right_args}};
+        const expr* outer_args[] = {&left, &right};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         assert(bm.occurs_check(290, &outer));  // Var 290 appears 3 times
         assert(bm.bindings.size() == 0);  // No explicit bindings
@@ -5586,20 +6721,30 @@ void test_bind_map_occurs_check() {
         t.push();
         
         expr v1{expr::var{300}};
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
         // Build 10 levels of nesting
         expr* current = &v1;
-        expr level1{expr::functor{"cons", {current, &a1}}};
-        expr level2{expr::functor{"cons", {&level1, &a1}}};
-        expr level3{expr::functor{"cons", {&level2, &a1}}};
-        expr level4{expr::functor{"cons", {&level3, &a1}}};
-        expr level5{expr::functor{"cons", {&level4, &a1}}};
-        expr level6{expr::functor{"cons", {&level5, &a1}}};
-        expr level7{expr::functor{"cons", {&level6, &a1}}};
-        expr level8{expr::functor{"cons", {&level7, &a1}}};
-        expr level9{expr::functor{"cons", {&level8, &a1}}};
-        expr level10{expr::functor{"cons", {&level9, &a1}}};
+        const expr* level1_args[] = {current, &a1};
+        expr level1{expr::functor{symbols().intern("cons", 2), level1_args}};
+        const expr* level2_args[] = {&level1, &a1};
+        expr level2{expr::functor{symbols().intern("cons", 2), level2_args}};
+        const expr* level3_args[] = {&level2, &a1};
+        expr level3{expr::functor{symbols().intern("cons", 2), level3_args}};
+        const expr* level4_args[] = {&level3, &a1};
+        expr level4{expr::functor{symbols().intern("cons", 2), level4_args}};
+        const expr* level5_args[] = {&level4, &a1};
+        expr level5{expr::functor{symbols().intern("cons", 2), level5_args}};
+        const expr* level6_args[] = {&level5, &a1};
+        expr level6{expr::functor{symbols().intern("cons", 2), level6_args}};
+        const expr* level7_args[] = {&level6, &a1};
+        expr level7{expr::functor{symbols().intern("cons", 2), level7_args}};
+        const expr* level8_args[] = {&level7, &a1};
+        expr level8{expr::functor{symbols().intern("cons", 2), level8_args}};
+        const expr* level9_args[] = {&level8, &a1};
+        expr level9{expr::functor{symbols().intern("cons", 2), level9_args}};
+        const expr* level10_args[] = {&level9, &a1};
+        expr level10{expr::functor{symbols().intern("cons", 2), level10_args}};
         
         assert(bm.occurs_check(300, &level10));  // Should find v1 at the bottom
         assert(!bm.occurs_check(301, &level10));
@@ -5637,11 +6782,15 @@ void test_bind_map_occurs_check() {
         
         // Build deeply nested cons (4 levels) with chains at the leaves
         // Structure: cons(cons(cons(cons(v_left1, v_right1), atom), atom), atom)
-        expr a1{expr::functor{"a", {}}};
-        expr level1{expr::functor{"cons", {&v_left1, &v_right1}}};  // Chains in both children
-        expr level2{expr::functor{"cons", {&level1, &a1}}};
-        expr level3{expr::functor{"cons", {&level2, &a1}}};
-        expr level4{expr::functor{"cons", {&level3, &a1}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* level1_args[] = {&v_left1, &v_right1};
+        expr level1{expr::functor{symbols().intern("cons", 2), level1_args}};  // Chains in both children
+        const expr* level2_args[] = {&level1, &a1};
+        expr level2{expr::functor{symbols().intern("cons", 2), level2_args}};
+        const expr* level3_args[] = {&level2, &a1};
+        expr level3{expr::functor{symbols().intern("cons", 2), level3_args}};
+        const expr* level4_args[] = {&level3, &a1};
+        expr level4{expr::functor{symbols().intern("cons", 2), level4_args}};
         
         // Setup outer chain
         bm.bindings[400] = &v1;
@@ -5691,9 +6840,12 @@ void test_bind_map_occurs_check() {
         expr vd2{expr::var{507}};
         bm.bindings[506] = &vd2;
         
-        expr left{expr::functor{"cons", {&va1, &vb1}}};
-        expr right{expr::functor{"cons", {&vc1, &vd1}}};
-        expr outer{expr::functor{"cons", {&left, &right}}};
+        const expr* left_args[] = {&va1, &vb1};
+        expr left{expr::functor{symbols().intern("cons", 2), left_args}};
+        const expr* right_args[] = {&vc1, &vd1};
+        expr right{expr::functor{symbols().intern("cons", 2), right_args}};
+        const expr* outer_args[] = {&left, &right};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         // All four target vars should be found
         assert(bm.occurs_check(501, &outer));  // va2
@@ -5731,18 +6883,21 @@ void test_bind_map_occurs_check() {
         
         // Target var deep inside
         expr v_target{expr::var{604}};
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
         // Build: outer_cons = cons(v_left, v_right)
         //        v_left -> inner_left_cons = cons(v_target, a1)
         //        v_right -> inner_right_cons = cons(a1, a1)
-        expr inner_left_cons{expr::functor{"cons", {&v_target, &a1}}};
-        expr inner_right_cons{expr::functor{"cons", {&a1, &a1}}};
+        const expr* inner_left_cons_args[] = {&v_target, &a1};
+        expr inner_left_cons{expr::functor{symbols().intern("cons", 2), inner_left_cons_args}};
+        const expr* inner_right_cons_args[] = {&a1, &a1};
+        expr inner_right_cons{expr::functor{symbols().intern("cons", 2), inner_right_cons_args}};
         
         bm.bindings[602] = &inner_left_cons;
         bm.bindings[603] = &inner_right_cons;
         
-        expr outer_cons{expr::functor{"cons", {&v_left, &v_right}}};
+        const expr* outer_cons_args[] = {&v_left, &v_right};
+        expr outer_cons{expr::functor{symbols().intern("cons", 2), outer_cons_args}};
         
         bm.bindings[600] = &v1;
         bm.bindings[601] = &outer_cons;
@@ -5767,13 +6922,14 @@ void test_bind_map_occurs_check() {
         
         expr v1{expr::var{700}};
         expr v2{expr::var{701}};
-        expr a1{expr::functor{"shared", {}}};
+        expr a1{expr::functor{symbols().intern("shared", 0), {}}};
         
         // Both vars bound to the same atom
         bm.bindings[700] = &a1;
         bm.bindings[701] = &a1;
         
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Both children reduce to the same atom, so no vars should be found
         assert(!bm.occurs_check(700, &c1));  // v1 reduces to atom
@@ -5798,7 +6954,8 @@ void test_bind_map_occurs_check() {
         bm.bindings[710] = &v_target;
         bm.bindings[711] = &v_target;
         
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Both children reduce to v_target, so searching for v_target should find it
         assert(bm.occurs_check(712, &c1));   // v_target found in both children
@@ -5818,14 +6975,16 @@ void test_bind_map_occurs_check() {
         expr v1{expr::var{720}};
         expr v2{expr::var{721}};
         expr v_inner{expr::var{722}};
-        expr a1{expr::functor{"x", {}}};
-        expr shared_cons{expr::functor{"cons", {&v_inner, &a1}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        const expr* shared_cons_args[] = {&v_inner, &a1};
+        expr shared_cons{expr::functor{symbols().intern("cons", 2), shared_cons_args}};
         
         // Both vars bound to the same cons
         bm.bindings[720] = &shared_cons;
         bm.bindings[721] = &shared_cons;
         
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Both children reduce to shared_cons which contains v_inner
         assert(bm.occurs_check(722, &c1));   // v_inner found in shared_cons
@@ -5856,7 +7015,8 @@ void test_bind_map_occurs_check() {
         bm.bindings[732] = &v_right2;
         bm.bindings[733] = &v_target;
         
-        expr c1{expr::functor{"cons", {&v_left1, &v_right1}}};
+        const expr* c1_args[] = {&v_left1, &v_right1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Both chains converge to v_target
         assert(bm.occurs_check(734, &c1));    // v_target found via both chains
@@ -5879,7 +7039,7 @@ void test_bind_map_occurs_check() {
         expr v_left2{expr::var{741}};
         expr v_right1{expr::var{742}};
         expr v_right2{expr::var{743}};
-        expr a_target{expr::functor{"convergence", {}}};
+        expr a_target{expr::functor{symbols().intern("convergence", 0), {}}};
         
         // Left chain: v_left1 -> v_left2 -> a_target
         bm.bindings[740] = &v_left2;
@@ -5889,7 +7049,8 @@ void test_bind_map_occurs_check() {
         bm.bindings[742] = &v_right2;
         bm.bindings[743] = &a_target;
         
-        expr c1{expr::functor{"cons", {&v_left1, &v_right1}}};
+        const expr* c1_args[] = {&v_left1, &v_right1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Both chains converge to atom, so no vars should be found
         assert(!bm.occurs_check(740, &c1));   // v_left1 compressed away
@@ -5913,8 +7074,9 @@ void test_bind_map_occurs_check() {
         expr v_right1{expr::var{752}};
         expr v_right2{expr::var{753}};
         expr v_inner{expr::var{754}};
-        expr a1{expr::functor{"y", {}}};
-        expr target_cons{expr::functor{"cons", {&v_inner, &a1}}};
+        expr a1{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* target_cons_args[] = {&v_inner, &a1};
+        expr target_cons{expr::functor{symbols().intern("cons", 2), target_cons_args}};
         
         // Left chain: v_left1 -> v_left2 -> target_cons
         bm.bindings[750] = &v_left2;
@@ -5924,7 +7086,8 @@ void test_bind_map_occurs_check() {
         bm.bindings[752] = &v_right2;
         bm.bindings[753] = &target_cons;
         
-        expr c1{expr::functor{"cons", {&v_left1, &v_right1}}};
+        const expr* c1_args[] = {&v_left1, &v_right1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Both chains converge to target_cons which contains v_inner
         assert(bm.occurs_check(754, &c1));    // v_inner found in target_cons
@@ -5936,6 +7099,45 @@ void test_bind_map_occurs_check() {
         
         t.pop();
     }
+
+    // Ground terms short-circuit without consulting the bindings
+    {
+        trail t;
+        bind_map bm(t);
+        expr_pool ep(t);
+        t.push();
+
+        const expr* a = ep.functor("a");
+        const expr* g = ep.functor("f", {a, ep.functor("g", {a})});
+        assert(g->meta.ground);
+
+        // even a (bogus) binding for a would-be var index is never looked at
+        assert(!bm.occurs_check(0, g));
+        assert(!bm.occurs_check(0, a));
+        assert(bm.bindings.empty());
+
+        // a non-ground term with the var nested under ground siblings is still found
+        const expr* ng = ep.functor("f", {g, ep.functor("h", {ep.var(3)})});
+        assert(!ng->meta.ground);
+        assert(bm.occurs_check(3, ng));
+        assert(!bm.occurs_check(4, ng));
+
+        t.pop();
+    }
+
+    // Deep terms are searched without recursion
+    {
+        trail t;
+        expr_pool ep(t);
+        bind_map bm(t);
+        const expr* deep = ep.var(1);
+        for (int i = 0; i < 200000; ++i)
+            deep = ep.functor("s", {deep});
+        assert(bm.occurs_check(1, deep));
+        assert(!bm.occurs_check(2, deep));
+        bm.bind(1, ep.var(2));
+        assert(bm.occurs_check(2, deep));
+    }
 }
 
 void test_bind_map_unify() {
@@ -5950,7 +7152,7 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"test", {}}};
+        expr a1{expr::functor{symbols().intern("test", 0), {}}};
         assert(bm.unify(&a1, &a1));
         assert(bm.bindings.size() == 0);
 
@@ -5962,8 +7164,8 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"foo", {}}};
-        expr a2{expr::functor{"bar", {}}};
+        expr a1{expr::functor{symbols().intern("foo", 0), {}}};
+        expr a2{expr::functor{symbols().intern("bar", 0), {}}};
         assert(!bm.unify(&a1, &a2));
         assert(bm.bindings.size() == 0);
 
@@ -5975,8 +7177,8 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"foo", {}}};
-        expr a2{expr::functor{"bar", {}}};
+        expr a1{expr::functor{symbols().intern("foo", 0), {}}};
+        expr a2{expr::functor{symbols().intern("bar", 0), {}}};
         assert(!bm.unify(&a2, &a1));  // Commuted
         assert(bm.bindings.size() == 0);
 
@@ -5988,8 +7190,8 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"same", {}}};
-        expr a2{expr::functor{"same", {}}};
+        expr a1{expr::functor{symbols().intern("same", 0), {}}};
+        expr a2{expr::functor{symbols().intern("same", 0), {}}};
         assert(bm.unify(&a1, &a2));
         assert(bm.bindings.size() == 0);
 
@@ -6001,8 +7203,8 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"same", {}}};
-        expr a2{expr::functor{"same", {}}};
+        expr a1{expr::functor{symbols().intern("same", 0), {}}};
+        expr a2{expr::functor{symbols().intern("same", 0), {}}};
         assert(bm.unify(&a2, &a1));  // Commuted
         assert(bm.bindings.size() == 0);
 
@@ -6015,7 +7217,7 @@ void test_bind_map_unify() {
         bind_map bm(t);
         t.push();
         expr v1{expr::var{0}};
-        expr a1{expr::functor{"bound", {}}};
+        expr a1{expr::functor{symbols().intern("bound", 0), {}}};
         assert(bm.unify(&v1, &a1));
         assert(bm.bindings.size() == 1);  // Just v1 -> a1
         assert(bm.bindings.count(0) == 1);
@@ -6030,7 +7232,7 @@ void test_bind_map_unify() {
         bind_map bm(t);
         t.push();
         expr v1{expr::var{1}};
-        expr a1{expr::functor{"bound", {}}};
+        expr a1{expr::functor{symbols().intern("bound", 0), {}}};
         assert(bm.unify(&a1, &v1));  // Commuted
         assert(bm.bindings.size() == 1);
         assert(bm.bindings.count(1) == 1);
@@ -6045,9 +7247,10 @@ void test_bind_map_unify() {
         bind_map bm(t);
         t.push();
         expr v1{expr::var{2}};
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         assert(bm.unify(&v1, &c1));
         assert(bm.bindings.size() == 1);
         assert(bm.bindings.count(2) == 1);  // v1 is bound
@@ -6062,9 +7265,10 @@ void test_bind_map_unify() {
         bind_map bm(t);
         t.push();
         expr v1{expr::var{3}};
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         assert(bm.unify(&c1, &v1));  // Commuted
         assert(bm.bindings.size() == 1);
         assert(bm.bindings.count(3) == 1);  // v1 is bound
@@ -6121,8 +7325,9 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{10}};
         expr v2{expr::var{10}};  // Same index
-        expr a1{expr::functor{"test", {}}};
-        expr c1{expr::functor{"cons", {&v2, &a1}}};
+        expr a1{expr::functor{symbols().intern("test", 0), {}}};
+        const expr* c1_args[] = {&v2, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         assert(!bm.unify(&v1, &c1));  // Should fail occurs check
         assert(bm.bindings.size() == 0);  // No binding created (occurs check before bind)
 
@@ -6136,8 +7341,9 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{11}};
         expr v2{expr::var{11}};
-        expr a1{expr::functor{"test", {}}};
-        expr c1{expr::functor{"cons", {&v2, &a1}}};
+        expr a1{expr::functor{symbols().intern("test", 0), {}}};
+        const expr* c1_args[] = {&v2, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         assert(!bm.unify(&c1, &v1));  // Commuted
         assert(bm.bindings.size() == 0);  // No binding created (occurs check before bind)
 
@@ -6152,12 +7358,13 @@ void test_bind_map_unify() {
         expr v1{expr::var{12}};
         expr v2{expr::var{13}};
         expr v3{expr::var{12}};  // Same as v1
-        expr a1{expr::functor{"test", {}}};
+        expr a1{expr::functor{symbols().intern("test", 0), {}}};
         
         // v2 -> v3 (which is same index as v1)
         bm.bindings[13] = &v3;
         
-        expr c1{expr::functor{"cons", {&v2, &a1}}};
+        const expr* c1_args[] = {&v2, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         assert(!bm.unify(&v1, &c1));  // Should fail: v1 with cons containing chain to v1
         assert(bm.bindings.size() == 1);  // Only original binding (v2 -> v3), no new binding
 
@@ -6172,11 +7379,12 @@ void test_bind_map_unify() {
         expr v1{expr::var{14}};
         expr v2{expr::var{15}};
         expr v3{expr::var{14}};
-        expr a1{expr::functor{"test", {}}};
+        expr a1{expr::functor{symbols().intern("test", 0), {}}};
         
         bm.bindings[15] = &v3;
         
-        expr c1{expr::functor{"cons", {&v2, &a1}}};
+        const expr* c1_args[] = {&v2, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         assert(!bm.unify(&c1, &v1));  // Commuted
         assert(bm.bindings.size() == 1);  // Only original binding (v2 -> v3), no new binding
 
@@ -6190,12 +7398,15 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{16}};
         expr v2{expr::var{16}};
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
         // Build: cons(cons(cons(v2, a1), a1), a1)
-        expr inner1{expr::functor{"cons", {&v2, &a1}}};
-        expr inner2{expr::functor{"cons", {&inner1, &a1}}};
-        expr outer{expr::functor{"cons", {&inner2, &a1}}};
+        const expr* inner1_args[] = {&v2, &a1};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* inner2_args[] = {&inner1, &a1};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* outer_args[] = {&inner2, &a1};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         assert(!bm.unify(&v1, &outer));  // Should fail
         assert(bm.bindings.size() == 0);  // No binding created (occurs check before bind)
@@ -6210,11 +7421,14 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{17}};
         expr v2{expr::var{17}};
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
-        expr inner1{expr::functor{"cons", {&v2, &a1}}};
-        expr inner2{expr::functor{"cons", {&inner1, &a1}}};
-        expr outer{expr::functor{"cons", {&inner2, &a1}}};
+        const expr* inner1_args[] = {&v2, &a1};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* inner2_args[] = {&inner1, &a1};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* outer_args[] = {&inner2, &a1};
+        expr outer{expr::functor{symbols().intern("cons", 2), outer_args}};
         
         assert(!bm.unify(&outer, &v1));  // Commuted
         assert(bm.bindings.size() == 0);  // No binding created (occurs check before bind)
@@ -6231,7 +7445,7 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{20}};
         expr v2{expr::var{21}};
-        expr a1{expr::functor{"target", {}}};
+        expr a1{expr::functor{symbols().intern("target", 0), {}}};
         
         // v1 -> v2 (unbound)
         bm.bindings[20] = &v2;
@@ -6252,7 +7466,7 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{22}};
         expr v2{expr::var{23}};
-        expr a1{expr::functor{"target", {}}};
+        expr a1{expr::functor{symbols().intern("target", 0), {}}};
         
         bm.bindings[22] = &v2;
         
@@ -6311,7 +7525,7 @@ void test_bind_map_unify() {
         expr v2{expr::var{29}};
         expr v3{expr::var{30}};
         expr v4{expr::var{31}};
-        expr a1{expr::functor{"end", {}}};
+        expr a1{expr::functor{symbols().intern("end", 0), {}}};
         
         // Chain: v1 -> v2 -> v3 -> v4 (unbound)
         bm.bindings[28] = &v2;
@@ -6336,7 +7550,7 @@ void test_bind_map_unify() {
         expr v2{expr::var{33}};
         expr v3{expr::var{34}};
         expr v4{expr::var{35}};
-        expr a1{expr::functor{"end", {}}};
+        expr a1{expr::functor{symbols().intern("end", 0), {}}};
         
         bm.bindings[32] = &v2;
         bm.bindings[33] = &v3;
@@ -6358,13 +7572,15 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
-        expr a3{expr::functor{"x", {}}};
-        expr a4{expr::functor{"y", {}}};
-        expr c2{expr::functor{"cons", {&a3, &a4}}};
+        expr a3{expr::functor{symbols().intern("x", 0), {}}};
+        expr a4{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c2_args[] = {&a3, &a4};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(bm.unify(&c1, &c2));
         assert(bm.bindings.size() == 0);
@@ -6377,13 +7593,15 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
-        expr a3{expr::functor{"x", {}}};
-        expr a4{expr::functor{"y", {}}};
-        expr c2{expr::functor{"cons", {&a3, &a4}}};
+        expr a3{expr::functor{symbols().intern("x", 0), {}}};
+        expr a4{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c2_args[] = {&a3, &a4};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(bm.unify(&c2, &c1));  // Commuted
         assert(bm.bindings.size() == 0);
@@ -6396,13 +7614,15 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
-        expr a3{expr::functor{"z", {}}};  // Different
-        expr a4{expr::functor{"y", {}}};
-        expr c2{expr::functor{"cons", {&a3, &a4}}};
+        expr a3{expr::functor{symbols().intern("z", 0), {}}};  // Different
+        expr a4{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c2_args[] = {&a3, &a4};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(!bm.unify(&c1, &c2));
         assert(bm.bindings.size() == 0);  // No bindings created (all atoms)
@@ -6415,13 +7635,15 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
-        expr a3{expr::functor{"x", {}}};
-        expr a4{expr::functor{"z", {}}};  // Different
-        expr c2{expr::functor{"cons", {&a3, &a4}}};
+        expr a3{expr::functor{symbols().intern("x", 0), {}}};
+        expr a4{expr::functor{symbols().intern("z", 0), {}}};  // Different
+        const expr* c2_args[] = {&a3, &a4};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(!bm.unify(&c1, &c2));
         assert(bm.bindings.size() == 0);  // No bindings created (all atoms)
@@ -6435,12 +7657,14 @@ void test_bind_map_unify() {
         bind_map bm(t);
         t.push();
         expr v1{expr::var{40}};
-        expr a1{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
+        expr a1{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
-        expr a2{expr::functor{"x", {}}};
-        expr a3{expr::functor{"y", {}}};
-        expr c2{expr::functor{"cons", {&a2, &a3}}};
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
+        expr a3{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c2_args[] = {&a2, &a3};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(bm.unify(&c1, &c2));  // Should bind v1 to a2
         assert(bm.bindings.size() == 1);  // One binding created
@@ -6456,12 +7680,14 @@ void test_bind_map_unify() {
         bind_map bm(t);
         t.push();
         expr v1{expr::var{41}};
-        expr a1{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
+        expr a1{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
-        expr a2{expr::functor{"x", {}}};
-        expr a3{expr::functor{"y", {}}};
-        expr c2{expr::functor{"cons", {&a2, &a3}}};
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
+        expr a3{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c2_args[] = {&a2, &a3};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(bm.unify(&c2, &c1));  // Commuted
         assert(bm.bindings.size() == 1);  // One binding created
@@ -6477,12 +7703,14 @@ void test_bind_map_unify() {
         bind_map bm(t);
         t.push();
         expr v1{expr::var{42}};
-        expr a1{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
+        expr a1{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
-        expr a2{expr::functor{"x", {}}};
-        expr a3{expr::functor{"z", {}}};  // Conflicts with a1
-        expr c2{expr::functor{"cons", {&a2, &a3}}};
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
+        expr a3{expr::functor{symbols().intern("z", 0), {}}};  // Conflicts with a1
+        const expr* c2_args[] = {&a2, &a3};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(!bm.unify(&c1, &c2));  // rhs children don't match
         // Partial binding left: v1 was bound to a2 before rhs failed
@@ -6498,12 +7726,14 @@ void test_bind_map_unify() {
         bind_map bm(t);
         t.push();
         expr v1{expr::var{43}};
-        expr a1{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
+        expr a1{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
-        expr a2{expr::functor{"x", {}}};
-        expr a3{expr::functor{"z", {}}};
-        expr c2{expr::functor{"cons", {&a2, &a3}}};
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
+        expr a3{expr::functor{symbols().intern("z", 0), {}}};
+        const expr* c2_args[] = {&a2, &a3};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(!bm.unify(&c2, &c1));  // Commuted
         // Partial binding left: v1 was bound to a2 before rhs failed
@@ -6518,17 +7748,21 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
-        expr inner1{expr::functor{"cons", {&a1, &a2}}};
-        expr a3{expr::functor{"c", {}}};
-        expr outer1{expr::functor{"cons", {&inner1, &a3}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        const expr* inner1_args[] = {&a1, &a2};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        expr a3{expr::functor{symbols().intern("c", 0), {}}};
+        const expr* outer1_args[] = {&inner1, &a3};
+        expr outer1{expr::functor{symbols().intern("cons", 2), outer1_args}};
         
-        expr a4{expr::functor{"a", {}}};
-        expr a5{expr::functor{"b", {}}};
-        expr inner2{expr::functor{"cons", {&a4, &a5}}};
-        expr a6{expr::functor{"c", {}}};
-        expr outer2{expr::functor{"cons", {&inner2, &a6}}};
+        expr a4{expr::functor{symbols().intern("a", 0), {}}};
+        expr a5{expr::functor{symbols().intern("b", 0), {}}};
+        const expr* inner2_args[] = {&a4, &a5};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        expr a6{expr::functor{symbols().intern("c", 0), {}}};
+        const expr* outer2_args[] = {&inner2, &a6};
+        expr outer2{expr::functor{symbols().intern("cons", 2), outer2_args}};
         
         assert(bm.unify(&outer1, &outer2));
         assert(bm.bindings.size() == 0);
@@ -6541,17 +7775,21 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
-        expr inner1{expr::functor{"cons", {&a1, &a2}}};
-        expr a3{expr::functor{"c", {}}};
-        expr outer1{expr::functor{"cons", {&inner1, &a3}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        const expr* inner1_args[] = {&a1, &a2};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        expr a3{expr::functor{symbols().intern("c", 0), {}}};
+        const expr* outer1_args[] = {&inner1, &a3};
+        expr outer1{expr::functor{symbols().intern("cons", 2), outer1_args}};
         
-        expr a4{expr::functor{"a", {}}};
-        expr a5{expr::functor{"b", {}}};
-        expr inner2{expr::functor{"cons", {&a4, &a5}}};
-        expr a6{expr::functor{"c", {}}};
-        expr outer2{expr::functor{"cons", {&inner2, &a6}}};
+        expr a4{expr::functor{symbols().intern("a", 0), {}}};
+        expr a5{expr::functor{symbols().intern("b", 0), {}}};
+        const expr* inner2_args[] = {&a4, &a5};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        expr a6{expr::functor{symbols().intern("c", 0), {}}};
+        const expr* outer2_args[] = {&inner2, &a6};
+        expr outer2{expr::functor{symbols().intern("cons", 2), outer2_args}};
         
         assert(bm.unify(&outer2, &outer1));  // Commuted
         assert(bm.bindings.size() == 0);
@@ -6566,10 +7804,11 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"test", {}}};
-        expr a2{expr::functor{"x", {}}};
-        expr a3{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a2, &a3}}};
+        expr a1{expr::functor{symbols().intern("test", 0), {}}};
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
+        expr a3{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a2, &a3};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         assert(!bm.unify(&a1, &c1));
         assert(bm.bindings.size() == 0);
@@ -6582,10 +7821,11 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"test", {}}};
-        expr a2{expr::functor{"x", {}}};
-        expr a3{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a2, &a3}}};
+        expr a1{expr::functor{symbols().intern("test", 0), {}}};
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
+        expr a3{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a2, &a3};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         assert(!bm.unify(&c1, &a1));  // Commuted
         assert(bm.bindings.size() == 0);
@@ -6601,12 +7841,14 @@ void test_bind_map_unify() {
         bind_map bm(t);
         t.push();
         expr v1{expr::var{50}};
-        expr a1{expr::functor{"a", {}}};
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         expr v2{expr::var{51}};
-        expr a2{expr::functor{"a", {}}};
-        expr c2{expr::functor{"cons", {&v2, &a2}}};
+        expr a2{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* c2_args[] = {&v2, &a2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(bm.unify(&c1, &c2));  // Should bind v1 to v2
         assert(bm.bindings.size() == 1);  // Verify binding was created
@@ -6625,12 +7867,14 @@ void test_bind_map_unify() {
         bind_map bm(t);
         t.push();
         expr v1{expr::var{52}};
-        expr a1{expr::functor{"a", {}}};
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         expr v2{expr::var{53}};
-        expr a2{expr::functor{"a", {}}};
-        expr c2{expr::functor{"cons", {&v2, &a2}}};
+        expr a2{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* c2_args[] = {&v2, &a2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(bm.unify(&c2, &c1));  // Commuted
         assert(bm.bindings.size() == 1);  // Verify binding was created
@@ -6650,15 +7894,19 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{54}};
         expr v2{expr::var{55}};
-        expr a1{expr::functor{"a", {}}};
-        expr inner1{expr::functor{"cons", {&v2, &a1}}};
-        expr c1{expr::functor{"cons", {&v1, &inner1}}};
-        
-        expr a2{expr::functor{"a", {}}};
-        expr a3{expr::functor{"b", {}}};
-        expr a4{expr::functor{"a", {}}};
-        expr inner2{expr::functor{"cons", {&a3, &a4}}};
-        expr c2{expr::functor{"cons", {&a2, &inner2}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* inner1_args[] = {&v2, &a1};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* c1_args[] = {&v1, &inner1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
+        
+        expr a2{expr::functor{symbols().intern("a", 0), {}}};
+        expr a3{expr::functor{symbols().intern("b", 0), {}}};
+        expr a4{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* inner2_args[] = {&a3, &a4};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* c2_args[] = {&a2, &inner2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(bm.unify(&c1, &c2));  // v1 -> a2, v2 -> a3
         assert(bm.bindings.size() == 2);  // Two bindings created
@@ -6677,15 +7925,19 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{56}};
         expr v2{expr::var{57}};
-        expr a1{expr::functor{"a", {}}};
-        expr inner1{expr::functor{"cons", {&v2, &a1}}};
-        expr c1{expr::functor{"cons", {&v1, &inner1}}};
-        
-        expr a2{expr::functor{"a", {}}};
-        expr a3{expr::functor{"b", {}}};
-        expr a4{expr::functor{"a", {}}};
-        expr inner2{expr::functor{"cons", {&a3, &a4}}};
-        expr c2{expr::functor{"cons", {&a2, &inner2}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* inner1_args[] = {&v2, &a1};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* c1_args[] = {&v1, &inner1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
+        
+        expr a2{expr::functor{symbols().intern("a", 0), {}}};
+        expr a3{expr::functor{symbols().intern("b", 0), {}}};
+        expr a4{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* inner2_args[] = {&a3, &a4};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* c2_args[] = {&a2, &inner2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(bm.unify(&c2, &c1));  // Commuted
         assert(bm.bindings.size() == 2);  // Two bindings created
@@ -6705,9 +7957,9 @@ void test_bind_map_unify() {
         expr v1{expr::var{60}};
         expr v2{expr::var{61}};
         expr v3{expr::var{62}};
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr a3{expr::functor{"z", {}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        expr a3{expr::functor{symbols().intern("z", 0), {}}};
         
         // First unification: v1 with a1
         assert(bm.unify(&v1, &a1));
@@ -6739,7 +7991,7 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{63}};
         expr v2{expr::var{64}};
-        expr a1{expr::functor{"first", {}}};
+        expr a1{expr::functor{symbols().intern("first", 0), {}}};
         
         // First: unify v1 with v2
         assert(bm.unify(&v1, &v2));
@@ -6774,7 +8026,7 @@ void test_bind_map_unify() {
         bind_map bm(t);
         t.push();
         expr v1{expr::var{66}};
-        expr a1{expr::functor{"bound", {}}};
+        expr a1{expr::functor{symbols().intern("bound", 0), {}}};
         
         bm.bindings[66] = &a1;
         
@@ -6791,7 +8043,7 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{67}};
         expr v2{expr::var{68}};
-        expr a1{expr::functor{"same", {}}};
+        expr a1{expr::functor{symbols().intern("same", 0), {}}};
         
         bm.bindings[67] = &a1;
         bm.bindings[68] = &a1;
@@ -6809,8 +8061,8 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{69}};
         expr v2{expr::var{70}};
-        expr a1{expr::functor{"first", {}}};
-        expr a2{expr::functor{"second", {}}};
+        expr a1{expr::functor{symbols().intern("first", 0), {}}};
+        expr a2{expr::functor{symbols().intern("second", 0), {}}};
         
         bm.bindings[69] = &a1;
         bm.bindings[70] = &a2;
@@ -6829,22 +8081,28 @@ void test_bind_map_unify() {
         expr v1{expr::var{71}};
         expr v2{expr::var{72}};
         expr v3{expr::var{73}};
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
         // Build: cons(cons(v1, v2), cons(v3, a1))
-        expr left1{expr::functor{"cons", {&v1, &v2}}};
-        expr right1{expr::functor{"cons", {&v3, &a1}}};
-        expr outer1{expr::functor{"cons", {&left1, &right1}}};
-        
-        expr a2{expr::functor{"x", {}}};
-        expr a3{expr::functor{"y", {}}};
-        expr a4{expr::functor{"z", {}}};
-        expr a5{expr::functor{"a", {}}};
+        const expr* left1_args[] = {&v1, &v2};
+        expr left1{expr::functor{symbols().intern("cons", 2), left1_args}};
+        const expr* right1_args[] = {&v3, &a1};
+        expr right1{expr::functor{symbols().intern("cons", 2), right1_args}};
+        const expr* outer1_args[] = {&left1, &right1};
+        expr outer1{expr::functor{symbols().intern("cons", 2), outer1_args}};
+        
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
+        expr a3{expr::functor{symbols().intern("y", 0), {}}};
+        expr a4{expr::functor{symbols().intern("z", 0), {}}};
+        expr a5{expr::functor{symbols().intern("a", 0), {}}};
         
         // Build: cons(cons(a2, a3), cons(a4, a5))
-        expr left2{expr::functor{"cons", {&a2, &a3}}};
-        expr right2{expr::functor{"cons", {&a4, &a5}}};
-        expr outer2{expr::functor{"cons", {&left2, &right2}}};
+        const expr* left2_args[] = {&a2, &a3};
+        expr left2{expr::functor{symbols().intern("cons", 2), left2_args}};
+        const expr* right2_args[] = {&a4, &a5};
+        expr right2{expr::functor{symbols().intern("cons", 2), right2_args}};
+        const expr* outer2_args[] = {&left2, &right2};
+        expr outer2{expr::functor{symbols().intern("cons", 2), outer2_args}};
         
         assert(bm.unify(&outer1, &outer2));
         assert(bm.bindings.size() == 3);  // Three bindings: v1->a2, v2->a3, v3->a4
@@ -6890,13 +8148,15 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
-        expr a3{expr::functor{"x", {}}};
-        expr a4{expr::functor{"z", {}}};  // Different from a2
-        expr c2{expr::functor{"cons", {&a3, &a4}}};
+        expr a3{expr::functor{symbols().intern("x", 0), {}}};
+        expr a4{expr::functor{symbols().intern("z", 0), {}}};  // Different from a2
+        const expr* c2_args[] = {&a3, &a4};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(!bm.unify(&c1, &c2));  // lhs matches, rhs doesn't
         assert(bm.bindings.size() == 0);  // No bindings created (all atoms)
@@ -6909,13 +8169,15 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         t.push();
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&a1, &a2}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&a1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
-        expr a3{expr::functor{"z", {}}};  // Different from a1
-        expr a4{expr::functor{"y", {}}};
-        expr c2{expr::functor{"cons", {&a3, &a4}}};
+        expr a3{expr::functor{symbols().intern("z", 0), {}}};  // Different from a1
+        expr a4{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c2_args[] = {&a3, &a4};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(!bm.unify(&c1, &c2));  // Should fail on lhs
         assert(bm.bindings.size() == 0);  // No bindings created (all atoms)
@@ -6932,19 +8194,25 @@ void test_bind_map_unify() {
         expr v2{expr::var{81}};
         
         // Build complex structure with vars
-        expr a1{expr::functor{"a", {}}};
-        expr inner1{expr::functor{"cons", {&v1, &a1}}};
-        expr inner2{expr::functor{"cons", {&inner1, &v2}}};
-        expr outer1{expr::functor{"cons", {&inner2, &a1}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* inner1_args[] = {&v1, &a1};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* inner2_args[] = {&inner1, &v2};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* outer1_args[] = {&inner2, &a1};
+        expr outer1{expr::functor{symbols().intern("cons", 2), outer1_args}};
         
         // Build matching structure with atoms
-        expr a2{expr::functor{"x", {}}};
-        expr a3{expr::functor{"a", {}}};
-        expr inner3{expr::functor{"cons", {&a2, &a3}}};
-        expr a4{expr::functor{"y", {}}};
-        expr inner4{expr::functor{"cons", {&inner3, &a4}}};
-        expr a5{expr::functor{"a", {}}};
-        expr outer2{expr::functor{"cons", {&inner4, &a5}}};
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
+        expr a3{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* inner3_args[] = {&a2, &a3};
+        expr inner3{expr::functor{symbols().intern("cons", 2), inner3_args}};
+        expr a4{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* inner4_args[] = {&inner3, &a4};
+        expr inner4{expr::functor{symbols().intern("cons", 2), inner4_args}};
+        expr a5{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* outer2_args[] = {&inner4, &a5};
+        expr outer2{expr::functor{symbols().intern("cons", 2), outer2_args}};
         
         assert(bm.unify(&outer1, &outer2));
         assert(bm.bindings.size() == 2);  // Two bindings: v1->a2, v2->a4
@@ -6961,13 +8229,15 @@ void test_bind_map_unify() {
         trail t;
         bind_map bm(t);
         expr v1{expr::var{82}};
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
-        expr a3{expr::functor{"z", {}}};
-        expr a4{expr::functor{"w", {}}};  // Different from a1
-        expr c2{expr::functor{"cons", {&a3, &a4}}};
+        expr a3{expr::functor{symbols().intern("z", 0), {}}};
+        expr a4{expr::functor{symbols().intern("w", 0), {}}};  // Different from a1
+        const expr* c2_args[] = {&a3, &a4};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Push frame before unification
         t.push();
@@ -6995,11 +8265,13 @@ void test_bind_map_unify() {
         expr v3{expr::var{85}};
         
         // First structure: cons(V1, V1) - both children are same var
-        expr c1{expr::functor{"cons", {&v1, &v1}}};
+        const expr* c1_args[] = {&v1, &v1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Second structure: cons(a, V2)
-        expr a1{expr::functor{"a", {}}};
-        expr c2{expr::functor{"cons", {&a1, &v2}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        const expr* c2_args[] = {&a1, &v2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unify cons(V1, V1) with cons(a, V2)
         // This should bind V1 to 'a' and V2 to 'a'
@@ -7009,8 +8281,9 @@ void test_bind_map_unify() {
         assert(bm.whnf(&v2) == &a1);
         
         // Now try to unify cons(V1, V1) with cons(V3, k)
-        expr a2{expr::functor{"k", {}}};
-        expr c3{expr::functor{"cons", {&v3, &a2}}};
+        expr a2{expr::functor{symbols().intern("k", 0), {}}};
+        const expr* c3_args[] = {&v3, &a2};
+        expr c3{expr::functor{symbols().intern("cons", 2), c3_args}};
         
         // This should fail because V1 reduces to 'a', so we're trying to unify
         // cons(a, a) with cons(V3, k), which would bind V3 to 'a', but then
@@ -7034,10 +8307,12 @@ void test_bind_map_unify() {
         expr v3{expr::var{88}};
         
         // First structure: cons(V1, V1)
-        expr c1{expr::functor{"cons", {&v1, &v1}}};
+        const expr* c1_args[] = {&v1, &v1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Second structure: cons(V2, V3)
-        expr c2{expr::functor{"cons", {&v2, &v3}}};
+        const expr* c2_args[] = {&v2, &v3};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unify cons(V1, V1) with cons(V2, V3)
         // This unifies V1 with V2 (lhs), then V1 with V3 (rhs)
@@ -7056,7 +8331,7 @@ void test_bind_map_unify() {
         assert(result1 == &v1 || result1 == &v2 || result1 == &v3);
         
         // Now unify V3 with atom 'a'
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         assert(bm.unify(&v3, &a1));
         assert(bm.bindings.size() == bindings_after_first + 1);  // One more binding
         
@@ -7077,14 +8352,17 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{89}};
         expr v2{expr::var{89}};  // Same index
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(V1, b), a) - V1 appears nested inside
-        expr inner{expr::functor{"cons", {&v2, &a2}}};
-        expr c2{expr::functor{"cons", {&inner, &a1}}};
+        const expr* inner_args[] = {&v2, &a2};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* c2_args[] = {&inner, &a1};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Should fail: trying to bind V1 to cons(cons(V1, b), a) which contains V1
         assert(!bm.unify(&c1, &c2));
@@ -7102,14 +8380,17 @@ void test_bind_map_unify() {
         expr v2{expr::var{91}};
         expr v3{expr::var{90}};  // Same as V1
         expr v4{expr::var{91}};  // Same as V2
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
         // Build cons(V1, V2)
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(V1, a), V2)
-        expr inner{expr::functor{"cons", {&v3, &a1}}};
-        expr c2{expr::functor{"cons", {&inner, &v4}}};
+        const expr* inner_args[] = {&v3, &a1};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* c2_args[] = {&inner, &v4};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(V1, V2) with cons(cons(V1, a), V2)
         // lhs: V1 with cons(V1, a) - should fail occurs check (V1 in structure)
@@ -7128,16 +8409,20 @@ void test_bind_map_unify() {
         expr v2{expr::var{93}};
         expr v3{expr::var{92}};  // Same as V1
         expr v4{expr::var{92}};  // Same as V1
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         
         // Build cons(V1, cons(V2, V1))
-        expr inner1{expr::functor{"cons", {&v2, &v3}}};
-        expr c1{expr::functor{"cons", {&v1, &inner1}}};
+        const expr* inner1_args[] = {&v2, &v3};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* c1_args[] = {&v1, &inner1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(V1, a), b)
-        expr inner2{expr::functor{"cons", {&v4, &a1}}};
-        expr c2{expr::functor{"cons", {&inner2, &a2}}};
+        const expr* inner2_args[] = {&v4, &a1};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* c2_args[] = {&inner2, &a2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(V1, cons(V2, V1)) with cons(cons(V1, a), b)
         // lhs: V1 with cons(V1, a) - should fail occurs check (V1 in structure)
@@ -7156,17 +8441,20 @@ void test_bind_map_unify() {
         expr v2{expr::var{94}};
         expr v3{expr::var{93}};  // Same as V1
         expr v4{expr::var{95}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         
         // Pre-existing chain: V4 -> V1
         bm.bindings[95] = &v1;
         
-        expr c1{expr::functor{"cons", {&v4, &v2}}};
+        const expr* c1_args[] = {&v4, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(a, cons(V1, b))
-        expr inner{expr::functor{"cons", {&v3, &a2}}};
-        expr c2{expr::functor{"cons", {&a1, &inner}}};
+        const expr* inner_args[] = {&v3, &a2};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* c2_args[] = {&a1, &inner};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(V4, V2) with cons(a, cons(V1, b))
         // V4 reduces to V1 via chain
@@ -7188,17 +8476,22 @@ void test_bind_map_unify() {
         expr v1{expr::var{96}};
         expr v2{expr::var{96}};  // Same as V1
         expr v3{expr::var{96}};  // Same as V1
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
         // Build cons(V1, cons(a, V1)) - V1 appears twice
-        expr inner{expr::functor{"cons", {&a1, &v2}}};
-        expr c1{expr::functor{"cons", {&v1, &inner}}};
+        const expr* inner_args[] = {&a1, &v2};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* c1_args[] = {&v1, &inner};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(V1, a), cons(a, b))
-        expr a2{expr::functor{"b", {}}};
-        expr inner2{expr::functor{"cons", {&v3, &a1}}};
-        expr inner3{expr::functor{"cons", {&a1, &a2}}};
-        expr c2{expr::functor{"cons", {&inner2, &inner3}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        const expr* inner2_args[] = {&v3, &a1};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* inner3_args[] = {&a1, &a2};
+        expr inner3{expr::functor{symbols().intern("cons", 2), inner3_args}};
+        const expr* c2_args[] = {&inner2, &inner3};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(V1, cons(a, V1)) with cons(cons(V1, a), cons(a, b))
         // lhs: V1 with cons(V1, a) - should fail occurs check immediately
@@ -7218,17 +8511,21 @@ void test_bind_map_unify() {
         expr v1{expr::var{97}};
         expr v2{expr::var{97}};  // Same as V1
         expr v3{expr::var{97}};  // Same as V1
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"a", {}}};
-        expr a3{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("a", 0), {}}};
+        expr a3{expr::functor{symbols().intern("a", 0), {}}};
         
         // Build cons(V1, cons(V1, V1))
-        expr inner1{expr::functor{"cons", {&v2, &v3}}};
-        expr c1{expr::functor{"cons", {&v1, &inner1}}};
+        const expr* inner1_args[] = {&v2, &v3};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* c1_args[] = {&v1, &inner1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(a, cons(a, a))
-        expr inner2{expr::functor{"cons", {&a2, &a3}}};
-        expr c2{expr::functor{"cons", {&a1, &inner2}}};
+        const expr* inner2_args[] = {&a2, &a3};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* c2_args[] = {&a1, &inner2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // All three occurrences of V1 must unify to 'a'
         assert(bm.unify(&c1, &c2));
@@ -7247,17 +8544,21 @@ void test_bind_map_unify() {
         expr v1{expr::var{98}};
         expr v2{expr::var{98}};  // Same as V1
         expr v3{expr::var{98}};  // Same as V1
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"x", {}}};
-        expr a3{expr::functor{"x", {}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
+        expr a3{expr::functor{symbols().intern("x", 0), {}}};
         
         // Build cons(cons(V1, V1), V1)
-        expr inner1{expr::functor{"cons", {&v1, &v2}}};
-        expr c1{expr::functor{"cons", {&inner1, &v3}}};
+        const expr* inner1_args[] = {&v1, &v2};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* c1_args[] = {&inner1, &v3};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(x, x), x)
-        expr inner2{expr::functor{"cons", {&a1, &a2}}};
-        expr c2{expr::functor{"cons", {&inner2, &a3}}};
+        const expr* inner2_args[] = {&a1, &a2};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* c2_args[] = {&inner2, &a3};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(bm.unify(&c1, &c2));
         assert(bm.bindings.size() == 1);  // Just V1->x
@@ -7276,16 +8577,20 @@ void test_bind_map_unify() {
         expr v2{expr::var{99}};  // Same as V1
         expr v3{expr::var{99}};  // Same as V1
         expr v4{expr::var{99}};  // Same as V1
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         
         // Build cons(V1, cons(V1, V1))
-        expr inner1{expr::functor{"cons", {&v2, &v3}}};
-        expr c1{expr::functor{"cons", {&v1, &inner1}}};
+        const expr* inner1_args[] = {&v2, &v3};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* c1_args[] = {&v1, &inner1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(V1, a), b)
-        expr inner2{expr::functor{"cons", {&v4, &a1}}};
-        expr c2{expr::functor{"cons", {&inner2, &a2}}};
+        const expr* inner2_args[] = {&v4, &a1};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* c2_args[] = {&inner2, &a2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(V1, cons(V1, V1)) with cons(cons(V1, a), b)
         // lhs: V1 with cons(V1, a) - should fail occurs check
@@ -7304,13 +8609,15 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{100}};
         expr v2{expr::var{101}};
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
         // Pre-bind V2 to V1
         bm.bindings[101] = &v1;
         
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
-        expr c2{expr::functor{"cons", {&a1, &v1}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
+        const expr* c2_args[] = {&a1, &v1};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(V1, V2) with cons(a, V1)
         // V2 reduces to V1, so we're unifying cons(V1, V1) with cons(a, V1)
@@ -7333,12 +8640,16 @@ void test_bind_map_unify() {
         expr v2{expr::var{103}};
         
         // Build cons(V1, cons(V2, V1))
-        expr inner1{expr::functor{"cons", {&v2, &v1}}};
-        expr c1{expr::functor{"cons", {&v1, &inner1}}};
+        const expr* inner1_args[] = {&v2, &v1};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* c1_args[] = {&v1, &inner1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(V2, cons(V1, V2))
-        expr inner2{expr::functor{"cons", {&v1, &v2}}};
-        expr c2{expr::functor{"cons", {&v2, &inner2}}};
+        const expr* inner2_args[] = {&v1, &v2};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* c2_args[] = {&v2, &inner2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(V1, cons(V2, V1)) with cons(V2, cons(V1, V2))
         // lhs: V1 with V2 - creates binding (say 102->103)
@@ -7366,13 +8677,15 @@ void test_bind_map_unify() {
         expr v1{expr::var{104}};
         expr v2{expr::var{105}};
         expr v3{expr::var{106}};
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
         // Pre-existing chain: V1 -> V2
         bm.bindings[104] = &v2;
         
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
-        expr c2{expr::functor{"cons", {&v3, &a1}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
+        const expr* c2_args[] = {&v3, &a1};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unify cons(V1, a) with cons(V3, a)
         // V1 reduces to V2, so we unify V2 with V3
@@ -7402,8 +8715,10 @@ void test_bind_map_unify() {
         bm.bindings[109] = &v4;
         
         // Unify cons(V2, V4) with cons(V5, V5)
-        expr c1{expr::functor{"cons", {&v2, &v4}}};
-        expr c2{expr::functor{"cons", {&v5, &v5}}};
+        const expr* c1_args[] = {&v2, &v4};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
+        const expr* c2_args[] = {&v5, &v5};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // lhs: V2 with V5 - binds one to the other
         // rhs: V4 with V5 - both now in same equivalence class
@@ -7429,15 +8744,18 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{112}};
         expr v2{expr::var{113}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         
         // Create shared inner: cons(V1, a)
-        expr inner{expr::functor{"cons", {&v1, &a1}}};
+        const expr* inner_args[] = {&v1, &a1};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
         
         // Build cons(inner, V2) and cons(inner, b)
-        expr c1{expr::functor{"cons", {&inner, &v2}}};
-        expr c2{expr::functor{"cons", {&inner, &a2}}};
+        const expr* c1_args[] = {&inner, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
+        const expr* c2_args[] = {&inner, &a2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unify cons(inner, V2) with cons(inner, b)
         // lhs: inner with inner - same pointer, succeeds
@@ -7459,14 +8777,16 @@ void test_bind_map_unify() {
         bind_map bm(t);
         expr v1{expr::var{114}};
         expr v2{expr::var{115}};
-        expr a1{expr::functor{"x", {}}};
-        expr a2{expr::functor{"y", {}}};
-        expr a3{expr::functor{"z", {}}};
+        expr a1{expr::functor{symbols().intern("x", 0), {}}};
+        expr a2{expr::functor{symbols().intern("y", 0), {}}};
+        expr a3{expr::functor{symbols().intern("z", 0), {}}};
         
         // First failure
         t.push();
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
-        expr c2{expr::functor{"cons", {&a2, &a3}}};  // Mismatched rhs
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
+        const expr* c2_args[] = {&a2, &a3};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};  // Mismatched rhs
         assert(!bm.unify(&c1, &c2));
         assert(bm.bindings.size() == 1);  // Partial: V1->a2
         assert(bm.whnf(&v1) == &a2);
@@ -7479,10 +8799,12 @@ void test_bind_map_unify() {
         
         // Second failure - different partial bindings
         t.push();
-        expr a4{expr::functor{"w", {}}};
-        expr a5{expr::functor{"q", {}}};
-        expr c3{expr::functor{"cons", {&v2, &a4}}};
-        expr c4{expr::functor{"cons", {&a5, &a1}}};  // Mismatched rhs
+        expr a4{expr::functor{symbols().intern("w", 0), {}}};
+        expr a5{expr::functor{symbols().intern("q", 0), {}}};
+        const expr* c3_args[] = {&v2, &a4};
+        expr c3{expr::functor{symbols().intern("cons", 2), c3_args}};
+        const expr* c4_args[] = {&a5, &a1};
+        expr c4{expr::functor{symbols().intern("cons", 2), c4_args}};  // Mismatched rhs
         assert(!bm.unify(&c3, &c4));
         assert(bm.bindings.size() == 1);  // Partial: V2->a5
         assert(bm.whnf(&v2) == &a5);
@@ -7506,20 +8828,26 @@ void test_bind_map_unify() {
         expr v2{expr::var{116}};
         expr v3{expr::var{116}};
         expr v4{expr::var{116}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"a", {}}};
-        expr a3{expr::functor{"a", {}}};
-        expr a4{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("a", 0), {}}};
+        expr a3{expr::functor{symbols().intern("a", 0), {}}};
+        expr a4{expr::functor{symbols().intern("a", 0), {}}};
         
         // Build cons(cons(V1, V1), cons(V1, V1))
-        expr left1{expr::functor{"cons", {&v1, &v2}}};
-        expr right1{expr::functor{"cons", {&v3, &v4}}};
-        expr c1{expr::functor{"cons", {&left1, &right1}}};
+        const expr* left1_args[] = {&v1, &v2};
+        expr left1{expr::functor{symbols().intern("cons", 2), left1_args}};
+        const expr* right1_args[] = {&v3, &v4};
+        expr right1{expr::functor{symbols().intern("cons", 2), right1_args}};
+        const expr* c1_args[] = {&left1, &right1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(a, a), cons(a, a))
-        expr left2{expr::functor{"cons", {&a1, &a2}}};
-        expr right2{expr::functor{"cons", {&a3, &a4}}};
-        expr c2{expr::functor{"cons", {&left2, &right2}}};
+        const expr* left2_args[] = {&a1, &a2};
+        expr left2{expr::functor{symbols().intern("cons", 2), left2_args}};
+        const expr* right2_args[] = {&a3, &a4};
+        expr right2{expr::functor{symbols().intern("cons", 2), right2_args}};
+        const expr* c2_args[] = {&left2, &right2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // All four occurrences must bind consistently
         assert(bm.unify(&c1, &c2));
@@ -7539,11 +8867,12 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{117}};
         expr v2{expr::var{118}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         
         // Create cons(a, b)
-        expr c_ab{expr::functor{"cons", {&a1, &a2}}};
+        const expr* c_ab_args[] = {&a1, &a2};
+        expr c_ab{expr::functor{symbols().intern("cons", 2), c_ab_args}};
         
         // Bind both V1 and V2 to the same cons cell
         bm.bindings[117] = &c_ab;
@@ -7566,15 +8895,17 @@ void test_bind_map_unify() {
         expr v1{expr::var{119}};
         expr v2{expr::var{120}};
         expr v3{expr::var{121}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         
         // Create cons(a, b) and bind V1 to it
-        expr c_ab{expr::functor{"cons", {&a1, &a2}}};
+        const expr* c_ab_args[] = {&a1, &a2};
+        expr c_ab{expr::functor{symbols().intern("cons", 2), c_ab_args}};
         bm.bindings[119] = &c_ab;
         
         // Unify V1 with cons(V2, V3)
-        expr c2{expr::functor{"cons", {&v2, &v3}}};
+        const expr* c2_args[] = {&v2, &v3};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // V1 reduces to cons(a, b), so we unify cons(a, b) with cons(V2, V3)
         // This should bind V2 to a and V3 to b
@@ -7597,16 +8928,18 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{122}};
         expr v2{expr::var{123}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
-        expr a3{expr::functor{"c", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        expr a3{expr::functor{symbols().intern("c", 0), {}}};
         
         // Pre-bind V1 to 'c'
         bm.bindings[122] = &a3;
         
         // Unify cons(V1, a) with cons(b, V2)
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
-        expr c2{expr::functor{"cons", {&a2, &v2}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
+        const expr* c2_args[] = {&a2, &v2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // lhs: V1 (reduces to c) with b - should fail
         assert(!bm.unify(&c1, &c2));
@@ -7624,16 +8957,18 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{124}};
         expr v2{expr::var{125}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
-        expr a3{expr::functor{"c", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        expr a3{expr::functor{symbols().intern("c", 0), {}}};
         
         // Pre-bind V2 to 'c'
         bm.bindings[125] = &a3;
         
         // Unify cons(V1, a) with cons(b, V2)
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
-        expr c2{expr::functor{"cons", {&a2, &v2}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
+        const expr* c2_args[] = {&a2, &v2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // lhs: V1 with b - succeeds, binds V1 to b
         // rhs: a with V2 (reduces to c) - should fail
@@ -7657,20 +8992,26 @@ void test_bind_map_unify() {
         expr v2{expr::var{127}};
         expr v3{expr::var{128}};
         expr v4{expr::var{129}};
-        expr a1{expr::functor{"w", {}}};
-        expr a2{expr::functor{"x", {}}};
-        expr a3{expr::functor{"y", {}}};
-        expr a4{expr::functor{"z", {}}};
+        expr a1{expr::functor{symbols().intern("w", 0), {}}};
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
+        expr a3{expr::functor{symbols().intern("y", 0), {}}};
+        expr a4{expr::functor{symbols().intern("z", 0), {}}};
         
         // Build cons(cons(cons(V1, V2), V3), V4)
-        expr inner1{expr::functor{"cons", {&v1, &v2}}};
-        expr inner2{expr::functor{"cons", {&inner1, &v3}}};
-        expr c1{expr::functor{"cons", {&inner2, &v4}}};
+        const expr* inner1_args[] = {&v1, &v2};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* inner2_args[] = {&inner1, &v3};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* c1_args[] = {&inner2, &v4};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(cons(w, x), y), z)
-        expr inner3{expr::functor{"cons", {&a1, &a2}}};
-        expr inner4{expr::functor{"cons", {&inner3, &a3}}};
-        expr c2{expr::functor{"cons", {&inner4, &a4}}};
+        const expr* inner3_args[] = {&a1, &a2};
+        expr inner3{expr::functor{symbols().intern("cons", 2), inner3_args}};
+        const expr* inner4_args[] = {&inner3, &a3};
+        expr inner4{expr::functor{symbols().intern("cons", 2), inner4_args}};
+        const expr* c2_args[] = {&inner4, &a4};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         assert(bm.unify(&c1, &c2));
         assert(bm.bindings.size() == 4);  // Four bindings created
@@ -7695,23 +9036,29 @@ void test_bind_map_unify() {
         expr v2{expr::var{131}};
         expr v3{expr::var{132}};
         expr v4{expr::var{133}};
-        expr a1{expr::functor{"w", {}}};
-        expr a2{expr::functor{"x", {}}};
-        expr a3{expr::functor{"y", {}}};
-        expr a4{expr::functor{"z", {}}};
+        expr a1{expr::functor{symbols().intern("w", 0), {}}};
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
+        expr a3{expr::functor{symbols().intern("y", 0), {}}};
+        expr a4{expr::functor{symbols().intern("z", 0), {}}};
         
         // Pre-bind V2 to x
         bm.bindings[131] = &a2;
         
         // Build cons(cons(cons(V1, V2), V3), V4)
-        expr inner1{expr::functor{"cons", {&v1, &v2}}};
-        expr inner2{expr::functor{"cons", {&inner1, &v3}}};
-        expr c1{expr::functor{"cons", {&inner2, &v4}}};
+        const expr* inner1_args[] = {&v1, &v2};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* inner2_args[] = {&inner1, &v3};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* c1_args[] = {&inner2, &v4};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(cons(w, x), y), z)
-        expr inner3{expr::functor{"cons", {&a1, &a2}}};
-        expr inner4{expr::functor{"cons", {&inner3, &a3}}};
-        expr c2{expr::functor{"cons", {&inner4, &a4}}};
+        const expr* inner3_args[] = {&a1, &a2};
+        expr inner3{expr::functor{symbols().intern("cons", 2), inner3_args}};
+        const expr* inner4_args[] = {&inner3, &a3};
+        expr inner4{expr::functor{symbols().intern("cons", 2), inner4_args}};
+        const expr* c2_args[] = {&inner4, &a4};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // V2 is already bound to x, so unification should succeed
         assert(bm.unify(&c1, &c2));
@@ -7742,15 +9089,19 @@ void test_bind_map_unify() {
         expr v6{expr::var{139}};
         
         // First unification: cons(V1, V2) with cons(V3, V4)
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
-        expr c2{expr::functor{"cons", {&v3, &v4}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
+        const expr* c2_args[] = {&v3, &v4};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         assert(bm.unify(&c1, &c2));
         size_t bindings_after_first = bm.bindings.size();
         assert(bindings_after_first == 2);  // V1 and V2 each bound
         
         // Second unification: cons(V3, V5) with cons(V6, V1)
-        expr c3{expr::functor{"cons", {&v3, &v5}}};
-        expr c4{expr::functor{"cons", {&v6, &v1}}};
+        const expr* c3_args[] = {&v3, &v5};
+        expr c3{expr::functor{symbols().intern("cons", 2), c3_args}};
+        const expr* c4_args[] = {&v6, &v1};
+        expr c4{expr::functor{symbols().intern("cons", 2), c4_args}};
         assert(bm.unify(&c3, &c4));
         
         // Now we have a complex network:
@@ -7776,11 +9127,13 @@ void test_bind_map_unify() {
         expr v1{expr::var{140}};
         expr v2{expr::var{140}};  // Same as V1
         expr v3{expr::var{140}};  // Same as V1
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
         // Build cons(cons(V1, V1), a) - V1 appears twice in nested structure
-        expr inner{expr::functor{"cons", {&v2, &v3}}};
-        expr c1{expr::functor{"cons", {&inner, &a1}}};
+        const expr* inner_args[] = {&v2, &v3};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* c1_args[] = {&inner, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Try to unify V1 with this structure containing V1
         assert(!bm.unify(&v1, &c1));
@@ -7796,13 +9149,16 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{141}};
         expr v2{expr::var{142}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"x", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("x", 0), {}}};
         
         // Build deeply nested structure: cons(cons(cons(V1, a), a), a)
-        expr inner1{expr::functor{"cons", {&v1, &a1}}};
-        expr inner2{expr::functor{"cons", {&inner1, &a1}}};
-        expr inner3{expr::functor{"cons", {&inner2, &a1}}};
+        const expr* inner1_args[] = {&v1, &a1};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* inner2_args[] = {&inner1, &a1};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* inner3_args[] = {&inner2, &a1};
+        expr inner3{expr::functor{symbols().intern("cons", 2), inner3_args}};
         
         // Unify V2 with this nested structure
         assert(bm.unify(&v2, &inner3));
@@ -7828,14 +9184,17 @@ void test_bind_map_unify() {
         expr v1{expr::var{143}};
         expr v2{expr::var{144}};
         expr v3{expr::var{143}};  // Same as V1
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
         // Build cons(V1, V2)
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(a, cons(V1, a)) - V1 appears in rhs
-        expr inner{expr::functor{"cons", {&v3, &a1}}};
-        expr c2{expr::functor{"cons", {&a1, &inner}}};
+        const expr* inner_args[] = {&v3, &a1};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* c2_args[] = {&a1, &inner};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(V1, V2) with cons(a, cons(V1, a))
         // lhs: V1 with a - succeeds, binds V1 to a
@@ -7859,14 +9218,17 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{145}};
         expr v2{expr::var{145}};  // Same as V1
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         
-        expr c1{expr::functor{"cons", {&a1, &v1}}};
+        const expr* c1_args[] = {&a1, &v1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(a, cons(b, V1))
-        expr inner{expr::functor{"cons", {&a2, &v2}}};
-        expr c2{expr::functor{"cons", {&a1, &inner}}};
+        const expr* inner_args[] = {&a2, &v2};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* c2_args[] = {&a1, &inner};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(a, V1) with cons(a, cons(b, V1))
         // lhs: a with a - succeeds
@@ -7884,18 +9246,23 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{146}};
         expr v2{expr::var{146}};  // Same as V1
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
-        expr a3{expr::functor{"c", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        expr a3{expr::functor{symbols().intern("c", 0), {}}};
         
         // Build cons(cons(V1, a), b)
-        expr inner1{expr::functor{"cons", {&v1, &a1}}};
-        expr c1{expr::functor{"cons", {&inner1, &a2}}};
+        const expr* inner1_args[] = {&v1, &a1};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* c1_args[] = {&inner1, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(cons(V1, c), a), b)
-        expr inner2{expr::functor{"cons", {&v2, &a3}}};
-        expr inner3{expr::functor{"cons", {&inner2, &a1}}};
-        expr c2{expr::functor{"cons", {&inner3, &a2}}};
+        const expr* inner2_args[] = {&v2, &a3};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* inner3_args[] = {&inner2, &a1};
+        expr inner3{expr::functor{symbols().intern("cons", 2), inner3_args}};
+        const expr* c2_args[] = {&inner3, &a2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(cons(V1, a), b) with cons(cons(cons(V1, c), a), b)
         // lhs: cons(V1, a) with cons(cons(V1, c), a)
@@ -7915,15 +9282,19 @@ void test_bind_map_unify() {
         expr v2{expr::var{148}};
         expr v3{expr::var{147}};  // Same as V1
         expr v4{expr::var{147}};  // Same as V1
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(V1, a), cons(b, V1))
-        expr inner1{expr::functor{"cons", {&v3, &a1}}};
-        expr inner2{expr::functor{"cons", {&a2, &v4}}};
-        expr c2{expr::functor{"cons", {&inner1, &inner2}}};
+        const expr* inner1_args[] = {&v3, &a1};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* inner2_args[] = {&a2, &v4};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* c2_args[] = {&inner1, &inner2};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(V1, V2) with cons(cons(V1, a), cons(b, V1))
         // lhs: V1 with cons(V1, a) - should fail occurs check immediately
@@ -7940,16 +9311,20 @@ void test_bind_map_unify() {
         t.push();
         expr v1{expr::var{149}};
         expr v2{expr::var{149}};  // Same as V1
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
-        expr a3{expr::functor{"c", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
+        expr a3{expr::functor{symbols().intern("c", 0), {}}};
         
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(cons(V1, b), c), a) - V1 deeply nested in lhs
-        expr inner1{expr::functor{"cons", {&v2, &a2}}};
-        expr inner2{expr::functor{"cons", {&inner1, &a3}}};
-        expr c2{expr::functor{"cons", {&inner2, &a1}}};
+        const expr* inner1_args[] = {&v2, &a2};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* inner2_args[] = {&inner1, &a3};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* c2_args[] = {&inner2, &a1};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(V1, a) with cons(cons(cons(V1, b), c), a)
         // lhs: V1 with cons(cons(V1, b), c) - should fail occurs check (V1 deeply nested)
@@ -7967,17 +9342,20 @@ void test_bind_map_unify() {
         expr v1{expr::var{150}};
         expr v2{expr::var{151}};
         expr v3{expr::var{151}};  // Same as V2
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         
         // Pre-existing chain: V2 -> V1
         bm.bindings[151] = &v1;
         
-        expr c1{expr::functor{"cons", {&v1, &a1}}};
+        const expr* c1_args[] = {&v1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(V2, b), a) - V2 chains to V1
-        expr inner{expr::functor{"cons", {&v3, &a2}}};
-        expr c2{expr::functor{"cons", {&inner, &a1}}};
+        const expr* inner_args[] = {&v3, &a2};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* c2_args[] = {&inner, &a1};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(V1, a) with cons(cons(V2, b), a)
         // lhs: V1 with cons(V2, b)
@@ -7998,13 +9376,16 @@ void test_bind_map_unify() {
         expr v2{expr::var{152}};  // Same as V1
         expr v3{expr::var{152}};  // Same as V1
         expr v4{expr::var{153}};
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         
         // Build cons(cons(V1, cons(V1, a)), b) - V1 appears twice in nested structure
-        expr inner1{expr::functor{"cons", {&v2, &a1}}};
-        expr inner2{expr::functor{"cons", {&v3, &inner1}}};
-        expr c1{expr::functor{"cons", {&inner2, &a2}}};
+        const expr* inner1_args[] = {&v2, &a1};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* inner2_args[] = {&v3, &inner1};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* c1_args[] = {&inner2, &a2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Try to unify V1 with this structure
         assert(!bm.unify(&v1, &c1));
@@ -8022,17 +9403,22 @@ void test_bind_map_unify() {
         expr v2{expr::var{155}};
         expr v3{expr::var{154}};  // Same as V1
         expr v4{expr::var{155}};  // Same as V2
-        expr a1{expr::functor{"a", {}}};
-        expr a2{expr::functor{"b", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
+        expr a2{expr::functor{symbols().intern("b", 0), {}}};
         
         // Build cons(cons(V1, V2), a)
-        expr inner1{expr::functor{"cons", {&v1, &v2}}};
-        expr c1{expr::functor{"cons", {&inner1, &a1}}};
+        const expr* inner1_args[] = {&v1, &v2};
+        expr inner1{expr::functor{symbols().intern("cons", 2), inner1_args}};
+        const expr* c1_args[] = {&inner1, &a1};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(cons(cons(V1, b), V2), a)
-        expr inner2{expr::functor{"cons", {&v3, &a2}}};
-        expr inner3{expr::functor{"cons", {&inner2, &v4}}};
-        expr c2{expr::functor{"cons", {&inner3, &a1}}};
+        const expr* inner2_args[] = {&v3, &a2};
+        expr inner2{expr::functor{symbols().intern("cons", 2), inner2_args}};
+        const expr* inner3_args[] = {&inner2, &v4};
+        expr inner3{expr::functor{symbols().intern("cons", 2), inner3_args}};
+        const expr* c2_args[] = {&inner3, &a1};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(cons(V1, V2), a) with cons(cons(cons(V1, b), V2), a)
         // lhs: cons(V1, V2) with cons(cons(V1, b), V2)
@@ -8052,13 +9438,16 @@ void test_bind_map_unify() {
         expr v2{expr::var{157}};
         expr v3{expr::var{157}};  // Same as V2
         expr v4{expr::var{156}};  // Same as V1
-        expr a1{expr::functor{"a", {}}};
+        expr a1{expr::functor{symbols().intern("a", 0), {}}};
         
-        expr c1{expr::functor{"cons", {&v1, &v2}}};
+        const expr* c1_args[] = {&v1, &v2};
+        expr c1{expr::functor{symbols().intern("cons", 2), c1_args}};
         
         // Build cons(V2, cons(V1, a))
-        expr inner{expr::functor{"cons", {&v4, &a1}}};
-        expr c2{expr::functor{"cons", {&v3, &inner}}};
+        const expr* inner_args[] = {&v4, &a1};
+        expr inner{expr::functor{symbols().intern("cons", 2), inner_args}};
+        const expr* c2_args[] = {&v3, &inner};
+        expr c2{expr::functor{symbols().intern("cons", 2), c2_args}};
         
         // Unifying cons(V1, V2) with cons(V2, cons(V1, a))
         // lhs: V1 with V2 - creates binding (either 156->157 or 157->156)
@@ -8250,8 +9639,9 @@ void test_bind_map_unify() {
 
         // Stack: cons(var(206), "hello")
         expr v_stack{expr::var{206}};
-        expr a_hello{expr::functor{"hello", {}}};
-        expr c_stack{expr::functor{"cons", {&v_stack, &a_hello}}};
+        expr a_hello{expr::functor{symbols().intern("hello", 0), {}}};
+        const expr* c_stack_args[] = {&v_stack, &a_hello};
+        expr c_stack{expr::functor{symbols().intern("cons", 2), c_stack_args}};
 
         // Pool: cons("world", "hello")
         const expr* c_pool = ep.functor("cons", {ep.functor("world", {}), ep.functor("hello", {})});
@@ -8676,13 +10066,465 @@ void test_bind_map_unify() {
 
         t.pop();
     }
-}
 
-void test_lineage_pool_constructor() {
-    // Basic construction
-    lineage_pool pool1;
-    assert(pool1.goal_lineages.size() == 0);
-    assert(pool1.resolution_lineages.size() == 0);
+    // Integers unify only with equal integers or with vars
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        const expr* one = ep.integer(1);
+        const expr* two = ep.integer(2);
+
+        assert(bm.unify(one, one));
+        assert(!bm.unify(one, two));
+        assert(!bm.unify(one, ep.functor("1")));
+        assert(!bm.unify(ep.functor("1"), one));
+        assert(bm.bindings.empty());
+
+        assert(bm.unify(ep.var(0), two));
+        assert(bm.whnf(ep.var(0)) == two);
+        assert(!bm.unify(ep.var(0), one));
+        assert(bm.unify(ep.functor("f", {ep.var(1), one}), ep.functor("f", {two, ep.var(2)})));
+        assert(bm.whnf(ep.var(1)) == two);
+        assert(bm.whnf(ep.var(2)) == one);
+
+        t.pop();
+    }
+
+    // Long lists unify without recursion, binding every element in order
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        const uint32_t n = 200000;
+        const expr* lhs = ep.functor("nil");
+        const expr* rhs = ep.functor("nil");
+        for (uint32_t i = n; i-- > 0;) {
+            lhs = ep.functor("cons", {ep.var(i), lhs});
+            rhs = ep.functor("cons", {ep.integer(i), rhs});
+        }
+        assert(bm.unify(lhs, rhs));
+        assert(bm.bindings.size() == n);
+        for (uint32_t i = 0; i < n; i += 997)
+            assert(bm.whnf(ep.var(i)) == ep.integer(i));
+
+        // a mismatch at the very end still fails, and a later call starts clean
+        const expr* bad = ep.functor("end");
+        const expr* good = ep.functor("nil");
+        for (uint32_t i = n; i-- > 0;) {
+            bad = ep.functor("cons", {ep.integer(i), bad});
+            good = ep.functor("cons", {ep.integer(i), good});
+        }
+        assert(!bm.unify(lhs, bad));
+        assert(bm.unify(lhs, good));
+        t.pop();
+        assert(bm.bindings.empty());
+    }
+}
+
+void test_bind_map_unify_template() {
+    // A clash against the template allocates nothing and binds nothing
+    {
+        trail t;
+        expr_pool ep(t);
+        sequencer seq(t);
+        copier cp(seq, ep);
+        bind_map bm(t);
+        const expr* X = ep.var(seq());
+        rule r(ep.functor("p", {ep.functor("f", {X}), X}), {});
+        const expr* goal = ep.functor("p", {ep.functor("g", {ep.functor("a")}), ep.functor("b")});
+        t.push();
+        uint32_t base = seq.reserve(r.vars.size());
+        size_t nodes_before = ep.nodes.size();
+        assert(!bm.unify(r.head_template, base, goal, r.linear, cp));
+        assert(ep.nodes.size() == nodes_before);
+        assert(bm.bindings.empty());
+        t.pop();
+    }
+
+    // Var cells bind the fresh vars base + slot to the goal's subterms
+    {
+        trail t;
+        expr_pool ep(t);
+        sequencer seq(t);
+        copier cp(seq, ep);
+        bind_map bm(t);
+        const expr* X = ep.var(seq());
+        const expr* Y = ep.var(seq());
+        rule r(ep.functor("p", {Y, ep.functor("f", {X})}), {});
+        const expr* a = ep.functor("a");
+        const expr* b = ep.functor("b");
+        const expr* goal = ep.functor("p", {a, ep.functor("f", {b})});
+        t.push();
+        uint32_t base = seq.reserve(r.vars.size());
+        size_t nodes_before = ep.nodes.size();
+        assert(bm.unify(r.head_template, base, goal, r.linear, cp));
+        assert(ep.nodes.size() == nodes_before);
+        assert(bm.bindings.at(base) == a);
+        assert(bm.bindings.at(base + 1) == b);
+        t.pop();
+    }
+
+    // A goal var takes a built instance of the template subterm it meets
+    {
+        trail t;
+        expr_pool ep(t);
+        sequencer seq(t);
+        copier cp(seq, ep);
+        bind_map bm(t);
+        const expr* X = ep.var(seq());
+        const expr* G = ep.var(seq());
+        const expr* g = ep.functor("g", {ep.functor("a")});
+        rule r(ep.functor("p", {ep.functor("f", {X, g}), g}), {});
+        t.push();
+        uint32_t base = seq.reserve(r.vars.size());
+        const expr* H = ep.var(seq());
+        assert(bm.unify(r.head_template, base, ep.functor("p", {G, H}), r.linear, cp));
+        assert(bm.whnf(G) == ep.functor("f", {ep.var(base), g}));
+        // ground subterms are bound as they are
+        assert(bm.whnf(H) == g);
+        t.pop();
+    }
+
+    // Repeated vars unify through their first binding
+    {
+        trail t;
+        expr_pool ep(t);
+        sequencer seq(t);
+        copier cp(seq, ep);
+        bind_map bm(t);
+        const expr* X = ep.var(seq());
+        rule r(ep.functor("p", {X, X}), {});
+        const expr* a = ep.functor("a");
+        const expr* G = ep.var(seq());
+        t.push();
+        uint32_t base = seq.reserve(r.vars.size());
+        assert(!bm.unify(r.head_template, base, ep.functor("p", {a, ep.functor("b")}), r.linear, cp));
+        t.pop();
+        t.push();
+        base = seq.reserve(r.vars.size());
+        assert(bm.unify(r.head_template, base, ep.functor("p", {G, a}), r.linear, cp));
+        assert(bm.whnf(ep.var(base)) == a);
+        assert(bm.whnf(G) == a);
+        t.pop();
+    }
+
+    // The occurs check runs for non-linear slots and is skipped for linear ones
+    {
+        trail t;
+        expr_pool ep(t);
+        sequencer seq(t);
+        copier cp(seq, ep);
+        bind_map bm(t);
+        const expr* X = ep.var(seq());
+        const expr* G = ep.var(seq());
+        rule r(ep.functor("p", {X, X}), {});
+        t.push();
+        uint32_t base = seq.reserve(r.vars.size());
+        assert(!bm.unify(r.head_template, base, ep.functor("p", {G, ep.functor("f", {G})}), r.linear, cp));
+        t.pop();
+
+        // a cycle through the goal side is still caught when building an instance
+        rule r2(ep.functor("p", {ep.functor("f", {X}), X}), {});
+        t.push();
+        base = seq.reserve(r2.vars.size());
+        assert(!bm.unify(r2.head_template, base, ep.functor("p", {G, G}), r2.linear, cp));
+        t.pop();
+
+        // a linear slot trusts its caller
+        rule r3(ep.functor("p", {X}), {});
+        assert(r3.linear == std::vector<uint32_t>({0}));
+        t.push();
+        base = seq.reserve(r3.vars.size());
+        assert(bm.unify(r3.head_template, base, ep.functor("p", {ep.functor("f", {G})}), r3.linear, cp));
+        assert(bm.whnf(ep.var(base)) == ep.functor("f", {G}));
+        t.pop();
+    }
+
+    // Results agree with copying the head and unifying the copy
+    {
+        trail t;
+        expr_pool ep(t);
+        sequencer seq(t);
+        copier cp(seq, ep);
+        const expr* X = ep.var(seq());
+        const expr* Y = ep.var(seq());
+        const expr* G = ep.var(seq());
+        const expr* H = ep.var(seq());
+        const expr* a = ep.functor("a");
+        std::vector<const expr*> heads = {
+            ep.functor("p", {X, Y}),
+            ep.functor("p", {X, X}),
+            ep.functor("p", {ep.functor("f", {X}), Y}),
+            ep.functor("p", {ep.functor("f", {X, a}), ep.functor("g", {X})}),
+            ep.functor("p", {a, ep.functor("f", {Y})}),
+        };
+        std::vector<const expr*> goals = {
+            ep.functor("p", {G, H}),
+            ep.functor("p", {G, G}),
+            ep.functor("p", {a, ep.functor("f", {G})}),
+            ep.functor("p", {ep.functor("f", {G, H}), ep.functor("g", {a})}),
+            ep.functor("p", {ep.functor("f", {a}), ep.functor("f", {a})}),
+            ep.functor("p", {G, ep.functor("f", {G})}),
+        };
+        for (const expr* h : heads) {
+            rule r(h, {});
+            for (const expr* goal : goals) {
+                bind_map shared(t);
+                bind_map copied(t);
+                t.push();
+                uint32_t base = seq.reserve(r.vars.size());
+                bool expected = copied.unify(cp(r.head_template, base), goal);
+                assert(shared.unify(r.head_template, base, goal, r.linear, cp) == expected);
+                if (expected)
+                    for (const expr* v : {ep.var(base), ep.var(base + 1), G, H})
+                        assert(shared.whnf(v) == copied.whnf(v));
+                t.pop();
+            }
+        }
+    }
+}
+
+void test_bind_map_deref() {
+    trail t;
+    expr_pool ep(t);
+    bind_map bm(t);
+    t.push();
+    const expr* a = ep.functor("a");
+
+    // Non-vars and unbound vars are returned as they are
+    assert(bm.deref(a) == a);
+    assert(bm.deref(ep.var(0)) == ep.var(0));
+
+    // Chains are followed to their end without being collapsed or logged
+    bm.bind(0, ep.var(1));
+    bm.bind(1, ep.var(2));
+    bm.bind(2, a);
+    size_t undo_before = t.undo_stack.size();
+    assert(bm.deref(ep.var(0)) == a);
+    assert(bm.bindings.at(0) == ep.var(1));
+    assert(t.undo_stack.size() == undo_before);
+
+    // A chain may end at an unbound var
+    bm.bind(3, ep.var(4));
+    assert(bm.deref(ep.var(3)) == ep.var(4));
+    t.pop();
+}
+
+void test_bind_map_binding() {
+    trail t;
+    expr_pool ep(t);
+    bind_map bm(t);
+    t.push();
+    const expr* a = ep.functor("a");
+
+    // Unbound and out-of-range slots read as null
+    assert(bm.binding(0) == nullptr);
+    assert(bm.binding(100) == nullptr);
+
+    // Only one step is taken, chains are not followed
+    bm.bind(0, ep.var(1));
+    bm.bind(1, a);
+    assert(bm.binding(0) == ep.var(1));
+    assert(bm.binding(1) == a);
+    t.pop();
+    assert(bm.binding(0) == nullptr);
+}
+
+void test_bind_map_matches() {
+    trail t;
+    expr_pool ep(t);
+    sequencer seq(t);
+    bind_map bm(t);
+    t.push();
+    const expr* a = ep.functor("a");
+    const expr* b = ep.functor("b");
+    const expr* X = ep.var(seq());
+    const expr* Y = ep.var(seq());
+
+    // Terms: symbols, arities and integers must agree where both are bound
+    assert(bm.matches(ep.functor("f", {a, ep.integer(1)}), ep.functor("f", {a, ep.integer(1)})));
+    assert(!bm.matches(ep.functor("f", {a}), ep.functor("g", {a})));
+    assert(!bm.matches(ep.functor("f", {a}), ep.functor("f", {a, a})));
+    assert(!bm.matches(ep.functor("f", {ep.integer(1)}), ep.functor("f", {ep.integer(2)})));
+    assert(!bm.matches(ep.integer(1), a));
+    assert(bm.matches(ep.functor("f", {X, b}), ep.functor("f", {a, Y})));
+    // repeated vars are not checked, so this is only a necessary condition
+    assert(bm.matches(ep.functor("f", {X, X}), ep.functor("f", {a, b})));
+
+    // Bindings are read through, and nothing is bound or logged
+    bm.bind(1, b);
+    size_t undo_before = t.undo_stack.size();
+    assert(!bm.matches(ep.functor("f", {X, a}), ep.functor("f", {a, Y})));
+    assert(bm.matches(ep.functor("f", {X, b}), ep.functor("f", {a, Y})));
+    assert(t.undo_stack.size() == undo_before);
+    assert(bm.bindings.get(0) == nullptr);
+
+    // Templates: var cells match anything, and an rhs var skips a whole subterm
+    {
+        rule r(ep.functor("p", {ep.functor("f", {X, a}), ep.functor("g", {b}), X}), {});
+        assert(bm.matches(r.head_template, ep.functor("p", {ep.functor("f", {b, a}), ep.functor("g", {b}), a})));
+        assert(bm.matches(r.head_template, ep.functor("p", {ep.var(9), ep.var(9), ep.var(9)})));
+        assert(!bm.matches(r.head_template, ep.functor("p", {ep.functor("f", {b, b}), ep.var(9), a})));
+        assert(!bm.matches(r.head_template, ep.functor("p", {ep.var(9), ep.functor("g", {a}), a})));
+        assert(!bm.matches(r.head_template, ep.functor("q", {ep.var(9), ep.var(9), ep.var(9)})));
+        // the second arg is read through Y's binding to b
+        assert(!bm.matches(r.head_template, ep.functor("p", {ep.functor("f", {a, Y}), ep.var(9), a})));
+        assert(t.undo_stack.size() == undo_before);
+    }
+
+    // The filter never rejects a goal that unification would accept
+    {
+        copier cp(seq, ep);
+        std::vector<const expr*> heads = {
+            ep.functor("p", {X, ep.functor("f", {X, a})}),
+            ep.functor("p", {ep.integer(3), ep.functor("g", {b})}),
+            ep.functor("p", {ep.functor("f", {a, X}), X}),
+        };
+        std::vector<const expr*> goals = {
+            ep.functor("p", {ep.var(7), ep.var(8)}),
+            ep.functor("p", {ep.integer(3), ep.functor("g", {ep.var(7)})}),
+            ep.functor("p", {ep.functor("f", {a, a}), b}),
+            ep.functor("p", {a, ep.functor("f", {a, a})}),
+            ep.functor("p", {ep.integer(4), Y}),
+        };
+        for (const expr* h : heads) {
+            rule r(h, {});
+            for (const expr* goal : goals) {
+                t.push();
+                uint32_t base = seq.reserve(r.vars.size());
+                bool unifies = bm.unify(r.head_template, base, goal, r.linear, cp);
+                t.pop();
+                assert(!unifies || bm.matches(r.head_template, goal));
+            }
+        }
+    }
+    t.pop();
+}
+
+void test_bind_map_record() {
+    trail t;
+    expr_pool ep(t);
+    bind_map bm(t);
+    t.push();
+    const expr* a = ep.functor("a");
+
+    // Nothing is recorded without a sink
+    bm.bind(0, a);
+    std::vector<uint32_t> bound;
+    bm.record(&bound);
+
+    // Vars bound from unbound are recorded in order; rebinding is not
+    bm.bind(2, ep.var(3));
+    bm.bind(1, a);
+    bm.bind(0, ep.functor("b"));
+    bm.bind(3, a);
+    assert(bound == std::vector<uint32_t>({2, 1, 3}));
+
+    // so collapsing a chain through whnf records nothing
+    bm.whnf(ep.var(2));
+    assert(bound == std::vector<uint32_t>({2, 1, 3}));
+
+    // Detaching the sink stops recording
+    bm.record(nullptr);
+    bm.bind(4, a);
+    assert(bound.size() == 3);
+    t.pop();
+}
+
+void test_rule_subterm_end() {
+    trail t;
+    expr_pool ep(t);
+    const expr* X = ep.var(0);
+    const expr* Y = ep.var(1);
+    const expr* g = ep.functor("g", {ep.functor("a")});
+
+    // cells: p, f, X, g, Y, X
+    rule r(ep.functor("p", {ep.functor("f", {X, g}), Y, X}), {});
+    assert(r.head_template.size() == 6);
+    assert(rule::subterm_end(r.head_template, 0) == 6);
+    assert(rule::subterm_end(r.head_template, 1) == 4);
+    // leaves, ground subterms included, span one cell
+    assert(rule::subterm_end(r.head_template, 2) == 3);
+    assert(rule::subterm_end(r.head_template, 3) == 4);
+    assert(rule::subterm_end(r.head_template, 5) == 6);
+}
+
+void test_rule_constructor() {
+    trail t;
+    expr_pool ep(t);
+    const expr* X = ep.var(0);
+    const expr* Y = ep.var(1);
+    const expr* Z = ep.var(2);
+
+    // Fields are stored as given
+    {
+        const expr* h = ep.functor("p", {X});
+        const expr* b = ep.functor("q", {X});
+        rule r{h, {b}};
+        assert(r.head == h);
+        assert(r.body == std::vector<const expr*>({b}));
+    }
+
+    // Ground heads and bodiless stand-ins have no linear vars
+    assert(rule(ep.functor("p", {ep.functor("a")}), {}).linear.empty());
+    assert(rule(nullptr, {}).linear.empty());
+
+    // Every var that occurs once in the head is linear, in ascending order
+    assert(rule(ep.functor("p", {Z, X, Y}), {}).linear == std::vector<uint32_t>({0, 1, 2}));
+
+    // Repeated vars are not, however deep the repeat
+    assert(rule(ep.functor("p", {X, X}), {}).linear.empty());
+    assert(rule(ep.functor("p", {X, ep.functor("f", {Y, ep.functor("g", {X})})}), {}).linear == std::vector<uint32_t>({1}));
+    assert(rule(ep.functor("cons", {X, ep.functor("cons", {Y, Z})}), {}).linear == std::vector<uint32_t>({0, 1, 2}));
+
+    // Only the head is analysed: vars shared with the body stay linear
+    assert(rule(ep.functor("p", {X}), {ep.functor("q", {X, X})}).linear == std::vector<uint32_t>({0}));
+
+    // Vars are listed head first, in the order a left-to-right copy meets them;
+    // linear vars are named by slot rather than by index
+    {
+        rule r(ep.functor("p", {Z, ep.functor("f", {X, Z})}), {ep.functor("q", {Y, X}), ep.functor("r", {ep.var(7), Y})});
+        assert(r.vars == std::vector<uint32_t>({2, 0, 1, 7}));
+        assert(r.linear == std::vector<uint32_t>({1}));
+    }
+    assert(rule(ep.functor("p"), {ep.functor("q", {X})}).vars == std::vector<uint32_t>({0}));
+    assert(rule(nullptr, {}).vars.empty());
+
+    // Templates are preorder: functors precede their args, vars carry their slot
+    {
+        const expr* a = ep.functor("a");
+        const expr* fYa = ep.functor("f", {Y, a});
+        const expr* h = ep.functor("p", {Y, fYa});
+        const expr* b = ep.functor("q", {X, Y});
+        rule r(h, {b, a});
+        assert(r.head_template == std::vector<rule::cell>({{h, 0}, {Y, 0}, {fYa, 0}, {Y, 0}, {a, 0}}));
+        assert(r.body_template.size() == 2);
+        assert(r.body_template[0] == std::vector<rule::cell>({{b, 0}, {X, 1}, {Y, 0}}));
+        assert(r.body_template[1] == std::vector<rule::cell>({{a, 0}}));
+    }
+
+    // Ground subterms are single cells, however deep
+    {
+        const expr* g = ep.functor("g", {ep.functor("h", {ep.functor("a")})});
+        rule r(ep.functor("p", {g, X}), {});
+        assert(r.head_template.size() == 3);
+        assert(r.head_template[1].e == g);
+    }
+    assert(rule(nullptr, {}).head_template.empty());
+    assert(rule(nullptr, {}).body_template.empty());
+
+    // Derived data takes part in comparison consistently
+    assert(rule(ep.functor("p", {X}), {}) == rule(ep.functor("p", {X}), {}));
+}
+
+void test_lineage_pool_constructor() {
+    // Basic construction
+    lineage_pool pool1;
+    assert(pool1.goal_lineages.size() == 0);
+    assert(pool1.resolution_lineages.size() == 0);
     assert(pool1.goal_lineages.empty());
     assert(pool1.resolution_lineages.empty());
 }
@@ -10147,6 +11989,10 @@ void test_sequencer_constructor() {
     
     // vars3 with different trail is unaffected
     assert(vars3.index == 0);
+
+    // No watermark has been logged yet
+    sequencer vars4(t);
+    assert(vars4.logged_depth == SIZE_MAX);
 }
 
 void test_sequencer() {
@@ -10725,6 +12571,98 @@ void test_sequencer() {
     }
 }
 
+void test_sequencer_reserve() {
+    // A block costs one trail entry, however large
+    {
+        trail t;
+        sequencer vars(t);
+        t.push();
+        assert(vars.reserve(5) == 0);
+        assert(vars.index == 5);
+        assert(t.undo_stack.size() == 1);
+        t.pop();
+        assert(vars.index == 0);
+        assert(t.undo_stack.empty());
+    }
+
+    // Further blocks in the same frame share the first watermark
+    {
+        trail t;
+        sequencer vars(t);
+        t.push();
+        assert(vars.reserve(3) == 0);
+        assert(vars.reserve(4) == 3);
+        assert(vars.reserve(1000) == 7);
+        assert(vars.index == 1007);
+        assert(t.undo_stack.size() == 1);
+        t.pop();
+        assert(vars.index == 0);
+    }
+
+    // Empty reservations log nothing
+    {
+        trail t;
+        sequencer vars(t);
+        t.push();
+        assert(vars.reserve(0) == 0);
+        assert(t.undo_stack.empty());
+        assert(vars.reserve(2) == 0);
+        assert(vars.reserve(0) == 2);
+        assert(t.undo_stack.size() == 1);
+        t.pop();
+    }
+
+    // Nested frames each roll back to their own watermark
+    {
+        trail t;
+        sequencer vars(t);
+        t.push();
+        vars.reserve(2);
+        t.push();
+        assert(vars.reserve(3) == 2);
+        t.push();
+        assert(vars.reserve(1) == 5);
+        assert(t.undo_stack.size() == 3);
+        t.pop();
+        assert(vars.index == 5);
+        t.pop();
+        assert(vars.index == 2);
+
+        // a new frame at a depth that was popped logs afresh
+        t.push();
+        assert(vars.reserve(4) == 2);
+        assert(t.undo_stack.size() == 2);
+        t.pop();
+        assert(vars.index == 2);
+        t.pop();
+        assert(vars.index == 0);
+    }
+
+    // Blocks interleave with single indices
+    {
+        trail t;
+        sequencer vars(t);
+        t.push();
+        assert(vars() == 0);
+        assert(vars.reserve(3) == 1);
+        assert(vars() == 4);
+        assert(vars.reserve(2) == 5);
+        assert(t.undo_stack.size() == 3);
+        t.pop();
+        assert(vars.index == 0);
+    }
+}
+
+void test_sequencer_rollback() {
+    trail t;
+    sequencer vars(t);
+    vars.index = 9;
+    vars.logged_depth = 4;
+    vars.rollback(3, 1);
+    assert(vars.index == 3);
+    assert(vars.logged_depth == 1);
+}
+
 void test_copier_constructor() {
     trail t;
     sequencer vars(t);
@@ -10750,642 +12688,86 @@ void test_copier_constructor() {
 }
 
 void test_copier() {
-    // Test 1: Copy atom - should return same pointer (atoms are immutable)
+    trail t;
+    sequencer vars(t);
+    expr_pool pool(t);
+    copier copy(vars, pool);
+    const expr* X = pool.var(0);
+    const expr* Y = pool.var(1);
+    const expr* a = pool.functor("a");
+
+    // Slots are offset by the base; the sequencer is not consulted
+    {
+        rule r(pool.functor("p", {Y, pool.functor("f", {X, Y})}), {pool.functor("q", {X})});
+        assert(copy(r.head_template, 10) == pool.functor("p", {pool.var(10), pool.functor("f", {pool.var(11), pool.var(10)})}));
+        assert(copy(r.body_template[0], 10) == pool.functor("q", {pool.var(11)}));
+        assert(vars.index == 0);
+    }
+
+    // Ground subterms are shared rather than rebuilt
+    {
+        const expr* g = pool.functor("g", {a});
+        rule r(pool.functor("p", {g, X}), {g});
+        const expr* copied = copy(r.head_template, 3);
+        assert(std::get<expr::functor>(copied->content).args[0] == g);
+        assert(copy(r.body_template[0], 3) == g);
+    }
+
+    // Slots follow copy order, so the head and body share one renaming
+    {
+        rule r(pool.functor("p", {X, pool.functor("cons", {Y, X})}), {pool.functor("q", {Y, a})});
+        const expr* X20 = pool.var(20);
+        const expr* Y21 = pool.var(21);
+        assert(copy(r.head_template, 20) == pool.functor("p", {X20, pool.functor("cons", {Y21, X20})}));
+        assert(copy(r.body_template[0], 20) == pool.functor("q", {Y21, a}));
+    }
+
+    // Deep templates are replayed without recursion
+    {
+        const uint32_t n = 200000;
+        const expr* list = pool.functor("nil");
+        for (uint32_t i = n; i-- > 0;)
+            list = pool.functor("cons", {pool.var(i), list});
+        rule r(list, {});
+        assert(r.vars.size() == n);
+        const expr* cur = copy(r.head_template, n);
+        for (uint32_t i = 0; i < n; ++i) {
+            const expr::functor& f = std::get<expr::functor>(cur->content);
+            assert(f.args[0] == pool.var(n + i));
+            cur = f.args[1];
+        }
+        assert(cur == pool.functor("nil"));
+    }
+}
+
+void test_copier_reserve() {
+    // A block is handed out in one piece, logging a single watermark
     {
         trail t;
         sequencer vars(t);
         expr_pool pool(t);
         copier copy(vars, pool);
-        
         t.push();
-        
-        const expr* original = pool.functor("test", {});
-        assert(pool.size() == 1);
-        assert(pool.exprs.size() == 1);
-        
-        std::map<uint32_t, uint32_t> var_map;
-        
-        const expr* copied = copy(original, var_map);
-        
-        assert(copied == original);  // Same atom
-        assert(var_map.empty());  // No variables mapped
-        assert(vars.index == 0);  // No fresh vars created
-        assert(pool.size() == 1);  // No new entries
-        assert(pool.exprs.size() == 1);
-        
-        t.pop();
-    }
-    
-    // Test 2: Copy single variable - creates fresh variable
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* original = pool.var(5);
-        assert(pool.size() == 1);
-        assert(pool.exprs.size() == 1);
-        assert(pool.exprs.count(*original) == 1);
-        
-        std::map<uint32_t, uint32_t> var_map;
-        
-        const expr* copied = copy(original, var_map);
-        
-        assert(copied != original);  // Different variable
-        assert(std::holds_alternative<expr::var>(copied->content));
-        assert(std::get<expr::var>(copied->content).index == 0);  // Fresh var starts at 0
-        assert(var_map.size() == 1);
-        assert(var_map.at(5) == 0);  // Original index 5 mapped to 0
-        assert(vars.index == 1);
-        assert(pool.size() == 2);  // Original var(5) and new var(0)
-        assert(pool.exprs.size() == 2);
-        assert(pool.exprs.count(*original) == 1);
-        assert(pool.exprs.count(*copied) == 1);
-        
-        t.pop();
-    }
-    
-    // Test 3: Copy same variable twice - should use same mapping
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* original = pool.var(10);
-        assert(pool.size() == 1);
-        
-        std::map<uint32_t, uint32_t> var_map;
-        
-        const expr* copied1 = copy(original, var_map);
-        assert(std::get<expr::var>(copied1->content).index == 0);
-        assert(var_map.size() == 1);
-        assert(var_map.at(10) == 0);
-        assert(vars.index == 1);
-        assert(pool.size() == 2);
-        assert(pool.exprs.size() == 2);
-        
-        const expr* copied2 = copy(original, var_map);
-        assert(copied2 == copied1);  // Should be same pointer (interned)
-        assert(var_map.size() == 1);  // No new mapping
-        assert(vars.index == 1);  // No new variable
-        assert(pool.size() == 2);  // Still 2
-        assert(pool.exprs.size() == 2);
-        
-        t.pop();
-    }
-    
-    // Test 4: Copy cons with atoms
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* a = pool.functor("a", {});
-        const expr* b = pool.functor("b", {});
-        const expr* original = pool.functor("cons", {a, b});
-        assert(pool.size() == 3);
-        assert(pool.exprs.size() == 3);
-        
-        std::map<uint32_t, uint32_t> var_map;
-        
-        const expr* copied = copy(original, var_map);
-        
-        assert(copied == original);  // Same cons since atoms unchanged
-        assert(var_map.empty());  // No variables
-        assert(vars.index == 0);
-        assert(pool.size() == 3);  // No new entries
-        assert(pool.exprs.size() == 3);
-        
-        t.pop();
-    }
-    
-    // Test 5: Copy cons with variables
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* v1 = pool.var(10);
-        const expr* v2 = pool.var(20);
-        const expr* original = pool.functor("cons", {v1, v2});
-        std::map<uint32_t, uint32_t> var_map;
-        
-        const expr* copied = copy(original, var_map);
-        
-        assert(copied != original);  // Different cons (different vars)
-        assert(std::holds_alternative<expr::functor>(copied->content));
-        
-        const expr::functor& copied_cons = std::get<expr::functor>(copied->content);
-        assert(std::get<expr::var>(copied_cons.args[0]->content).index == 0);
-        assert(std::get<expr::var>(copied_cons.args[1]->content).index == 1);
-        
-        assert(var_map.size() == 2);
-        assert(var_map.at(10) == 0);
-        assert(var_map.at(20) == 1);
-        assert(vars.index == 2);
-        
-        // Pool should contain: var(10), var(20), original cons, var(0), var(1), new cons
-        assert(pool.size() == 6);
-        assert(pool.exprs.size() == 6);
-        assert(pool.exprs.count(*v1) == 1);
-        assert(pool.exprs.count(*v2) == 1);
-        assert(pool.exprs.count(*original) == 1);
-        assert(pool.exprs.count(*copied_cons.args[0]) == 1);
-        assert(pool.exprs.count(*copied_cons.args[1]) == 1);
-        assert(pool.exprs.count(*copied) == 1);
-        
-        t.pop();
-    }
-    
-    // Test 6: Copy cons with same variable in both positions
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* v = pool.var(5);
-        const expr* original = pool.functor("cons", {v, v});
-        assert(pool.size() == 2);  // var(5) and cons
-        
-        std::map<uint32_t, uint32_t> var_map;
-        
-        const expr* copied = copy(original, var_map);
-        
-        const expr::functor& copied_cons = std::get<expr::functor>(copied->content);
-        assert(std::get<expr::var>(copied_cons.args[0]->content).index == 0);
-        assert(std::get<expr::var>(copied_cons.args[1]->content).index == 0);
-        assert(copied_cons.args[0] == copied_cons.args[1]);  // Same variable
-        
-        assert(var_map.size() == 1);
-        assert(var_map.at(5) == 0);
-        assert(vars.index == 1);  // Only one fresh variable created
-        
-        // Pool: var(5), original cons, var(0), new cons
-        assert(pool.size() == 4);
-        assert(pool.exprs.size() == 4);
-        assert(pool.exprs.count(*v) == 1);
-        assert(pool.exprs.count(*original) == 1);
-        assert(pool.exprs.count(*copied_cons.args[0]) == 1);
-        assert(pool.exprs.count(*copied) == 1);
-        
-        t.pop();
-    }
-    
-    // Test 7: Copy nested cons with mixed content
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* a = pool.functor("atom", {});
-        const expr* v = pool.var(7);
-        const expr* inner = pool.functor("cons", {a, v});
-        const expr* original = pool.functor("cons", {inner, a});
-        std::map<uint32_t, uint32_t> var_map;
-        
-        const expr* copied = copy(original, var_map);
-        
-        assert(copied != original);
-        const expr::functor& outer_cons = std::get<expr::functor>(copied->content);
-        assert(outer_cons.args[1] == a);  // Atom unchanged
-        
-        const expr::functor& inner_cons = std::get<expr::functor>(outer_cons.args[0]->content);
-        assert(inner_cons.args[0] == a);  // Atom unchanged
-        assert(std::get<expr::var>(inner_cons.args[1]->content).index == 0);
-        
-        assert(var_map.size() == 1);
-        assert(var_map.at(7) == 0);
-        assert(vars.index == 1);
-        
-        t.pop();
-    }
-    
-    // Test 8: Copy deeply nested cons
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* v1 = pool.var(10);
-        const expr* v2 = pool.var(20);
-        const expr* v3 = pool.var(30);
-        const expr* c1 = pool.functor("cons", {v1, v2});
-        const expr* c2 = pool.functor("cons", {c1, v3});
-        const expr* original = pool.functor("cons", {c2, v1});  // v1 appears twice
-        
-        std::map<uint32_t, uint32_t> var_map;
-        const expr* copied = copy(original, var_map);
-        
-        assert(var_map.size() == 3);
-        assert(var_map.at(10) == 0);
-        assert(var_map.at(20) == 1);
-        assert(var_map.at(30) == 2);
-        assert(vars.index == 3);
-        
-        // Verify structure
-        const expr::functor& top = std::get<expr::functor>(copied->content);
-        assert(std::get<expr::var>(top.args[1]->content).index == 0);  // v1 mapped to 0
-        
-        const expr::functor& middle = std::get<expr::functor>(top.args[0]->content);
-        assert(std::get<expr::var>(middle.args[1]->content).index == 2);  // v3 mapped to 2
-        
-        const expr::functor& bottom = std::get<expr::functor>(middle.args[0]->content);
-        assert(std::get<expr::var>(bottom.args[0]->content).index == 0);  // v1 mapped to 0
-        assert(std::get<expr::var>(bottom.args[1]->content).index == 1);  // v2 mapped to 1
-        
-        t.pop();
-    }
-    
-    // Test 9: Copy with pre-populated variable map
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* v5 = pool.var(5);
-        const expr* v10 = pool.var(10);
-        const expr* original = pool.functor("cons", {v5, v10});
-        
-        // Pre-populate map
-        std::map<uint32_t, uint32_t> var_map;
-        var_map[5] = 100;  // Map 5 to 100
-        
-        const expr* copied = copy(original, var_map);
-        
-        // v5 should use existing mapping, v10 should get fresh
-        assert(var_map.size() == 2);
-        assert(var_map.at(5) == 100);  // Unchanged
-        assert(var_map.at(10) == 0);  // Fresh variable
-        
-        const expr::functor& copied_cons = std::get<expr::functor>(copied->content);
-        assert(std::get<expr::var>(copied_cons.args[0]->content).index == 100);
-        assert(std::get<expr::var>(copied_cons.args[1]->content).index == 0);
-        
-        assert(vars.index == 1);  // Only one fresh var created
-        
-        t.pop();
-    }
-    
-    // Test 10: Copy multiple expressions with shared variable map
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* v1 = pool.var(1);
-        const expr* v2 = pool.var(2);
-        const expr* expr1 = pool.functor("cons", {v1, v2});
-        const expr* expr2 = pool.functor("cons", {v2, v1});  // Swapped
-        
-        std::map<uint32_t, uint32_t> var_map;
-        
-        const expr* copied1 = copy(expr1, var_map);
-        assert(var_map.size() == 2);
-        assert(var_map.at(1) == 0);
-        assert(var_map.at(2) == 1);
-        assert(vars.index == 2);
-        
-        const expr* copied2 = copy(expr2, var_map);
-        assert(var_map.size() == 2);  // No new mappings
-        assert(vars.index == 2);  // No new variables
-        
-        // Verify both use same variable mapping
-        const expr::functor& cons1 = std::get<expr::functor>(copied1->content);
-        const expr::functor& cons2 = std::get<expr::functor>(copied2->content);
-        assert(std::get<expr::var>(cons1.args[0]->content).index == 0);
-        assert(std::get<expr::var>(cons1.args[1]->content).index == 1);
-        assert(std::get<expr::var>(cons2.args[0]->content).index == 1);
-        assert(std::get<expr::var>(cons2.args[1]->content).index == 0);
-        
-        t.pop();
-    }
-    
-    // Test 11: Copy empty variable map vs populated
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* v = pool.var(42);
-        
-        std::map<uint32_t, uint32_t> map1;
-        const expr* copy1 = copy(v, map1);
-        assert(std::get<expr::var>(copy1->content).index == 0);
-        assert(map1.at(42) == 0);
-        
-        std::map<uint32_t, uint32_t> map2;
-        const expr* copy2 = copy(v, map2);
-        assert(std::get<expr::var>(copy2->content).index == 1);
-        assert(map2.at(42) == 1);
-        
-        // Different maps, different fresh variables
-        assert(copy1 != copy2);
-        assert(vars.index == 2);
-        
-        t.pop();
-    }
-    
-    // Test 12: Copy complex nested structure
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        // Build: cons(cons(var(1), atom("a")), cons(var(2), var(1)))
-        const expr* v1 = pool.var(1);
-        const expr* v2 = pool.var(2);
-        const expr* a = pool.functor("a", {});
-        const expr* left = pool.functor("cons", {v1, a});
-        const expr* right = pool.functor("cons", {v2, v1});
-        const expr* original = pool.functor("cons", {left, right});
-        
-        std::map<uint32_t, uint32_t> var_map;
-        const expr* copied = copy(original, var_map);
-        
-        assert(var_map.size() == 2);
-        assert(var_map.at(1) == 0);
-        assert(var_map.at(2) == 1);
-        assert(vars.index == 2);
-        
-        // Verify structure: cons(cons(var(0), atom("a")), cons(var(1), var(0)))
-        const expr::functor& top = std::get<expr::functor>(copied->content);
-        
-        const expr::functor& left_cons = std::get<expr::functor>(top.args[0]->content);
-        assert(std::get<expr::var>(left_cons.args[0]->content).index == 0);
-        assert(left_cons.args[1] == a);
-        
-        const expr::functor& right_cons = std::get<expr::functor>(top.args[1]->content);
-        assert(std::get<expr::var>(right_cons.args[0]->content).index == 1);
-        assert(std::get<expr::var>(right_cons.args[1]->content).index == 0);
-        
-        t.pop();
-    }
-    
-    // Test 13: Copy with backtracking
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* v = pool.var(5);
-        const expr* original = pool.functor("cons", {v, pool.functor("x", {})});
-        
-        t.push();
-        std::map<uint32_t, uint32_t> var_map;
-        const expr* copied = copy(original, var_map);
-        assert(vars.index == 1);
-        assert(pool.size() == 5);  // v(5), atom("x"), original cons, v(0), new cons
-        
-        t.pop();
-        assert(vars.index == 0);
-        assert(pool.size() == 3);  // Back to v(5), atom("x"), original cons
-        
-        t.pop();
-    }
-    
-    // Test 14: Multiple variables in sequence
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        std::map<uint32_t, uint32_t> var_map;
-        
-        // Copy variables in order
-        const expr* v10 = pool.var(10);
-        const expr* copy10 = copy(v10, var_map);
-        assert(std::get<expr::var>(copy10->content).index == 0);
-        assert(vars.index == 1);
-        
-        const expr* v20 = pool.var(20);
-        const expr* copy20 = copy(v20, var_map);
-        assert(std::get<expr::var>(copy20->content).index == 1);
-        assert(vars.index == 2);
-        
-        const expr* v30 = pool.var(30);
-        const expr* copy30 = copy(v30, var_map);
-        assert(std::get<expr::var>(copy30->content).index == 2);
-        assert(vars.index == 3);
-        
-        assert(var_map.size() == 3);
-        
-        t.pop();
-    }
-    
-    // Test 15: Copy expression with all three types
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        // Build: cons(atom("a"), cons(var(5), atom("b")))
-        const expr* a = pool.functor("a", {});
-        const expr* b = pool.functor("b", {});
-        const expr* v5 = pool.var(5);
-        const expr* inner = pool.functor("cons", {v5, b});
-        const expr* original = pool.functor("cons", {a, inner});
-        
-        std::map<uint32_t, uint32_t> var_map;
-        const expr* copied = copy(original, var_map);
-        
-        assert(var_map.size() == 1);
-        assert(var_map.at(5) == 0);
-        assert(vars.index == 1);
-        
-        // Verify structure
-        const expr::functor& top = std::get<expr::functor>(copied->content);
-        assert(top.args[0] == a);  // Atom unchanged
-        
-        const expr::functor& inner_cons = std::get<expr::functor>(top.args[1]->content);
-        assert(std::get<expr::var>(inner_cons.args[0]->content).index == 0);
-        assert(inner_cons.args[1] == b);  // Atom unchanged
-        
-        t.pop();
-    }
-    
-    // Test 16: Copy with variable appearing multiple times in deep structure
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* v1 = pool.var(1);
-        const expr* v2 = pool.var(2);
-        // Build: cons(cons(v1, v2), cons(v2, v1))
-        const expr* left = pool.functor("cons", {v1, v2});
-        const expr* right = pool.functor("cons", {v2, v1});
-        const expr* original = pool.functor("cons", {left, right});
-        
-        std::map<uint32_t, uint32_t> var_map;
-        const expr* copied = copy(original, var_map);
-        
-        assert(var_map.size() == 2);
-        assert(var_map.at(1) == 0);
-        assert(var_map.at(2) == 1);
-        assert(vars.index == 2);
-        
-        // Verify all occurrences use consistent mapping
-        const expr::functor& top = std::get<expr::functor>(copied->content);
-        const expr::functor& left_cons = std::get<expr::functor>(top.args[0]->content);
-        const expr::functor& right_cons = std::get<expr::functor>(top.args[1]->content);
-        
-        assert(std::get<expr::var>(left_cons.args[0]->content).index == 0);  // v1
-        assert(std::get<expr::var>(left_cons.args[1]->content).index == 1);  // v2
-        assert(std::get<expr::var>(right_cons.args[0]->content).index == 1);  // v2
-        assert(std::get<expr::var>(right_cons.args[1]->content).index == 0);  // v1
-        
-        t.pop();
-    }
-    
-    // Test 17: Copy atom-only structure
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* a1 = pool.functor("a1", {});
-        const expr* a2 = pool.functor("a2", {});
-        const expr* a3 = pool.functor("a3", {});
-        const expr* c1 = pool.functor("cons", {a1, a2});
-        const expr* original = pool.functor("cons", {c1, a3});
-        
-        std::map<uint32_t, uint32_t> var_map;
-        const expr* copied = copy(original, var_map);
-        
-        assert(copied == original);  // No variables, so same structure
-        assert(var_map.empty());
-        assert(vars.index == 0);
-        
-        t.pop();
-    }
-    
-    // Test 18: Copy with interleaved fresh() calls
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* v10 = pool.var(10);
-        std::map<uint32_t, uint32_t> var_map;
-        
-        copy(v10, var_map);
-        assert(vars.index == 1);
-        assert(var_map.at(10) == 0);
-        
-        // Manually create a fresh variable using vars()
-        const expr* fresh_var = pool.var(vars());
-        assert(std::get<expr::var>(fresh_var->content).index == 1);
-        assert(vars.index == 2);
-        
-        const expr* v20 = pool.var(20);
-        copy(v20, var_map);
-        assert(vars.index == 3);
-        assert(var_map.at(20) == 2);
-        
-        t.pop();
-    }
-    
-    // Test 19: Verify pool interning during copy
-    {
-        trail t;
-        sequencer vars(t);
-        expr_pool pool(t);
-        copier copy(vars, pool);
-        
-        t.push();
-        
-        const expr* v1 = pool.var(1);
-        const expr* a = pool.functor("a", {});
-        const expr* original = pool.functor("cons", {v1, a});
-        
-        std::map<uint32_t, uint32_t> var_map;
-        const expr* copied1 = copy(original, var_map);
-        size_t pool_size_after_first = pool.size();
-        
-        // Copy again with cleared map - creates fresh var(1) which already exists!
-        var_map.clear();
-        const expr* copied2 = copy(original, var_map);
-        
-        // Fresh variable is var(1), which already exists, so gets interned
-        // cons(var(1), atom("a")) also already exists, so also interned
-        assert(vars.index == 2);
-        assert(pool.exprs.size() == pool_size_after_first);  // No new entries due to interning
-        assert(copied2 == original);  // Should be same as original due to interning!
-        
+        vars();
+        assert(copy.reserve(3) == 1);
+        assert(vars.index == 4);
+        assert(t.undo_stack.size() == 2);
+        assert(copy.reserve(2) == 4);
+        assert(t.undo_stack.size() == 2);
         t.pop();
+        assert(vars.index == 0);
     }
-    
-    // Test 20: Copy with zero-indexed variables
+
+    // Nothing is reserved or logged for an empty block
     {
         trail t;
         sequencer vars(t);
         expr_pool pool(t);
         copier copy(vars, pool);
-        
         t.push();
-        
-        const expr* v0 = pool.var(0);
-        const expr* v1 = pool.var(1);
-        const expr* original = pool.functor("cons", {v0, v1});
-        
-        std::map<uint32_t, uint32_t> var_map;
-        const expr* copied = copy(original, var_map);
-        
-        assert(var_map.at(0) == 0);  // 0 maps to fresh 0
-        assert(var_map.at(1) == 1);  // 1 maps to fresh 1
-        assert(vars.index == 2);
-        
+        assert(copy.reserve(0) == 0);
+        assert(vars.index == 0);
+        assert(t.undo_stack.empty());
         t.pop();
     }
 }
@@ -11469,7 +12851,7 @@ void test_normalizer() {
         
         assert(result == a);
         assert(std::holds_alternative<expr::functor>(result->content));
-        assert(std::get<expr::functor>(result->content).name == "hello");
+        assert(symbols().name(std::get<expr::functor>(result->content).id) == "hello");
         
         t.pop();
     }
@@ -11495,7 +12877,7 @@ void test_normalizer() {
         const expr* result = norm(v1);
         
         assert(result == a);
-        assert(std::get<expr::functor>(result->content).name == "end");
+        assert(symbols().name(std::get<expr::functor>(result->content).id) == "end");
         
         t.pop();
     }
@@ -11931,6 +13313,46 @@ void test_normalizer() {
         
         t.pop();
     }
+
+    // Vars bound to integers normalize to the integer in the target pool
+    {
+        trail t;
+        expr_pool src(t);
+        expr_pool pool(t);
+        bind_map bm(t);
+        normalizer norm(pool, bm);
+
+        t.push();
+
+        bm.bind(0, src.integer(-3));
+        const expr* result = norm(pool.functor("f", {pool.var(0), pool.integer(4)}));
+        assert(result == pool.functor("f", {pool.integer(-3), pool.integer(4)}));
+
+        t.pop();
+    }
+
+    // Deep terms are normalized without recursion
+    {
+        trail t;
+        expr_pool pool(t);
+        bind_map bm(t);
+        normalizer norm(pool, bm);
+
+        t.push();
+
+        const uint32_t n = 200000;
+        const expr* open = pool.var(0);
+        const expr* closed = pool.integer(7);
+        for (uint32_t i = 0; i < n; ++i) {
+            open = pool.functor("s", {open});
+            closed = pool.functor("s", {closed});
+        }
+        bm.bind(0, pool.var(1));
+        bm.bind(1, pool.integer(7));
+        assert(norm(open) == closed);
+
+        t.pop();
+    }
 }
 
 // Concrete frontier for use in frontier tests.
@@ -12254,6 +13676,313 @@ void test_expr_printer() {
         assert(oss.str() == "[X, Y, Z]");
         t.pop();
     }
+
+    // Test 20: Integers print as decimal literals, including inside lists
+    {
+        trail t;
+        expr_pool pool(t);
+        t.push();
+        std::map<uint32_t, std::string> var_names;
+        std::ostringstream oss;
+        expr_printer ep(oss, var_names);
+        ep(pool.functor("f", {pool.integer(-12), pool.integer(0)}));
+        oss << " ";
+        ep(pool.functor("cons", {pool.integer(1), pool.functor("cons", {pool.integer(2), pool.functor("nil", {})})}));
+        assert(oss.str() == "f(-12, 0) [1, 2]");
+        t.pop();
+    }
+}
+
+void test_builtins_contains() {
+    trail t;
+    expr_pool ep(t);
+    t.push();
+
+    // Reserved names at their fixed arities are builtins
+    assert(builtins::contains(ep.functor("int_add", {ep.var(0), ep.var(1), ep.var(2)})));
+    assert(builtins::contains(ep.functor("int_sub", {ep.var(0), ep.var(1), ep.var(2)})));
+    assert(builtins::contains(ep.functor("int_mul", {ep.var(0), ep.var(1), ep.var(2)})));
+    assert(builtins::contains(ep.functor("int_lt", {ep.var(0), ep.var(1)})));
+    assert(builtins::contains(ep.functor("int_le", {ep.var(0), ep.var(1)})));
+    assert(builtins::contains(ep.functor("int_gt", {ep.var(0), ep.var(1)})));
+    assert(builtins::contains(ep.functor("int_ge", {ep.var(0), ep.var(1)})));
+
+    // Other arities, other names, vars and integers are not
+    assert(!builtins::contains(ep.functor("int_add", {ep.var(0), ep.var(1)})));
+    assert(!builtins::contains(ep.functor("int_lt", {ep.var(0), ep.var(1), ep.var(2)})));
+    assert(!builtins::contains(ep.functor("add", {ep.var(0), ep.var(1), ep.var(2)})));
+    assert(!builtins::contains(ep.functor("int_add")));
+    assert(!builtins::contains(ep.var(0)));
+    assert(!builtins::contains(ep.integer(1)));
+
+    t.pop();
+}
+
+void test_builtins_rule_at() {
+    trail t;
+    expr_pool ep(t);
+    t.push();
+
+    database db;
+    db.push_back(rule{ep.functor("a"), {}});
+    db.push_back(rule{ep.functor("b"), {ep.functor("a")}});
+
+    // Database indices pass straight through
+    assert(&builtins::rule_at(db, 0) == &db[0]);
+    assert(&builtins::rule_at(db, 1) == &db[1]);
+
+    // The builtin candidate maps to a shared, bodiless stand-in
+    const rule& r = builtins::rule_at(db, builtins::candidate);
+    assert(r.head == nullptr);
+    assert(r.body.empty());
+    assert(&builtins::rule_at(database{}, builtins::candidate) == &r);
+
+    // Anything else out of range still throws
+    bool threw = false;
+    try { builtins::rule_at(db, 2); } catch (const std::out_of_range&) { threw = true; }
+    assert(threw);
+
+    t.pop();
+}
+
+void test_builtins_constructor() {
+    trail t;
+    expr_pool ep(t);
+    bind_map bm(t);
+    builtins bi(bm, ep);
+    assert(&bi.bm == &bm);
+    assert(&bi.ep == &ep);
+}
+
+void test_builtins_ready() {
+    trail t;
+    expr_pool ep(t);
+    bind_map bm(t);
+    builtins bi(bm, ep);
+    t.push();
+
+    const expr* X = ep.var(0);
+    const expr* Y = ep.var(1);
+    const expr* Z = ep.var(2);
+    const expr* two = ep.integer(2);
+    const expr* six = ep.integer(6);
+    const expr* zero = ep.integer(0);
+
+    // int_add / int_sub need any two of their three arguments
+    for (const char* name : {"int_add", "int_sub"}) {
+        assert(!bi.ready(ep.functor(name, {X, Y, Z})));
+        assert(!bi.ready(ep.functor(name, {two, Y, Z})));
+        assert(!bi.ready(ep.functor(name, {X, Y, six})));
+        assert(bi.ready(ep.functor(name, {two, six, Z})));
+        assert(bi.ready(ep.functor(name, {two, Y, six})));
+        assert(bi.ready(ep.functor(name, {X, two, six})));
+        assert(bi.ready(ep.functor(name, {two, two, six})));
+    }
+
+    // int_mul additionally fires on a lone zero factor
+    assert(!bi.ready(ep.functor("int_mul", {two, Y, Z})));
+    assert(!bi.ready(ep.functor("int_mul", {X, Y, six})));
+    assert(bi.ready(ep.functor("int_mul", {two, six, Z})));
+    assert(bi.ready(ep.functor("int_mul", {two, Y, six})));
+    assert(bi.ready(ep.functor("int_mul", {X, two, six})));
+    assert(bi.ready(ep.functor("int_mul", {zero, Y, Z})));
+    assert(bi.ready(ep.functor("int_mul", {X, zero, Z})));
+
+    // Comparisons need both sides
+    for (const char* name : {"int_lt", "int_le", "int_gt", "int_ge"}) {
+        assert(!bi.ready(ep.functor(name, {X, Y})));
+        assert(!bi.ready(ep.functor(name, {two, Y})));
+        assert(!bi.ready(ep.functor(name, {X, two})));
+        assert(bi.ready(ep.functor(name, {two, six})));
+    }
+
+    // Arguments are read through the bindings
+    const expr* lt = ep.functor("int_lt", {X, Y});
+    bm.bind(0, two);
+    assert(!bi.ready(lt));
+    bm.bind(1, ep.var(3));
+    assert(!bi.ready(lt));
+    bm.bind(3, six);
+    assert(bi.ready(lt));
+
+    // A bound non-integer argument decides the goal on its own
+    assert(bi.ready(ep.functor("int_add", {ep.functor("a"), Z, ep.var(4)})));
+    assert(bi.ready(ep.functor("int_gt", {ep.var(5), ep.functor("f", {ep.var(6)})})));
+
+    t.pop();
+}
+
+void test_builtins_evaluate() {
+    // Addition and subtraction solve for whichever argument is free
+    {
+        trail t;
+        expr_pool ep(t);
+        bind_map bm(t);
+        builtins bi(bm, ep);
+        t.push();
+
+        assert(bi.evaluate(ep.functor("int_add", {ep.integer(2), ep.integer(3), ep.var(0)})));
+        assert(bm.whnf(ep.var(0)) == ep.integer(5));
+        assert(bi.evaluate(ep.functor("int_add", {ep.integer(2), ep.var(1), ep.integer(-3)})));
+        assert(bm.whnf(ep.var(1)) == ep.integer(-5));
+        assert(bi.evaluate(ep.functor("int_add", {ep.var(2), ep.integer(4), ep.integer(10)})));
+        assert(bm.whnf(ep.var(2)) == ep.integer(6));
+
+        assert(bi.evaluate(ep.functor("int_sub", {ep.integer(2), ep.integer(3), ep.var(3)})));
+        assert(bm.whnf(ep.var(3)) == ep.integer(-1));
+        assert(bi.evaluate(ep.functor("int_sub", {ep.integer(10), ep.var(4), ep.integer(4)})));
+        assert(bm.whnf(ep.var(4)) == ep.integer(6));
+        assert(bi.evaluate(ep.functor("int_sub", {ep.var(5), ep.integer(4), ep.integer(10)})));
+        assert(bm.whnf(ep.var(5)) == ep.integer(14));
+
+        // Fully bound goals are checked
+        assert(bi.evaluate(ep.functor("int_add", {ep.integer(1), ep.integer(1), ep.integer(2)})));
+        assert(!bi.evaluate(ep.functor("int_add", {ep.integer(1), ep.integer(1), ep.integer(3)})));
+        assert(!bi.evaluate(ep.functor("int_sub", {ep.var(0), ep.var(1), ep.var(2)})));
+
+        t.pop();
+        assert(bm.bindings.empty());
+    }
+
+    // Multiplication solves for a factor only when it divides exactly
+    {
+        trail t;
+        expr_pool ep(t);
+        bind_map bm(t);
+        builtins bi(bm, ep);
+        t.push();
+
+        assert(bi.evaluate(ep.functor("int_mul", {ep.integer(-4), ep.integer(3), ep.var(0)})));
+        assert(bm.whnf(ep.var(0)) == ep.integer(-12));
+        assert(bi.evaluate(ep.functor("int_mul", {ep.integer(4), ep.var(1), ep.integer(12)})));
+        assert(bm.whnf(ep.var(1)) == ep.integer(3));
+        assert(bi.evaluate(ep.functor("int_mul", {ep.var(2), ep.integer(-3), ep.integer(12)})));
+        assert(bm.whnf(ep.var(2)) == ep.integer(-4));
+        assert(!bi.evaluate(ep.functor("int_mul", {ep.integer(5), ep.var(3), ep.integer(12)})));
+        assert(bm.whnf(ep.var(3)) == ep.var(3));
+
+        // A zero factor fixes the product and leaves the other factor free
+        assert(bi.evaluate(ep.functor("int_mul", {ep.integer(0), ep.var(4), ep.var(5)})));
+        assert(bm.whnf(ep.var(4)) == ep.var(4));
+        assert(bm.whnf(ep.var(5)) == ep.integer(0));
+        assert(!bi.evaluate(ep.functor("int_mul", {ep.var(6), ep.integer(0), ep.integer(7)})));
+
+        t.pop();
+    }
+
+    // Comparisons
+    {
+        trail t;
+        expr_pool ep(t);
+        bind_map bm(t);
+        builtins bi(bm, ep);
+        t.push();
+
+        const expr* one = ep.integer(1);
+        const expr* two = ep.integer(2);
+        assert(bi.evaluate(ep.functor("int_lt", {one, two})));
+        assert(!bi.evaluate(ep.functor("int_lt", {two, two})));
+        assert(bi.evaluate(ep.functor("int_le", {two, two})));
+        assert(!bi.evaluate(ep.functor("int_le", {two, one})));
+        assert(bi.evaluate(ep.functor("int_gt", {two, one})));
+        assert(!bi.evaluate(ep.functor("int_gt", {one, one})));
+        assert(bi.evaluate(ep.functor("int_ge", {one, one})));
+        assert(!bi.evaluate(ep.functor("int_ge", {one, two})));
+        assert(bm.bindings.empty());
+
+        t.pop();
+    }
+
+    // Overflow, division overflow and non-integer arguments fail
+    {
+        trail t;
+        expr_pool ep(t);
+        bind_map bm(t);
+        builtins bi(bm, ep);
+        t.push();
+
+        assert(!bi.evaluate(ep.functor("int_add", {ep.integer(INT64_MAX), ep.integer(1), ep.var(0)})));
+        assert(!bi.evaluate(ep.functor("int_sub", {ep.integer(INT64_MIN), ep.integer(1), ep.var(0)})));
+        assert(!bi.evaluate(ep.functor("int_mul", {ep.integer(INT64_MAX), ep.integer(2), ep.var(0)})));
+        assert(!bi.evaluate(ep.functor("int_mul", {ep.integer(-1), ep.var(0), ep.integer(INT64_MIN)})));
+        assert(!bi.evaluate(ep.functor("int_add", {ep.functor("a"), ep.integer(1), ep.var(0)})));
+        assert(!bi.evaluate(ep.functor("int_lt", {ep.integer(1), ep.functor("b")})));
+        assert(bm.bindings.empty());
+
+        t.pop();
+    }
+
+    // Evaluating before enough arguments are bound is a logic error
+    {
+        trail t;
+        expr_pool ep(t);
+        bind_map bm(t);
+        builtins bi(bm, ep);
+        t.push();
+
+        bool threw = false;
+        try { bi.evaluate(ep.functor("int_lt", {ep.integer(1), ep.var(0)})); } catch (const std::logic_error&) { threw = true; }
+        assert(threw);
+
+        t.pop();
+    }
+}
+
+void test_builtins_lookup() {
+    trail t;
+    expr_pool ep(t);
+    t.push();
+
+    const expr* X = ep.var(0);
+    assert(builtins::lookup(ep.functor("int_add", {X, X, X})) == builtins::op::add);
+    assert(builtins::lookup(ep.functor("int_sub", {X, X, X})) == builtins::op::sub);
+    assert(builtins::lookup(ep.functor("int_mul", {X, X, X})) == builtins::op::mul);
+    assert(builtins::lookup(ep.functor("int_lt", {X, X})) == builtins::op::lt);
+    assert(builtins::lookup(ep.functor("int_le", {X, X})) == builtins::op::le);
+    assert(builtins::lookup(ep.functor("int_gt", {X, X})) == builtins::op::gt);
+    assert(builtins::lookup(ep.functor("int_ge", {X, X})) == builtins::op::ge);
+    assert(!builtins::lookup(ep.functor("int_ge", {X})).has_value());
+    assert(!builtins::lookup(X).has_value());
+    assert(!builtins::lookup(ep.integer(0)).has_value());
+
+    t.pop();
+}
+
+void test_builtins_value() {
+    trail t;
+    expr_pool ep(t);
+    bind_map bm(t);
+    builtins bi(bm, ep);
+    t.push();
+
+    assert(bi.value(ep.integer(-8)) == -8);
+    assert(!bi.value(ep.var(0)).has_value());
+    assert(!bi.value(ep.functor("a")).has_value());
+
+    // values are read through chains of bindings
+    bm.bind(0, ep.var(1));
+    bm.bind(1, ep.integer(8));
+    assert(bi.value(ep.var(0)) == 8);
+
+    t.pop();
+}
+
+void test_builtins_bound_non_integer() {
+    trail t;
+    expr_pool ep(t);
+    bind_map bm(t);
+    builtins bi(bm, ep);
+    t.push();
+
+    assert(!bi.bound_non_integer(ep.integer(3)));
+    assert(!bi.bound_non_integer(ep.var(0)));
+    assert(bi.bound_non_integer(ep.functor("a")));
+    assert(bi.bound_non_integer(ep.functor("f", {ep.integer(3)})));
+
+    bm.bind(0, ep.functor("a"));
+    assert(bi.bound_non_integer(ep.var(0)));
+
+    t.pop();
 }
 void test_frontier_constructor() {
     // Test 1: empty database and fresh pool - db and lp refs stored, members empty
@@ -12523,6 +14252,25 @@ void test_frontier_size() {
     }
 }
 
+void test_frontier_contains() {
+    database db;
+    lineage_pool lp;
+    int_frontier f(db, lp);
+    const goal_lineage* gl0 = lp.goal(nullptr, 0);
+    const goal_lineage* gl1 = lp.goal(nullptr, 1);
+
+    // Only inserted goals are members
+    assert(!f.contains(gl0));
+    f.insert(gl0, 1);
+    assert(f.contains(gl0));
+    assert(!f.contains(gl1));
+
+    // Resolved goals leave the frontier
+    db.push_back(rule{nullptr, {}});
+    f.resolve(lp.resolution(gl0, 0));
+    assert(!f.contains(gl0));
+}
+
 void test_frontier_at() {
     // Test 1: at() retrieves the inserted value
     {
@@ -13134,12 +14882,14 @@ void test_goal_store_constructor() {
         lineage_pool lp;
         database db;
         goals gs_init;
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         assert(gs.empty());
         assert(gs.size() == 0);
         assert(&gs.db == &db);
         assert(&gs.cp == &cp);
         assert(&gs.bm == &bm);
+        assert(&gs.bi == &bi);
         assert(&gs.lp == &lp);
     }
 
@@ -13155,7 +14905,8 @@ void test_goal_store_constructor() {
         database db;
         const expr* a = ep.functor("p", {});
         goals gs_init = {a};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         assert(gs.size() == 1);
         assert(!gs.empty());
         assert(gs.at(lp.goal(nullptr, 0)) == a);
@@ -13175,7 +14926,8 @@ void test_goal_store_constructor() {
         const expr* a0 = ep.functor("first", {});
         const expr* a1 = ep.functor("second", {});
         goals gs_init = {a0, a1};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         assert(gs.size() == 2);
         assert(gs.at(lp.goal(nullptr, 0)) == a0);
         assert(gs.at(lp.goal(nullptr, 1)) == a1);
@@ -13198,7 +14950,8 @@ void test_goal_store_constructor() {
         const expr* e3 = ep.functor("d", {});
         const expr* e4 = ep.functor("e", {});
         goals gs_init = {e0, e1, e2, e3, e4};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         assert(gs.size() == 5);
         assert(gs.at(lp.goal(nullptr, 0)) == e0);
         assert(gs.at(lp.goal(nullptr, 1)) == e1);
@@ -13220,7 +14973,8 @@ void test_goal_store_constructor() {
         database db;
         const expr* a = ep.functor("goal", {});
         goals gs_init = {a};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* stored = gs.at(lp.goal(nullptr, 0));
         assert(stored == a);  // same pointer, not a copy
         t.pop();
@@ -13228,7 +14982,7 @@ void test_goal_store_constructor() {
 }
 
 void test_goal_store_try_unify_head() {
-    // Test 1: atom head == atom goal -> returns true, no bindings, translation_map untouched
+    // Test 1: atom head == atom goal -> returns true, no bindings, nothing reserved
     {
         trail t;
         expr_pool ep(t);
@@ -13239,21 +14993,22 @@ void test_goal_store_try_unify_head() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* h = ep.functor("match", {});
         rule r = {h, {}};
         const expr* goal = ep.functor("match", {});
-        std::map<uint32_t, uint32_t> tm;
+        uint32_t base;
         assert(t.depth() == 1);
-        bool result = gs.try_unify_head(goal, r, tm);
+        bool result = gs.try_unify_head(goal, r, base);
         assert(result == true);
         assert(bm.bindings.empty());
-        assert(tm.empty());  // no vars in head
+        assert(seq.index == 0);  // no vars in head
         assert(t.depth() == 1);
         t.pop();
     }
 
-    // Test 2: atom head != atom goal -> returns false, no bindings, no map entries
+    // Test 2: atom head != atom goal -> returns false, no bindings, nothing reserved
     {
         trail t;
         expr_pool ep(t);
@@ -13264,16 +15019,17 @@ void test_goal_store_try_unify_head() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* h = ep.functor("foo", {});
         rule r = {h, {}};
         const expr* goal = ep.functor("bar", {});
-        std::map<uint32_t, uint32_t> tm;
+        uint32_t base;
         assert(t.depth() == 1);
-        bool result = gs.try_unify_head(goal, r, tm);
+        bool result = gs.try_unify_head(goal, r, base);
         assert(!result);
         assert(bm.bindings.empty());
-        assert(tm.empty());
+        assert(seq.index == 0);
         assert(t.depth() == 1);
         t.pop();
     }
@@ -13289,13 +15045,14 @@ void test_goal_store_try_unify_head() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* h = ep.functor("cons", {ep.functor("a", {}), ep.functor("b", {})});
         rule r = {h, {}};
         const expr* goal = ep.functor("a", {});
-        std::map<uint32_t, uint32_t> tm;
+        uint32_t base;
         assert(t.depth() == 1);
-        bool result = gs.try_unify_head(goal, r, tm);
+        bool result = gs.try_unify_head(goal, r, base);
         assert(!result);
         assert(bm.bindings.empty());
         assert(t.depth() == 1);
@@ -13313,13 +15070,14 @@ void test_goal_store_try_unify_head() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* h = ep.functor("h", {});
         rule r = {h, {}};
         const expr* goal = ep.functor("cons", {ep.functor("a", {}), ep.functor("b", {})});
-        std::map<uint32_t, uint32_t> tm;
+        uint32_t base;
         assert(t.depth() == 1);
-        bool result = gs.try_unify_head(goal, r, tm);
+        bool result = gs.try_unify_head(goal, r, base);
         assert(!result);
         assert(bm.bindings.empty());
         assert(t.depth() == 1);
@@ -13337,18 +15095,18 @@ void test_goal_store_try_unify_head() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* v = ep.var(seq());
         rule r = {v, {}};
         const expr* goal = ep.functor("x", {});
-        std::map<uint32_t, uint32_t> tm;
+        uint32_t base;
         assert(t.depth() == 1);
-        bool result = gs.try_unify_head(goal, r, tm);
+        bool result = gs.try_unify_head(goal, r, base);
         assert(result == true);
         assert(t.depth() == 1);
-        // get the fresh index from the translation_map and verify the binding
-        uint32_t var_idx = std::get<expr::var>(v->content).index;
-        const expr* fresh_var = ep.var(tm.at(var_idx));
+        // the only var takes slot 0 of the reserved block
+        const expr* fresh_var = ep.var(base);
         assert(bm.whnf(fresh_var) == goal);
         t.pop();
     }
@@ -13364,22 +15122,22 @@ void test_goal_store_try_unify_head() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* v = ep.var(seq());
         rule r = {v, {}};
         const expr* goal = ep.functor("cons", {ep.functor("l", {}), ep.functor("r", {})});
-        std::map<uint32_t, uint32_t> tm;
+        uint32_t base;
         assert(t.depth() == 1);
-        bool result = gs.try_unify_head(goal, r, tm);
+        bool result = gs.try_unify_head(goal, r, base);
         assert(result == true);
         assert(t.depth() == 1);
-        uint32_t var_idx = std::get<expr::var>(v->content).index;
-        const expr* fresh_var = ep.var(tm.at(var_idx));
+        const expr* fresh_var = ep.var(base);
         assert(bm.whnf(fresh_var) == goal);
         t.pop();
     }
 
-    // Test 7: translation_map is populated correctly after a single-var call
+    // Test 7: a single-var head reserves one fresh index past the sequencer's
     {
         trail t;
         expr_pool ep(t);
@@ -13390,18 +15148,19 @@ void test_goal_store_try_unify_head() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* v = ep.var(seq());
         uint32_t var_idx = std::get<expr::var>(v->content).index;
         rule r = {v, {}};
         const expr* goal = ep.functor("target", {});
-        std::map<uint32_t, uint32_t> tm;
+        uint32_t base;
         assert(t.depth() == 1);
-        gs.try_unify_head(goal, r, tm);
+        gs.try_unify_head(goal, r, base);
         assert(t.depth() == 1);
-        assert(tm.size() == 1);
-        assert(tm.count(var_idx) == 1);
-        assert(bm.whnf(ep.var(tm.at(var_idx))) == goal);
+        assert(base == var_idx + 1);
+        assert(seq.index == base + 1);
+        assert(bm.whnf(ep.var(base)) == goal);
         t.pop();
     }
 
@@ -13416,22 +15175,22 @@ void test_goal_store_try_unify_head() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* v = ep.var(seq());
         const expr* h = ep.functor("cons", {v, ep.functor("b", {})});
         rule r = {h, {}};
         const expr* goal = ep.functor("cons", {ep.functor("a", {}), ep.functor("b", {})});
-        std::map<uint32_t, uint32_t> tm;
+        uint32_t base;
         assert(t.depth() == 1);
-        bool result = gs.try_unify_head(goal, r, tm);
+        bool result = gs.try_unify_head(goal, r, base);
         assert(result == true);
         assert(t.depth() == 1);
-        uint32_t var_idx = std::get<expr::var>(v->content).index;
-        assert(bm.whnf(ep.var(tm.at(var_idx))) == ep.functor("a", {}));
+        assert(bm.whnf(ep.var(base)) == ep.functor("a", {}));
         t.pop();
     }
 
-    // Test 9: cons head with two distinct vars -> translation_map has 2 entries, both bound
+    // Test 9: cons head with two distinct vars -> a block of 2 is reserved, both bound
     {
         trail t;
         expr_pool ep(t);
@@ -13442,26 +15201,25 @@ void test_goal_store_try_unify_head() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* v1 = ep.var(seq());
         const expr* v2 = ep.var(seq());
         const expr* h = ep.functor("cons", {v1, v2});
         rule r = {h, {}};
         const expr* goal = ep.functor("cons", {ep.functor("a", {}), ep.functor("b", {})});
-        std::map<uint32_t, uint32_t> tm;
+        uint32_t base;
         assert(t.depth() == 1);
-        bool result = gs.try_unify_head(goal, r, tm);
+        bool result = gs.try_unify_head(goal, r, base);
         assert(result == true);
-        assert(tm.size() == 2);
+        assert(seq.index == base + 2);
         assert(t.depth() == 1);
-        uint32_t idx1 = std::get<expr::var>(v1->content).index;
-        uint32_t idx2 = std::get<expr::var>(v2->content).index;
-        assert(bm.whnf(ep.var(tm.at(idx1))) == ep.functor("a", {}));
-        assert(bm.whnf(ep.var(tm.at(idx2))) == ep.functor("b", {}));
+        assert(bm.whnf(ep.var(base)) == ep.functor("a", {}));
+        assert(bm.whnf(ep.var(base + 1)) == ep.functor("b", {}));
         t.pop();
     }
 
-    // Test 10: pre-populated translation_map -> copier reuses existing mapping, no new seq() call
+    // Test 10: each call reserves its own block, so instances never share vars
     {
         trail t;
         expr_pool ep(t);
@@ -13472,25 +15230,53 @@ void test_goal_store_try_unify_head() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* v = ep.var(seq());
-        uint32_t var_idx = std::get<expr::var>(v->content).index;
-        rule r = {v, {}};
-        // pre-populate translation_map: map var_idx to a manually allocated fresh index
-        uint32_t pre_fresh = seq();
-        std::map<uint32_t, uint32_t> tm;
-        tm[var_idx] = pre_fresh;
-        uint32_t idx_before = seq.index;  // snapshot: copier should not advance seq further
-        const expr* goal = ep.functor("reuse", {});
+        rule r = {ep.functor("p", {v, v}), {}};
+        uint32_t base1, base2;
         assert(t.depth() == 1);
-        bool result = gs.try_unify_head(goal, r, tm);
-        assert(result == true);
-        assert(seq.index == idx_before);  // no new seq() call was made by the copier
-        assert(tm.size() == 1);           // no new entry added to translation_map
-        assert(bm.whnf(ep.var(pre_fresh)) == goal);
+        assert(gs.try_unify_head(ep.functor("p", {ep.functor("a"), ep.functor("a")}), r, base1));
+        assert(gs.try_unify_head(ep.functor("p", {ep.functor("b"), ep.functor("b")}), r, base2));
+        assert(base2 == base1 + 1);
+        assert(bm.whnf(ep.var(base1)) == ep.functor("a"));
+        assert(bm.whnf(ep.var(base2)) == ep.functor("b"));
         assert(t.depth() == 1);
         t.pop();
     }
+
+    // Linear head vars: unification results are unchanged by the elided checks
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        sequencer seq(t);
+        copier cp(seq, ep);
+        bind_map bm(t);
+        lineage_pool lp;
+        database db;
+        goals gs_init = {};
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
+        const expr* X = ep.var(seq());
+        const expr* Y = ep.var(seq());
+        const expr* G = ep.var(seq());
+
+        // p(X, Y) is fully linear: both vars bind without occurs checks
+        rule r = {ep.functor("p", {X, Y}), {}};
+        uint32_t base;
+        assert(gs.try_unify_head(ep.functor("p", {ep.functor("f", {G}), G}), r, base));
+        assert(bm.whnf(ep.var(base)) == ep.functor("f", {G}));
+        assert(bm.whnf(ep.var(base + 1)) == G);
+
+        // p(X, X) is not: the occurs check still rejects X = f(X) through the goal
+        t.push();
+        rule r2 = {ep.functor("p", {X, X}), {}};
+        assert(!gs.try_unify_head(ep.functor("p", {G, ep.functor("f", {G})}), r2, base));
+        t.pop();
+
+        t.pop();
+    }
 }
 
 void test_goal_store_applicable() {
@@ -13505,7 +15291,8 @@ void test_goal_store_applicable() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* h = ep.functor("match", {});
         rule r = {h, {}};
         const expr* goal = ep.functor("match", {});
@@ -13528,7 +15315,8 @@ void test_goal_store_applicable() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* h = ep.functor("foo", {});
         rule r = {h, {}};
         const expr* goal = ep.functor("bar", {});
@@ -13551,7 +15339,8 @@ void test_goal_store_applicable() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* v = ep.var(seq());
         rule r = {v, {}};
         const expr* goal = ep.functor("x", {});
@@ -13574,7 +15363,8 @@ void test_goal_store_applicable() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* v = ep.var(seq());
         const expr* h = ep.functor("cons", {v, ep.functor("b", {})});
         rule r = {h, {}};
@@ -13598,7 +15388,8 @@ void test_goal_store_applicable() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* h = ep.functor("h", {});
         rule r = {h, {}};
         const expr* goal = ep.functor("cons", {ep.functor("a", {}), ep.functor("b", {})});
@@ -13622,7 +15413,8 @@ void test_goal_store_applicable() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* v = ep.var(seq());
         const expr* h = ep.functor("cons", {v, ep.functor("c", {})});
         rule r = {h, {}};
@@ -13646,7 +15438,8 @@ void test_goal_store_applicable() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* v = ep.var(seq());
         rule r = {v, {}};
         const expr* goal = ep.functor("x", {});
@@ -13671,7 +15464,8 @@ void test_goal_store_applicable() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* v = ep.var(seq());
         const expr* h = ep.functor("cons", {v, ep.functor("c", {})});
         rule r = {h, {}};
@@ -13697,7 +15491,8 @@ void test_goal_store_applicable() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* v = ep.var(seq());
         rule r = {v, {}};
         const expr* goal = ep.functor("x", {});
@@ -13725,7 +15520,8 @@ void test_goal_store_applicable() {
         lineage_pool lp;
         database db;
         goals gs_init = {};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const expr* v1 = ep.var(seq());
         const expr* v2 = ep.var(seq());
         const expr* h = ep.functor("cons", {v1, v2});
@@ -13740,6 +15536,65 @@ void test_goal_store_applicable() {
         assert(t.depth() == 1);
         t.pop();
     }
+
+    // Builtin goals ignore the rule and are applicable until refuted
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        sequencer seq(t);
+        copier cp(seq, ep);
+        bind_map bm(t);
+        lineage_pool lp;
+        database db;
+        goals gs_init = {};
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
+        const rule& r = builtins::rule_at(db, builtins::candidate);
+        const expr* X = ep.var(seq());
+        // not ready yet: cannot be refuted
+        assert(gs.applicable(ep.functor("int_lt", {X, ep.integer(1)}), r));
+        // ready: applicable exactly when evaluation succeeds
+        assert(gs.applicable(ep.functor("int_lt", {ep.integer(0), ep.integer(1)}), r));
+        assert(!gs.applicable(ep.functor("int_lt", {ep.integer(1), ep.integer(1)}), r));
+        assert(gs.applicable(ep.functor("int_add", {ep.integer(1), ep.integer(1), X}), r));
+        assert(!gs.applicable(ep.functor("int_add", {ep.functor("a"), ep.integer(1), X}), r));
+        // the trial evaluation leaves no bindings behind
+        assert(bm.bindings.empty());
+        assert(t.depth() == 1);
+        t.pop();
+    }
+
+    // Clashes the read-only prefilter sees never reach the trail, and are counted
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        sequencer seq(t);
+        copier cp(seq, ep);
+        bind_map bm(t);
+        lineage_pool lp;
+        database db;
+        goals gs_init = {};
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
+        const expr* X = ep.var(seq());
+        rule r = {ep.functor("p", {ep.functor("f", {X}), X}), {}};
+        assert(gs.get_prefiltered() == 0);
+        size_t undo_before = t.undo_stack.size();
+        uint32_t index_before = seq.index;
+        assert(!gs.applicable(ep.functor("p", {ep.functor("g", {ep.functor("a")}), ep.functor("a")}), r));
+        assert(!gs.applicable(ep.functor("q", {ep.var(9)}), r));
+        assert(gs.get_prefiltered() == 2);
+        assert(t.undo_stack.size() == undo_before);
+        assert(seq.index == index_before);
+
+        // survivors still go through full unification, which may reject them
+        assert(!gs.applicable(ep.functor("p", {ep.functor("f", {ep.functor("a")}), ep.functor("b")}), r));
+        assert(gs.applicable(ep.functor("p", {ep.functor("f", {ep.functor("a")}), ep.functor("a")}), r));
+        assert(gs.get_prefiltered() == 2);
+        t.pop();
+    }
 }
 
 void test_goal_store_expand() {
@@ -13758,7 +15613,8 @@ void test_goal_store_expand() {
         database db;
         db.push_back({h, {}});
         goals gs_init = {ep.functor("fact", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         assert(gs.size() == 1);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
@@ -13781,7 +15637,8 @@ void test_goal_store_expand() {
         database db;
         db.push_back({h, {b}});
         goals gs_init = {ep.functor("h", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         gs.resolve(rl);
@@ -13805,7 +15662,8 @@ void test_goal_store_expand() {
         database db;
         db.push_back({h, {b1, b2}});
         goals gs_init = {ep.functor("h", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         gs.resolve(rl);
@@ -13831,7 +15689,8 @@ void test_goal_store_expand() {
         database db;
         db.push_back({h, {b1, b2, b3}});
         goals gs_init = {ep.functor("h", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         gs.resolve(rl);
@@ -13860,7 +15719,8 @@ void test_goal_store_expand() {
         db.push_back({h, {}});
         const expr* goal_atom = ep.functor("x", {});
         goals gs_init = {goal_atom};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         uint32_t fresh_idx = seq.index;  // next index expand will allocate
@@ -13870,7 +15730,7 @@ void test_goal_store_expand() {
         t.pop();
     }
 
-    // Test 6: head var shared with body var - same translation map entry means same fresh copy
+    // Test 6: head var shared with body var - same template slot means same fresh copy
     // Rule: V :- V.  Goal: atom("x").
     // Both head and body copies of V get the same fresh index; child resolves to "x".
     {
@@ -13886,7 +15746,8 @@ void test_goal_store_expand() {
         db.push_back({v, {v}});
         const expr* goal_atom = ep.functor("x", {});
         goals gs_init = {goal_atom};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         gs.resolve(rl);
@@ -13914,7 +15775,8 @@ void test_goal_store_expand() {
         db.push_back({v1, {v2}});
         const expr* goal_atom = ep.functor("x", {});
         goals gs_init = {goal_atom};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         gs.resolve(rl);
@@ -13942,7 +15804,8 @@ void test_goal_store_expand() {
         database db;
         db.push_back({h, {v}});
         goals gs_init = {ep.functor("h", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         gs.resolve(rl);
@@ -13956,7 +15819,7 @@ void test_goal_store_expand() {
 
     // Test 9: same var appears twice in body - both children are the same fresh pointer
     // Rule: atom("h") :- V, V.  Goal: atom("h").
-    // Single translation map entry for V -> both body copies are identical.
+    // Single template slot for V -> both body copies are identical.
     {
         trail t;
         expr_pool ep(t);
@@ -13970,14 +15833,15 @@ void test_goal_store_expand() {
         database db;
         db.push_back({h, {v, v}});
         goals gs_init = {ep.functor("h", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         gs.resolve(rl);
         assert(gs.size() == 2);
         const expr* c0 = gs.at(lp.goal(rl, 0));
         const expr* c1 = gs.at(lp.goal(rl, 1));
-        assert(c0 == c1);  // same pointer - same fresh var (same translation map entry)
+        assert(c0 == c1);  // same pointer - same fresh var (same template slot)
         assert(std::holds_alternative<expr::var>(c0->content));
         assert(bm.whnf(c0) == c0);  // unbound
         t.pop();
@@ -13999,7 +15863,8 @@ void test_goal_store_expand() {
         database db;
         db.push_back({h, {v1, v2}});
         goals gs_init = {ep.functor("h", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         gs.resolve(rl);
@@ -14030,7 +15895,8 @@ void test_goal_store_expand() {
         database db;
         db.push_back({h, {b}});
         goals gs_init = {ep.functor("match", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         gs.resolve(rl);
@@ -14053,7 +15919,8 @@ void test_goal_store_expand() {
         database db;
         db.push_back({h, {}});
         goals gs_init = {ep.functor("foo", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         assert_throws(gs.resolve(rl), std::runtime_error);
@@ -14075,7 +15942,8 @@ void test_goal_store_expand() {
         database db;
         db.push_back({h, {}});
         goals gs_init = {ep.functor("x", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         assert_throws(gs.resolve(rl), std::runtime_error);
@@ -14096,7 +15964,8 @@ void test_goal_store_expand() {
         db.push_back({h, {}});
         const expr* goal = ep.functor("cons", {ep.functor("a", {}), ep.functor("b", {})});
         goals gs_init = {goal};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         assert_throws(gs.resolve(rl), std::runtime_error);
@@ -14120,7 +15989,8 @@ void test_goal_store_expand() {
         db.push_back({h, {}});
         const expr* goal = ep.functor("cons", {a, b});
         goals gs_init = {goal};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         assert_throws(gs.resolve(rl), std::runtime_error);
@@ -14147,7 +16017,8 @@ void test_goal_store_expand() {
         const expr* ga = ep.functor("a", {});
         const expr* goal = ep.functor("cons", {ga, ep.functor("b", {})});
         goals gs_init = {goal};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         uint32_t fresh_idx = seq.index;  // fresh copy of v will get this index
@@ -14176,7 +16047,8 @@ void test_goal_store_expand() {
         const expr* goal0 = ep.functor("first", {});
         const expr* goal1 = ep.functor("second", {});
         goals gs_init = {goal0, goal1};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl0 = lp.goal(nullptr, 0);
         const resolution_lineage* rl0 = lp.resolution(gl0, 0);
         uint32_t fresh0 = seq.index;  // first fresh index to be allocated
@@ -14210,7 +16082,8 @@ void test_goal_store_expand() {
         db.push_back({h0, {b0}});  // rule 0
         db.push_back({h1, {b1}});  // rule 1
         goals gs_init = {ep.functor("p", {}), ep.functor("q", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl0 = lp.goal(nullptr, 0);
         const goal_lineage* gl1 = lp.goal(nullptr, 1);
         const resolution_lineage* rl0 = lp.resolution(gl0, 0);
@@ -14240,7 +16113,8 @@ void test_goal_store_expand() {
         db.push_back({h1, {ep.functor("step2", {})}});  // rule 0: step1 :- step2
         db.push_back({h2, {}});                   // rule 1: step2 (fact)
         goals gs_init = {ep.functor("step1", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl0 = lp.resolution(gl, 0);
         gs.resolve(rl0);
@@ -14274,7 +16148,8 @@ void test_goal_store_expand() {
         const expr* gb = ep.functor("b", {});
         const expr* goal = ep.functor("cons", {ga, gb});
         goals gs_init = {goal};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         uint32_t fresh_start = seq.index;
@@ -14300,7 +16175,8 @@ void test_goal_store_expand() {
         database db;
         db.push_back({h, {body_cons}});
         goals gs_init = {ep.functor("h", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         gs.resolve(rl);
@@ -14325,7 +16201,8 @@ void test_goal_store_expand() {
         db.push_back({h, {b}});
         const expr* goal_var = ep.var(seq());
         goals gs_init = {goal_var};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         gs.resolve(rl);
@@ -14351,7 +16228,8 @@ void test_goal_store_expand() {
         db.push_back({v, {v, v}});
         const expr* goal_atom = ep.functor("val", {});
         goals gs_init = {goal_atom};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         gs.resolve(rl);
@@ -14387,7 +16265,8 @@ void test_goal_store_expand() {
         const expr* gc = ep.functor("c", {});
         const expr* goal = ep.functor("cons", {ga, ep.functor("cons", {gb, gc})});
         goals gs_init = {goal};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         gs.resolve(rl);
@@ -14421,7 +16300,8 @@ void test_goal_store_expand() {
         db.push_back({h, {}});
         const expr* original_goal = ep.functor("right", {});
         goals gs_init = {original_goal};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         assert(gs.size() == 1);
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
@@ -14447,7 +16327,8 @@ void test_goal_store_expand() {
         db.push_back({h_good, {body}});  // rule 0
         db.push_back({h_bad,  {}});      // rule 1
         goals gs_init = {ep.functor("good", {}), ep.functor("good", {})};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
         const goal_lineage* gl0 = lp.goal(nullptr, 0);
         const resolution_lineage* rl0 = lp.resolution(gl0, 0);
         gs.resolve(rl0);
@@ -14477,24 +16358,203 @@ void test_goal_store_expand() {
         const expr* h = ep.functor("cons", {v1, ep.functor("cons", {mid, v2})});
         const expr* leaf = ep.functor("leaf", {});
         database db;
-        db.push_back({h, {leaf}});
-        const expr* left  = ep.functor("left", {});
-        const expr* right = ep.functor("right", {});
-        const expr* goal = ep.functor("cons", {left, ep.functor("cons", {mid, right})});
+        db.push_back({h, {leaf}});
+        const expr* left  = ep.functor("left", {});
+        const expr* right = ep.functor("right", {});
+        const expr* goal = ep.functor("cons", {left, ep.functor("cons", {mid, right})});
+        goals gs_init = {goal};
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
+        const goal_lineage* gl = lp.goal(nullptr, 0);
+        const resolution_lineage* rl = lp.resolution(gl, 0);
+        uint32_t fresh_start = seq.index;
+        gs.resolve(rl);
+        assert(gs.size() == 1);
+        assert(gs.at(lp.goal(rl, 0)) == leaf);
+        assert(bm.whnf(ep.var(fresh_start))     == left);
+        assert(bm.whnf(ep.var(fresh_start + 1)) == right);
+        t.pop();
+    }
+
+    // Builtin goal: resolving binds the output and produces no children
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        sequencer seq(t);
+        copier cp(seq, ep);
+        bind_map bm(t);
+        lineage_pool lp;
+        database db;
+        db.push_back({ep.functor("unused"), {ep.functor("unused")}});
+        const expr* X = ep.var(seq());
+        goals gs_init = {ep.functor("int_mul", {ep.integer(6), ep.integer(7), X})};
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
+        gs.resolve(lp.resolution(lp.goal(nullptr, 0), builtins::candidate));
+        assert(gs.empty());
+        assert(bm.whnf(X) == ep.integer(42));
+        // a refuted builtin cannot be expanded
+        bool threw = false;
+        try { gs.expand(ep.functor("int_gt", {ep.integer(1), X}), builtins::rule_at(db, builtins::candidate)); }
+        catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+        t.pop();
+    }
+
+    // Renaming a clause reserves its vars in blocks: one sequencer entry per frame
+    {
+        trail t;
+        expr_pool ep(t);
+        sequencer seq(t);
+        copier cp(seq, ep);
+        bind_map bm(t);
+        lineage_pool lp;
+        std::vector<const expr*> v;
+        for (int i = 0; i < 6; ++i)
+            v.push_back(ep.var(seq()));
+        database db;
+        db.push_back({ep.functor("p", {v[0], v[1], v[2]}), {ep.functor("q", {v[3], v[4], v[5], v[0]})}});
+        const expr* goal = ep.functor("p", {ep.functor("a"), ep.functor("b"), ep.functor("c")});
         goals gs_init = {goal};
-        goal_store gs(db, gs_init, t, cp, bm, lp);
-        const goal_lineage* gl = lp.goal(nullptr, 0);
-        const resolution_lineage* rl = lp.resolution(gl, 0);
+        builtins bi(bm, ep);
+        goal_store gs(db, gs_init, t, cp, bm, bi, lp);
+
+        t.push();
+        size_t undo_before = t.undo_stack.size();
         uint32_t fresh_start = seq.index;
-        gs.resolve(rl);
-        assert(gs.size() == 1);
-        assert(gs.at(lp.goal(rl, 0)) == leaf);
-        assert(bm.whnf(ep.var(fresh_start))     == left);
-        assert(bm.whnf(ep.var(fresh_start + 1)) == right);
+        auto body = gs.expand(goal, db[0]);
+        assert(seq.index == fresh_start + 6);
+        size_t rewinds = std::count_if(t.undo_stack.begin() + undo_before, t.undo_stack.end(),
+            [](const trail::entry& e) { return e.kind == trail::op::rewind; });
+        assert(rewinds == 1);
+
+        // fresh indices follow first occurrence, head first, as single allocation did
+        assert(body[0] == ep.functor("q", {ep.var(fresh_start + 3), ep.var(fresh_start + 4), ep.var(fresh_start + 5), ep.var(fresh_start)}));
+        assert(bm.whnf(ep.var(fresh_start)) == ep.functor("a"));
         t.pop();
+        assert(seq.index == fresh_start);
     }
 }
 
+void test_goal_store_get_prefiltered() {
+    trail t;
+    expr_pool ep(t);
+    t.push();
+    sequencer seq(t);
+    copier cp(seq, ep);
+    bind_map bm(t);
+    lineage_pool lp;
+    database db;
+    goals gs_init = {};
+    builtins bi(bm, ep);
+    goal_store gs(db, gs_init, t, cp, bm, bi, lp);
+
+    // Starts at zero and counts only prefilter rejections
+    assert(gs.get_prefiltered() == 0);
+    rule r = {ep.functor("p", {ep.functor("a")}), {}};
+    gs.applicable(ep.functor("p", {ep.functor("a")}), r);
+    assert(gs.get_prefiltered() == 0);
+    gs.applicable(ep.functor("p", {ep.functor("b")}), r);
+    gs.applicable(ep.functor("p", {ep.functor("c")}), r);
+    assert(gs.get_prefiltered() == 2);
+
+    // Builtin goals bypass the filter
+    gs.applicable(ep.functor("int_lt", {ep.integer(2), ep.integer(1)}), builtins::rule_at(db, builtins::candidate));
+    assert(gs.get_prefiltered() == 2);
+    t.pop();
+}
+
+void test_rule_index_constructor() {
+    trail t;
+    expr_pool ep(t);
+    t.push();
+    database db;
+    db.push_back({ep.functor("p", {ep.functor("a")}), {}});  // 0
+    db.push_back({ep.functor("q"), {}});                     // 1
+    db.push_back({ep.var(0), {}});                           // 2: matches any goal
+    db.push_back({ep.functor("p", {ep.functor("b")}), {}});  // 3
+    rule_index ri(db);
+    assert(&ri.db == &db);
+    assert(ri.initial_candidates == std::vector<size_t>({0, 1, 2, 3}));
+    assert(ri.predicate_candidates.size() == 2);
+    assert(ri.predicate_candidates.at(symbols().intern("p", 1)) == std::vector<size_t>({0, 2, 3}));
+    assert(ri.predicate_candidates.at(symbols().intern("q", 0)) == std::vector<size_t>({1, 2}));
+    assert(ri.unindexed_candidates == std::vector<size_t>({2}));
+    t.pop();
+}
+
+void test_rule_index_seed() {
+    trail t;
+    expr_pool ep(t);
+    t.push();
+    database db;
+    db.push_back({ep.functor("p", {ep.functor("a")}), {}});
+    db.push_back({ep.functor("q"), {}});
+    rule_index ri(db);
+    // by predicate, by nothing for undefined ones, and all rules for a var goal
+    assert(ri.seed(ep.functor("p", {ep.var(0)})) == std::vector<size_t>({0}));
+    assert(ri.seed(ep.functor("r")).empty());
+    assert(ri.seed(ep.var(0)) == std::vector<size_t>({0, 1}));
+    // builtins get the stand-in candidate
+    assert(ri.seed(ep.functor("int_lt", {ep.integer(1), ep.integer(2)})) == std::vector<size_t>({builtins::candidate}));
+    t.pop();
+}
+
+void test_rule_index_predicate() {
+    trail t;
+    expr_pool ep(t);
+    t.push();
+    database db;
+    db.push_back({ep.functor("p", {ep.functor("a")}), {}});
+    rule_index ri(db);
+    assert(ri.predicate(symbols().intern("p", 1)) == &ri.predicate_candidates.at(symbols().intern("p", 1)));
+    assert(ri.predicate(symbols().intern("p", 2)) == nullptr);
+    t.pop();
+}
+
+void test_rule_index_lookup() {
+    trail t;
+    expr_pool ep(t);
+    t.push();
+    uint32_t p = symbols().intern("p", 2);
+    database db;
+    db.push_back({ep.functor("p", {ep.functor("a"), ep.integer(1)}), {}});  // 0
+    db.push_back({ep.functor("p", {ep.var(0), ep.integer(2)}), {}});        // 1
+    db.push_back({ep.var(1), {}});                                          // 2
+    db.push_back({ep.functor("p", {ep.functor("a"), ep.var(2)}), {}});      // 3
+    rule_index ri(db);
+
+    // Every position is indexed, and rules matching any key are kept once
+    const std::vector<rule_index::argument_index>& positions = ri.argument_indices.at(p);
+    assert(positions.size() == 2);
+    assert(positions[0].functors.at(symbols().intern("a", 0)) == std::vector<size_t>({0, 3}));
+    assert(positions[0].unkeyed == std::vector<size_t>({1, 2}));
+    assert(positions[1].integers.at(1) == std::vector<size_t>({0}));
+    assert(positions[1].integers.at(2) == std::vector<size_t>({1}));
+    assert(positions[1].unkeyed == std::vector<size_t>({2, 3}));
+
+    // A bound arg selects its key's rules plus the unkeyed ones
+    rule_index::selection s;
+    assert(ri.lookup(p, 0, ep.functor("a"), s));
+    assert(*s.keyed == std::vector<size_t>({0, 3}));
+    assert(s.unkeyed == &positions[0].unkeyed);
+    assert(s.size() == 4);
+    assert(ri.lookup(p, 1, ep.integer(2), s));
+    assert(*s.keyed == std::vector<size_t>({1}));
+    assert(s.size() == 3);
+
+    // A key no head mentions selects only the unkeyed rules
+    assert(ri.lookup(p, 1, ep.integer(7), s));
+    assert(s.keyed->empty());
+    assert(*s.unkeyed == std::vector<size_t>({2, 3}));
+
+    // Unbound args and undefined predicates select nothing to narrow by
+    assert(!ri.lookup(p, 0, ep.var(5), s));
+    assert(!ri.lookup(symbols().intern("r", 1), 0, ep.functor("a"), s));
+    t.pop();
+}
+
 void test_candidate_store_constructor() {
     // Test 1: Empty db, empty goals -> size 0, initial_candidates is empty
     {
@@ -14503,7 +16563,7 @@ void test_candidate_store_constructor() {
         goals gs_init = {};
         candidate_store cs(db, gs_init, lp);
         assert(cs.size() == 0);
-        assert(cs.initial_candidates.empty());
+        assert(cs.ri.initial_candidates.empty());
     }
 
     // Test 2: Non-empty db (3 rules), empty goals -> size 0, initial_candidates = [0,1,2]
@@ -14520,8 +16580,8 @@ void test_candidate_store_constructor() {
         goals gs_init = {};
         candidate_store cs(db, gs_init, lp);
         assert(cs.size() == 0);
-        assert(cs.initial_candidates.size() == 3);
-        std::vector<size_t> ic = cs.initial_candidates;
+        assert(cs.ri.initial_candidates.size() == 3);
+        std::vector<size_t> ic = cs.ri.initial_candidates;
         std::sort(ic.begin(), ic.end());
         assert(ic == std::vector<size_t>({0, 1, 2}));
         t.pop();
@@ -14614,6 +16674,85 @@ void test_candidate_store_constructor() {
         }
         t.pop();
     }
+
+    // Test 7: builtin goals are seeded with the builtin candidate only
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        lineage_pool lp;
+        const expr* a = ep.functor("a", {});
+        database db;
+        db.push_back({a, {}});
+        db.push_back({a, {}});
+        goals gs_init = {a, ep.functor("int_le", {ep.var(0), ep.integer(3)})};
+        candidate_store cs(db, gs_init, lp);
+        assert(cs.at(lp.goal(nullptr, 0)).size() == 2);
+        assert(cs.at(lp.goal(nullptr, 1)) == std::vector<size_t>({builtins::candidate}));
+        t.pop();
+    }
+
+    // Goals are seeded with the rules of their own predicate, in database order
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        lineage_pool lp;
+        const expr* X = ep.var(0);
+        database db;
+        db.push_back({ep.functor("p", {ep.functor("a")}), {}});
+        db.push_back({ep.functor("q", {X}), {}});
+        db.push_back({ep.functor("p", {X}), {}});
+        db.push_back({ep.functor("p", {X, X}), {}});
+        goals gs_init = {ep.functor("p", {ep.functor("b")}), ep.functor("q", {X}), ep.functor("p", {X, X}), ep.functor("r")};
+        candidate_store cs(db, gs_init, lp);
+        assert(cs.at(lp.goal(nullptr, 0)) == std::vector<size_t>({0, 2}));
+        assert(cs.at(lp.goal(nullptr, 1)) == std::vector<size_t>({1}));
+        // arity is part of the predicate
+        assert(cs.at(lp.goal(nullptr, 2)) == std::vector<size_t>({3}));
+        // no rule defines r, so its goal starts out conflicted
+        assert(cs.at(lp.goal(nullptr, 3)).empty());
+        assert(cs.conflicted());
+        t.pop();
+    }
+
+    // Rules with var heads may match anything; var goals may match any rule
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        lineage_pool lp;
+        database db;
+        db.push_back({ep.functor("p"), {}});
+        db.push_back({ep.var(0), {}});
+        db.push_back({ep.functor("q"), {}});
+        db.push_back({ep.functor("p"), {}});
+        goals gs_init = {ep.functor("p"), ep.functor("q"), ep.functor("r"), ep.var(1)};
+        candidate_store cs(db, gs_init, lp);
+        assert(cs.at(lp.goal(nullptr, 0)) == std::vector<size_t>({0, 1, 3}));
+        assert(cs.at(lp.goal(nullptr, 1)) == std::vector<size_t>({1, 2}));
+        assert(cs.at(lp.goal(nullptr, 2)) == std::vector<size_t>({1}));
+        assert(cs.at(lp.goal(nullptr, 3)) == std::vector<size_t>({0, 1, 2, 3}));
+        t.pop();
+    }
+    // A given index is shared rather than rebuilt
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        lineage_pool lp;
+        database db;
+        db.push_back({ep.functor("p", {ep.functor("a")}), {}});
+        goals gs_init = {ep.functor("p", {ep.var(0)})};
+        rule_index ri(db);
+        candidate_store shared(db, gs_init, lp, &ri);
+        assert(&shared.ri == &ri);
+        assert(shared.owned_index == nullptr);
+        assert(shared.at(lp.goal(nullptr, 0)) == std::vector<size_t>({0}));
+        candidate_store own(db, gs_init, lp);
+        assert(&own.ri == own.owned_index.get());
+        t.pop();
+    }
 }
 
 void test_candidate_store_eliminate() {
@@ -14837,6 +16976,33 @@ void test_candidate_store_eliminate() {
         assert(c1.size() == 1 && c1[0] == 0);
         t.pop();
     }
+
+    // A single goal can be eliminated on its own, leaving the others as they are
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        lineage_pool lp;
+        const expr* a = ep.functor("a", {});
+        database db;
+        db.push_back({a, {}});
+        db.push_back({a, {}});
+        db.push_back({a, {}});
+        goals gs_init = {a, a};
+        candidate_store cs(db, gs_init, lp);
+        const goal_lineage* gl0 = lp.goal(nullptr, 0);
+        const goal_lineage* gl1 = lp.goal(nullptr, 1);
+        std::vector<const goal_lineage*> seen;
+        size_t removed = cs.eliminate(gl1, [&](const goal_lineage* gl, size_t c) {
+            seen.push_back(gl);
+            return c != 1;
+        });
+        assert(removed == 2);
+        assert(seen == std::vector<const goal_lineage*>(3, gl1));
+        assert(cs.at(gl0).size() == 3);
+        assert(cs.at(gl1) == std::vector<size_t>({1}));
+        t.pop();
+    }
 }
 
 void test_candidate_store_unit() {
@@ -15014,6 +17180,68 @@ void test_candidate_store_unit() {
         assert(out_cand == 0);
         t.pop();
     }
+
+    // Test 9: a builtin goal's lone candidate is never reported as unit
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        lineage_pool lp;
+        const expr* a = ep.functor("a", {});
+        database db;
+        db.push_back({a, {}});
+        db.push_back({a, {}});
+        goals gs_init = {ep.functor("int_lt", {ep.integer(0), ep.integer(1)}), a};
+        candidate_store cs(db, gs_init, lp);
+        const goal_lineage* out_gl = nullptr;
+        size_t out_cand = 99;
+        assert(!cs.unit(out_gl, out_cand));
+        cs.eliminate([](const goal_lineage*, size_t c) { return c == 1; });
+        assert(cs.unit(out_gl, out_cand));
+        assert(out_gl == lp.goal(nullptr, 1));
+        assert(out_cand == 0);
+        t.pop();
+    }
+
+    // Units are queued as counts reach one, and dropped once resolved
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        lineage_pool lp;
+        const expr* a = ep.functor("a", {});
+        const expr* b = ep.functor("b", {});
+        database db;
+        db.push_back({a, {b}});  // 0: a :- b.
+        db.push_back({a, {}});   // 1: a.
+        db.push_back({b, {}});   // 2: b.
+        db.push_back({b, {}});   // 3: b.
+        goals gs_init = {a};
+        candidate_store cs(db, gs_init, lp);
+        const goal_lineage* g0 = lp.goal(nullptr, 0);
+        const goal_lineage* gl = nullptr;
+        size_t cand = 99;
+        assert(cs.units.empty());
+        assert(!cs.unit(gl, cand));
+
+        cs.eliminate(g0, [](const goal_lineage*, size_t i) { return i == 1; });
+        assert(cs.units.size() == 1);
+        assert(cs.unit(gl, cand));
+        assert(gl == g0 && cand == 0);
+        // asking again finds the same unit, still queued
+        assert(cs.unit(gl, cand));
+        assert(cs.units.size() == 1);
+
+        const resolution_lineage* rl = lp.resolution(g0, 0);
+        cs.resolve(rl);
+        assert(!cs.unit(gl, cand));
+        assert(cs.units.empty());
+
+        cs.eliminate(lp.goal(rl, 0), [](const goal_lineage*, size_t i) { return i == 2; });
+        assert(cs.unit(gl, cand));
+        assert(gl == lp.goal(rl, 0) && cand == 3);
+        t.pop();
+    }
 }
 
 void test_candidate_store_conflicted() {
@@ -15150,6 +17378,142 @@ void test_candidate_store_conflicted() {
         assert(cs.conflicted());   // now empty
         t.pop();
     }
+
+    // The count of empty goals is kept exact as goals empty and leave
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        lineage_pool lp;
+        const expr* a = ep.functor("a", {});
+        const expr* b = ep.functor("b", {});
+        database db;
+        db.push_back({a, {}});  // 0: a.
+        db.push_back({b, {}});  // 1: b.
+        db.push_back({b, {}});  // 2: b.
+        goals gs_init = {a, b};
+        candidate_store cs(db, gs_init, lp);
+        const goal_lineage* ga = lp.goal(nullptr, 0);
+        const goal_lineage* gb = lp.goal(nullptr, 1);
+        assert(cs.conflicts == 0);
+
+        cs.eliminate(gb, [](const goal_lineage*, size_t) { return true; });
+        assert(cs.conflicts == 1);
+        assert(cs.conflicted());
+        cs.eliminate([](const goal_lineage*, size_t) { return true; });
+        assert(cs.conflicts == 2);
+        // eliminating nothing more leaves the count alone
+        cs.eliminate([](const goal_lineage*, size_t) { return true; });
+        assert(cs.conflicts == 2);
+
+        // an empty goal leaving the store takes its conflict with it
+        cs.resolve(lp.resolution(ga, 0));
+        assert(cs.conflicts == 1);
+        assert(cs.conflicted());
+        t.pop();
+    }
+}
+
+void test_candidate_store_index() {
+    // A bound first arg selects its facts straight from the index
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        bind_map bm(t);
+        lineage_pool lp;
+        database db;
+        for (int64_t i = 0; i < 100; ++i)
+            db.push_back({ep.functor("edge", {ep.integer(i), ep.integer(i + 1)}), {}});
+        goals gs_init = {ep.functor("edge", {ep.integer(7), ep.var(0)})};
+        candidate_store cs(db, gs_init, lp);
+        const goal_lineage* gl = lp.goal(nullptr, 0);
+        assert(cs.at(gl).size() == 100);
+        cs.index(gl, gs_init[0], bm);
+        assert(cs.at(gl) == std::vector<size_t>({7}));
+        // every position was indexed up front, in the shared index
+        assert(cs.ri.argument_indices.at(std::get<expr::functor>(gs_init[0]->content).id).size() == 2);
+        t.pop();
+    }
+
+    // Args are read through their bindings, and the narrowest bound position wins
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        bind_map bm(t);
+        lineage_pool lp;
+        const expr* a = ep.functor("a");
+        const expr* b = ep.functor("b");
+        database db;
+        db.push_back({ep.functor("p", {a, a}), {}});
+        db.push_back({ep.functor("p", {a, b}), {}});
+        db.push_back({ep.functor("p", {b, b}), {}});
+        db.push_back({ep.functor("p", {a, ep.functor("f", {ep.var(0)})}), {}});
+        const expr* goal = ep.functor("p", {ep.var(1), ep.var(2)});
+        goals gs_init = {goal};
+        candidate_store cs(db, gs_init, lp);
+        const goal_lineage* gl = lp.goal(nullptr, 0);
+        bm.bind(1, a);
+        bm.bind(2, ep.var(3));
+        bm.bind(3, ep.functor("f", {b}));
+        cs.index(gl, goal, bm);
+        assert(cs.at(gl) == std::vector<size_t>({3}));
+        t.pop();
+    }
+
+    // Var head args match any key, so they are merged into every selection
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        bind_map bm(t);
+        lineage_pool lp;
+        const expr* X = ep.var(0);
+        database db;
+        db.push_back({ep.functor("p", {ep.functor("a")}), {}});
+        db.push_back({ep.functor("p", {X}), {}});
+        db.push_back({ep.functor("p", {ep.integer(3)}), {}});
+        db.push_back({ep.var(1), {}});
+        db.push_back({ep.functor("p", {ep.functor("a")}), {}});
+        goals gs_init = {ep.functor("p", {ep.functor("a")}), ep.functor("p", {ep.integer(3)}), ep.functor("p", {ep.functor("c")}), ep.functor("p", {ep.integer(4)})};
+        candidate_store cs(db, gs_init, lp);
+        for (int i = 0; i < 4; ++i)
+            cs.index(lp.goal(nullptr, i), gs_init[i], bm);
+        assert(cs.at(lp.goal(nullptr, 0)) == std::vector<size_t>({0, 1, 3, 4}));
+        assert(cs.at(lp.goal(nullptr, 1)) == std::vector<size_t>({1, 2, 3}));
+        assert(cs.at(lp.goal(nullptr, 2)) == std::vector<size_t>({1, 3}));
+        assert(cs.at(lp.goal(nullptr, 3)) == std::vector<size_t>({1, 3}));
+        t.pop();
+    }
+
+    // Unbound args, atoms, builtins and undefined predicates are left as seeded
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        bind_map bm(t);
+        lineage_pool lp;
+        database db;
+        db.push_back({ep.functor("p", {ep.functor("a")}), {}});
+        db.push_back({ep.functor("p", {ep.functor("b")}), {}});
+        db.push_back({ep.functor("q"), {}});
+        goals gs_init = {
+            ep.functor("p", {ep.var(0)}),
+            ep.functor("q"),
+            ep.functor("int_add", {ep.integer(1), ep.integer(2), ep.var(1)}),
+            ep.functor("r", {ep.functor("a")}),
+        };
+        candidate_store cs(db, gs_init, lp);
+        for (int i = 0; i < 4; ++i)
+            cs.index(lp.goal(nullptr, i), gs_init[i], bm);
+        assert(cs.at(lp.goal(nullptr, 0)) == std::vector<size_t>({0, 1}));
+        assert(cs.at(lp.goal(nullptr, 1)) == std::vector<size_t>({2}));
+        assert(cs.at(lp.goal(nullptr, 2)) == std::vector<size_t>({builtins::candidate}));
+        assert(cs.at(lp.goal(nullptr, 3)).empty());
+        assert(cs.ri.argument_indices.count(symbols().intern("r", 1)) == 0);
+        t.pop();
+    }
 }
 
 void test_candidate_store_expand() {
@@ -15178,14 +17542,13 @@ void test_candidate_store_expand() {
         t.push();
         lineage_pool lp;
         const expr* a = ep.functor("a", {});
-        const expr* b = ep.functor("b", {});
         database db;
-        db.push_back({a, {b}});  // rule 0: 1-body
+        db.push_back({a, {a}});  // rule 0: 1-body
         db.push_back({a, {}});
         db.push_back({a, {}});
         goals gs_init = {a};
         candidate_store cs(db, gs_init, lp);
-        std::vector<size_t> expected = cs.initial_candidates;
+        std::vector<size_t> expected = cs.ri.initial_candidates;
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
         cs.resolve(rl);
@@ -15204,13 +17567,12 @@ void test_candidate_store_expand() {
         t.push();
         lineage_pool lp;
         const expr* a = ep.functor("a", {});
-        const expr* b = ep.functor("b", {});
         database db;
-        db.push_back({a, {b, b}});  // rule 0: 2-body
+        db.push_back({a, {a, a}});  // rule 0: 2-body
         db.push_back({a, {}});
         goals gs_init = {a};
         candidate_store cs(db, gs_init, lp);
-        std::vector<size_t> expected = cs.initial_candidates;
+        std::vector<size_t> expected = cs.ri.initial_candidates;
         std::sort(expected.begin(), expected.end());
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
@@ -15231,14 +17593,13 @@ void test_candidate_store_expand() {
         t.push();
         lineage_pool lp;
         const expr* a = ep.functor("a", {});
-        const expr* b = ep.functor("b", {});
         database db;
-        db.push_back({a, {b, b, b}});  // rule 0: 3-body
+        db.push_back({a, {a, a, a}});  // rule 0: 3-body
         db.push_back({a, {}});
         db.push_back({a, {}});
         goals gs_init = {a};
         candidate_store cs(db, gs_init, lp);
-        std::vector<size_t> expected = cs.initial_candidates;
+        std::vector<size_t> expected = cs.ri.initial_candidates;
         std::sort(expected.begin(), expected.end());
         const goal_lineage* gl = lp.goal(nullptr, 0);
         const resolution_lineage* rl = lp.resolution(gl, 0);
@@ -15259,14 +17620,13 @@ void test_candidate_store_expand() {
         t.push();
         lineage_pool lp;
         const expr* a = ep.functor("a", {});
-        const expr* b = ep.functor("b", {});
         database db;
-        db.push_back({a, {b}});  // rule 0: 1-body
+        db.push_back({a, {a}});  // rule 0: 1-body
         db.push_back({a, {}});
         db.push_back({a, {}});
         goals gs_init = {a};
         candidate_store cs(db, gs_init, lp);
-        std::vector<size_t> full_initial = cs.initial_candidates;
+        std::vector<size_t> full_initial = cs.ri.initial_candidates;
         std::sort(full_initial.begin(), full_initial.end());
         // eliminate index 1 and 2 from the parent goal -> parent now has only candidate 0
         cs.eliminate([](const goal_lineage*, size_t c) { return c == 1 || c == 2; });
@@ -15282,8 +17642,58 @@ void test_candidate_store_expand() {
         t.pop();
     }
 
-    // Test 6: children's candidate vectors are independent copies
-    // Modifying one child's vector does not affect the other's
+    // Test 6: children's candidate vectors are independent copies
+    // Modifying one child's vector does not affect the other's
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        lineage_pool lp;
+        const expr* a = ep.functor("a", {});
+        database db;
+        db.push_back({a, {a, a}});  // rule 0: 2-body
+        db.push_back({a, {}});
+        goals gs_init = {a};
+        candidate_store cs(db, gs_init, lp);
+        std::vector<size_t> full_initial = cs.ri.initial_candidates;
+        std::sort(full_initial.begin(), full_initial.end());
+        const goal_lineage* gl = lp.goal(nullptr, 0);
+        const resolution_lineage* rl = lp.resolution(gl, 0);
+        cs.resolve(rl);
+        // eliminate a candidate from child 0 only
+        const goal_lineage* child0 = lp.goal(rl, 0);
+        const goal_lineage* child1 = lp.goal(rl, 1);
+        cs.eliminate([child0](const goal_lineage* gl, size_t c) {
+            return gl == child0 && c == 0;
+        });
+        // child0 is reduced; child1 must still have the full initial set
+        assert(cs.at(child0).size() == full_initial.size() - 1);
+        std::vector<size_t> c1 = cs.at(child1);
+        std::sort(c1.begin(), c1.end());
+        assert(c1 == full_initial);
+        t.pop();
+    }
+
+    // Builtin body atoms get the builtin candidate, the rest get the full set
+    {
+        trail t;
+        expr_pool ep(t);
+        t.push();
+        lineage_pool lp;
+        const expr* a = ep.functor("a", {});
+        const expr* b = ep.functor("int_add", {ep.var(0), ep.var(1), ep.var(2)});
+        database db;
+        db.push_back({a, {a, b}});
+        goals gs_init = {a};
+        candidate_store cs(db, gs_init, lp);
+        auto children = cs.expand(cs.at(lp.goal(nullptr, 0)), db[0]);
+        assert(children.size() == 2);
+        assert(children[0] == cs.ri.initial_candidates);
+        assert(children[1] == std::vector<size_t>({builtins::candidate}));
+        t.pop();
+    }
+
+    // Body atoms are seeded by predicate, like goals
     {
         trail t;
         expr_pool ep(t);
@@ -15292,30 +17702,153 @@ void test_candidate_store_expand() {
         const expr* a = ep.functor("a", {});
         const expr* b = ep.functor("b", {});
         database db;
-        db.push_back({a, {b, b}});  // rule 0: 2-body
+        db.push_back({a, {b, ep.functor("c", {}), a}});
+        db.push_back({b, {}});
         db.push_back({a, {}});
+        db.push_back({b, {}});
         goals gs_init = {a};
         candidate_store cs(db, gs_init, lp);
-        std::vector<size_t> full_initial = cs.initial_candidates;
-        std::sort(full_initial.begin(), full_initial.end());
-        const goal_lineage* gl = lp.goal(nullptr, 0);
-        const resolution_lineage* rl = lp.resolution(gl, 0);
-        cs.resolve(rl);
-        // eliminate a candidate from child 0 only
-        const goal_lineage* child0 = lp.goal(rl, 0);
-        const goal_lineage* child1 = lp.goal(rl, 1);
-        cs.eliminate([child0](const goal_lineage* gl, size_t c) {
-            return gl == child0 && c == 0;
-        });
-        // child0 is reduced; child1 must still have the full initial set
-        assert(cs.at(child0).size() == full_initial.size() - 1);
-        std::vector<size_t> c1 = cs.at(child1);
-        std::sort(c1.begin(), c1.end());
-        assert(c1 == full_initial);
+        auto children = cs.expand(cs.at(lp.goal(nullptr, 0)), db[0]);
+        assert(children.size() == 3);
+        assert(children[0] == std::vector<size_t>({1, 3}));
+        assert(children[1].empty());
+        assert(children[2] == std::vector<size_t>({0, 2}));
         t.pop();
     }
 }
 
+void test_applicability_cache_constructor() {
+    applicability_cache ac(4);
+    assert(ac.capacity == 4);
+    assert(ac.size() == 0);
+    assert(ac.slots.empty());
+    assert(ac.hand == 0);
+}
+
+void test_applicability_cache_normalize() {
+    trail t;
+    t.push();
+    expr_pool ep(t);
+    bind_map bm(t);
+    applicability_cache ac(4);
+    const expr* X = ep.var(0);
+    const expr* Y = ep.var(1);
+    const expr* Z = ep.var(7);
+    applicability_cache::key k1, k2;
+
+    // Variants share a key: vars are numbered by first occurrence
+    ac.normalize(ep.functor("p", {X, Y, X}), bm, k1);
+    ac.normalize(ep.functor("p", {Z, X, Z}), bm, k2);
+    assert(k1 == k2);
+    assert(k1.size() == 4);
+    assert(k1[1] == applicability_cache::var_tag);
+    assert(k1[2] == (applicability_cache::var_tag | 1));
+    assert(k1[3] == applicability_cache::var_tag);
+
+    // Sharing differs, so the key differs
+    ac.normalize(ep.functor("p", {X, Y, Y}), bm, k2);
+    assert(k1 != k2);
+
+    // Integers take a tag word and a value word
+    ac.normalize(ep.functor("p", {ep.integer(-3)}), bm, k1);
+    assert(k1.size() == 3);
+    assert(k1[1] == applicability_cache::integer_tag);
+    assert(k1[2] == static_cast<uint64_t>(-3));
+
+    // Terms are read through their bindings
+    bm.unify(X, ep.functor("a"));
+    ac.normalize(ep.functor("p", {X, Y}), bm, k1);
+    ac.normalize(ep.functor("p", {ep.functor("a"), Z}), bm, k2);
+    assert(k1 == k2);
+
+    // Nested args follow their functor in preorder
+    ac.normalize(ep.functor("f", {ep.functor("g", {Y}), Z}), bm, k1);
+    assert(k1.size() == 4);
+    assert(k1[1] == (applicability_cache::functor_tag | symbols().intern("g", 1)));
+    assert(k1[2] == applicability_cache::var_tag);
+    assert(k1[3] == (applicability_cache::var_tag | 1));
+    t.pop();
+}
+
+void test_applicability_cache_find() {
+    applicability_cache ac(4);
+    applicability_cache::key k1{1, 2};
+    applicability_cache::key k2{1, 3};
+
+    // Missing keys are not found
+    assert(ac.find(k1) == nullptr);
+
+    // Inserted answers are found, false ones included
+    ac.insert(k1, true);
+    ac.insert(k2, false);
+    assert(ac.size() == 2);
+    assert(ac.find(k1) && *ac.find(k1));
+    assert(ac.find(k2) && !*ac.find(k2));
+
+    // A hit marks the entry referenced
+    assert(ac.slots[ac.index.at(k1)].referenced);
+    assert(ac.slots[ac.index.at(k2)].referenced);
+
+    // Whether the prefilter made the call is reported on request
+    applicability_cache::key k3{1, 4};
+    ac.insert(k3, false, true);
+    bool prefiltered = false;
+    assert(ac.find(k3, &prefiltered) && prefiltered);
+    assert(ac.find(k2, &prefiltered) && !prefiltered);
+}
+
+void test_applicability_cache_insert() {
+    // A second insert of a key keeps the first answer
+    {
+        applicability_cache ac(4);
+        ac.insert({1}, true);
+        ac.insert({1}, false);
+        assert(ac.size() == 1);
+        assert(*ac.find({1}));
+    }
+
+    // A cache of no capacity holds nothing
+    {
+        applicability_cache ac(0);
+        ac.insert({1}, true);
+        assert(ac.size() == 0);
+        assert(ac.find({1}) == nullptr);
+    }
+
+    // A full cache evicts the first unreferenced entry from the hand on
+    {
+        applicability_cache ac(2);
+        ac.insert({1}, true);
+        ac.insert({2}, true);
+        assert(ac.size() == 2);
+        ac.find({1});
+        ac.insert({3}, false);
+        assert(ac.size() == 2);
+        assert(ac.find({2}) == nullptr);
+        assert(ac.find({3}) && !*ac.find({3}));
+        // {1} has spent its second chance, while the hit on {3} renewed its own
+        ac.insert({4}, true);
+        assert(ac.size() == 2);
+        assert(ac.slots.size() == 2);
+        assert(ac.find({1}) == nullptr);
+        assert(ac.find({3}) != nullptr);
+        assert(ac.find({4}) != nullptr);
+    }
+
+    // With every entry referenced, the hand comes round to its start
+    {
+        applicability_cache ac(2);
+        ac.insert({1}, true);
+        ac.insert({2}, true);
+        ac.find({1});
+        ac.find({2});
+        ac.insert({3}, true);
+        assert(ac.find({1}) == nullptr);
+        assert(ac.find({2}) != nullptr);
+        assert(ac.find({3}) != nullptr);
+    }
+}
+
 void test_mcts_decider_constructor() {
     // Test 1: Basic construction with empty stores
     {
@@ -15574,6 +18107,33 @@ void test_mcts_decider_choose_goal() {
         
         assert(sim.length() == length_before + 1);
     }
+
+    // Builtin goals are never chosen; with only builtins left there is no choice
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        lineage_pool lp;
+        database db;
+        db.push_back({ep.functor("a"), {}});
+        goals gs_init = {ep.functor("int_lt", {ep.var(0), ep.integer(1)}), ep.functor("a")};
+        candidate_store cs(db, gs_init, lp);
+
+        monte_carlo::tree_node<mcts_decider::choice> root;
+        std::mt19937 rng(123);
+        monte_carlo::simulation<mcts_decider::choice, std::mt19937> sim(root, 1.414, rng);
+        mcts_decider decider(cs, sim);
+
+        for (int i = 0; i < 10; ++i)
+            assert(decider.choose_goal() == lp.goal(nullptr, 1));
+
+        cs.members.erase(lp.goal(nullptr, 1));
+        size_t length_before = sim.length();
+        assert(decider.choose_goal() == nullptr);
+        assert(decider() == std::make_pair((const goal_lineage*)nullptr, (size_t)0));
+        assert(sim.length() == length_before);
+        t.pop();
+    }
 }
 
 void test_mcts_decider_choose_candidate() {
@@ -16494,8 +19054,18 @@ void test_cdcl_constructor() {
     {
         cdcl c;
         assert(c.avoidances.empty());
+        assert(c.watches.empty());
         assert(c.watched_goals.empty());
+        assert(c.taken.empty());
         assert(c.eliminated_resolutions.empty());
+        assert(c.hits.empty());
+        assert(c.activity.empty());
+        assert(c.deleted == 0);
+        assert(c.pinned.empty());
+        assert(c.implied_avoidances.empty());
+        assert(c.unimplied_goals.empty());
+        assert(c.occurrences.empty());
+        assert(c.subsumed == 0);
         assert(!c.is_refuted);
     }
 
@@ -16513,8 +19083,8 @@ void test_cdcl_constructor() {
     }
 }
 
-void test_cdcl_upsert() {
-    // Test 1: Upsert multi-element avoidance - stored, no elimination
+void test_cdcl_watch() {
+    // Test 1: Watching points the slot at the resolution and links its goal
     {
         lineage_pool lp;
         cdcl c;
@@ -16524,107 +19094,63 @@ void test_cdcl_upsert() {
         const resolution_lineage* rl1 = lp.resolution(g1, 0);
         const resolution_lineage* rl2 = lp.resolution(g2, 0);
 
-        avoidance av;
-        av.insert(rl1);
-        av.insert(rl2);
-
-        c.upsert(0, av);
+        c.watches[0] = {nullptr, nullptr};
+        c.watch(0, 0, rl1);
+        c.watch(0, 1, rl2);
 
-        assert(c.avoidances.size() == 1);
-        assert(c.avoidances.at(0) == av);
+        assert(c.watches.at(0)[0] == rl1);
+        assert(c.watches.at(0)[1] == rl2);
+        assert(c.watched_goals.at(g1).count(0) == 1);
+        assert(c.watched_goals.at(g2).count(0) == 1);
+        // watching alone never eliminates
         assert(c.eliminated_resolutions.empty());
     }
 
-    // Test 2: Upsert singleton avoidance - rl added to eliminated_resolutions
-    {
-        lineage_pool lp;
-        cdcl c;
-
-        const goal_lineage* g1 = lp.goal(nullptr, 0);
-        const resolution_lineage* rl1 = lp.resolution(g1, 0);
-
-        avoidance av;
-        av.insert(rl1);
-
-        c.upsert(0, av);
-
-        assert(c.avoidances.size() == 1);
-        assert(c.avoidances.at(0) == av);
-        assert(c.eliminated_resolutions.size() == 1);
-        assert(c.eliminated_resolutions.count(rl1) == 1);
-    }
-
-    // Test 3: Upsert to overwrite existing id - avoidance replaced, elimination updated
+    // Test 2: Two avoidances watching the same goal are both linked
     {
         lineage_pool lp;
         cdcl c;
 
         const goal_lineage* g1 = lp.goal(nullptr, 0);
-        const goal_lineage* g2 = lp.goal(nullptr, 1);
         const resolution_lineage* rl1 = lp.resolution(g1, 0);
-        const resolution_lineage* rl2 = lp.resolution(g2, 0);
-
-        avoidance av_multi;
-        av_multi.insert(rl1);
-        av_multi.insert(rl2);
-
-        c.upsert(0, av_multi);
-        assert(c.avoidances.at(0) == av_multi);
-        assert(c.eliminated_resolutions.empty());
-
-        // Overwrite with singleton - now rl1 becomes eliminated
-        avoidance av_single;
-        av_single.insert(rl1);
-
-        c.upsert(0, av_single);
-
-        assert(c.avoidances.size() == 1);
-        assert(c.avoidances.at(0) == av_single);
-        assert(c.eliminated_resolutions.size() == 1);
-        assert(c.eliminated_resolutions.count(rl1) == 1);
-    }
-
-    // Test 4: Upsert empty avoidance - stored, no elimination, is_refuted NOT set by upsert
-    {
-        cdcl c;
+        const resolution_lineage* rl2 = lp.resolution(g1, 1);
 
-        avoidance empty_av;
-        c.upsert(0, empty_av);
+        c.watches[0] = {nullptr, nullptr};
+        c.watches[1] = {nullptr, nullptr};
+        c.watch(0, 0, rl1);
+        c.watch(1, 0, rl2);
 
-        assert(c.avoidances.size() == 1);
-        assert(c.avoidances.at(0).empty());
-        assert(c.eliminated_resolutions.empty());
-        // is_refuted is only set by learn(), not upsert()
-        assert(!c.is_refuted);
+        assert(c.watched_goals.at(g1) == std::set<size_t>({0, 1}));
     }
 }
 
 void test_cdcl_erase() {
-    // Test 1: Erase single avoidance with one rl - avoidance removed and watched_goals unlinked
+    // Test 1: Erase a watched avoidance - avoidance, watches and links removed
     {
         lineage_pool lp;
         cdcl c;
 
         const goal_lineage* g1 = lp.goal(nullptr, 0);
+        const goal_lineage* g2 = lp.goal(nullptr, 1);
         const resolution_lineage* rl1 = lp.resolution(g1, 0);
+        const resolution_lineage* rl2 = lp.resolution(g2, 0);
 
-        avoidance av;
-        av.insert(rl1);
-
-        // Manually set up state as instructed
-        c.avoidances[0] = av;
-        c.watched_goals[g1].insert(0);
-
-        assert(c.avoidances.size() == 1);
-        assert(c.watched_goals.at(g1).size() == 1);
+        decision_store ds;
+        ds.insert(rl1);
+        ds.insert(rl2);
+        c.learn(lemma(ds), true);
 
         c.erase(0);
 
         assert(c.avoidances.empty());
+        assert(c.pinned.empty());
+        assert(c.implied_avoidances.empty());
+        assert(c.watches.empty());
         assert(c.watched_goals.at(g1).empty());
+        assert(c.watched_goals.at(g2).empty());
     }
 
-    // Test 2: Erase avoidance with multiple rls with distinct parents - all links removed
+    // Test 2: Only the watched goals are linked, so only they are unlinked
     {
         lineage_pool lp;
         cdcl c;
@@ -16636,63 +19162,65 @@ void test_cdcl_erase() {
         const resolution_lineage* rl2 = lp.resolution(g2, 0);
         const resolution_lineage* rl3 = lp.resolution(g3, 0);
 
-        avoidance av;
-        av.insert(rl1);
-        av.insert(rl2);
-        av.insert(rl3);
+        decision_store ds;
+        ds.insert(rl1);
+        ds.insert(rl2);
+        ds.insert(rl3);
+        c.learn(lemma(ds));
 
-        c.avoidances[0] = av;
-        c.watched_goals[g1].insert(0);
-        c.watched_goals[g2].insert(0);
-        c.watched_goals[g3].insert(0);
+        assert(c.watched_goals.size() == 2);
+        size_t linked = 0;
+        for (const auto& [gl, ids] : c.watched_goals)
+            linked += ids.count(0);
+        assert(linked == 2);
 
         c.erase(0);
 
         assert(c.avoidances.empty());
-        assert(c.watched_goals.at(g1).empty());
-        assert(c.watched_goals.at(g2).empty());
-        assert(c.watched_goals.at(g3).empty());
+        for (const auto& [gl, ids] : c.watched_goals)
+            assert(ids.empty());
     }
 
-    // Test 3: Two avoidances sharing a parent - erasing one leaves the other's link intact
+    // Test 3: Two avoidances sharing a goal - erasing one leaves the other's link intact
     {
         lineage_pool lp;
         cdcl c;
 
         const goal_lineage* g1 = lp.goal(nullptr, 0);
-        const resolution_lineage* rl1 = lp.resolution(g1, 0);
-        const resolution_lineage* rl2 = lp.resolution(g1, 1);
-
-        avoidance av0;
-        av0.insert(rl1);
-        avoidance av1;
-        av1.insert(rl2);
-
-        c.avoidances[0] = av0;
-        c.avoidances[1] = av1;
-        c.watched_goals[g1].insert(0);
-        c.watched_goals[g1].insert(1);
+        const goal_lineage* g2 = lp.goal(nullptr, 1);
+        const goal_lineage* g3 = lp.goal(nullptr, 2);
+        const resolution_lineage* rl_a1 = lp.resolution(g1, 0);
+        const resolution_lineage* rl_a2 = lp.resolution(g2, 0);
+        const resolution_lineage* rl_b1 = lp.resolution(g2, 1);
+        const resolution_lineage* rl_b2 = lp.resolution(g3, 0);
+
+        decision_store ds0;
+        ds0.insert(rl_a1);
+        ds0.insert(rl_a2);
+        decision_store ds1;
+        ds1.insert(rl_b1);
+        ds1.insert(rl_b2);
+        c.learn(lemma(ds0));
+        c.learn(lemma(ds1));
 
-        assert(c.watched_goals.at(g1).size() == 2);
+        assert(c.watched_goals.at(g2) == std::set<size_t>({0, 1}));
 
         c.erase(0);
 
-        // avoidance 0 gone, avoidance 1 intact
         assert(c.avoidances.size() == 1);
-        assert(c.avoidances.count(1) == 1);
-
-        // link to avoidance 0 gone, link to avoidance 1 still there
-        assert(c.watched_goals.at(g1).size() == 1);
-        assert(c.watched_goals.at(g1).count(0) == 0);
-        assert(c.watched_goals.at(g1).count(1) == 1);
+        assert(c.avoidances.at(1) == ds1);
+        assert(c.watches.count(0) == 0);
+        assert(c.watched_goals.at(g1).empty());
+        assert(c.watched_goals.at(g2) == std::set<size_t>({1}));
+        assert(c.watched_goals.at(g3) == std::set<size_t>({1}));
     }
 
-    // Test 4: Erase empty avoidance - no watched_goals cleanup needed, just removed from avoidances
+    // Test 4: Erase empty avoidance - nothing watched, just removed from avoidances
     {
         cdcl c;
 
-        avoidance empty_av;
-        c.avoidances[0] = empty_av;
+        decision_store empty_ds;
+        c.learn(lemma(empty_ds));
 
         c.erase(0);
 
@@ -16700,62 +19228,108 @@ void test_cdcl_erase() {
         assert(c.watched_goals.empty());
     }
 
-    // Test 5: Multiple avoidances, multiple rls per avoidance - erasing one avoidance removes
-    //         only its specific links; all links belonging to other avoidances remain intact
+    // Test 5: Erasing after a watched goal was extracted creates no entry for it
     {
         lineage_pool lp;
         cdcl c;
 
         const goal_lineage* g1 = lp.goal(nullptr, 0);
         const goal_lineage* g2 = lp.goal(nullptr, 1);
-        const goal_lineage* g3 = lp.goal(nullptr, 2);
+        const resolution_lineage* rl1 = lp.resolution(g1, 0);
+        const resolution_lineage* rl2 = lp.resolution(g2, 0);
 
-        const resolution_lineage* rl_a1 = lp.resolution(g1, 0); // av0: parent g1
-        const resolution_lineage* rl_a2 = lp.resolution(g2, 0); // av0: parent g2
-        const resolution_lineage* rl_b1 = lp.resolution(g2, 1); // av1: parent g2
-        const resolution_lineage* rl_b2 = lp.resolution(g3, 0); // av1: parent g3
+        decision_store ds;
+        ds.insert(rl1);
+        ds.insert(rl2);
+        c.learn(lemma(ds));
 
-        avoidance av0;
-        av0.insert(rl_a1);
-        av0.insert(rl_a2);
+        c.watched_goals.erase(g1);
+        c.erase(0);
 
-        avoidance av1;
-        av1.insert(rl_b1);
-        av1.insert(rl_b2);
+        assert(c.watched_goals.count(g1) == 0);
+        assert(c.watched_goals.at(g2).empty());
+    }
 
-        // Manually set up: av0 watched by g1 and g2; av1 watched by g2 and g3
-        c.avoidances[0] = av0;
-        c.avoidances[1] = av1;
-        c.watched_goals[g1].insert(0);
-        c.watched_goals[g2].insert(0);
-        c.watched_goals[g2].insert(1);
-        c.watched_goals[g3].insert(1);
+    // Test 6: Erasing removes the avoidance from the occurrence index
+    {
+        lineage_pool lp;
+        cdcl c;
 
-        assert(c.avoidances.size() == 2);
-        assert(c.watched_goals.at(g1).size() == 1);
-        assert(c.watched_goals.at(g2).size() == 2);
-        assert(c.watched_goals.at(g3).size() == 1);
+        const resolution_lineage* rl1 = lp.resolution(lp.goal(nullptr, 0), 0);
+        const resolution_lineage* rl2 = lp.resolution(lp.goal(nullptr, 1), 0);
+        const resolution_lineage* rl3 = lp.resolution(lp.goal(nullptr, 2), 0);
+
+        c.learn(lemma(avoidance{rl1, rl2}));
+        c.learn(lemma(avoidance{rl2, rl3}));
+        assert(c.occurrences.at(rl2) == std::set<size_t>({0, 1}));
 
-        // Erase av0 - should remove id 0 from g1 and g2, leave av1 and g3's link untouched
         c.erase(0);
 
-        assert(c.avoidances.size() == 1);
-        assert(c.avoidances.count(0) == 0);
-        assert(c.avoidances.count(1) == 1);
-        assert(c.avoidances.at(1) == av1);
+        // resolutions left in no avoidance are dropped from the index
+        assert(c.occurrences.count(rl1) == 0);
+        assert(c.occurrences.at(rl2) == std::set<size_t>({1}));
+        assert(c.occurrences.at(rl3) == std::set<size_t>({1}));
+    }
+}
 
-        // g1 exclusively watched av0 - its set is now empty
-        assert(c.watched_goals.at(g1).empty());
+void test_cdcl_redundant() {
+    lineage_pool lp;
+    cdcl c;
+
+    const resolution_lineage* rl1 = lp.resolution(lp.goal(nullptr, 0), 0);
+    const resolution_lineage* rl2 = lp.resolution(lp.goal(nullptr, 1), 0);
+    const resolution_lineage* rl3 = lp.resolution(lp.goal(nullptr, 2), 0);
+    const resolution_lineage* rl4 = lp.resolution(lp.goal(nullptr, 3), 0);
+
+    // Nothing is redundant against an empty store
+    assert(!c.redundant(avoidance{rl1}));
+
+    c.learn(lemma(avoidance{rl1, rl2}));
+
+    // Duplicates and supersets of a stored avoidance are redundant, and say which
+    size_t by = 7;
+    assert(c.redundant(avoidance{rl1, rl2}));
+    assert(c.redundant(avoidance{rl1, rl2, rl3}, &by));
+    assert(by == 0);
+
+    // Overlapping only in part, or being a subset, is not
+    assert(!c.redundant(avoidance{rl1, rl3}));
+    assert(!c.redundant(avoidance{rl1}));
+    assert(!c.redundant(avoidance{rl3, rl4}, &by));
+    assert(!c.redundant(avoidance{}));
+    assert(by == 0);
+
+    // Once refuted, everything is
+    c.learn(lemma(avoidance{}));
+    assert(c.redundant(avoidance{rl3, rl4}));
+    assert(c.redundant(avoidance{}));
+}
 
-        // g2 watched both - only the link to av0 (id 0) is gone; link to av1 (id 1) remains
-        assert(c.watched_goals.at(g2).size() == 1);
-        assert(c.watched_goals.at(g2).count(0) == 0);
-        assert(c.watched_goals.at(g2).count(1) == 1);
+void test_cdcl_supersets() {
+    lineage_pool lp;
+    cdcl c;
 
-        // g3 only watched av1 - completely untouched
-        assert(c.watched_goals.at(g3).size() == 1);
-        assert(c.watched_goals.at(g3).count(1) == 1);
-    }
+    const resolution_lineage* rl1 = lp.resolution(lp.goal(nullptr, 0), 0);
+    const resolution_lineage* rl2 = lp.resolution(lp.goal(nullptr, 1), 0);
+    const resolution_lineage* rl3 = lp.resolution(lp.goal(nullptr, 2), 0);
+    const resolution_lineage* rl4 = lp.resolution(lp.goal(nullptr, 3), 0);
+
+    c.learn(lemma(avoidance{rl1, rl2, rl3}));
+    c.learn(lemma(avoidance{rl1, rl4}));
+    c.learn(lemma(avoidance{rl2, rl3, rl4}));
+
+    // Stored avoidances containing all of the given one
+    assert(c.supersets(avoidance{rl1}) == std::vector<size_t>({0, 1}));
+    assert(c.supersets(avoidance{rl2, rl3}) == std::vector<size_t>({0, 2}));
+    assert(c.supersets(avoidance{rl1, rl2, rl3}) == std::vector<size_t>({0}));
+    assert(c.supersets(avoidance{rl1, rl3, rl4}).empty());
+
+    // A resolution in no avoidance rules out every candidate
+    const resolution_lineage* rl5 = lp.resolution(lp.goal(nullptr, 4), 0);
+    assert(c.supersets(avoidance{rl1, rl5}).empty());
+
+    // The empty avoidance is contained in all of them
+    assert(c.supersets(avoidance{}) == std::vector<size_t>({0, 1, 2}));
 }
 
 void test_cdcl_learn() {
@@ -16947,7 +19521,7 @@ void test_cdcl_learn() {
         assert(c.avoidances.at(0).count(rl1) == 1);
     }
 
-    // Test 9: Same decision store learned twice — two independent avoidances at ids 0 and 1
+    // Test 9: Same decision store learned twice — the duplicate is dropped, but uses up id 1
     {
         lineage_pool lp;
         cdcl c;
@@ -16964,14 +19538,12 @@ void test_cdcl_learn() {
         c.learn(lemma(ds));
         c.learn(lemma(ds));
 
-        // Two distinct avoidance entries with the same content
-        assert(c.avoidances.size() == 2);
-        assert(c.avoidances.at(0) == c.avoidances.at(1));
-        // Both avoidances watched by both goals
-        assert(c.watched_goals.at(g1).count(0) == 1);
-        assert(c.watched_goals.at(g1).count(1) == 1);
-        assert(c.watched_goals.at(g2).count(0) == 1);
-        assert(c.watched_goals.at(g2).count(1) == 1);
+        assert(c.avoidances.size() == 1);
+        assert(c.avoidances.at(0) == ds);
+        assert(c.next_avoidance_id == 2);
+        assert(c.subsumed == 1);
+        assert(c.watched_goals.at(g1) == std::set<size_t>({0}));
+        assert(c.watched_goals.at(g2) == std::set<size_t>({0}));
     }
 
     // Test 10: is_refuted persists across subsequent learns
@@ -16991,7 +19563,9 @@ void test_cdcl_learn() {
         c.learn(lemma(ds)); // additional learn after refutation
 
         assert(c.is_refuted); // still refuted
-        assert(c.avoidances.size() == 2);
+        // the empty avoidance subsumes everything learned after it
+        assert(c.avoidances.size() == 1);
+        assert(c.subsumed == 1);
     }
 
     // Test 11: Multi-level chain (3 levels) — only the deepest leaf's parent is watched
@@ -17085,23 +19659,127 @@ void test_cdcl_learn() {
 
         assert(c.avoidances.size() == 2);
 
-        // Erase av0: constrain with sibling of rl1 (g1 is watched, rl1_alt not in av0 → erase)
-        c.constrain(rl1_alt);
+        // Erase av0: constrain with sibling of rl1 (g1 is watched, rl1_alt not in av0 → erase)
+        c.constrain(rl1_alt);
+
+        assert(c.avoidances.size() == 1);
+        assert(c.avoidances.count(0) == 0);
+        assert(c.avoidances.count(1) == 1);
+        assert(c.avoidances.at(1).count(rl2) == 1); // av1 intact
+
+        // Third learn — must get a fresh id (2) and must NOT overwrite av1 at id 1
+        c.learn(lemma(ds3));
+
+        assert(c.avoidances.size() == 2);                   // av1 + av2
+        assert(c.avoidances.at(1).count(rl2) == 1);         // av1 untouched
+        assert(c.avoidances.count(2) == 1);                 // av2 at fresh id 2
+        assert(c.avoidances.at(2).count(rl3) == 1);         // av2 content correct
+        assert(c.watched_goals.at(g2).count(1) == 1);       // g2 still links to av1
+        assert(c.watched_goals.at(g3).count(2) == 1);       // g3 links to av2 at id 2
+    }
+
+    // Test 14: A subset replaces the stored avoidances it is contained in,
+    //          keeping the greatest of their activities
+    {
+        lineage_pool lp;
+        cdcl c;
+
+        const goal_lineage* g1 = lp.goal(nullptr, 0);
+        const goal_lineage* g3 = lp.goal(nullptr, 2);
+        const resolution_lineage* rl1 = lp.resolution(g1, 0);
+        const resolution_lineage* rl2 = lp.resolution(lp.goal(nullptr, 1), 0);
+        const resolution_lineage* rl3 = lp.resolution(g3, 0);
+        const resolution_lineage* rl4 = lp.resolution(lp.goal(nullptr, 3), 0);
+
+        c.learn(lemma(avoidance{rl1, rl2, rl3}));
+        c.learn(lemma(avoidance{rl1, rl3, rl4}));
+        c.learn(lemma(avoidance{rl2, rl4}));
+        c.activity[0] = 1.0;
+        c.activity[1] = 3.0;
+
+        c.learn(lemma(avoidance{rl1, rl3}));
+
+        assert(c.avoidances.size() == 2);
+        assert(c.avoidances.count(2) == 1);
+        assert(c.avoidances.at(3) == avoidance({rl1, rl3}));
+        assert(c.subsumed == 2);
+        assert(c.activity.at(3) == 3.0);
+        assert(c.activity.count(0) == 0);
+        assert(c.activity.count(1) == 0);
+        // the replaced avoidances are unwatched and unindexed
+        assert(c.watches.count(0) == 0);
+        assert(c.watches.count(1) == 0);
+        assert(c.watched_goals.at(g1) == std::set<size_t>({3}));
+        assert(c.occurrences.at(rl1) == std::set<size_t>({3}));
+        assert(c.occurrences.at(rl4) == std::set<size_t>({2}));
+    }
+
+    // Test 15: A singleton subsumes every avoidance containing its resolution
+    {
+        lineage_pool lp;
+        cdcl c;
+
+        const resolution_lineage* rl1 = lp.resolution(lp.goal(nullptr, 0), 0);
+        const resolution_lineage* rl2 = lp.resolution(lp.goal(nullptr, 1), 0);
+        const resolution_lineage* rl3 = lp.resolution(lp.goal(nullptr, 2), 0);
+
+        c.learn(lemma(avoidance{rl1, rl2}));
+        c.learn(lemma(avoidance{rl2, rl3}));
+        c.learn(lemma(avoidance{rl2}));
+
+        assert(c.avoidances.size() == 1);
+        assert(c.eliminated(rl2));
+        assert(c.occurrences.size() == 1);
+
+        // and everything learned with it afterwards is dropped
+        c.learn(lemma(avoidance{rl1, rl2, rl3}));
+        assert(c.avoidances.size() == 1);
+        assert(c.subsumed == 3);
+        assert(c.next_avoidance_id == 4);
+    }
+
+    // Test 16: Only lemmas learned with a pin are pinned
+    {
+        lineage_pool lp;
+        cdcl c;
+
+        decision_store ds1; ds1.insert(lp.resolution(lp.goal(nullptr, 0), 0));
+        decision_store ds2; ds2.insert(lp.resolution(lp.goal(nullptr, 1), 0));
+        decision_store ds3; ds3.insert(lp.resolution(lp.goal(nullptr, 2), 0));
+
+        c.learn(lemma(ds1), true);
+        c.learn(lemma(ds2));
+        c.learn(lemma(ds3), true);
+
+        assert(c.avoidances.size() == 3);
+        assert(c.pinned == std::set<size_t>({0, 2}));
+    }
+
+    // Test 17: Pins are kept through subsumption, whichever way it goes
+    {
+        lineage_pool lp;
+        cdcl c;
+
+        const resolution_lineage* rl1 = lp.resolution(lp.goal(nullptr, 0), 0);
+        const resolution_lineage* rl2 = lp.resolution(lp.goal(nullptr, 1), 0);
+        const resolution_lineage* rl3 = lp.resolution(lp.goal(nullptr, 2), 0);
+        const resolution_lineage* rl4 = lp.resolution(lp.goal(nullptr, 3), 0);
+
+        c.learn(lemma(avoidance{rl1, rl2, rl3}), true);
+        c.learn(lemma(avoidance{rl2, rl4}));
+        assert(c.pinned == std::set<size_t>({0}));
 
-        assert(c.avoidances.size() == 1);
+        // a subset learned unpinned takes over the pin of what it replaces
+        c.learn(lemma(avoidance{rl1, rl2}));
         assert(c.avoidances.count(0) == 0);
-        assert(c.avoidances.count(1) == 1);
-        assert(c.avoidances.at(1).count(rl2) == 1); // av1 intact
-
-        // Third learn — must get a fresh id (2) and must NOT overwrite av1 at id 1
-        c.learn(lemma(ds3));
+        assert(c.pinned == std::set<size_t>({2}));
 
-        assert(c.avoidances.size() == 2);                   // av1 + av2
-        assert(c.avoidances.at(1).count(rl2) == 1);         // av1 untouched
-        assert(c.avoidances.count(2) == 1);                 // av2 at fresh id 2
-        assert(c.avoidances.at(2).count(rl3) == 1);         // av2 content correct
-        assert(c.watched_goals.at(g2).count(1) == 1);       // g2 still links to av1
-        assert(c.watched_goals.at(g3).count(2) == 1);       // g3 links to av2 at id 2
+        // a pinned lemma dropped as redundant pins the subset that covers it
+        c.learn(lemma(avoidance{rl2, rl3, rl4}), true);
+        assert(c.avoidances.count(3) == 0);
+        assert(c.pinned == std::set<size_t>({1, 2}));
+        // pinned or not, only those learned unpinned came from a conflict
+        assert(c.implied_avoidances == std::set<size_t>({1, 2}));
     }
 }
 
@@ -17126,18 +19804,19 @@ void test_cdcl_constrain() {
 
         c.constrain(rl1);
 
-        // rl1 removed; avoidance is now singleton {rl2}
-        assert(c.avoidances.at(0).size() == 1);
-        assert(c.avoidances.at(0).count(rl1) == 0);
-        assert(c.avoidances.at(0).count(rl2) == 1);
+        // rl1 taken; the avoidance is kept as learned, with only rl2 untaken
+        assert(c.avoidances.at(0) == av);
+        assert(c.taken.at(g1) == rl1);
+        // the elimination counts toward the avoidance's activity
+        assert(c.hits.at(0) == 1);
 
         // Singleton → rl2 is now eliminated
         assert(c.eliminated_resolutions.size() == 1);
         assert(c.eliminated_resolutions.count(rl2) == 1);
     }
 
-    // Test 2: rl IS the singleton in an avoidance - rl removed, avoidance becomes empty;
-    //         is_refuted NOT set (only learn() does that, not upsert())
+    // Test 2: rl IS the singleton in an avoidance - nothing is left to eliminate;
+    //         is_refuted NOT set (only learn() does that)
     {
         lineage_pool lp;
         cdcl c;
@@ -17154,8 +19833,9 @@ void test_cdcl_constrain() {
 
         c.constrain(rl1);
 
-        // rl1 removed; avoidance is now empty (upsert called, not insert - no refutation)
-        assert(c.avoidances.at(0).empty());
+        // the avoidance stays, with every resolution taken - no refutation
+        assert(c.avoidances.at(0) == av);
+        assert(c.eliminated_resolutions.size() == 1);
         assert(!c.is_refuted);
     }
 
@@ -17217,9 +19897,8 @@ void test_cdcl_constrain() {
 
         c.constrain(rl1);
 
-        // av0 reduced: rl1 removed → {rl2}, upsert → rl2 eliminated
-        assert(c.avoidances.at(0).size() == 1);
-        assert(c.avoidances.at(0).count(rl2) == 1);
+        // av0: rl1 taken, only rl2 left → rl2 eliminated
+        assert(c.avoidances.at(0) == av0);
         assert(c.eliminated_resolutions.count(rl2) == 1);
 
         // av1 untouched (g1 does not watch it)
@@ -17310,22 +19989,86 @@ void test_cdcl_constrain() {
         ds.insert(rl2);
         c.learn(lemma(ds)); // av0 = {rl1, rl2}, watched by g1 and g2
 
-        // Step 1: constrain(rl1) — reduces av0 to {rl2}; watched_goals[g1] goes stale
+        // Step 1: constrain(rl1) — only rl2 is left untaken; g1's watch list is dropped
         c.constrain(rl1);
-        assert(c.avoidances.at(0).size() == 1);
-        assert(c.avoidances.at(0).count(rl2) == 1);
+        assert(c.eliminated_resolutions.count(rl2) == 1);
+        assert(c.watched_goals.count(g1) == 0);
 
-        // Step 2: constrain(rl2_sibling) — g2 is watched but rl2_sibling not in {rl2}
-        //         → erase(av0); only g2's link is cleaned up; g1's link is left dangling
+        // Step 2: constrain(rl2_sibling) — g2 is watched but went another way
+        //         → erase(av0)
         c.constrain(rl2_sibling);
         assert(c.avoidances.empty());
 
-        // Step 3: constrain(rl1_sibling) — g1 has stale link to the now-deleted av0;
-        //         must be a no-op, but currently crashes via avoidances.at(stale_id)
+        // Step 3: constrain(rl1_sibling) — nothing watches g1 any more; must be a no-op
         c.constrain(rl1_sibling);
 
         assert(c.avoidances.empty()); // still empty — no avoidance resurrected
     }
+
+    // Test 8: Longer avoidances move a watch on, and only eliminate at the last
+    {
+        lineage_pool lp;
+        cdcl c;
+
+        const goal_lineage* g1 = lp.goal(nullptr, 0);
+        const goal_lineage* g2 = lp.goal(nullptr, 1);
+        const goal_lineage* g3 = lp.goal(nullptr, 2);
+        const resolution_lineage* rl1 = lp.resolution(g1, 0);
+        const resolution_lineage* rl2 = lp.resolution(g2, 0);
+        const resolution_lineage* rl3 = lp.resolution(g3, 0);
+
+        decision_store ds;
+        ds.insert(rl1);
+        ds.insert(rl2);
+        ds.insert(rl3);
+        c.learn(lemma(ds));
+
+        // take the resolutions in watch order: the first moves to the unwatched one
+        std::array<const resolution_lineage*, 2> w = c.watches.at(0);
+        const resolution_lineage* unwatched = rl1 != w[0] && rl1 != w[1] ? rl1
+                                            : rl2 != w[0] && rl2 != w[1] ? rl2 : rl3;
+        assert(c.watched_goals.count(unwatched->parent) == 0);
+
+        c.constrain(w[0]);
+        assert(c.eliminated_resolutions.empty());
+        assert(c.watched_goals.at(unwatched->parent).count(0) == 1);
+        assert(c.watches.at(0)[0] == unwatched);
+
+        c.constrain(unwatched);
+        assert(c.eliminated_resolutions == std::set<const resolution_lineage*>({w[1]}));
+    }
+
+    // Test 9: A goal resolved another way is noticed once a watch reaches it
+    {
+        lineage_pool lp;
+        cdcl c;
+
+        const goal_lineage* g1 = lp.goal(nullptr, 0);
+        const goal_lineage* g2 = lp.goal(nullptr, 1);
+        const goal_lineage* g3 = lp.goal(nullptr, 2);
+        const resolution_lineage* rl1 = lp.resolution(g1, 0);
+        const resolution_lineage* rl2 = lp.resolution(g2, 0);
+        const resolution_lineage* rl3 = lp.resolution(g3, 0);
+
+        decision_store ds;
+        ds.insert(rl1);
+        ds.insert(rl2);
+        ds.insert(rl3);
+        c.learn(lemma(ds));
+
+        std::array<const resolution_lineage*, 2> w = c.watches.at(0);
+        const resolution_lineage* unwatched = rl1 != w[0] && rl1 != w[1] ? rl1
+                                            : rl2 != w[0] && rl2 != w[1] ? rl2 : rl3;
+
+        // the unwatched goal goes another way: the avoidance is not visited
+        c.constrain(lp.resolution(unwatched->parent, 1));
+        assert(c.avoidances.size() == 1);
+
+        // taking a watched resolution finds it can never be completed
+        c.constrain(w[0]);
+        assert(c.avoidances.empty());
+        assert(c.eliminated_resolutions.empty());
+    }
 }
 
 void test_cdcl_refuted() {
@@ -17453,6 +20196,467 @@ void test_cdcl_eliminated() {
     }
 }
 
+void test_cdcl_implied() {
+    lineage_pool lp;
+    cdcl c;
+    const resolution_lineage* rl1 = lp.resolution(lp.goal(nullptr, 0), 0);
+    const resolution_lineage* rl2 = lp.resolution(lp.goal(nullptr, 1), 0);
+    const resolution_lineage* rl3 = lp.resolution(lp.goal(nullptr, 2), 0);
+
+    // Conflict lemmas are implied; pinned ones are not
+    c.learn(lemma(avoidance{rl1, rl2}));
+    c.learn(lemma(avoidance{rl2, rl3}), true);
+    assert(c.implied(0));
+    assert(!c.implied(1));
+
+    // A conflict lemma stays implied when it takes over a pin
+    c.learn(lemma(avoidance{rl3}));
+    assert(c.implied(2));
+    assert(c.pinned.contains(2));
+
+    // Erased and unknown avoidances are not
+    c.erase(0);
+    assert(!c.implied(0));
+    assert(!c.implied(7));
+
+    // Nor are conflict lemmas whose analysis used a lemma that is not
+    c.learn(lemma(avoidance{rl1}), false, false);
+    assert(!c.implied(3));
+    assert(!c.pinned.contains(3));
+}
+
+void test_cdcl_explain() {
+    lineage_pool lp;
+    cdcl c;
+
+    const goal_lineage* g1 = lp.goal(nullptr, 0);
+    const goal_lineage* g2 = lp.goal(nullptr, 1);
+    const goal_lineage* g3 = lp.goal(nullptr, 2);
+    const resolution_lineage* r10 = lp.resolution(g1, 0);
+    const resolution_lineage* r20 = lp.resolution(g2, 0);
+    const resolution_lineage* r30 = lp.resolution(g3, 0);
+
+    c.learn(lemma(avoidance{r10, r20}));
+    c.learn(lemma(avoidance{r30}));
+
+    // Eliminations learned outright have no reason
+    std::vector<const resolution_lineage*> result;
+    c.explain(g3, result);
+    assert(result.empty());
+
+    // Taking r10 eliminates r20, so g2 is explained by r10
+    c.constrain(r10);
+    assert(c.eliminated(r20));
+    assert(c.reasons.at(g2) == std::vector<const resolution_lineage*>({r10}));
+    c.explain(g2, result);
+    assert(result == std::vector<const resolution_lineage*>({r10}));
+
+    // Explanations are appended, and unconstrained goals add nothing
+    c.explain(g1, result);
+    c.explain(g2, result);
+    assert(result == std::vector<const resolution_lineage*>({r10, r10}));
+
+    // Eliminations by avoidances that are not implied, outright or on
+    // constraint, are reported as such
+    cdcl pinned;
+    pinned.learn(lemma(avoidance{r10, r20}), true);
+    pinned.learn(lemma(avoidance{lp.resolution(g3, 1)}), true);
+    pinned.constrain(r10);
+    assert(pinned.unimplied_goals == std::set<const goal_lineage*>({g2, g3}));
+    result.clear();
+    assert(!pinned.explain(g2, result));
+    assert(result == std::vector<const resolution_lineage*>({r10}));
+    assert(!pinned.explain(g3, result));
+    assert(pinned.explain(g1, result));
+    assert(c.explain(g2, result));
+}
+
+void test_cdcl_credit() {
+    // Test 1: Eliminations in a copy are credited to the original's avoidances
+    {
+        lineage_pool lp;
+        cdcl c;
+
+        const goal_lineage* g1 = lp.goal(nullptr, 0);
+        const goal_lineage* g2 = lp.goal(nullptr, 1);
+        const resolution_lineage* rl1 = lp.resolution(g1, 0);
+        const resolution_lineage* rl2 = lp.resolution(g2, 0);
+
+        decision_store ds;
+        ds.insert(rl1);
+        ds.insert(rl2);
+        c.learn(lemma(ds));
+
+        cdcl copy = c;
+        copy.constrain(rl1);
+        assert(copy.hits.at(0) == 1);
+        assert(c.hits.empty());
+
+        c.credit(copy);
+        c.credit(copy);
+        assert(c.activity.at(0) == 2.0);
+    }
+
+    // Test 2: Hits for avoidances the original no longer has are ignored
+    {
+        lineage_pool lp;
+        cdcl c;
+        cdcl copy;
+        copy.hits[7] = 3;
+        c.credit(copy);
+        assert(c.activity.empty());
+    }
+}
+
+void test_cdcl_reduce() {
+    // three-resolution avoidances over goals g0..g5, plus one short one
+    auto three = [](lineage_pool& lp, size_t first) {
+        decision_store ds;
+        for (size_t i = first; i < first + 3; ++i)
+            ds.insert(lp.resolution(lp.goal(nullptr, i), 0));
+        return ds;
+    };
+
+    // Test 1: Under the target, nothing is deleted
+    {
+        lineage_pool lp;
+        cdcl c;
+        c.learn(lemma(three(lp, 0)));
+        assert(c.reduce(4) == 0);
+        assert(c.avoidances.size() == 1);
+    }
+
+    // Test 2: The least active long avoidances go first, down to the target
+    {
+        lineage_pool lp;
+        cdcl c;
+        for (size_t i = 0; i < 6; ++i)
+            c.learn(lemma(three(lp, i)));
+        c.activity[0] = 4.0;
+        c.activity[2] = 1.0;
+
+        // the newest target / 2 = 1 avoidance (id 5) is protected
+        assert(c.reduce(2) == 4);
+        assert(c.avoidances.size() == 2);
+        assert(c.avoidances.count(0) == 1);
+        assert(c.avoidances.count(5) == 1);
+        assert(c.watches.count(1) == 0);
+        // survivors' activity decays
+        assert(c.activity.at(0) == 2.0);
+        assert(c.activity.count(2) == 0);
+    }
+
+    // Test 3: Short avoidances are never deleted, even past the target
+    {
+        lineage_pool lp;
+        cdcl c;
+        const resolution_lineage* rl = lp.resolution(lp.goal(nullptr, 0), 0);
+        decision_store single;
+        single.insert(rl);
+        decision_store pair;
+        pair.insert(lp.resolution(lp.goal(nullptr, 10), 0));
+        pair.insert(lp.resolution(lp.goal(nullptr, 11), 0));
+        c.learn(lemma(single));
+        c.learn(lemma(pair));
+        c.learn(lemma(three(lp, 1)));
+        c.learn(lemma(three(lp, 2)));
+
+        assert(c.reduce(0) == 2);
+        assert(c.avoidances.size() == 2);
+        assert(c.eliminated(rl));
+        assert(c.avoidances.count(1) == 1);
+    }
+
+    // Test 4: Among equally active avoidances, the longer goes first
+    {
+        lineage_pool lp;
+        cdcl c;
+        decision_store four = three(lp, 0);
+        four.insert(lp.resolution(lp.goal(nullptr, 3), 0));
+        c.learn(lemma(three(lp, 4)));
+        c.learn(lemma(four));
+        c.learn(lemma(three(lp, 8)));
+
+        assert(c.reduce(2) == 1);
+        assert(c.avoidances.count(1) == 0);
+    }
+
+    // Test 5: Pinned avoidances are never deleted, however inactive
+    {
+        lineage_pool lp;
+        cdcl c;
+        c.learn(lemma(three(lp, 0)), true);
+        c.learn(lemma(three(lp, 4)));
+        c.learn(lemma(three(lp, 8)), true);
+        c.activity[1] = 1.0;
+
+        assert(c.reduce(0) == 1);
+        assert(c.avoidances.size() == 2);
+        assert(c.avoidances.count(0) == 1);
+        assert(c.avoidances.count(2) == 1);
+    }
+}
+
+void test_cdcl_get_kept() {
+    lineage_pool lp;
+    cdcl c;
+    assert(c.get_kept() == 0);
+    decision_store ds1;
+    ds1.insert(lp.resolution(lp.goal(nullptr, 0), 0));
+    decision_store ds2;
+    ds2.insert(lp.resolution(lp.goal(nullptr, 1), 0));
+    c.learn(lemma(ds1));
+    c.learn(lemma(ds2));
+    assert(c.get_kept() == 2);
+    c.erase(0);
+    assert(c.get_kept() == 1);
+}
+
+void test_cdcl_get_deleted() {
+    lineage_pool lp;
+    cdcl c;
+    assert(c.get_deleted() == 0);
+    for (size_t i = 0; i < 4; ++i) {
+        decision_store ds;
+        for (size_t j = i; j < i + 3; ++j)
+            ds.insert(lp.resolution(lp.goal(nullptr, j), 0));
+        c.learn(lemma(ds));
+    }
+    c.reduce(2);
+    assert(c.get_deleted() == 2);
+    c.reduce(0);
+    assert(c.get_deleted() == 4);
+    // erasures that are not reductions are not counted
+    decision_store ds;
+    c.learn(lemma(ds));
+    c.erase(4);
+    assert(c.get_deleted() == 4);
+}
+
+void test_cdcl_get_subsumed() {
+    lineage_pool lp;
+    cdcl c;
+    const resolution_lineage* rl1 = lp.resolution(lp.goal(nullptr, 0), 0);
+    const resolution_lineage* rl2 = lp.resolution(lp.goal(nullptr, 1), 0);
+    assert(c.get_subsumed() == 0);
+    c.learn(lemma(avoidance{rl1, rl2}));
+    // dropped on arrival
+    c.learn(lemma(avoidance{rl1, rl2}));
+    assert(c.get_subsumed() == 1);
+    // dropped later
+    c.learn(lemma(avoidance{rl1}));
+    assert(c.get_subsumed() == 2);
+    assert(c.get_kept() + c.get_deleted() + c.get_subsumed() == c.next_avoidance_id);
+}
+
+void test_lemma_store_constructor() {
+    lemma_store ls("lemmas.bin");
+    assert(ls.path == "lemmas.bin");
+}
+
+void test_lemma_store_fingerprint() {
+    trail t;
+    t.push();
+    expr_pool ep(t);
+    const expr* a = ep.functor("a");
+    database db;
+    db.push_back(rule{ep.functor("p", {ep.var(0)}), {ep.functor("q", {ep.var(0)})}});
+    db.push_back(rule{ep.functor("q", {a}), {}});
+    goals gl{ep.functor("p", {ep.var(5)}), ep.functor("q", {ep.integer(3)})};
+    uint64_t h = lemma_store::fingerprint(db, gl);
+
+    // Stable, and blind to how vars happen to be numbered
+    assert(lemma_store::fingerprint(db, gl) == h);
+    database renamed;
+    renamed.push_back(rule{ep.functor("p", {ep.var(7)}), {ep.functor("q", {ep.var(7)})}});
+    renamed.push_back(rule{ep.functor("q", {a}), {}});
+    goals regl{ep.functor("p", {ep.var(9)}), ep.functor("q", {ep.integer(3)})};
+    assert(lemma_store::fingerprint(renamed, regl) == h);
+
+    // Rule order, var sharing and goals all count
+    database reordered{db[1], db[0]};
+    assert(lemma_store::fingerprint(reordered, gl) != h);
+    database unshared;
+    unshared.push_back(rule{ep.functor("p", {ep.var(0)}), {ep.functor("q", {ep.var(1)})}});
+    unshared.push_back(rule{ep.functor("q", {a}), {}});
+    assert(lemma_store::fingerprint(unshared, gl) != h);
+    goals other{ep.functor("p", {ep.var(5)}), ep.functor("q", {ep.integer(4)})};
+    assert(lemma_store::fingerprint(db, other) != h);
+    t.pop();
+}
+
+void test_lemma_store_load() {
+    std::string path = (std::filesystem::temp_directory_path() / "atlas_test_lemma_store_load").string();
+    std::filesystem::remove(path);
+
+    // Test 1: No path, or no file yet - nothing is loaded
+    {
+        lineage_pool lp;
+        cdcl c;
+        assert(lemma_store("").load(1, c, lp) == 0);
+        assert(lemma_store(path).load(1, c, lp) == 0);
+        assert(c.get_kept() == 0);
+    }
+
+    // Test 2: Avoidances come back over equal lineages, pinned against trims
+    {
+        lineage_pool before;
+        const resolution_lineage* r0 = before.resolution(before.goal(nullptr, 0), 1);
+        const resolution_lineage* r1 = before.resolution(before.goal(r0, 2), 3);
+        const resolution_lineage* r2 = before.resolution(before.goal(nullptr, 4), 0);
+        cdcl saved;
+        saved.learn(lemma(avoidance{r1, r2}));
+        saved.learn(lemma(avoidance{r0}));
+        lemma_store(path).save(7, saved);
+
+        lineage_pool lp;
+        cdcl c;
+        assert(lemma_store(path).load(7, c, lp) == 2);
+        lp.trim();
+        const resolution_lineage* l0 = lp.resolution(lp.goal(nullptr, 0), 1);
+        const resolution_lineage* l1 = lp.resolution(lp.goal(l0, 2), 3);
+        const resolution_lineage* l2 = lp.resolution(lp.goal(nullptr, 4), 0);
+        assert(lp.resolution_lineages.at(*l1));
+        assert(c.get_kept() == 2);
+        assert(c.get_avoidances().at(0) == avoidance({l1, l2}));
+        assert(c.get_avoidances().at(1) == avoidance({l0}));
+        assert(c.eliminated(l0));
+        assert(!c.refuted());
+    }
+
+    // Test 3: A file for another key is ignored
+    {
+        lineage_pool lp;
+        cdcl c;
+        assert(lemma_store(path).load(8, c, lp) == 0);
+        assert(c.get_kept() == 0);
+        assert(lp.resolution_lineages.empty());
+    }
+
+    // Test 4: Truncated, foreign, old and malformed files, and files naming
+    // a lineage they never wrote, are ignored, leaving the pool and store empty
+    {
+        std::string contents;
+        {
+            std::ifstream in(path, std::ios::binary);
+            contents.assign(std::istreambuf_iterator<char>(in), {});
+        }
+        // one lineage, then one avoidance of lineage 5
+        std::ostringstream bad_lineage;
+        bad_lineage.write(lemma_store::magic, sizeof(lemma_store::magic));
+        for (uint64_t v : {1, 7, 1, 0, 0, 0, 1, 1, 5})
+            lemma_store::put(bad_lineage, v);
+        std::vector<std::string> files{
+            contents.substr(0, contents.size() - 1),                  // truncated
+            "n(1).",                                                  // foreign
+            std::string("ATLL\x02\x07", 6),                           // another version
+            std::string("ATLL\x01\x07\x01\x00\x00\x80", 10),          // ends mid-value
+            std::string("ATLL\x01\x07\x01\x01\x00\x00", 10),          // its own parent
+            std::string("ATLL\x01\x07", 6) + std::string(10, '\xff'), // past 64 bits
+            bad_lineage.str(),                                        // an unknown lineage
+        };
+        for (const std::string& file : files) {
+            {
+                std::ofstream out(path, std::ios::binary | std::ios::trunc);
+                out << file;
+            }
+            lineage_pool lp;
+            cdcl c;
+            assert(lemma_store(path).load(7, c, lp) == 0);
+            assert(c.get_kept() == 0);
+            assert(lp.resolution_lineages.empty());
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+void test_lemma_store_save() {
+    std::string path = (std::filesystem::temp_directory_path() / "atlas_test_lemma_store_save").string();
+    std::filesystem::remove(path);
+
+    // Test 1: No path - nothing is written
+    {
+        cdcl c;
+        c.learn(lemma(avoidance{}));
+        lemma_store("").save(1, c);
+    }
+
+    // Test 2: A shared prefix is written once, and a refutation carries over
+    {
+        lineage_pool lp;
+        const resolution_lineage* r0 = lp.resolution(lp.goal(nullptr, 0), 0);
+        const resolution_lineage* r1 = lp.resolution(lp.goal(r0, 0), 1);
+        const resolution_lineage* r2 = lp.resolution(lp.goal(r0, 1), 1);
+        cdcl c;
+        c.learn(lemma(avoidance{r1, r2}));
+        lemma_store(path).save(3, c);
+        assert(!std::filesystem::exists(path + ".tmp"));
+        // magic, version, key, 3 lineages of 3 bytes, 1 avoidance of 1 + 2 bytes
+        assert(std::filesystem::file_size(path) == 4 + 1 + 1 + 1 + 9 + 1 + 3);
+
+        c.learn(lemma(avoidance{}));
+        lemma_store(path).save(3, c);
+        lineage_pool loaded_lp;
+        cdcl loaded;
+        assert(lemma_store(path).load(3, loaded, loaded_lp) == 1);
+        assert(loaded.refuted());
+    }
+
+    // Test 3: Only conflict lemmas are written, not the pinned ones that block
+    // this run's solutions and budgets
+    {
+        lineage_pool lp;
+        const resolution_lineage* r0 = lp.resolution(lp.goal(nullptr, 0), 0);
+        const resolution_lineage* r1 = lp.resolution(lp.goal(nullptr, 1), 0);
+        cdcl c;
+        c.learn(lemma(avoidance{r0}), true);
+        c.learn(lemma(avoidance{r1}));
+        lemma_store(path).save(3, c);
+        lineage_pool loaded_lp;
+        cdcl loaded;
+        assert(lemma_store(path).load(3, loaded, loaded_lp) == 1);
+        assert(loaded.get_avoidances().at(0) == avoidance({loaded_lp.resolution(loaded_lp.goal(nullptr, 1), 0)}));
+    }
+    std::filesystem::remove(path);
+}
+
+void test_lemma_store_put_get() {
+    std::stringstream ss;
+    std::vector<uint64_t> values{0, 1, 127, 128, 300, 1ull << 35, UINT64_MAX};
+    for (uint64_t v : values)
+        lemma_store::put(ss, v);
+    // seven bits a byte
+    assert(ss.str().size() == 1 + 1 + 1 + 2 + 2 + 6 + 10);
+    uint64_t got;
+    for (uint64_t v : values) {
+        assert(lemma_store::get(ss, got));
+        assert(got == v);
+    }
+
+    // Reading past the end, or past 64 bits, fails
+    assert(!lemma_store::get(ss, got));
+    std::stringstream wide(std::string(10, '\xff'));
+    assert(!lemma_store::get(wide, got));
+}
+
+void test_lemma_store_number() {
+    lineage_pool lp;
+    const resolution_lineage* r0 = lp.resolution(lp.goal(nullptr, 2), 5);
+    const resolution_lineage* r1 = lp.resolution(lp.goal(r0, 1), 0);
+    std::map<const resolution_lineage*, size_t> numbers;
+    std::stringstream ss;
+
+    // Ancestors are numbered and written first
+    assert(lemma_store::number(r1, numbers, ss) == 1);
+    assert(numbers.at(r0) == 0);
+    assert(lemma_store::number(r0, numbers, ss) == 0);
+    std::vector<uint64_t> words;
+    uint64_t word;
+    while (lemma_store::get(ss, word))
+        words.push_back(word);
+    assert(words == std::vector<uint64_t>({0, 2, 5, 1, 1, 0}));
+}
+
 // ---------------------------------------------------------------------------
 // sim_mock: minimal concrete sim subclass used to test the sim base class.
 // Overrides decide_one() with a scripted, deterministic sequence.
@@ -17496,6 +20700,9 @@ void test_sim_constructor() {
         assert(&s.cp.sequencer_ref == &seq);
         assert(&s.cp.expr_pool_ref == &ep);
         assert(&s.c  != &c);  // cdcl is copied by value
+        assert(s.cache == nullptr);
+        assert(s.cached_prefiltered == 0);
+        assert(s.get_prefiltered() == 0);
         assert(s.gs.empty());
         assert(s.cs.empty());
         assert(s.decision_idx   == 0);
@@ -17595,29 +20802,143 @@ void test_sim_get_decisions() {
     {
         trail t; t.push();
         expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
-        database db; goals gs; cdcl c;
+        database db; goals gs; cdcl c;
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+
+        const decisions& d = s.get_decisions();
+        assert(d.size() == 0);
+        assert(&d == &s.ds);
+    }
+
+    // Reference is live: direct mutation to ds is visible through get_decisions()
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
+        database db; goals gs; cdcl c;
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+
+        const decisions& d = s.get_decisions();
+        const goal_lineage* gl = lp.goal(nullptr, 0);
+        const resolution_lineage* rl = lp.resolution(gl, 0);
+        s.ds.insert(rl);
+
+        assert(d.size() == 1);
+        assert(d.count(rl) == 1);
+    }
+}
+
+void test_sim_get_cdcl() {
+    // Returns const ref to the sim's own copy of the cdcl
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
+        database db; goals gs; cdcl c;
+        c.learn(lemma(decision_store{lp.resolution(lp.goal(nullptr, 0), 0)}));
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+
+        const cdcl& sc = s.get_cdcl();
+        assert(&sc == &s.c);
+        assert(&sc != &c);
+        assert(sc.get_kept() == 1);
+    }
+
+    // Reference is live: eliminations the sim's copy makes are visible
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
+        database db; goals gs; cdcl c;
+        const resolution_lineage* rl1 = lp.resolution(lp.goal(nullptr, 0), 0);
+        const resolution_lineage* rl2 = lp.resolution(lp.goal(nullptr, 1), 0);
+        c.learn(lemma(decision_store{rl1, rl2}));
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+
+        const cdcl& sc = s.get_cdcl();
+        s.c.constrain(rl1);
+        assert(sc.eliminated(rl2));
+        assert(!c.eliminated(rl2));
+    }
+}
+
+void test_sim_get_prefiltered() {
+    // Zero before any head is checked
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
+        database db; goals gs; cdcl c;
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+
+        assert(s.get_prefiltered() == 0);
+    }
+
+    // Reports the goal_store's count of heads rejected without unifying
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
+        const expr* b = ep.functor("b");
+        database db;
+        db.push_back(rule{ep.functor("p", {ep.functor("a")}), {}});
+        db.push_back(rule{ep.functor("p", {b}), {}});
+        db.push_back(rule{ep.functor("q", {b}), {}});
+        const expr* X = ep.var(seq());
+        goals gs{ep.functor("q", {X}), ep.functor("p", {X})};
+        cdcl c;
         sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
 
-        const decisions& d = s.get_decisions();
-        assert(d.size() == 0);
-        assert(&d == &s.ds);
+        // q(X) is unit and binds X to b, so p(a) is rejected by the prefilter
+        assert(s());
+        assert(s.decision_idx == 0);
+        assert(s.get_prefiltered() == 1);
+        assert(s.get_prefiltered() == s.gs.get_prefiltered());
     }
+}
 
-    // Reference is live: direct mutation to ds is visible through get_decisions()
+void test_sim_failed() {
+    trail t; t.push();
+    expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
+    const expr* a = ep.functor("a");
+    const expr* b = ep.functor("b");
+    database db;
+    db.push_back(rule{ep.functor("p", {a}), {}});                  // 0: p(a).
+    db.push_back(rule{ep.functor("p", {b}), {}});                  // 1: p(b).
+    db.push_back(rule{ep.functor("q", {b}), {}});                  // 2: q(b).
+    db.push_back(rule{ep.functor("q", {ep.functor("c")}), {}});    // 3: q(c).
+    uint32_t x = seq();
+    goals gs{ep.functor("p", {ep.var(x)}), ep.functor("q", {ep.var(x)})};
+    const resolution_lineage* pa = lp.resolution(lp.goal(nullptr, 0), 0);
+    const resolution_lineage* pb = lp.resolution(lp.goal(nullptr, 0), 1);
+
+    // Stopped at a conflict
     {
-        trail t; t.push();
-        expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
-        database db; goals gs; cdcl c;
+        t.push();
+        cdcl c;
         sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+        s.scripted = {pa};
+        assert(!s());
+        assert(s.failed());
+        t.pop();
+    }
 
-        const decisions& d = s.get_decisions();
-        const goal_lineage* gl = lp.goal(nullptr, 0);
-        const resolution_lineage* rl = lp.resolution(gl, 0);
-        s.ds.insert(rl);
+    // Solved
+    {
+        t.push();
+        cdcl c;
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+        s.scripted = {pb};
+        assert(s());
+        assert(!s.failed());
+        t.pop();
+    }
 
-        assert(d.size() == 1);
-        assert(d.count(rl) == 1);
+    // Out of budget
+    {
+        t.push();
+        cdcl c;
+        sim_mock s(0, db, gs, t, seq, ep, bm, lp, c);
+        assert(!s());
+        assert(!s.failed());
+        t.pop();
     }
+    t.pop();
 }
 
 void test_sim_solved() {
@@ -17905,7 +21226,7 @@ void test_sim_derive_one() {
         assert(sim.derive_one() == nullptr);
     }
 
-    // Test 4: Two rules but only one matches the goal → after conflicted() reduces to 1 → unit
+    // Test 4: Two rules but only one matches the goal's predicate → seeded with 1 → unit
     {
         trail t;
         t.push();
@@ -17924,19 +21245,45 @@ void test_sim_derive_one() {
         monte_carlo::simulation<mcts_decider::choice, std::mt19937> mc(root, 1.414, rng);
         ridge_sim sim(sim_args{100, db, goals, t, seq, ep, bm, lp, c}, mcts_sim_args{mc});
 
-        // Initially, derive_one() returns nullptr
-        assert(sim.derive_one() == nullptr);
-
-        // Initially 2 candidates; conflicted() eliminates rule 1 (q head ≠ p goal)
-        assert(sim.conflicted() == false);
+        // Only rule 0 is seeded: the predicate index leaves out rule 1 (q head ≠ p goal)
         const goal_lineage* gl0 = lp.goal(nullptr, 0);
         assert(sim.cs.at(gl0).size() == 1);
+        assert(sim.conflicted() == false);
 
         const resolution_lineage* expected = lp.resolution(gl0, 0);
         const resolution_lineage* result = sim.derive_one();
         assert(result != nullptr);
         assert(result == expected);
     }
+
+    // Test 5: a ready builtin goal is derived ahead of unit propagation
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        sequencer seq(t);
+        lineage_pool lp;
+        database db;
+        db.push_back(rule{ep.functor("p", {}), {}});
+        const expr* X = ep.var(seq());
+        goals goals;
+        goals.push_back(ep.functor("int_add", {ep.integer(1), X, ep.integer(3)}));
+        goals.push_back(ep.functor("int_lt", {X, ep.var(seq())}));
+        cdcl c;
+        monte_carlo::tree_node<mcts_decider::choice> root;
+        std::mt19937 rng(42);
+        monte_carlo::simulation<mcts_decider::choice, std::mt19937> mc(root, 1.414, rng);
+        ridge_sim sim(sim_args{100, db, goals, t, seq, ep, bm, lp, c}, mcts_sim_args{mc});
+
+        const resolution_lineage* expected = lp.resolution(lp.goal(nullptr, 0), builtins::candidate);
+        assert(sim.derive_one() == expected);
+        sim.resolve(expected);
+        assert(bm.whnf(X) == ep.integer(2));
+
+        // the remaining comparison waits on its second argument
+        assert(sim.derive_one() == nullptr);
+    }
 }
 
 void test_sim_resolve() {
@@ -18009,7 +21356,7 @@ void test_sim_resolve() {
         // cs tracks the same sub-goal
         assert(sim.cs.size() == 1);
         // Old goal no longer in cs
-        assert(sim.cs.at(sub_gl).size() == 1); // db has 1 rule
+        assert(sim.cs.at(sub_gl).empty()); // db has no rule for q
     }
 
     // Test 3: c.constrain effect - avoidance reduced from 2 to 1 → remaining rl eliminated
@@ -18051,42 +21398,465 @@ void test_sim_resolve() {
         assert(sim.c.eliminated(rl1));
     }
 
-    // Test 4: resolve with two-level chain - verify gs, cs, and rs sizes at each step
+    // Test 4: resolve with two-level chain - verify gs, cs, and rs sizes at each step
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        sequencer seq(t);
+        lineage_pool lp;
+        database db;
+        db.push_back(rule{ep.functor("p", {}), {ep.functor("q", {}), ep.functor("r", {})}}); // p :- q, r.
+        goals goals;
+        goals.push_back(ep.functor("p", {}));
+        cdcl c;
+        monte_carlo::tree_node<mcts_decider::choice> root;
+        std::mt19937 rng(42);
+        monte_carlo::simulation<mcts_decider::choice, std::mt19937> mc(root, 1.414, rng);
+        ridge_sim sim(sim_args{100, db, goals, t, seq, ep, bm, lp, c}, mcts_sim_args{mc});
+
+        assert(sim.gs.size() == 1);
+        assert(sim.rs.size() == 0);
+
+        const goal_lineage* gl0 = lp.goal(nullptr, 0);
+        const resolution_lineage* rl = lp.resolution(gl0, 0);
+        sim.resolve(rl);
+
+        assert(sim.rs.size() == 1);
+        assert(sim.rs.count(rl) == 1);
+        // p removed; q and r added (body has 2 sub-goals)
+        assert(sim.gs.size() == 2);
+        assert(sim.cs.size() == 2);
+
+        const goal_lineage* sub_gl0 = lp.goal(rl, 0);
+        const goal_lineage* sub_gl1 = lp.goal(rl, 1);
+        assert(sim.gs.at(sub_gl0) == ep.functor("q", {}));
+        assert(sim.gs.at(sub_gl1) == ep.functor("r", {}));
+    }
+
+    // Subgoals are narrowed by the args their parent's head bound
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        sequencer seq(t);
+        lineage_pool lp;
+        const expr* X = ep.var(seq());
+        const expr* Y = ep.var(seq());
+        database db;
+        db.push_back(rule{ep.functor("path", {X}), {ep.functor("edge", {X, Y})}}); // path(X) :- edge(X, Y).
+        for (int64_t i = 0; i < 10; ++i)
+            db.push_back(rule{ep.functor("edge", {ep.integer(i), ep.integer(i + 1)}), {}});
+        goals goals;
+        goals.push_back(ep.functor("path", {ep.integer(4)}));
+        cdcl c;
+        monte_carlo::tree_node<mcts_decider::choice> root;
+        std::mt19937 rng(42);
+        monte_carlo::simulation<mcts_decider::choice, std::mt19937> mc(root, 1.414, rng);
+        ridge_sim sim(sim_args{100, db, goals, t, seq, ep, bm, lp, c}, mcts_sim_args{mc});
+
+        const resolution_lineage* rl = lp.resolution(lp.goal(nullptr, 0), 0);
+        sim.resolve(rl);
+        assert(sim.cs.at(lp.goal(rl, 0)) == std::vector<size_t>({5}));
+    }
+}
+
+void test_sim_watch() {
+    // Only new goals and goals whose vars a resolution binds are checked again
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        sequencer seq(t);
+        lineage_pool lp;
+        const expr* X = ep.var(seq());
+        const expr* Y = ep.var(seq());
+        const expr* a = ep.functor("a");
+        const expr* b = ep.functor("b");
+        database db;
+        db.push_back(rule{ep.functor("p", {a}), {}});  // 0: p(a).
+        db.push_back(rule{ep.functor("q", {a}), {}});  // 1: q(a).
+        db.push_back(rule{ep.functor("q", {b}), {}});  // 2: q(b).
+        db.push_back(rule{ep.functor("r", {Y}), {}});  // 3: r(Y).
+        db.push_back(rule{ep.functor("r", {b}), {}});  // 4: r(b).
+        goals goals;
+        goals.push_back(ep.functor("p", {X}));
+        goals.push_back(ep.functor("q", {X}));
+        goals.push_back(ep.functor("r", {ep.var(seq())}));
+        cdcl c;
+        monte_carlo::tree_node<mcts_decider::choice> root;
+        std::mt19937 rng(42);
+        monte_carlo::simulation<mcts_decider::choice, std::mt19937> mc(root, 1.414, rng);
+        ridge_sim sim(sim_args{100, db, goals, t, seq, ep, bm, lp, c}, mcts_sim_args{mc});
+        const goal_lineage* gp = lp.goal(nullptr, 0);
+        const goal_lineage* gq = lp.goal(nullptr, 1);
+        const goal_lineage* gr = lp.goal(nullptr, 2);
+
+        // every goal starts dirty; a check registers it under its unbound vars
+        assert(sim.dirty.size() == 3);
+        assert(!sim.conflicted());
+        assert(sim.dirty.empty());
+        assert(sim.watchers.at(0) == std::unordered_set<const goal_lineage*>({gp, gq}));
+        assert(sim.watchers.at(2) == std::unordered_set<const goal_lineage*>({gr}));
+        assert(sim.cs.at(gq).size() == 2);
+
+        // resolving p(X) with p(a) binds X, which dirties q(X) but not r(_)
+        sim.resolve(lp.resolution(gp, 0));
+        assert(sim.newly_bound == std::vector<uint32_t>({0}));
+        // p(X) watched X too, but it has left the stores and will be skipped
+        assert(sim.dirty == std::unordered_set<const goal_lineage*>({gp, gq}));
+        assert(!sim.cs.contains(gp));
+        assert(!sim.watchers.contains(0));
+        size_t prefiltered = sim.gs.get_prefiltered();
+        assert(!sim.conflicted());
+        // only q(X) was checked again: its q(b) candidate is now gone
+        assert(sim.cs.at(gq) == std::vector<size_t>({1}));
+        assert(sim.gs.get_prefiltered() == prefiltered + 1);
+        assert(sim.cs.at(gr).size() == 2);
+    }
+
+    // Subgoals are checked, and watch the vars their bindings lead to
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        sequencer seq(t);
+        lineage_pool lp;
+        const expr* X = ep.var(seq());
+        const expr* G = ep.var(seq());
+        database db;
+        db.push_back(rule{ep.functor("p", {X}), {ep.functor("q", {X})}});  // 0: p(X) :- q(X).
+        db.push_back(rule{ep.functor("q", {ep.functor("a")}), {}});        // 1: q(a).
+        db.push_back(rule{ep.functor("q", {ep.functor("b")}), {}});        // 2: q(b).
+        goals goals;
+        goals.push_back(ep.functor("p", {G}));
+        cdcl c;
+        monte_carlo::tree_node<mcts_decider::choice> root;
+        std::mt19937 rng(42);
+        monte_carlo::simulation<mcts_decider::choice, std::mt19937> mc(root, 1.414, rng);
+        ridge_sim sim(sim_args{100, db, goals, t, seq, ep, bm, lp, c}, mcts_sim_args{mc});
+
+        assert(!sim.conflicted());
+        const resolution_lineage* rl = lp.resolution(lp.goal(nullptr, 0), 0);
+        sim.resolve(rl);
+        const goal_lineage* child = lp.goal(rl, 0);
+        assert(sim.dirty.contains(child));
+        assert(!sim.conflicted());
+        // the child is q(X') with X' bound to G, so it watches G
+        assert(sim.watchers.at(1).contains(child));
+        assert(sim.cs.at(child).size() == 2);
+    }
+}
+
+void test_sim_mark() {
+    trail t;
+    t.push();
+    expr_pool ep(t);
+    bind_map bm(t);
+    sequencer seq(t);
+    lineage_pool lp;
+    database db;
+    db.push_back(rule{ep.functor("p", {}), {}});
+    const expr* X = ep.var(seq());
+    const expr* Y = ep.var(seq());
+    goals goals;
+    goals.push_back(ep.functor("int_add", {ep.integer(1), ep.integer(2), X}));  // ready
+    goals.push_back(ep.functor("int_lt", {X, Y}));                            // waits on X and Y
+    goals.push_back(ep.functor("p", {}));
+    cdcl c;
+    sim_mock s(10, db, goals, t, seq, ep, bm, lp, c);
+    const goal_lineage* g0 = lp.goal(nullptr, 0);
+    const goal_lineage* g1 = lp.goal(nullptr, 1);
+    const goal_lineage* g2 = lp.goal(nullptr, 2);
+
+    // Construction marks every goal, queueing only the ready builtin
+    assert(s.dirty.size() == 3);
+    assert(s.ready == std::deque<const goal_lineage*>({g0}));
+
+    // Marking once the inputs are bound queues the builtin; other goals
+    // are only made dirty
+    s.dirty.clear();
+    bm.bind(std::get<expr::var>(X->content).index, ep.integer(3));
+    bm.bind(std::get<expr::var>(Y->content).index, ep.integer(4));
+    s.mark(g1);
+    s.mark(g2);
+    assert(s.dirty.size() == 2);
+    assert(s.ready == std::deque<const goal_lineage*>({g0, g1}));
+
+    // Resolved goals are only made dirty, and derivation skips them
+    s.resolve(lp.resolution(g0, builtins::candidate));
+    s.mark(g0);
+    assert(s.ready.size() == 2);
+    assert(s.derive_one() == lp.resolution(g1, builtins::candidate));
+    assert(s.ready.empty());
+    t.pop();
+}
+
+void test_sim_eliminate_cached() {
+    // Sims sharing a cache reuse each other's head checks, across renamings
+    trail t;
+    t.push();
+    expr_pool ep(t);
+    bind_map bm(t);
+    sequencer seq(t);
+    lineage_pool lp;
+    const expr* a = ep.functor("a");
+    const expr* fa = ep.functor("f", {a});
+    database db;
+    db.push_back(rule{ep.functor("p", {fa}), {}});                                  // 0: p(f(a)).
+    db.push_back(rule{ep.functor("p", {ep.functor("f", {ep.functor("b")})}), {}}); // 1: p(f(b)).
+    db.push_back(rule{ep.functor("q", {a}), {}});                                   // 2: q(a).
+    applicability_cache ac(16);
+    cdcl c;
+    monte_carlo::tree_node<mcts_decider::choice> root;
+    std::mt19937 rng(42);
+
+    {
+        t.push();
+        goals goals{ep.functor("p", {fa}), ep.functor("q", {ep.var(seq())})};
+        monte_carlo::simulation<mcts_decider::choice, std::mt19937> mc(root, 1.414, rng);
+        ridge_sim sim(sim_args{100, db, goals, t, seq, ep, bm, lp, c, &ac}, mcts_sim_args{mc});
+        assert(sim.cache == &ac);
+        assert(!sim.conflicted());
+        // one entry per goal and candidate checked; p(f(b)) missed the prefilter
+        assert(ac.size() == 3);
+        assert(sim.gs.get_prefiltered() == 1);
+        assert(sim.cs.at(lp.goal(nullptr, 0)) == std::vector<size_t>({0}));
+        t.pop();
+    }
+
+    {
+        t.push();
+        goals goals{ep.functor("p", {fa}), ep.functor("q", {ep.var(seq())})};
+        monte_carlo::simulation<mcts_decider::choice, std::mt19937> mc(root, 1.414, rng);
+        ridge_sim sim(sim_args{100, db, goals, t, seq, ep, bm, lp, c, &ac}, mcts_sim_args{mc});
+        // the renamed q goal hits too, so no head is checked again; the
+        // p(f(b)) rejection still counts, since the prefilter made it
+        assert(!sim.conflicted());
+        assert(ac.size() == 3);
+        assert(sim.gs.get_prefiltered() == 0);
+        assert(sim.cached_prefiltered == 1);
+        assert(sim.get_prefiltered() == 1);
+        assert(sim.cs.at(lp.goal(nullptr, 0)) == std::vector<size_t>({0}));
+        assert(sim.cs.at(lp.goal(nullptr, 1)) == std::vector<size_t>({2}));
+        t.pop();
+    }
+    t.pop();
+}
+
+void test_sim_explain() {
+    // A goal rests on its parent resolution and on the binders of its vars
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
+        const expr* a = ep.functor("a");
+        database db;
+        db.push_back(rule{ep.functor("p", {a}), {}});                  // 0: p(a).
+        db.push_back(rule{ep.functor("q", {ep.functor("b")}), {}});    // 1: q(b).
+        uint32_t x = seq();
+        goals gs{ep.functor("p", {ep.var(x)}), ep.functor("q", {ep.var(x)})};
+        cdcl c;
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+        const goal_lineage* gq = lp.goal(nullptr, 1);
+        const resolution_lineage* rp = lp.resolution(lp.goal(nullptr, 0), 0);
+        s.resolve(rp);
+        assert(s.binders.at(x).first == rp);
+
+        std::vector<const resolution_lineage*> pending;
+        s.explain(gq, false, pending);
+        assert(pending == std::vector<const resolution_lineage*>({nullptr, rp}));
+        assert(s.explained_vars == std::unordered_set<uint32_t>({x}));
+
+        // a var already explained is not followed again
+        pending.clear();
+        s.explain(gq, false, pending);
+        assert(pending == std::vector<const resolution_lineage*>({nullptr}));
+        t.pop();
+    }
+
+    // A forced goal also rests on what eliminated its candidates
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
+        const expr* a = ep.functor("a");
+        const expr* b = ep.functor("b");
+        database db;
+        db.push_back(rule{ep.functor("p", {a}), {}});                  // 0: p(a).
+        db.push_back(rule{ep.functor("q", {a}), {}});                  // 1: q(a).
+        db.push_back(rule{ep.functor("q", {b}), {}});                  // 2: q(b).
+        goals gs{ep.functor("p", {a}), ep.functor("q", {ep.var(seq())})};
+        const goal_lineage* gq = lp.goal(nullptr, 1);
+        const resolution_lineage* rp = lp.resolution(lp.goal(nullptr, 0), 0);
+        const resolution_lineage* rq = lp.resolution(gq, 1);
+        cdcl c;
+        c.learn(lemma(decisions{rp, rq}));
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+        s.resolve(rp);
+        assert(s.c.eliminated(rq));
+
+        std::vector<const resolution_lineage*> pending;
+        s.explain(gq, false, pending);
+        assert(pending == std::vector<const resolution_lineage*>({nullptr}));
+
+        pending.clear();
+        s.explain(gq, true, pending);
+        assert(pending == std::vector<const resolution_lineage*>({nullptr, rp}));
+        t.pop();
+    }
+}
+
+void test_sim_analyze() {
+    // Only the decisions the conflicting goal depends on are blamed
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
+        const expr* a = ep.functor("a");
+        const expr* b = ep.functor("b");
+        database db;
+        db.push_back(rule{ep.functor("p", {a}), {}});                  // 0: p(a).
+        db.push_back(rule{ep.functor("p", {b}), {}});                  // 1: p(b).
+        db.push_back(rule{ep.functor("q", {a}), {}});                  // 2: q(a).
+        db.push_back(rule{ep.functor("q", {b}), {}});                  // 3: q(b).
+        db.push_back(rule{ep.functor("s", {a}), {}});                  // 4: s(a).
+        db.push_back(rule{ep.functor("s", {ep.functor("c")}), {}});    // 5: s(c).
+        uint32_t x = seq(), y = seq();
+        goals gs{ep.functor("p", {ep.var(x)}), ep.functor("q", {ep.var(y)}), ep.functor("s", {ep.var(y)})};
+        cdcl c;
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+        const resolution_lineage* rp = lp.resolution(lp.goal(nullptr, 0), 0);
+        const resolution_lineage* rq = lp.resolution(lp.goal(nullptr, 1), 3);
+        s.scripted = {rp, rq};
+
+        assert(!s());
+        assert(s.conflicted());
+        assert(s.binders.at(y).first == rq);
+        assert(s.binders.at(y).second == b);
+        assert(s.resolved_terms.at(lp.goal(nullptr, 1)) == gs.at(1));
+        assert(s.get_decisions() == decisions({rp, rq}));
+        assert(s.analyze() == decisions({rq}));
+        t.pop();
+    }
+
+    // Forced resolutions are explained through the decisions that forced them
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
+        const expr* a = ep.functor("a");
+        const expr* b = ep.functor("b");
+        database db;
+        db.push_back(rule{ep.functor("p", {a}), {}});                  // 0: p(a).
+        db.push_back(rule{ep.functor("p", {b}), {}});                  // 1: p(b).
+        db.push_back(rule{ep.functor("q", {a}), {}});                  // 2: q(a).
+        db.push_back(rule{ep.functor("q", {b}), {}});                  // 3: q(b).
+        db.push_back(rule{ep.functor("s", {a}), {}});                  // 4: s(a).
+        db.push_back(rule{ep.functor("s", {ep.functor("c")}), {}});    // 5: s(c).
+        db.push_back(rule{ep.functor("r", {a}), {}});                  // 6: r(a).
+        db.push_back(rule{ep.functor("r", {b}), {}});                  // 7: r(b).
+        uint32_t x = seq(), y = seq(), z = seq();
+        goals gs{ep.functor("p", {ep.var(x)}), ep.functor("q", {ep.var(y)}),
+                 ep.functor("s", {ep.var(y)}), ep.functor("r", {ep.var(z)})};
+        const resolution_lineage* rp = lp.resolution(lp.goal(nullptr, 0), 0);
+        const resolution_lineage* rq = lp.resolution(lp.goal(nullptr, 1), 2);
+        const resolution_lineage* rr = lp.resolution(lp.goal(nullptr, 3), 6);
+        cdcl c;
+        c.learn(lemma(avoidance{rp, rq}));
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+        s.scripted = {rr, rp};
+
+        // p(a) eliminates q(a), forcing q(b), which leaves s(Y) empty
+        assert(!s());
+        assert(s.conflicted());
+        assert(s.get_decisions() == decisions({rr, rp}));
+        assert(s.analyze() == decisions({rp}));
+        t.pop();
+    }
+
+    // Without a conflict every decision is kept
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
+        database db;
+        db.push_back(rule{ep.functor("p", {}), {ep.functor("r", {})}}); // 0: p :- r.
+        db.push_back(rule{ep.functor("p", {}), {}});                    // 1: p.
+        goals gs{ep.functor("p", {})};
+        cdcl c;
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+        const resolution_lineage* rl = lp.resolution(lp.goal(nullptr, 0), 1);
+        s.scripted = {rl};
+
+        assert(s());
+        assert(s.analyze() == decisions({rl}));
+        t.pop();
+    }
+}
+
+void test_sim_implied() {
+    trail t; t.push();
+    expr_pool ep(t); bind_map bm(t); sequencer seq(t); lineage_pool lp;
+    const expr* a = ep.functor("a");
+    const expr* b = ep.functor("b");
+    database db;
+    db.push_back(rule{ep.functor("p", {a}), {}});                  // 0: p(a).
+    db.push_back(rule{ep.functor("p", {b}), {}});                  // 1: p(b).
+    db.push_back(rule{ep.functor("q", {b}), {}});                  // 2: q(b).
+    db.push_back(rule{ep.functor("q", {ep.functor("c")}), {}});    // 3: q(c).
+    uint32_t x = seq();
+    goals gs{ep.functor("p", {ep.var(x)}), ep.functor("q", {ep.var(x)})};
+    const resolution_lineage* pa = lp.resolution(lp.goal(nullptr, 0), 0);
+    const resolution_lineage* qb = lp.resolution(lp.goal(nullptr, 1), 2);
+
+    // A conflict resting on the program alone
+    {
+        t.push();
+        cdcl c;
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+        assert(!s.implied());
+        s.scripted = {pa};
+        assert(!s());
+        s.analyze();
+        assert(s.implied());
+        t.pop();
+    }
+
+    // Forced to q(c), and so into conflict, by a conflict lemma
+    {
+        t.push();
+        cdcl c;
+        c.learn(lemma(avoidance{qb}));
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+        assert(!s());
+        assert(s.analyze().empty());
+        assert(s.implied());
+        t.pop();
+    }
+
+    // The same, by a lemma blocking a solution
+    {
+        t.push();
+        cdcl c;
+        c.learn(lemma(avoidance{qb}), true);
+        sim_mock s(10, db, gs, t, seq, ep, bm, lp, c);
+        assert(!s());
+        assert(s.analyze().empty());
+        assert(!s.implied());
+        t.pop();
+    }
+
+    // No conflict
     {
-        trail t;
         t.push();
-        expr_pool ep(t);
-        bind_map bm(t);
-        sequencer seq(t);
-        lineage_pool lp;
-        database db;
-        db.push_back(rule{ep.functor("p", {}), {ep.functor("q", {}), ep.functor("r", {})}}); // p :- q, r.
-        goals goals;
-        goals.push_back(ep.functor("p", {}));
         cdcl c;
-        monte_carlo::tree_node<mcts_decider::choice> root;
-        std::mt19937 rng(42);
-        monte_carlo::simulation<mcts_decider::choice, std::mt19937> mc(root, 1.414, rng);
-        ridge_sim sim(sim_args{100, db, goals, t, seq, ep, bm, lp, c}, mcts_sim_args{mc});
-
-        assert(sim.gs.size() == 1);
-        assert(sim.rs.size() == 0);
-
-        const goal_lineage* gl0 = lp.goal(nullptr, 0);
-        const resolution_lineage* rl = lp.resolution(gl0, 0);
-        sim.resolve(rl);
-
-        assert(sim.rs.size() == 1);
-        assert(sim.rs.count(rl) == 1);
-        // p removed; q and r added (body has 2 sub-goals)
-        assert(sim.gs.size() == 2);
-        assert(sim.cs.size() == 2);
-
-        const goal_lineage* sub_gl0 = lp.goal(rl, 0);
-        const goal_lineage* sub_gl1 = lp.goal(rl, 1);
-        assert(sim.gs.at(sub_gl0) == ep.functor("q", {}));
-        assert(sim.gs.at(sub_gl1) == ep.functor("r", {}));
+        sim_mock s(0, db, gs, t, seq, ep, bm, lp, c);
+        assert(!s());
+        s.analyze();
+        assert(!s.implied());
+        t.pop();
     }
+    t.pop();
 }
 
 void test_sim() {
@@ -18281,6 +22051,175 @@ void test_sim() {
         assert(&r == &s.rs);
         assert(&d == &s.ds);
     }
+
+    // Builtins with unbound inputs and nothing left to decide flounder
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        sequencer seq(t);
+        lineage_pool lp;
+        database db;
+        goals goals;
+        goals.push_back(ep.functor("int_lt", {ep.var(seq()), ep.integer(1)}));
+        cdcl c;
+        monte_carlo::tree_node<mcts_decider::choice> root;
+        std::mt19937 rng(42);
+        monte_carlo::simulation<mcts_decider::choice, std::mt19937> mc(root, 1.414, rng);
+        ridge_sim sim(sim_args{100, db, goals, t, seq, ep, bm, lp, c}, mcts_sim_args{mc});
+
+        assert(!sim());
+        assert(sim.get_resolutions().empty());
+        assert(sim.get_decisions().empty());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// solver tests — solver_mock runs sim_mocks and counts terminations
+
+struct solver_mock : solver {
+    solver_mock(solver_args sa) : solver(sa) {}
+
+    size_t terminate_cnt = 0;
+
+    std::unique_ptr<sim> construct_sim() override {
+        return std::make_unique<sim_mock>(max_resolutions, db, gl, t, vars, ep, bm, lp, c);
+    }
+    void terminate(sim&) override {
+        ++terminate_cnt;
+    }
+};
+
+void test_solver_save_lemmas() {
+    // db: {p(a).}, goals: p(b) — in conflict before any decision
+    trail t; t.push();
+    expr_pool ep(t); bind_map bm(t); sequencer seq(t);
+    database db;
+    db.push_back(rule{ep.functor("p", {ep.functor("a")}), {}});
+    goals gl{ep.functor("p", {ep.functor("b")})};
+    const size_t unlimited = std::numeric_limits<size_t>::max();
+    std::string path = (std::filesystem::temp_directory_path() / "atlas_test_solver_save_lemmas").string();
+    std::filesystem::remove(path);
+
+    // Without a lemma file, nothing is written
+    {
+        solver_mock s(solver_args{db, gl, t, seq, bm, 10});
+        std::optional<resolutions> soln;
+        assert(!s(soln));
+        s.save_lemmas();
+        assert(!std::filesystem::exists(path));
+    }
+
+    // The refutation is written under the inputs' key, and read back by a
+    // solver on the same inputs
+    {
+        solver_mock s(solver_args{db, gl, t, seq, bm, 10, nullptr, 1 << 16, unlimited, path});
+        assert(s.c.get_kept() == 0);
+        std::optional<resolutions> soln;
+        assert(!s(soln));
+        assert(s.c.refuted());
+        s.save_lemmas();
+        assert(std::filesystem::exists(path));
+
+        lineage_pool lp;
+        cdcl c;
+        assert(lemma_store(path).load(lemma_store::fingerprint(db, gl), c, lp) == 1);
+        assert(c.refuted());
+
+        solver_mock again(solver_args{db, gl, t, seq, bm, 10, nullptr, 1 << 16, unlimited, path});
+        assert(again.c.refuted());
+        assert(!again(soln));
+        assert(again.terminate_cnt == 0);
+    }
+    std::filesystem::remove(path);
+
+    // A lemma file that cannot be opened loads nothing, and saving to it throws
+    {
+        std::string unopenable = (std::filesystem::temp_directory_path() / "atlas_no_such_dir" / "lemmas").string();
+        solver_mock s(solver_args{db, gl, t, seq, bm, 10, nullptr, 1 << 16, unlimited, unopenable});
+        assert(s.c.get_kept() == 0);
+        std::optional<resolutions> soln;
+        assert(!s(soln));
+        bool threw = false;
+        try { s.save_lemmas(); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+        assert(!std::filesystem::exists(unopenable));
+    }
+}
+
+void test_solver_get_cdcl() {
+    // Returns const ref to the solver's own cdcl, which its sims copy
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t);
+        database db; goals gl;
+        solver_mock s(solver_args{db, gl, t, seq, bm, 10});
+
+        const cdcl& c = s.get_cdcl();
+        assert(&c == &s.c);
+        assert(c.get_kept() == 0);
+    }
+
+    // Reference is live: the lemma each sim ends with is visible
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t);
+        database db;
+        db.push_back(rule{ep.functor("p", {}), {}});
+        goals gl{ep.functor("p", {})};
+        solver_mock s(solver_args{db, gl, t, seq, bm, 10});
+
+        const cdcl& c = s.get_cdcl();
+        std::optional<resolutions> soln;
+        assert(s(soln));
+        assert(soln.has_value());
+        assert(&s.managed_sim->get_cdcl() != &c);
+        // the solution took no decisions, so its lemma is empty and pinned
+        assert(c.get_kept() == 1);
+        assert(c.refuted());
+        assert(c.pinned == std::set<size_t>({0}));
+    }
+}
+
+void test_solver_get_prefiltered() {
+    // Zero before any sim has run
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t);
+        database db; goals gl;
+        solver_mock s(solver_args{db, gl, t, seq, bm, 10});
+
+        assert(s.get_prefiltered() == 0);
+    }
+
+    // Prefilter rejections are added up over the solver's sims
+    {
+        trail t; t.push();
+        expr_pool ep(t); bind_map bm(t); sequencer seq(t);
+        const expr* b = ep.functor("b");
+        database db;
+        db.push_back(rule{ep.functor("p", {ep.functor("a")}), {}});
+        db.push_back(rule{ep.functor("p", {b}), {}});
+        db.push_back(rule{ep.functor("q", {b}), {}});
+        const expr* X = ep.var(seq());
+        goals gl{ep.functor("q", {X}), ep.functor("p", {X})};
+        solver_mock s(solver_args{db, gl, t, seq, bm, 10});
+
+        // q(X) binds X to b, so p(a) is rejected without unifying
+        std::optional<resolutions> soln;
+        assert(s(soln));
+        assert(soln.has_value());
+        assert(s.terminate_cnt == 1);
+        assert(s.managed_sim->get_prefiltered() == 1);
+        assert(s.get_prefiltered() == 1);
+
+        // the sim made no decisions, so its lemma refutes the goals and no
+        // further sim runs; the total stays where it was
+        assert(!s(soln));
+        assert(!soln.has_value());
+        assert(s.get_prefiltered() == 1);
+    }
 }
 
 void test_ridge_sim_constructor() {
@@ -18447,16 +22386,12 @@ void test_ridge_sim_constructor() {
         assert(gl1->parent == nullptr);
         assert(gl2->parent == nullptr);
         
-        // CRITICAL: Three goals, each with all 3 db rules as candidates
+        // CRITICAL: Three goals, each with the one db rule of its predicate as candidate
         assert(simulation.cs.size() == 3);
         
-        assert(simulation.cs.at(gl0).size() == 3);
-        assert(simulation.cs.at(gl1).size() == 3);
-        assert(simulation.cs.at(gl2).size() == 3);
-        
-        assert(std::set<size_t>(simulation.cs.at(gl0).begin(), simulation.cs.at(gl0).end()) == std::set<size_t>({0, 1, 2}));
-        assert(std::set<size_t>(simulation.cs.at(gl1).begin(), simulation.cs.at(gl1).end()) == std::set<size_t>({0, 1, 2}));
-        assert(std::set<size_t>(simulation.cs.at(gl2).begin(), simulation.cs.at(gl2).end()) == std::set<size_t>({0, 1, 2}));
+        assert(simulation.cs.at(gl0) == std::vector<size_t>({0}));
+        assert(simulation.cs.at(gl1) == std::vector<size_t>({1}));
+        assert(simulation.cs.at(gl2) == std::vector<size_t>({2}));
         
         // Max resolutions
         assert(simulation.max_resolutions == 200);
@@ -18501,8 +22436,8 @@ void test_ridge_sim_constructor() {
         // CRITICAL: All goals added to goal_store
         assert(simulation.gs.size() == 3);
         
-        // CRITICAL: goal_adder adds ALL db rules to ALL goals (trivially, before elimination)
-        // 3 goals * 1 db rule = 3 total candidates
+        // CRITICAL: each goal is seeded with the db rules of its own predicate;
+        // only p has one, so q and r start with no candidates
         assert(simulation.cs.size() == 3);
         
         const goal_lineage* gl_p = nullptr;
@@ -18516,8 +22451,8 @@ void test_ridge_sim_constructor() {
         }
         
         assert(simulation.cs.at(gl_p) == std::vector<size_t>({0}));
-        assert(simulation.cs.at(gl_q) == std::vector<size_t>({0}));
-        assert(simulation.cs.at(gl_r) == std::vector<size_t>({0}));
+        assert(simulation.cs.at(gl_q).empty());
+        assert(simulation.cs.at(gl_r).empty());
         
         // CRITICAL: Verify resolution and decision stores empty
         assert(simulation.rs.size() == 0);
@@ -18684,14 +22619,11 @@ void test_ridge_sim_constructor() {
         
         assert(simulation.cs.size() == 4);
         
-        assert(simulation.cs.at(gl0).size() == 6);
-        assert(simulation.cs.at(gl1).size() == 6);
-        assert(simulation.cs.at(gl2).size() == 6);
-        assert(simulation.cs.at(gl3).size() == 6);
-        
-        for (const goal_lineage* gl : {gl0, gl1, gl2, gl3}) {
-            assert(std::set<size_t>(simulation.cs.at(gl).begin(), simulation.cs.at(gl).end()) == std::set<size_t>({0, 1, 2, 3, 4, 5}));
-        }
+        // each goal is seeded with the rules of its own predicate
+        assert(simulation.cs.at(gl0) == std::vector<size_t>({0, 1}));
+        assert(simulation.cs.at(gl1) == std::vector<size_t>({2, 3, 4}));
+        assert(simulation.cs.at(gl2) == std::vector<size_t>({5}));
+        assert(simulation.cs.at(gl3).empty());
         
         // Max resolutions
         assert(simulation.max_resolutions == 75);
@@ -18947,8 +22879,9 @@ void test_ridge_sim_constructor() {
         assert(simulation.ds.size() == 0);
         assert(simulation.rs.size() == 0);
         
+        // no rule defines any goal's predicate
         for (const auto& [gl, ge] : simulation.gs) {
-            assert(simulation.cs.at(gl).size() == 2);
+            assert(simulation.cs.at(gl).empty());
             assert(gl->parent == nullptr);
             assert(gl->idx >= 0 && gl->idx < 5);
         }
@@ -19797,7 +23730,7 @@ void test_horizon() {
         normalizer norm(ep, bm);
         const expr* X_val = norm(X);
         assert(std::holds_alternative<expr::functor>(X_val->content));
-        assert(std::get<expr::functor>(X_val->content).name == "42");
+        assert(symbols().name(std::get<expr::functor>(X_val->content).id) == "42");
     }
 
     // Test 4: Immediate refutation — empty database, goal has no candidates.
@@ -19909,7 +23842,7 @@ void test_horizon() {
         // CRITICAL: bm binds X to "2"
         const expr* X_val = norm(X);
         assert(std::holds_alternative<expr::functor>(X_val->content));
-        assert(std::get<expr::functor>(X_val->content).name == "2");
+        assert(symbols().name(std::get<expr::functor>(X_val->content).id) == "2");
 
         // CRITICAL: soln contains exactly 2 resolutions (one per goal)
         assert(soln.value().size() == 2);
@@ -19966,7 +23899,7 @@ void test_horizon() {
 
         const expr* X_val1 = norm(X);
         assert(std::holds_alternative<expr::functor>(X_val1->content));
-        std::string parent1 = std::get<expr::functor>(X_val1->content).name;
+        std::string parent1 = symbols().name(std::get<expr::functor>(X_val1->content).id);
         assert(parent1 == "bob" || parent1 == "carol");
 
         // Second parent of alice — CDCL blocks the first decision; other rule is unit-prop'd
@@ -19978,7 +23911,7 @@ void test_horizon() {
 
         const expr* X_val2 = norm(X);
         assert(std::holds_alternative<expr::functor>(X_val2->content));
-        std::string parent2 = std::get<expr::functor>(X_val2->content).name;
+        std::string parent2 = symbols().name(std::get<expr::functor>(X_val2->content).id);
         assert(parent2 == "bob" || parent2 == "carol");
 
         // CRITICAL: the two solutions bind X to different names
@@ -20040,9 +23973,9 @@ void test_horizon() {
         assert(soln.has_value());
         assert(soln.value().size() == 5);
 
-        std::string A1 = std::get<expr::functor>(norm(A)->content).name;
-        std::string B1 = std::get<expr::functor>(norm(B)->content).name;
-        std::string C1 = std::get<expr::functor>(norm(C)->content).name;
+        std::string A1 = symbols().name(std::get<expr::functor>(norm(A)->content).id);
+        std::string B1 = symbols().name(std::get<expr::functor>(norm(B)->content).id);
+        std::string C1 = symbols().name(std::get<expr::functor>(norm(C)->content).id);
 
         assert(is_valid_color(A1) && is_valid_color(B1) && is_valid_color(C1));
         // CRITICAL: adjacent nodes have different colors
@@ -20058,9 +23991,9 @@ void test_horizon() {
         assert(soln.has_value());
         assert(soln.value().size() == 5);
 
-        std::string A2 = std::get<expr::functor>(norm(A)->content).name;
-        std::string B2 = std::get<expr::functor>(norm(B)->content).name;
-        std::string C2 = std::get<expr::functor>(norm(C)->content).name;
+        std::string A2 = symbols().name(std::get<expr::functor>(norm(A)->content).id);
+        std::string B2 = symbols().name(std::get<expr::functor>(norm(B)->content).id);
+        std::string C2 = symbols().name(std::get<expr::functor>(norm(C)->content).id);
 
         assert(is_valid_color(A2) && is_valid_color(B2) && is_valid_color(C2));
         assert(A2 != B2);
@@ -20137,7 +24070,7 @@ void test_horizon() {
 
         const expr* G_val1 = norm(G);
         assert(std::holds_alternative<expr::functor>(G_val1->content));
-        std::string gp1 = std::get<expr::functor>(G_val1->content).name;
+        std::string gp1 = symbols().name(std::get<expr::functor>(G_val1->content).id);
         assert(gp1 == "alice" || gp1 == "bob");
 
         // Call 2: second grandparent of dave — must differ from the first
@@ -20149,7 +24082,7 @@ void test_horizon() {
 
         const expr* G_val2 = norm(G);
         assert(std::holds_alternative<expr::functor>(G_val2->content));
-        std::string gp2 = std::get<expr::functor>(G_val2->content).name;
+        std::string gp2 = symbols().name(std::get<expr::functor>(G_val2->content).id);
         assert(gp2 == "alice" || gp2 == "bob");
 
         // CRITICAL: the two solutions bind G to different names
@@ -21367,6 +25300,226 @@ void test_horizon() {
             };
         });
     }
+
+    // Test 23: A small lemma budget bounds the avoidances kept across iterations.
+    // db: {n(1). n(2). n(3).}, goals: n(X), n(Y), n(Z), X + Y + Z < 3 (unsatisfiable;
+    // the first conflicts rest on all three choices, so their lemmas are deletable)
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        sequencer seq(t);
+
+        database db;
+        for (int64_t i = 1; i <= 3; ++i)
+            db.push_back(rule{ep.functor("n", {ep.integer(i)}), {}});
+
+        const expr* X = ep.var(seq());
+        const expr* Y = ep.var(seq());
+        const expr* Z = ep.var(seq());
+        goals goals;
+        goals.push_back(ep.functor("n", {X}));
+        goals.push_back(ep.functor("n", {Y}));
+        goals.push_back(ep.functor("n", {Z}));
+        const expr* S = ep.var(seq());
+        const expr* T = ep.var(seq());
+        goals.push_back(ep.functor("int_add", {X, Y, S}));
+        goals.push_back(ep.functor("int_add", {S, Z, T}));
+        goals.push_back(ep.functor("int_lt", {T, ep.integer(3)}));
+
+        std::mt19937 rng(42);
+        horizon solver(solver_args{db, goals, t, seq, bm, 1000, nullptr, 1 << 16, 4}, mcts_solver_args{1.414, rng});
+        assert(solver.max_lemmas == 4);
+
+        std::optional<resolution_store> soln;
+        size_t iterations = 0;
+        while (iterations < 1000 && solver(soln)) {
+            assert(!soln.has_value());
+            ++iterations;
+            // every avoidance learned is kept, or was deleted or subsumed
+            assert(solver.c.get_kept() + solver.c.get_deleted() + solver.c.get_subsumed() == solver.c.next_avoidance_id);
+        }
+        // deletions spared what the refutation needed
+        assert(solver.c.get_deleted() > 0);
+        assert(solver.c.refuted());
+    }
+
+    // Test 24: Lemmas saved by one run prune the next from its first iteration.
+    // Same puzzle as Test 23; a run that refutes it leaves the empty avoidance
+    // in the file, so a second run on the same inputs is refuted at once.
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        sequencer seq(t);
+
+        database db;
+        for (int64_t i = 1; i <= 3; ++i)
+            db.push_back(rule{ep.functor("n", {ep.integer(i)}), {}});
+
+        const expr* X = ep.var(seq());
+        const expr* Y = ep.var(seq());
+        const expr* Z = ep.var(seq());
+        goals goals;
+        goals.push_back(ep.functor("n", {X}));
+        goals.push_back(ep.functor("n", {Y}));
+        goals.push_back(ep.functor("n", {Z}));
+        const expr* S = ep.var(seq());
+        const expr* T = ep.var(seq());
+        goals.push_back(ep.functor("int_add", {X, Y, S}));
+        goals.push_back(ep.functor("int_add", {S, Z, T}));
+        goals.push_back(ep.functor("int_lt", {T, ep.integer(3)}));
+
+        std::string path = (std::filesystem::temp_directory_path() / "atlas_test_horizon_lemmas").string();
+        std::filesystem::remove(path);
+        std::optional<resolution_store> soln;
+
+        size_t first_iterations = 0;
+        {
+            std::mt19937 rng(42);
+            horizon solver(solver_args{db, goals, t, seq, bm, 1000, nullptr, 1 << 16, 1 << 14, path}, mcts_solver_args{1.414, rng});
+            assert(solver.c.get_kept() == 0);
+            while (first_iterations < 1000 && solver(soln))
+                ++first_iterations;
+            assert(solver.c.refuted());
+            solver.save_lemmas();
+        }
+        assert(first_iterations > 1);
+
+        // the same inputs: refuted before any sim runs
+        {
+            std::mt19937 rng(42);
+            horizon solver(solver_args{db, goals, t, seq, bm, 1000, nullptr, 1 << 16, 1 << 14, path}, mcts_solver_args{1.414, rng});
+            assert(solver.c.refuted());
+            assert(!solver(soln));
+        }
+
+        // another budget: conflict lemmas hold under any budget, so this
+        // run is refuted at once too
+        {
+            std::mt19937 rng(42);
+            horizon solver(solver_args{db, goals, t, seq, bm, 999, nullptr, 1 << 16, 1 << 14, path}, mcts_solver_args{1.414, rng});
+            assert(solver.c.refuted());
+            assert(!solver(soln));
+        }
+        std::filesystem::remove(path);
+    }
+
+    // Test 25: Under a small lemma budget, the solutions are still exact.
+    // Three mutually adjacent nodes in four colours have 4 * 3 * 2 = 24
+    // colourings; reduction may delete conflict lemmas, but never those
+    // blocking a colouring already found, so none is found twice.
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        sequencer seq(t);
+
+        database db;
+        for (int64_t i = 1; i <= 4; ++i)
+            db.push_back(rule{ep.functor("colour", {ep.integer(i)}), {}});
+        for (int64_t i = 1; i <= 4; ++i)
+            for (int64_t j = 1; j <= 4; ++j)
+                if (i != j)
+                    db.push_back(rule{ep.functor("diff", {ep.integer(i), ep.integer(j)}), {}});
+
+        const expr* A = ep.var(seq());
+        const expr* B = ep.var(seq());
+        const expr* C = ep.var(seq());
+        goals goals;
+        goals.push_back(ep.functor("colour", {A}));
+        goals.push_back(ep.functor("colour", {B}));
+        goals.push_back(ep.functor("colour", {C}));
+        goals.push_back(ep.functor("diff", {A, B}));
+        goals.push_back(ep.functor("diff", {B, C}));
+        goals.push_back(ep.functor("diff", {A, C}));
+
+        std::mt19937 rng(42);
+        horizon solver(solver_args{db, goals, t, seq, bm, 1000, nullptr, 1 << 16, 4}, mcts_solver_args{1.414, rng});
+
+        std::optional<resolution_store> soln;
+        std::set<std::array<size_t, 3>> colourings;
+        size_t found = 0;
+        size_t iterations = 0;
+        while (iterations < 10000 && solver(soln)) {
+            ++iterations;
+            if (!soln)
+                continue;
+            ++found;
+            std::array<size_t, 3> colouring{};
+            for (const resolution_lineage* rl : *soln)
+                if (!rl->parent->parent && rl->parent->idx < 3)
+                    colouring[rl->parent->idx] = rl->idx;
+            colourings.insert(colouring);
+        }
+        assert(solver.c.refuted());
+        assert(found == 24);
+        assert(colourings.size() == 24);
+        assert(solver.c.get_deleted() > 0);
+    }
+
+    // Test 26: The same query, run twice over one lemma file, gives the same
+    // solutions: the file holds conflict lemmas only, never those blocking
+    // the first run's solutions.
+    // db: {n(1). n(2). n(3).}, goals: n(X), n(Y), X < Y (three solutions)
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        sequencer seq(t);
+
+        database db;
+        for (int64_t i = 1; i <= 3; ++i)
+            db.push_back(rule{ep.functor("n", {ep.integer(i)}), {}});
+
+        const expr* X = ep.var(seq());
+        const expr* Y = ep.var(seq());
+        goals goals;
+        goals.push_back(ep.functor("n", {X}));
+        goals.push_back(ep.functor("n", {Y}));
+        goals.push_back(ep.functor("int_lt", {X, Y}));
+
+        std::string path = (std::filesystem::temp_directory_path() / "atlas_test_horizon_rerun").string();
+        std::filesystem::remove(path);
+
+        // each run saves as it goes, as the CLI does, and reports the
+        // values of X and Y in each solution
+        auto run = [&] {
+            std::mt19937 rng(42);
+            horizon solver(solver_args{db, goals, t, seq, bm, 1000, nullptr, 1 << 16, 1 << 14, path}, mcts_solver_args{1.414, rng});
+            std::set<std::pair<size_t, size_t>> solutions;
+            std::optional<resolution_store> soln;
+            size_t iterations = 0;
+            while (iterations < 1000 && solver(soln)) {
+                ++iterations;
+                if (!soln)
+                    continue;
+                std::pair<size_t, size_t> xy;
+                for (const resolution_lineage* rl : *soln) {
+                    if (rl->parent->parent)
+                        continue;
+                    if (rl->parent->idx == 0)
+                        xy.first = rl->idx;
+                    if (rl->parent->idx == 1)
+                        xy.second = rl->idx;
+                }
+                solutions.insert(xy);
+                solver.save_lemmas();
+            }
+            assert(solver.c.refuted());
+            solver.save_lemmas();
+            return solutions;
+        };
+
+        std::set<std::pair<size_t, size_t>> first = run();
+        assert(first == (std::set<std::pair<size_t, size_t>>{{0, 1}, {0, 2}, {1, 2}}));
+        assert(run() == first);
+        std::filesystem::remove(path);
+    }
 }
 
 void test_ridge_sim() {
@@ -21928,10 +26081,10 @@ void test_ridge_sim() {
         assert(simulation.rs.count(rl_c) == 1);
     }
     
-    // Test 10: Fixpoint iteration - multiple head eliminations before decision
+    // Test 10: Fixpoint iteration - other predicates are never seeded
     // Database: a., b., c., d., e :- f.
     // Goal: :- e.
-    // Expected: Head elim removes a,b,c,d (4 candidates), unit prop on e→f, conflict on f
+    // Expected: Seeding leaves out a,b,c,d, unit prop on e→f, conflict on f
     {
         trail t;
         t.push();
@@ -21959,9 +26112,9 @@ void test_ridge_sim() {
         
         ridge_sim simulation(sim_args{100, db, goals, t, seq, ep, bm, lp, c}, mcts_sim_args{sim});
         
-        // Before execution, verify 5 candidates added
+        // Before execution, verify only the e rule was seeded
         const goal_lineage* gl0_for_check = lp.goal(nullptr, 0);
-        assert(simulation.cs.at(gl0_for_check).size() == 5);
+        assert(simulation.cs.at(gl0_for_check) == std::vector<size_t>({4}));
         
         bool result = simulation();
         
@@ -22044,12 +26197,12 @@ void test_ridge_sim() {
         // CRITICAL: All unit propagations (no decisions)
         assert(simulation.ds.size() == 0);
         
-        // CRITICAL: Avoidance store modified (rl(gl0,0) erased after resolution)
+        // CRITICAL: Avoidance kept as learned; taking rl(gl0,0) left only the
+        // dummy untaken, so the dummy is now eliminated
         assert(simulation.c.avoidances.size() == 1);
-        const avoidance& remaining = simulation.c.avoidances.begin()->second;
-        assert(remaining.size() == 1);  // Only dummy remains
-        assert(remaining.count(rl_dummy) == 1);
-        assert(remaining.count(rl_a0_pre) == 0);  // This was erased
+        assert(simulation.c.avoidances.begin()->second == avoid);
+        assert(simulation.c.eliminated(rl_dummy));
+        assert(!simulation.c.eliminated(rl_a0_pre));
         
         // Stores empty
         assert(simulation.gs.size() == 0);
@@ -22519,16 +26672,16 @@ void test_ridge_sim() {
         
         ridge_sim simulation(sim_args{100, db, goals, t, seq, ep, bm, lp, c}, mcts_sim_args{sim});
         
-        // Initial state: 20 candidates
+        // Initial state: only the matching rule is seeded
         const goal_lineage* gl0_for_check = lp.goal(nullptr, 0);
-        assert(simulation.cs.at(gl0_for_check).size() == 20);
+        assert(simulation.cs.at(gl0_for_check) == std::vector<size_t>({19}));
         
         bool result = simulation();
         
         // CRITICAL: Solution found
         assert(result == true);
         
-        // CRITICAL: Exactly 1 resolution (head elim removes 19, unit prop on idx 19)
+        // CRITICAL: Exactly 1 resolution (unit prop on idx 19)
         assert(simulation.rs.size() == 1);
         
         // CRITICAL: Verify exact resolution
@@ -22923,9 +27076,9 @@ void test_ridge_sim() {
         
         ridge_sim simulation(sim_args{100, db, goals, t, seq, ep, bm, lp, c}, mcts_sim_args{sim});
         
-        // Verify 30 candidates initially
+        // Verify only the p rule is seeded, despite the 30 rules
         const goal_lineage* gl0 = lp.goal(nullptr, 0);
-        assert(simulation.cs.at(gl0).size() == 30);
+        assert(simulation.cs.at(gl0) == std::vector<size_t>({10}));
         
         bool result = simulation();
         
@@ -25566,7 +29719,7 @@ void test_ridge() {
         normalizer norm(ep, bm);
         const expr* X_val = norm(X);
         assert(std::holds_alternative<expr::functor>(X_val->content));
-        assert(std::get<expr::functor>(X_val->content).name == "42");
+        assert(symbols().name(std::get<expr::functor>(X_val->content).id) == "42");
     }
 
     // Test 4: Immediate refutation — empty database, goal has no candidates.
@@ -25686,7 +29839,7 @@ void test_ridge() {
         // CRITICAL: bm binds X to "2"
         const expr* X_val = norm(X);
         assert(std::holds_alternative<expr::functor>(X_val->content));
-        assert(std::get<expr::functor>(X_val->content).name == "2");
+        assert(symbols().name(std::get<expr::functor>(X_val->content).id) == "2");
 
         // CRITICAL: soln contains exactly the two resolutions for X=2 — one per goal.
         // Regardless of which goal MCTS decided first, both rl(gl_a,1) and rl(gl_b,2)
@@ -25750,7 +29903,7 @@ void test_ridge() {
 
         const expr* X_val1 = norm(X);
         assert(std::holds_alternative<expr::functor>(X_val1->content));
-        std::string parent1 = std::get<expr::functor>(X_val1->content).name;
+        std::string parent1 = symbols().name(std::get<expr::functor>(X_val1->content).id);
         assert(parent1 == "bob" || parent1 == "carol");
 
         // Second parent of alice — sim_one rolls back bm then unit-props the other rule
@@ -25762,7 +29915,7 @@ void test_ridge() {
 
         const expr* X_val2 = norm(X);
         assert(std::holds_alternative<expr::functor>(X_val2->content));
-        std::string parent2 = std::get<expr::functor>(X_val2->content).name;
+        std::string parent2 = symbols().name(std::get<expr::functor>(X_val2->content).id);
         assert(parent2 == "bob" || parent2 == "carol");
 
         // CRITICAL: the two solutions bind X to different names
@@ -25849,8 +30002,8 @@ void test_ridge() {
         assert(std::holds_alternative<expr::functor>(P_val1->content));
 
         // CRITICAL: Q = true in every solution of (P∨Q)∧(¬P∨Q)
-        assert(std::get<expr::functor>(Q_val1->content).name == "true");
-        std::string P_str1 = std::get<expr::functor>(P_val1->content).name;
+        assert(symbols().name(std::get<expr::functor>(Q_val1->content).id) == "true");
+        std::string P_str1 = symbols().name(std::get<expr::functor>(P_val1->content).id);
         assert(P_str1 == "true" || P_str1 == "false");
 
         // Second solution: CDCL eliminates first P choice; the other propagates
@@ -25865,8 +30018,8 @@ void test_ridge() {
         assert(std::holds_alternative<expr::functor>(P_val2->content));
 
         // CRITICAL: Q still true after finding the second solution
-        assert(std::get<expr::functor>(Q_val2->content).name == "true");
-        std::string P_str2 = std::get<expr::functor>(P_val2->content).name;
+        assert(symbols().name(std::get<expr::functor>(Q_val2->content).id) == "true");
+        std::string P_str2 = symbols().name(std::get<expr::functor>(P_val2->content).id);
 
         // CRITICAL: the two solutions assign opposite values to P
         assert(P_str2 != P_str1);
@@ -25941,9 +30094,9 @@ void test_ridge() {
         // All 5 goals are resolved in every solution
         assert(soln.value().size() == 5);
 
-        std::string A1 = std::get<expr::functor>(norm(A)->content).name;
-        std::string B1 = std::get<expr::functor>(norm(B)->content).name;
-        std::string C1 = std::get<expr::functor>(norm(C)->content).name;
+        std::string A1 = symbols().name(std::get<expr::functor>(norm(A)->content).id);
+        std::string B1 = symbols().name(std::get<expr::functor>(norm(B)->content).id);
+        std::string C1 = symbols().name(std::get<expr::functor>(norm(C)->content).id);
 
         assert(is_valid_color(A1) && is_valid_color(B1) && is_valid_color(C1));
         // CRITICAL: adjacent nodes have different colors
@@ -25959,9 +30112,9 @@ void test_ridge() {
         assert(soln.has_value());
         assert(soln.value().size() == 5);
 
-        std::string A2 = std::get<expr::functor>(norm(A)->content).name;
-        std::string B2 = std::get<expr::functor>(norm(B)->content).name;
-        std::string C2 = std::get<expr::functor>(norm(C)->content).name;
+        std::string A2 = symbols().name(std::get<expr::functor>(norm(A)->content).id);
+        std::string B2 = symbols().name(std::get<expr::functor>(norm(B)->content).id);
+        std::string C2 = symbols().name(std::get<expr::functor>(norm(C)->content).id);
 
         assert(is_valid_color(A2) && is_valid_color(B2) && is_valid_color(C2));
         assert(A2 != B2);
@@ -27066,6 +31219,109 @@ void test_ridge() {
             return {ep.import(norm(T))};
         });
     }
+
+    // Factorial over native integers: fact(0, 1).  fact(N, F) :- int_gt(N, 0), int_sub(N, 1, M), fact(M, G), int_mul(N, G, F).
+    // Goal: fact(4, F). Builtins evaluate inline, so the only decision is where the recursion stops.
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        sequencer seq(t);
+
+        database db;
+        db.push_back(rule{ep.functor("fact", {ep.integer(0), ep.integer(1)}), {}});
+        {
+            const expr* N = ep.var(seq());
+            const expr* F = ep.var(seq());
+            const expr* M = ep.var(seq());
+            const expr* G = ep.var(seq());
+            db.push_back(rule{ep.functor("fact", {N, F}), {
+                ep.functor("int_gt", {N, ep.integer(0)}),
+                ep.functor("int_sub", {N, ep.integer(1), M}),
+                ep.functor("fact", {M, G}),
+                ep.functor("int_mul", {N, G, F}),
+            }});
+        }
+
+        const expr* F = ep.var(seq());
+        goals goals;
+        goals.push_back(ep.functor("fact", {ep.integer(4), F}));
+
+        std::mt19937 rng(42);
+        ridge solver(solver_args{db, goals, t, seq, bm, 1000}, mcts_solver_args{1.414, rng});
+
+        std::optional<resolution_store> soln;
+        for (int i = 0; i < 100 && !soln.has_value(); ++i)
+            assert(solver(soln));
+
+        assert(soln.has_value());
+        normalizer norm(ep, bm);
+        assert(norm(F) == ep.integer(24));
+    }
+
+    // Database held in a frozen base: the solver's scratch terms go to its overlay
+    {
+        trail t;
+        expr_pool base(t);
+        sequencer seq(t);
+        bind_map bm(t);
+
+        database db;
+        db.push_back(rule{base.functor("edge", {base.integer(1), base.integer(2)}), {}});
+        db.push_back(rule{base.functor("edge", {base.integer(2), base.integer(3)}), {}});
+        {
+            const expr* X = base.var(seq());
+            const expr* Y = base.var(seq());
+            const expr* Z = base.var(seq());
+            db.push_back(rule{base.functor("path", {X, Y}), {base.functor("edge", {X, Y})}});
+            db.push_back(rule{base.functor("path", {X, Z}), {base.functor("edge", {X, Y}), base.functor("path", {Y, Z})}});
+        }
+        const expr* T = base.var(seq());
+        goals goals;
+        goals.push_back(base.functor("path", {base.integer(1), T}));
+        base.freeze();
+        size_t base_size = base.size();
+
+        std::mt19937 rng(42);
+        ridge solver(solver_args{db, goals, t, seq, bm, 1000, &base}, mcts_solver_args{1.414, rng});
+        assert(solver.ep.base == &base);
+
+        std::optional<resolution_store> soln;
+        for (int i = 0; i < 100 && !soln.has_value(); ++i)
+            assert(solver(soln));
+        assert(soln.has_value());
+        assert(base.size() == base_size);
+        assert(solver.ep.size() > 0);
+
+        expr_pool scratch(t, &base);
+        normalizer norm(scratch, bm);
+        const expr* answer = norm(T);
+        assert(answer == base.integer(2) || answer == base.integer(3));
+    }
+    // The solver's rule index is built once and shared by every sim
+    {
+        trail t;
+        t.push();
+        expr_pool ep(t);
+        bind_map bm(t);
+        sequencer seq(t);
+
+        database db;
+        db.push_back(rule{ep.functor("p", {ep.functor("a")}), {}});
+        db.push_back(rule{ep.functor("p", {ep.functor("b")}), {}});
+        goals goals{ep.functor("p", {ep.var(seq())})};
+
+        std::mt19937 rng(42);
+        ridge solver(solver_args{db, goals, t, seq, bm, 1000}, mcts_solver_args{1.414, rng});
+        assert(&solver.ri.db == &db);
+        std::optional<resolution_store> soln;
+        for (int i = 0; i < 2; ++i) {
+            solver(soln);
+            assert(&solver.managed_sim->cs.ri == &solver.ri);
+            assert(solver.managed_sim->cs.owned_index == nullptr);
+        }
+    }
 }
 
 void unit_test_main() {
@@ -27076,19 +31332,51 @@ void unit_test_main() {
     TEST(test_trail_constructor);
     TEST(test_trail_push_pop);
     TEST(test_trail_log);
+    TEST(test_trail_log_unbind);
+    TEST(test_trail_log_rebind);
+    TEST(test_trail_log_truncate);
+    TEST(test_trail_log_rewind);
+    TEST(test_symbol_table_intern);
+    TEST(test_symbol_table_name);
+    TEST(test_symbol_table_arity);
+    TEST(test_symbol_table_size);
+    TEST(test_symbols);
+    TEST(test_arena_constructor);
+    TEST(test_arena_allocate);
+    TEST(test_arena_rewind);
+    TEST(test_arena_used);
     TEST(test_functor_constructor);
     TEST(test_var_constructor);
+    TEST(test_integer_constructor);
     TEST(test_functor_cons_constructor);
     TEST(test_expr_constructor);
+    TEST(test_expr_hash);
     TEST(test_expr_pool_functor_constructor);
     TEST(test_expr_pool_functor);
     TEST(test_expr_pool_var);
+    TEST(test_expr_pool_integer);
     TEST(test_expr_pool_functor_cons);
     TEST(test_expr_pool_import);
+    TEST(test_expr_pool_intern);
+    TEST(test_expr_pool_annotate);
+    TEST(test_expr_pool_truncate);
+    TEST(test_expr_pool_rollback);
+    TEST(test_expr_pool_freeze);
+    TEST(test_expr_pool_frozen);
+    TEST(test_expr_pool_size);
+    TEST(test_expr_pool_find);
+    TEST(test_bind_map_binding_array);
     TEST(test_bind_map_bind);
     TEST(test_bind_map_whnf);
     TEST(test_bind_map_occurs_check);
     TEST(test_bind_map_unify);
+    TEST(test_bind_map_unify_template);
+    TEST(test_bind_map_deref);
+    TEST(test_bind_map_binding);
+    TEST(test_bind_map_matches);
+    TEST(test_bind_map_record);
+    TEST(test_rule_subterm_end);
+    TEST(test_rule_constructor);
     TEST(test_lineage_pool_constructor);
     TEST(test_lineage_pool_intern_goal);
     TEST(test_lineage_pool_intern_resolution);
@@ -27100,16 +31388,28 @@ void unit_test_main() {
     TEST(test_lineage_pool_import);
     TEST(test_sequencer_constructor);
     TEST(test_sequencer);
+    TEST(test_sequencer_reserve);
+    TEST(test_sequencer_rollback);
     TEST(test_copier_constructor);
     TEST(test_copier);
+    TEST(test_copier_reserve);
     TEST(test_normalizer_constructor);
     TEST(test_normalizer);
     TEST(test_expr_printer_constructor);
     TEST(test_expr_printer);
+    TEST(test_builtins_contains);
+    TEST(test_builtins_rule_at);
+    TEST(test_builtins_constructor);
+    TEST(test_builtins_ready);
+    TEST(test_builtins_evaluate);
+    TEST(test_builtins_lookup);
+    TEST(test_builtins_value);
+    TEST(test_builtins_bound_non_integer);
     TEST(test_frontier_constructor);
     TEST(test_frontier_insert);
     TEST(test_frontier_empty);
     TEST(test_frontier_size);
+    TEST(test_frontier_contains);
     TEST(test_frontier_at);
     TEST(test_frontier_begin_end);
     TEST(test_frontier_resolve);
@@ -27120,11 +31420,21 @@ void unit_test_main() {
     TEST(test_goal_store_try_unify_head);
     TEST(test_goal_store_applicable);
     TEST(test_goal_store_expand);
+    TEST(test_goal_store_get_prefiltered);
+    TEST(test_rule_index_constructor);
+    TEST(test_rule_index_seed);
+    TEST(test_rule_index_predicate);
+    TEST(test_rule_index_lookup);
     TEST(test_candidate_store_constructor);
     TEST(test_candidate_store_eliminate);
     TEST(test_candidate_store_unit);
     TEST(test_candidate_store_conflicted);
+    TEST(test_candidate_store_index);
     TEST(test_candidate_store_expand);
+    TEST(test_applicability_cache_constructor);
+    TEST(test_applicability_cache_normalize);
+    TEST(test_applicability_cache_find);
+    TEST(test_applicability_cache_insert);
     TEST(test_mcts_decider_constructor);
     TEST(test_mcts_decider_choose_goal);
     TEST(test_mcts_decider_choose_candidate);
@@ -27133,20 +31443,47 @@ void unit_test_main() {
     TEST(test_lemma_get_resolutions);
     TEST(test_lemma_remove_ancestors);
     TEST(test_cdcl_constructor);
-    TEST(test_cdcl_upsert);
+    TEST(test_cdcl_watch);
     TEST(test_cdcl_erase);
+    TEST(test_cdcl_redundant);
+    TEST(test_cdcl_supersets);
     TEST(test_cdcl_learn);
     TEST(test_cdcl_constrain);
     TEST(test_cdcl_refuted);
     TEST(test_cdcl_eliminated);
+    TEST(test_cdcl_implied);
+    TEST(test_cdcl_explain);
+    TEST(test_cdcl_credit);
+    TEST(test_cdcl_reduce);
+    TEST(test_cdcl_get_kept);
+    TEST(test_cdcl_get_deleted);
+    TEST(test_cdcl_get_subsumed);
+    TEST(test_lemma_store_constructor);
+    TEST(test_lemma_store_fingerprint);
+    TEST(test_lemma_store_load);
+    TEST(test_lemma_store_save);
+    TEST(test_lemma_store_put_get);
+    TEST(test_lemma_store_number);
     TEST(test_sim_constructor);
     TEST(test_sim_get_resolutions);
     TEST(test_sim_get_decisions);
+    TEST(test_sim_get_cdcl);
+    TEST(test_sim_get_prefiltered);
+    TEST(test_sim_failed);
     TEST(test_sim_solved);
     TEST(test_sim_conflicted);
     TEST(test_sim_derive_one);
     TEST(test_sim_resolve);
+    TEST(test_sim_watch);
+    TEST(test_sim_mark);
+    TEST(test_sim_eliminate_cached);
+    TEST(test_sim_explain);
+    TEST(test_sim_analyze);
+    TEST(test_sim_implied);
     TEST(test_sim);
+    TEST(test_solver_save_lemmas);
+    TEST(test_solver_get_cdcl);
+    TEST(test_solver_get_prefiltered);
     TEST(test_ridge_sim_constructor);
     TEST(test_ridge_sim_decide_one);
     TEST(test_horizon_sim_reward);
@@ -1,4 +1,6 @@
 #include <any>
+#include <cctype>
+#include <charconv>
 #include "../hpp/expr_visitor.hpp"
 
 expr_visitor::expr_visitor(expr_pool& pool, sequencer& seq, std::map<std::string, uint32_t>& var_map)
@@ -28,6 +30,16 @@ std::any expr_visitor::visitFunctor(CHCParser::FunctorContext* ctx) {
     auto* atom_token = ctx->ATOM();
     assert(atom_token != nullptr);
     std::string name = atom_token->getText();
+
+    // a bare numeric ATOM is a native integer, unless it has a leading zero
+    // (so 007 stays an atom distinct from 7) or overflows int64
+    if (ctx->expr().empty() && std::isdigit((unsigned char)name.front()) && (name.size() == 1 || name.front() != '0')) {
+        int64_t value;
+        auto [end, ec] = std::from_chars(name.data(), name.data() + name.size(), value);
+        if (ec == std::errc() && end == name.data() + name.size())
+            return (const expr*)pool.integer(value);
+    }
+
     std::vector<const expr*> args;
     for (auto* sub_expr : ctx->expr())
         args.push_back(std::any_cast<const expr*>(visit(sub_expr)));
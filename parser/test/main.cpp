@@ -306,6 +306,29 @@ void test_expr_visitor_visitFunctor_binary() {
     assert(result == pool.functor("add", {pool.var(var_map.at("X")), pool.var(var_map.at("Y"))}));
 }
 
+void test_expr_visitor_visitFunctor_integer() {
+    trail t;
+    expr_pool pool(t);
+    sequencer seq(t);
+    std::map<std::string, uint32_t> var_map;
+    expr_visitor ev(pool, seq, var_map);
+
+    // only canonical literals are integers: 007 and overflowing ones stay atoms
+    std::string input = "f(0, 7, 007, 99999999999999999999)";
+    antlr4::ANTLRInputStream stream(input);
+    CHCLexer lexer(&stream);
+    antlr4::CommonTokenStream tokens(&lexer);
+    CHCParser parser(&tokens);
+    auto* ctx = first_expr(stream, tokens, lexer, parser);
+
+    const expr* result = std::any_cast<const expr*>(ev.visitExpr(ctx));
+    assert(result == pool.functor("f", {
+        pool.integer(0),
+        pool.integer(7),
+        pool.functor("007", {}),
+        pool.functor("99999999999999999999", {})}));
+}
+
 void test_expr_visitor_visitList_empty() {
     trail t;
     expr_pool pool(t);
@@ -676,7 +699,7 @@ void test_import_goals_from_string_single() {
 
     auto [gl, var_name_to_idx] = import_goals_from_string("reach(0, 2)", pool, seq);
     assert(gl.size() == 1);
-    assert(gl[0] == pool.functor("reach", {pool.functor("0", {}), pool.functor("2", {})}));
+    assert(gl[0] == pool.functor("reach", {pool.integer(0), pool.integer(2)}));
     assert(var_name_to_idx.empty());
 }
 
@@ -739,10 +762,10 @@ void test_import_database_from_file_facts() {
     for (const auto& r : db)
         assert(r.body.empty());
 
-    // Each head is base(N) — functor("base", {functor(N, {})}).
-    assert(db[0].head == pool.functor("base", {pool.functor("0", {})}));
-    assert(db[1].head == pool.functor("base", {pool.functor("1", {})}));
-    assert(db[2].head == pool.functor("base", {pool.functor("2", {})}));
+    // Each head is base(N) — functor("base", {integer(N)}).
+    assert(db[0].head == pool.functor("base", {pool.integer(0)}));
+    assert(db[1].head == pool.functor("base", {pool.integer(1)}));
+    assert(db[2].head == pool.functor("base", {pool.integer(2)}));
 }
 
 void test_import_database_from_file_rules() {
@@ -807,6 +830,7 @@ void unit_test_main() {
     TEST(test_expr_visitor_visitFunctor_nullary);
     TEST(test_expr_visitor_visitFunctor_unary);
     TEST(test_expr_visitor_visitFunctor_binary);
+    TEST(test_expr_visitor_visitFunctor_integer);
     TEST(test_expr_visitor_visitList_empty);
     TEST(test_expr_visitor_visitList);
     TEST(test_expr_visitor_visitList_pipe);